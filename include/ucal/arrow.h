@@ -0,0 +1,182 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// Conversions on Apache Arrow arrays (C Data Interface)
+// ----------------------------------------------------------------------------------------------
+#ifndef ARROW_H_D2078C60_0B6B_439F_B110_087913F54042
+#define ARROW_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "tzposix.h"
+
+CDECL_BEG
+
+// The C Data Interface is an ABI: the structures are copied from the Arrow specification, and
+// the guard lets them coexist with the Arrow headers.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char          *format;
+    const char          *name;
+    const char          *metadata;
+    int64_t              flags;
+    int64_t              n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema  *dictionary;
+    void               (*release)(struct ArrowSchema *);
+    void                *private_data;
+};
+
+struct ArrowArray {
+    int64_t              length;
+    int64_t              null_count;
+    int64_t              offset;
+    int64_t              n_buffers;
+    int64_t              n_children;
+    const void         **buffers;
+    struct ArrowArray  **children;
+    struct ArrowArray   *dictionary;
+    void               (*release)(struct ArrowArray *);
+    void                *private_data;
+};
+
+#endif /*ARROW_C_DATA_INTERFACE*/
+
+/// @brief temporal Arrow types
+typedef enum {
+    ucal_ArrowType_Timestamp,   ///< @c ts?:zone, int64 in seconds, ms, us or ns
+    ucal_ArrowType_Date32,      ///< @c tdD, int32 days
+    ucal_ArrowType_Date64       ///< @c tdm, int64 milliseconds
+} ucal_ArrowTypeT;
+
+/// @brief a temporal Arrow type, from a schema format string
+typedef struct {
+    ucal_ArrowTypeT type;       ///< kind of values
+    int32_t         perSec;     ///< units per second; 0 for @c date32
+    const char     *tzname;     ///< zone of a time stamp, in the format string; @c NULL if none
+} ucal_ArrowTimeT;
+
+/// @brief number of fields an exported struct array can have
+#define UCAL_ARROW_FIELDS 6
+
+/// @brief buffers for civil fields
+///
+/// Fields with a @c NULL buffer are left out of the export; the others become the children of
+/// a struct array, in this order, named after the members.
+typedef struct {
+    int16_t *year;      ///< calendar year, exported as @c int16
+    int8_t  *month;     ///< month, 1..12, exported as @c int8
+    int8_t  *day;       ///< day of month, 1..31, exported as @c int8
+    int8_t  *hour;      ///< hour, 0..23, exported as @c int8
+    int8_t  *minute;    ///< minute, 0..59, exported as @c int8
+    int8_t  *second;    ///< second, 0..59, exported as @c int8
+} ucal_ArrowFieldsT;
+
+/// @brief an exported array with its schema
+///
+/// Holds the structures handed to the consumer and the small tables they point to.  The value
+/// buffers are the caller's; the validity buffer is the caller's or the input array's.  All
+/// of them must stay valid until the consumer releases the array, which calls @c onRelease.
+/// The holder must not move while the export is alive, but @c array and @c schema can be moved
+/// to the consumer as the C Data Interface allows.  Zero the holder, or set @c onRelease and
+/// @c arg, before the conversion; the conversions leave them alone.
+typedef struct ucal_ArrowOut_S {
+    struct ArrowArray   array;                          ///< the exported array
+    struct ArrowSchema  schema;                         ///< its type
+    void              (*onRelease)(void *arg);          ///< called when @c array is released
+    void               *arg;                            ///< argument for @c onRelease
+    const void         *buf[2];
+    struct ArrowArray  *childArr[UCAL_ARROW_FIELDS];
+    struct ArrowSchema *childSch[UCAL_ARROW_FIELDS];
+    struct ArrowArray   child[UCAL_ARROW_FIELDS];
+    struct ArrowSchema  childSchema[UCAL_ARROW_FIELDS];
+    const void         *childBuf[UCAL_ARROW_FIELDS][2];
+} ucal_ArrowOutT;
+
+/// @brief get the temporal type of an Arrow schema
+///
+/// Understands time stamps of all units (@c tss, @c tsm, @c tsu, @c tsn, with or without a
+/// zone), @c date32 (@c tdD) and @c date64 (@c tdm).
+///
+/// @note Sets @c errno to @c EINVAL if the format is no temporal type of these.
+/// @param into     where to store the type
+/// @param schema   schema of the array
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_ArrowGetType(ucal_ArrowTimeT *into, struct ArrowSchema const *schema);
+
+/// @brief resolve the zone of an Arrow time stamp type
+///
+/// Arrow zones are fixed offsets like @c +01:00, or names.  The offsets and @c UTC are
+/// understood directly, and anything else is tried as POSIX TZ string.  Zone database names
+/// like @c Europe/Berlin need the TZif files; map them to the POSIX TZ string from the file
+/// footer and pass the zone in a conversion context instead.
+///
+/// @note Sets @c errno to @c EINVAL if the name cannot be resolved.
+/// @param into     where to store the zone
+/// @param tzname   zone from the type
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_ArrowZone(tziPosixZoneT *into, const char *tzname);
+
+/// @brief convert an Arrow temporal array to a @c date32 array of local dates
+///
+/// Time stamps with a zone are converted to local time with @c tziBatchUtc2Local(), time
+/// stamps without a zone and dates are taken as they are.  The zone comes from @c ctx if given,
+/// or else from the type.  The result is exported into @c out.
+///
+/// Nulls of the input stay nulls.  Values whose year is beyond the calendar become nulls, too.
+/// If nothing became null and the input starts on a byte boundary of its validity bitmap, the
+/// bitmap is passed through; otherwise the combined validity goes to @c valid.
+///
+/// @note Sets @c errno to @c EINVAL on invalid arguments, a zone that cannot be resolved, or
+///       an unaligned input without @c valid; to @c ERANGE if values became nulls without
+///       @c valid.
+/// @param out      where to export the result
+/// @param days     where to store the days since 1970-01-01; @c in->length elements
+/// @param valid    where to store the validity bitmap; @c (in->length+7)/8 bytes or @c NULL
+/// @param ctx      conversion context of the zone, or @c NULL for the zone of the type
+/// @param in       input array
+/// @param type     type of @c in, from @c ucal_ArrowGetType()
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_ArrowToDate32(ucal_ArrowOutT *out, int32_t *days, uint8_t *valid,
+                               tziConvCtxT *ctx, struct ArrowArray const *in,
+                               ucal_ArrowTimeT const *type);
+
+/// @brief convert an Arrow temporal array to a struct array of civil fields
+///
+/// Like @c ucal_ArrowToDate32(), but the local time is split into the fields selected in
+/// @c fields.  The children share the validity bitmap of the struct array.
+///
+/// @note Sets @c errno like @c ucal_ArrowToDate32(), and to @c EINVAL if no field is selected.
+/// @param out      where to export the result
+/// @param fields   where to store the fields; @c in->length elements each
+/// @param valid    where to store the validity bitmap; @c (in->length+7)/8 bytes or @c NULL
+/// @param ctx      conversion context of the zone, or @c NULL for the zone of the type
+/// @param in       input array
+/// @param type     type of @c in, from @c ucal_ArrowGetType()
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_ArrowToFields(ucal_ArrowOutT *out, ucal_ArrowFieldsT const *fields,
+                               uint8_t *valid, tziConvCtxT *ctx, struct ArrowArray const *in,
+                               ucal_ArrowTimeT const *type);
+
+CDECL_END
+#endif /*ARROW_H_D2078C60_0B6B_439F_B110_087913F54042*/
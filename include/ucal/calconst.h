@@ -21,6 +21,7 @@
 #define UCAL_rdnNTP  693596
 #define UCAL_rdnUNIX 719163
 #define UCAL_rdnGPS  722820
+#define UCAL_rdnUUID 577736
 
 // The week cycle and the Gregorian calendar cycle are aligned: The 1st day of a quadricentennial
 // is always a Monday.  Other cycles need more effort...
@@ -41,4 +42,9 @@
 //   phi = (1980-01-06 - 1970-01-01) * 86400 (mod 1024*7*86400)
 #define UCAL_sysPhiGPS 0x12d53d80
 
+// UUIDs of version 1 and 6 count 100ns ticks since the Gregorian reform, 1582-10-15.  The phi is
+// the tick count at the UNIX epoch:
+//   phi = (1970-01-01 - 1582-10-15) * 86400 * 10⁷
+#define UCAL_sysPhiUUID 0x1b21dd213814000
+
 #endif /*CALCONST_H_D2078C60_0B6B_439F_B110_087913F54042*/
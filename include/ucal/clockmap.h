@@ -0,0 +1,121 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// Mapping of monotonic trace clocks to UTC, and nanosecond time stamps to civil time
+// ----------------------------------------------------------------------------------------------
+#ifndef CLOCKMAP_H_D2078C60_0B6B_439F_B110_087913F54042
+#define CLOCKMAP_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+CDECL_BEG
+
+/// @brief number of fraction bits of a segment drift
+#define UCAL_CLK_DRIFT_BITS 40
+
+/// @brief a segment of a clock map
+///
+/// The segment starts at an anchor pair and maps a monotonic time @c m to
+/// @c real+(m-mono)*(1+drift/2^UCAL_CLK_DRIFT_BITS).
+typedef struct {
+    int64_t mono;   ///< anchor, monotonic nanoseconds
+    int64_t real;   ///< anchor, UTC nanoseconds in UNIX scale
+    int32_t drift;  ///< rate deviation, fixed point with @c UCAL_CLK_DRIFT_BITS fraction bits
+} ucal_ClkSegT;
+
+/// @brief a piecewise-linear map from a monotonic clock to UTC
+///
+/// The segments are stored in a caller-supplied array.
+typedef struct {
+    ucal_ClkSegT *seg;      ///< segments, ascending by monotonic time
+    size_t        nseg;     ///< number of segments in use
+    size_t        cap;      ///< capacity of the segment array
+} ucal_ClockMapT;
+
+/// @brief set up an empty clock map
+/// @param map      clock map to set up
+/// @param buf      segment storage
+/// @param cap      number of segments @c buf can hold
+extern void ucal_ClockMapInit(ucal_ClockMapT *map, ucal_ClkSegT *buf, size_t cap);
+
+/// @brief add an anchor pair to a clock map
+///
+/// Anchors must be added in ascending order of the monotonic time; each one closes the segment
+/// started by the previous anchor.  The rate of that segment is fitted to hit both anchors.  If
+/// the rate deviates by 1/512 or more (the real time clock was stepped), the segment keeps the
+/// rate of its predecessor and the step happens at the new anchor.  The last segment and the
+/// time before the first anchor are extrapolated with the nearest rate.
+///
+/// @note Sets @c errno to @c EINVAL if the monotonic time does not ascend and to @c ERANGE if
+///       the map is full.
+///
+/// @param map      clock map to update
+/// @param mono     monotonic time, nanoseconds
+/// @param real     UTC at the same instant, nanoseconds in UNIX scale
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_ClockMapAddAnchor(ucal_ClockMapT *map, int64_t mono, int64_t real);
+
+/// @brief map a monotonic time stamp to UTC
+///
+/// A map without anchors is the identity.
+///
+/// @param map      clock map to use
+/// @param mono     monotonic time, nanoseconds
+/// @return         UTC in nanoseconds, UNIX scale
+extern int64_t ucal_ClockMapToReal(ucal_ClockMapT const *map, int64_t mono);
+
+/// @brief map an array of monotonic time stamps to UTC
+///
+/// Like @c ucal_ClockMapToReal() for every element; @c real and @c mono may be the same array.
+/// The input should be mostly ascending, as a trace is; the segment is only searched when a
+/// time stamp leaves the current one.
+///
+/// @param map      clock map to use
+/// @param real     where to store the results; @c count elements
+/// @param mono     monotonic time stamps
+/// @param count    number of elements
+extern void ucal_ClockMapConvert(ucal_ClockMapT const *map, int64_t *real, int64_t const *mono,
+                                 size_t count);
+
+/// @brief split a nanosecond time stamp into civil date and time
+///
+/// This does the work of @c ucal_TimeToRdn(), @c ucal_RdnToDateGD() and
+/// @c ucal_DayTimeSplit() in one step.
+///
+/// @param date     where to store the date
+/// @param time     where to store the time of day
+/// @param nsec     where to store the nanoseconds; can be @c NULL
+/// @param ns       nanoseconds in UNIX scale
+extern void ucal_NsToCivilGD(ucal_CivilDateT *date, ucal_CivilTimeT *time, uint32_t *nsec,
+                             int64_t ns);
+
+/// @brief split an array of nanosecond time stamps into civil date and time
+///
+/// Like @c ucal_NsToCivilGD() for every element.  The date of the last day seen is kept, so
+/// the calendar work is done once per day for ordered input.
+///
+/// @param date     where to store the dates; @c count elements
+/// @param time     where to store the times of day; @c count elements
+/// @param nsec     where to store the nanoseconds; @c count elements or @c NULL
+/// @param ns       nanoseconds in UNIX scale
+/// @param count    number of elements
+extern void ucal_NsToCivilArrayGD(ucal_CivilDateT *date, ucal_CivilTimeT *time, uint32_t *nsec,
+                                  int64_t const *ns, size_t count);
+
+CDECL_END
+#endif /*CLOCKMAP_H_D2078C60_0B6B_439F_B110_087913F54042*/
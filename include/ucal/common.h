@@ -123,6 +123,12 @@ static inline int64_t ucal_i64Asr(int64_t v, unsigned s) {
 // We have some tuple-like types, mainly to represent the result of split (division)
 // operations.
 
+/// @brief nanoseconds, as time stamp in UNIX scale or as time span
+///
+/// 64 bits cover about 292 years on either side of 1970, which is all a time stamp pipeline
+/// usually needs; the calendar functions take RDNs for anything further out.
+typedef int64_t ucal_ns_t;
+
 /// @brief result of splitting a @c time_t value by an @c uint32_t divider
 typedef struct {
     time_t   q; ///< quotient (integer part)
@@ -154,7 +160,10 @@ typedef struct {
 static inline ucal_iu32DivT ucal_iu32Div(int32_t n, uint32_t d) {
     uint32_t m = -(n < 0);
     uint32_t q = m ^ ((m ^ (uint32_t)n) / d);
-    return (ucal_iu32DivT){ .q = ucal_u32_i32(q), .r = (uint32_t)n - q * d };
+    ucal_iu32DivT qr;
+    qr.q = ucal_u32_i32(q);
+    qr.r = (uint32_t)n - q * d;
+    return qr;
 }
 
 /// @brief calculate (a - b) / d under floor division rules
@@ -166,7 +175,10 @@ static inline ucal_iu32DivT ucal_iu32SubDiv(int32_t a, int32_t b, uint32_t d) {
     uint32_t m = -(a < b);
     uint32_t n = (uint32_t)a - (uint32_t)b;
     uint32_t q = m ^ ((m ^ n) / d);
-    return (ucal_iu32DivT){ .q = ucal_u32_i32(q), .r = n - q * d };
+    ucal_iu32DivT qr;
+    qr.q = ucal_u32_i32(q);
+    qr.r = n - q * d;
+    return qr;
 }
 
 // -------------------------------------------------------------------------------------
@@ -260,6 +272,12 @@ typedef struct {
     int8_t dWDay;   ///< day of week, [1..7], 1==Monday
 } ucal_WeekDateT;
 
+/// @brief an ISO8601 ordinal date
+typedef struct {
+    int16_t dYear;  ///< calendar year
+    int16_t dYDay;  ///< day of year, [1..366]
+} ucal_OrdinalDateT;
+
 /// @brief civil 24-h time
 typedef struct {
     int8_t tHour;     ///< hour in 24-h clock
@@ -342,6 +360,47 @@ extern ucal_TimeDivT ucal_TimeToDays(time_t tt);
 /// @returns    tuple with the RataDie Number as quotient and seconds in day as remainder
 extern ucal_TimeDivT ucal_TimeToRdn(time_t tt);
 
+// -------------------------------------------------------------------------------------
+/// @brief split nanoseconds into full seconds and nanoseconds
+///
+/// A floor division by 10⁹.  64bit targets divide by the constant, which compilers turn into a
+/// multiplication; elsewhere the chained Granlund-Möller division does it with 32bit
+/// multiplications.  There is no hardware division either way.
+///
+/// @param  ns  nanoseconds to split
+/// @returns    tuple with seconds as quotient and nanoseconds as remainder
+extern ucal_i64u32DivT ucal_NsToSecs(ucal_ns_t ns);
+
+// -------------------------------------------------------------------------------------
+/// @brief split nanosecond time stamp into full RDN days and seconds since midnight
+///
+/// The nanosecond counterpart of ucal_TimeToRdn().
+/// @param  ns      nanoseconds in UNIX scale
+/// @param  nsec    where to store the nanoseconds in the second; can be @c NULL
+/// @returns        tuple with the RataDie Number as quotient and seconds in day as remainder
+extern ucal_TimeDivT ucal_NsToRdn(ucal_ns_t ns, uint32_t *nsec);
+
+/// @brief merge seconds and nanoseconds
+///
+/// No range check; @c tt must be within the range of @c ucal_ns_t.  The merge is done in
+/// unsigned arithmetic, so the lowest second of the range does not overflow on the way.
+/// @param  tt      seconds
+/// @param  nsec    nanoseconds, can be off-scale
+/// @returns        nanoseconds
+static inline ucal_ns_t ucal_TimeToNs(time_t tt, int32_t nsec) {
+    return ucal_u64_i64((uint64_t)tt * 1000000000u + (uint64_t)nsec);
+}
+
+/// @brief convert a @c timespec to nanoseconds
+/// @param  ts      time value; @c tv_nsec can be off-scale
+/// @returns        nanoseconds
+extern ucal_ns_t ucal_TimespecToNs(const struct timespec *ts);
+
+/// @brief convert nanoseconds to a normalised @c timespec
+/// @param  into    where to store the result
+/// @param  ns      nanoseconds
+extern void ucal_NsToTimespec(struct timespec *into, ucal_ns_t ns);
+
 // -------------------------------------------------------------------------------------
 /// @brief split elapsed days in year to elapsed months and elapsed days in month
 ///
@@ -0,0 +1,112 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the interface for financial day count conventions.
+// ----------------------------------------------------------------------------------------------
+#ifndef DAYCOUNT_H_D2078C60_0B6B_439F_B110_087913F54042
+#define DAYCOUNT_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+CDECL_BEG
+
+/// @brief day count conventions
+///
+/// The 30/360 variants follow the ISDA 2006 definitions, section 4.16; 30/360 US is the SIA
+/// rule set with the end-of-February adjustments.
+typedef enum {
+    ucal_DcAct360,          ///< ACT/360
+    ucal_DcAct365F,         ///< ACT/365 Fixed
+    ucal_DcActActISDA,      ///< ACT/ACT ISDA: days in leap years / 366 + other days / 365
+    ucal_Dc30_360,          ///< 30/360, Bond Basis, 4.16(f)
+    ucal_Dc30_360US,        ///< 30/360 US, with the end-of-February rules
+    ucal_Dc30E_360,         ///< 30E/360, Eurobond Basis, 4.16(g)
+    ucal_Dc30E_360ISDA,     ///< 30E/360 ISDA, 4.16(h), second date is not the maturity date
+    ucal_Dc30E_360ISDAMat   ///< 30E/360 ISDA, second date is the maturity date
+} ucal_DayCountT;
+
+/// @brief common denominator of ACT/ACT ISDA year fractions
+#define UCAL_DC_ACTACT_DEN (365 * 366)
+
+/// @brief an exact year fraction
+///
+/// The denominator only depends on the convention: 360, 365, @c UCAL_DC_ACTACT_DEN, or
+/// frequency times reference period for ACT/ACT ICMA.  Fractions of one convention can be
+/// added by their numerators.
+typedef struct {
+    int64_t num;    ///< numerator; negative if the second date is before the first
+    int64_t den;    ///< denominator, positive
+} ucal_YearFracT;
+
+/// @brief calculate the year fraction between two dates
+///
+/// @note Sets @c errno to @c EINVAL for an unknown convention.
+/// @param into     where to store the fraction
+/// @param dc       a @c ucal_DayCountT
+/// @param d1       start date (RDN)
+/// @param d2       end date (RDN)
+/// @return         @c true on success, @c false on error
+extern bool ucal_YearFrac(ucal_YearFracT *into, int dc, int32_t d1, int32_t d2);
+
+/// @brief calculate the ACT/ACT ICMA year fraction between two dates
+///
+/// The dates should be in the reference (coupon) period; a long stub has to be split by the
+/// caller into the notional periods it spans.
+///
+/// @note Sets @c errno to @c EINVAL if the period is empty or the frequency is zero.
+/// @param into     where to store the fraction
+/// @param d1       start date (RDN)
+/// @param d2       end date (RDN)
+/// @param ps       start of the reference period (RDN)
+/// @param pe       end of the reference period (RDN)
+/// @param freq     number of periods per year
+/// @return         @c true on success, @c false on error
+extern bool ucal_YearFracICMA(ucal_YearFracT *into, int32_t d1, int32_t d2, int32_t ps,
+                              int32_t pe, unsigned freq);
+
+/// @brief convert a year fraction to fixed point
+/// @param yf       fraction
+/// @return         years with 32 fraction bits, rounded to nearest
+extern int64_t ucal_YearFracQ32(ucal_YearFracT const *yf);
+
+/// @brief calculate the year fractions between pairs of dates
+/// @note Sets @c errno to @c EINVAL for an unknown convention.
+/// @param into     where to store the fractions; @c count elements
+/// @param dc       a @c ucal_DayCountT
+/// @param d1       start dates (RDN)
+/// @param d2       end dates (RDN)
+/// @param count    number of pairs
+/// @return         number of fractions calculated: @c count or zero
+extern size_t ucal_YearFracArray(ucal_YearFracT *into, int dc, int32_t const *d1,
+                                 int32_t const *d2, size_t count);
+
+/// @brief calculate the year fractions between pairs of dates in fixed point
+///
+/// Like ucal_YearFracArray() followed by ucal_YearFracQ32().
+/// @note Sets @c errno to @c EINVAL for an unknown convention.
+/// @param into     where to store the fractions; @c count elements
+/// @param dc       a @c ucal_DayCountT
+/// @param d1       start dates (RDN)
+/// @param d2       end dates (RDN)
+/// @param count    number of pairs
+/// @return         number of fractions calculated: @c count or zero
+extern size_t ucal_YearFracQ32Array(int64_t *into, int dc, int32_t const *d1,
+                                    int32_t const *d2, size_t count);
+
+CDECL_END
+#endif /*DAYCOUNT_H_D2078C60_0B6B_439F_B110_087913F54042*/
@@ -0,0 +1,184 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// ISO 8601 durations: parsing and calendar-correct application
+// ----------------------------------------------------------------------------------------------
+#ifndef DURATION_H_D2078C60_0B6B_439F_B110_087913F54042
+#define DURATION_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "common.h"
+#include "tzposix.h"
+
+CDECL_BEG
+
+/// @brief a parsed ISO 8601 duration
+///
+/// A duration has a nominal (calendar) part and an exact part.  Years and months are folded
+/// into months, weeks into days; hours, minutes and seconds are folded into seconds plus a
+/// binary fraction.  A negative duration has all its components negated; the fraction is
+/// always positive, so @c secs is the floor of the exact part.
+typedef struct {
+    int32_t  months;    ///< nominal months (years * 12 + months)
+    int32_t  days;      ///< nominal days (weeks * 7 + days)
+    int64_t  secs;      ///< exact seconds (hours * 3600 + minutes * 60 + seconds)
+    uint32_t frac;      ///< fraction of a second, Q0.32
+} ucal_DurationT;
+
+/// @brief check if a duration has a nominal (calendar) part
+/// @param dur  duration to check
+/// @return     @c true if months or days are not zero
+static inline bool ucal_DurationIsNominal(ucal_DurationT const *dur) {
+    return (0 != dur->months) || (0 != dur->days);
+}
+
+/// @brief negate a duration
+/// @param dur  duration to negate in place
+extern void ucal_DurationNegate(ucal_DurationT *dur);
+
+/// @brief decode an ISO 8601 duration
+///
+/// Accepts @c PnYnMnWnDTnHnMnS, where any component can be omitted (but not all), the @c T
+/// must be followed by a time component, and an optional leading sign negates the whole
+/// duration.  Weeks may be mixed with other components, as ISO 8601-2 permits.  The last
+/// component may have a decimal fraction (with dot or comma) if it is an hour, minute or
+/// second; fractions of the nominal units are rejected, since their length depends on where
+/// they are applied.
+///
+/// @note Sets @c errno to @c EINVAL on syntax errors and @c ERANGE if a component overflows.
+///
+/// @param into     where to store the duration
+/// @param pstr     pointer to current parse position
+/// @param end      end of parse region; can be @c NULL to stop at @c NUL byte
+/// @return         @c true on success, @c false on error
+extern bool ucal_decDuration(ucal_DurationT *into, const char **pstr, const char *end);
+
+/// @brief apply a duration to a day
+///
+/// The months are added first; if the day of the month does not exist in the target month, it
+/// is clamped to the last day of that month (Jan 31 plus one month is Feb 28 or 29).  Then the
+/// days are added.  The exact part must be zero.
+///
+/// @note Sets @c errno to @c EINVAL if the duration has an exact part, and to @c ERANGE if the
+///       result is out of range.
+///
+/// @param into     where to store the resulting RDN
+/// @param rdn      start day
+/// @param dur      duration to apply
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_DurationAddRdn(int32_t *into, int32_t rdn, ucal_DurationT const *dur);
+
+/// @brief apply a duration to a UTC time stamp
+///
+/// The nominal part is applied to the date as by @c ucal_DurationAddRdn() keeping the time of
+/// day, then the exact seconds are added.  The fraction is dropped (rounded toward the past).
+///
+/// @note Sets @c errno to @c ERANGE if the result is out of range.
+///
+/// @param into     where to store the result
+/// @param tt       start time
+/// @param dur      duration to apply
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_DurationAddTime(time_t *into, time_t tt, ucal_DurationT const *dur);
+
+/// @brief apply a duration to a time stamp in a time zone
+///
+/// The nominal part is applied to the @e local date, keeping the local time of day, so one day
+/// after noon is noon again, even over a DST transition.  If the local result falls into a
+/// transition gap or overlap, @c hint selects the zone; @c tziCvtHint_HrA moves times in the
+/// gap forward and takes the first of two ambiguous times, like RFC 5545 does.  The exact part
+/// is added after that, in UTC, so @c PT24H is always 86400 seconds.
+///
+/// @note Sets @c errno to @c EINVAL for @c NULL arguments or an ambiguous result with
+///       @c tziCvtHint_None, and @c ERANGE if the result is out of range.
+///
+/// @param into     where to store the result (UTC, UNIX scale)
+/// @param ctx      conversion context to use/update
+/// @param tsfrom   start time (UTC, UNIX scale)
+/// @param dur      duration to apply
+/// @param hint     how to resolve a local result in a gap or overlap
+/// @return         @c true on success, @c false otherwise
+extern bool tziDurationAdd(int64_t *into, tziConvCtxT *ctx, int64_t tsfrom,
+                           ucal_DurationT const *dur, tziCvtHintT hint);
+
+/// @brief apply a duration to an array of days
+///
+/// Like @c ucal_DurationAddRdn() for every element; @c into and @c rdn may be the same array.
+///
+/// @param into     where to store the results; @c count elements
+/// @param rdn      start days
+/// @param count    number of elements
+/// @param dur      duration to apply
+/// @return         number of elements converted; less than @c count on error
+extern size_t ucal_DurationAddRdnBatch(int32_t *into, int32_t const *rdn, size_t count,
+                                       ucal_DurationT const *dur);
+
+/// @brief apply a duration to an array of UTC time stamps
+///
+/// Like @c ucal_DurationAddTime() for every element; @c into and @c tt may be the same array.
+/// Durations without months reduce to a plain addition.
+///
+/// @param into     where to store the results; @c count elements
+/// @param tt       start times
+/// @param count    number of elements
+/// @param dur      duration to apply
+/// @return         number of elements converted; less than @c count on error
+extern size_t ucal_DurationAddTimeBatch(time_t *into, time_t const *tt, size_t count,
+                                        ucal_DurationT const *dur);
+
+/// @brief apply a duration to an array of time stamps in a time zone
+///
+/// Like @c tziDurationAdd() for every element; @c into and @c tsfrom may be the same array.
+///
+/// @param into     where to store the results; @c count elements
+/// @param ctx      conversion context to use/update
+/// @param tsfrom   start times
+/// @param count    number of elements
+/// @param dur      duration to apply
+/// @param hint     how to resolve a local result in a gap or overlap
+/// @return         number of elements converted; less than @c count on error
+extern size_t tziDurationAddBatch(int64_t *into, tziConvCtxT *ctx, int64_t const *tsfrom,
+                                  size_t count, ucal_DurationT const *dur, tziCvtHintT hint);
+
+/// @brief apply a duration to a UTC time stamp in nanoseconds
+///
+/// Like @c ucal_DurationAddTime(), but the fraction is kept, rounded to nanoseconds.
+///
+/// @note Sets @c errno to @c ERANGE if the result is out of range.
+///
+/// @param into     where to store the result
+/// @param ns       start time, nanoseconds in UNIX scale
+/// @param dur      duration to apply
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_DurationAddNs(ucal_ns_t *into, ucal_ns_t ns, ucal_DurationT const *dur);
+
+/// @brief apply a duration to an array of UTC time stamps in nanoseconds
+///
+/// Like @c ucal_DurationAddNs() for every element; @c into and @c ns may be the same array.
+/// The shift is constant over a UTC day, so only the first time stamp of a day needs a split.
+///
+/// @param into     where to store the results; @c count elements
+/// @param ns       start times
+/// @param count    number of elements
+/// @param dur      duration to apply
+/// @return         number of elements converted; less than @c count on error
+extern size_t ucal_DurationAddNsBatch(ucal_ns_t *into, ucal_ns_t const *ns, size_t count,
+                                      ucal_DurationT const *dur);
+
+CDECL_END
+#endif /*DURATION_H_D2078C60_0B6B_439F_B110_087913F54042*/
@@ -0,0 +1,136 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the interface for 52/53-week fiscal (retail) calendars.
+// ----------------------------------------------------------------------------------------------
+#ifndef FISCAL_H_D2078C60_0B6B_439F_B110_087913F54042
+#define FISCAL_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+CDECL_BEG
+
+/// @brief how the first day of a fiscal year is found from the anchor date
+typedef enum {
+    ucal_FiscalNearest, ///< anchor weekday nearest to the anchor date
+    ucal_FiscalLast,    ///< last anchor weekday on or before the anchor date
+    ucal_FiscalFirst    ///< first anchor weekday on or after the anchor date
+} ucal_FiscalRuleT;
+
+/// @brief a 52/53-week fiscal calendar
+///
+/// A fiscal year starts on the anchor weekday found by the rule from the anchor date in the
+/// calendar year @c fiscal_year-yearOffs, and runs up to the start of the next one.  The
+/// weeks of a year are grouped into periods; the 53rd week of a long year is appended to the
+/// leap period.  Rules are usually stated by the last day of the year; "ends on the Saturday
+/// nearest Jan,31" is the same as "starts on the Sunday nearest Feb,1".  The ISO8601 week
+/// calendar is "starts on the Monday nearest Jan,1".
+///
+/// The caller sets the configuration part and calls ucal_FiscalInit(), which checks it and
+/// fills in the lookup tables.
+typedef struct {
+    // configuration
+    int8_t  aMonth;         ///< month of the anchor date, [1..12]
+    int8_t  aMDay;          ///< day of the anchor date, [1..31]; Feb,29 is not possible
+    int8_t  aWDay;          ///< weekday of the first day of a fiscal year, [1..7], 1==Monday
+    int8_t  rule;           ///< a @c ucal_FiscalRuleT
+    int8_t  yearOffs;       ///< fiscal year minus calendar year of its anchor date
+    int8_t  nPeriods;       ///< number of periods in a year, [1..13]
+    int8_t  leapPeriod;     ///< period that gets the 53rd week, [1..nPeriods]
+    uint8_t pWeeks[13];     ///< weeks in the periods of a 52-week year; must add up to 52
+    // derived by ucal_FiscalInit()
+    int16_t aYDay;          ///< day of year (zero based) of the anchor date in a regular year
+    uint8_t pStart[2][14];  ///< first week (zero based) of the periods, 52 and 53-week years
+    uint8_t wPeriod[2][53]; ///< period (zero based) of the weeks, 52 and 53-week years
+} ucal_FiscalCalT;
+
+/// @brief a date in a fiscal calendar
+typedef struct {
+    int16_t dYear;      ///< fiscal year
+    int16_t dYDay;      ///< day in fiscal year, [1..371]
+    int8_t  dWeek;      ///< week in fiscal year, [1..53]
+    int8_t  dPeriod;    ///< period in fiscal year, [1..13]
+    int8_t  dPWeek;     ///< week in period
+    int8_t  dWDay;      ///< day in week, [1..7]; 1 is the anchor weekday
+} ucal_FiscalDateT;
+
+/// @brief check a fiscal calendar configuration and set up its tables
+///
+/// Typical period patterns are 4-4-5, 4-5-4 or 5-4-4 repeated for the four quarters, or 13
+/// periods of 4 weeks.
+///
+/// @note Sets @c errno to @c EINVAL if the configuration is invalid.
+/// @param cal      calendar with the configuration part set
+/// @return         @c true on success, @c false on error
+extern bool ucal_FiscalInit(ucal_FiscalCalT *cal);
+
+/// @brief calculate RDN of the first day of a fiscal year
+/// @param cal      fiscal calendar
+/// @param y        fiscal year
+/// @return         RDN of the first day of the year
+extern int32_t ucal_YearStartFC(ucal_FiscalCalT const *cal, int16_t y);
+
+/// @brief get the number of weeks in a fiscal year
+/// @param cal      fiscal calendar
+/// @param y        fiscal year
+/// @return         52 or 53
+extern int ucal_YearWeeksFC(ucal_FiscalCalT const *cal, int16_t y);
+
+/// @brief merge the components of a fiscal date to a RataDie Number
+///
+/// Periods outside [1,nPeriods] wrap into the neighbouring years.
+/// @param cal      fiscal calendar
+/// @param y        fiscal year
+/// @param p        period, [1,nPeriods] (can be off-range)
+/// @param w        week in period (can be off-range)
+/// @param d        day in week, [1,7] (can be off-range)
+/// @return         RDN of the date
+extern int32_t ucal_DateToRdnFC(ucal_FiscalCalT const *cal, int16_t y, int16_t p, int16_t w,
+                                int16_t d);
+
+/// @brief convert RataDie Number to date in a fiscal calendar
+///
+/// This function fails if the resulting year is out of the range that can be stored in the date
+/// buffer.
+/// @param into     destination
+/// @param cal      fiscal calendar
+/// @param rdn      source day number
+/// @return         @c true if successful, @c false if truncated
+extern bool ucal_RdnToDateFC(ucal_FiscalDateT *into, ucal_FiscalCalT const *cal, int32_t rdn);
+
+/// @brief convert RataDie Numbers to fiscal dates
+/// @param into     destination; @c count elements
+/// @param cal      fiscal calendar
+/// @param rdn      source day numbers
+/// @param count    number of elements
+/// @return         number of elements converted; less than @c count on error
+extern size_t ucal_RdnToDateFCArray(ucal_FiscalDateT *into, ucal_FiscalCalT const *cal,
+                                    int32_t const *rdn, size_t count);
+
+/// @brief convert fiscal dates to RataDie Numbers
+///
+/// Uses year, period, week in period and day in week of the dates, like ucal_DateToRdnFC().
+/// @param into     destination; @c count elements
+/// @param cal      fiscal calendar
+/// @param fd       source dates
+/// @param count    number of elements
+extern void ucal_DateToRdnFCArray(int32_t *into, ucal_FiscalCalT const *cal,
+                                  ucal_FiscalDateT const *fd, size_t count);
+
+CDECL_END
+#endif /*FISCAL_H_D2078C60_0B6B_439F_B110_087913F54042*/
@@ -35,6 +35,13 @@ typedef struct {
 /// @return         time stamp as raw GPS time
 extern ucal_GpsRawTimeT ucal_GpsMapTime(time_t tt, int16_t ls);
 
+/// @brief convert nanoseconds to a raw GPS time
+/// @param ns       system time, nanoseconds in UNIX scale
+/// @param ls       leap second correction to apply
+/// @param nsec     where to store the nanoseconds in the second; can be @c NULL
+/// @return         time stamp as raw GPS time
+extern ucal_GpsRawTimeT ucal_GpsMapNs(ucal_ns_t ns, int16_t ls, uint32_t *nsec);
+
 /// @brief map a raw GPS time stamp into the RataDie time scale
 /// @param w        GPS week, [0..1023]
 /// @param t        GPS time in week, [0..604799]
@@ -54,6 +61,18 @@ extern ucal_iu32DivT ucal_GpsMapRaw1(uint16_t w, uint32_t t, int16_t ls, int32_t
 /// @return
 extern time_t ucal_GpsMapRaw2(uint16_t w, uint32_t t, int16_t ls, const time_t *base);
 
+/// @brief map a raw GPS time stamp into nanoseconds in UNIX scale
+///
+/// Like ucal_GpsMapRaw2(), for time stamps with a fraction of the second.
+/// @param w        GPS week, [0..1023]
+/// @param t        GPS time in week, [0..604799]
+/// @param nsec     nanoseconds in the second
+/// @param ls       GPS leap second difference to UTC
+/// @param base     pointer to base time, nanoseconds in UNIX scale (can be NULL)
+/// @return         nanoseconds in UNIX scale
+extern ucal_ns_t ucal_GpsMapRaw2Ns(uint16_t w, uint32_t t, uint32_t nsec, int16_t ls,
+                                   const ucal_ns_t *base);
+
 /// @brief remap a RataDie number to a base date
 ///
 /// This maps a GNSS day (as RataDie number) to an 1024 week period starting at @c baseRdn.
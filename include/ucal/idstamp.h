@@ -0,0 +1,127 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the interface for time stamps embedded in time-ordered identifiers.
+// ----------------------------------------------------------------------------------------------
+#ifndef IDSTAMP_H_D2078C60_0B6B_439F_B110_087913F54042
+#define IDSTAMP_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+CDECL_BEG
+
+/// @brief Snowflake epoch of Twitter/X, ms in UNIX scale
+#define UCAL_SNOWFLAKE_TWITTER INT64_C(1288834974657)
+/// @brief Snowflake epoch of Discord, ms in UNIX scale
+#define UCAL_SNOWFLAKE_DISCORD INT64_C(1420070400000)
+
+/// @brief kinds of time-ordered identifiers
+///
+/// | kind      | binary                  | text                       | time stamp            |
+/// |-----------|-------------------------|----------------------------|-----------------------|
+/// | UUID      | 16 bytes                | 36 or 32 hex digits        | see below             |
+/// | ULID      | 16 bytes                | 26 Crockford base32 digits | 48 bit ms since 1970  |
+/// | ObjectId  | 12 bytes                | 24 hex digits              | 32 bit s since 1970   |
+/// | Snowflake | @c uint64_t, host order | decimal                    | ms since @c epoch     |
+///
+/// UUIDs of version 1 and 6 hold 60 bits of 100ns ticks since 1582-10-15, version 7 has 48 bits
+/// of ms since 1970.  Other versions have no time stamp.
+typedef enum {
+    ucal_IdUUID,        ///< UUID version 1, 6 or 7; the version is taken from each ID
+    ucal_IdULID,        ///< ULID
+    ucal_IdObjectId,    ///< MongoDB ObjectId
+    ucal_IdSnowflake    ///< Snowflake ID
+} ucal_IdKindT;
+
+/// @brief format of an identifier column
+typedef struct {
+    uint8_t kind;   ///< a @c ucal_IdKindT
+    uint8_t shift;  ///< Snowflake: bits below the time stamp, 22 for the usual layout
+    int64_t epoch;  ///< Snowflake: epoch in ms, UNIX scale
+} ucal_IdFormatT;
+
+/// @brief extract the time stamp of a binary identifier
+///
+/// @note Sets @c errno to @c EINVAL for UUID versions without time stamp and to @c ERANGE if
+///       the time is not representable in nanoseconds.
+/// @param into     where to store the time, nanoseconds in UNIX scale
+/// @param fmt      identifier format
+/// @param id       identifier bytes, as described for @c ucal_IdKindT
+/// @return         @c true on success, @c false on error
+extern bool ucal_IdToNs(int64_t *into, ucal_IdFormatT const *fmt, const uint8_t *id);
+
+/// @brief extract the time stamps of an array of binary identifiers
+/// @param into     where to store the times, nanoseconds in UNIX scale; @c count elements
+/// @param fmt      identifier format
+/// @param ids      identifiers
+/// @param stride   distance between two identifiers in bytes
+/// @param count    number of identifiers
+/// @return         number of identifiers converted; less than @c count on error
+extern size_t ucal_IdToNsArray(int64_t *into, ucal_IdFormatT const *fmt, const uint8_t *ids,
+                               size_t stride, size_t count);
+
+/// @brief extract the time stamps of an array of identifiers in text form
+///
+/// The fields have a fixed width of @c stride characters; only the digits that carry the time
+/// stamp are read.  UUIDs can be written with or without hyphens, hex digits in either case.
+/// Crockford base32 is read without regard to case, with @c I and @c L taken as @c 1 and @c O
+/// as @c 0.  A Snowflake field ends at the first character that is not a decimal digit.
+///
+/// @note Sets @c errno to @c EINVAL on a bad character or UUID version and to @c ERANGE if a
+///       time is not representable.
+/// @param into     where to store the times, nanoseconds in UNIX scale; @c count elements
+/// @param fmt      identifier format
+/// @param text     identifiers
+/// @param stride   distance between two identifiers in characters
+/// @param count    number of identifiers
+/// @return         number of identifiers converted; less than @c count on error
+extern size_t ucal_decIdArray(int64_t *into, ucal_IdFormatT const *fmt, const char *text,
+                              size_t stride, size_t count);
+
+/// @brief extract the civil dates and times of an array of binary identifiers
+///
+/// Like ucal_IdToNsArray() followed by ucal_NsToCivilArrayGD(), in blocks that stay in cache.
+/// @param date     where to store the dates; @c count elements
+/// @param time     where to store the times of day; @c count elements
+/// @param nsec     where to store the nanoseconds; @c count elements or @c NULL
+/// @param fmt      identifier format
+/// @param ids      identifiers
+/// @param stride   distance between two identifiers in bytes
+/// @param count    number of identifiers
+/// @return         number of identifiers converted; less than @c count on error
+extern size_t ucal_IdToCivilArray(ucal_CivilDateT *date, ucal_CivilTimeT *time, uint32_t *nsec,
+                                  ucal_IdFormatT const *fmt, const uint8_t *ids, size_t stride,
+                                  size_t count);
+
+/// @brief extract the civil dates and times of an array of identifiers in text form
+///
+/// Like ucal_decIdArray() followed by ucal_NsToCivilArrayGD(), in blocks that stay in cache.
+/// @param date     where to store the dates; @c count elements
+/// @param time     where to store the times of day; @c count elements
+/// @param nsec     where to store the nanoseconds; @c count elements or @c NULL
+/// @param fmt      identifier format
+/// @param text     identifiers
+/// @param stride   distance between two identifiers in characters
+/// @param count    number of identifiers
+/// @return         number of identifiers converted; less than @c count on error
+extern size_t ucal_decIdCivilArray(ucal_CivilDateT *date, ucal_CivilTimeT *time, uint32_t *nsec,
+                                   ucal_IdFormatT const *fmt, const char *text, size_t stride,
+                                   size_t count);
+
+CDECL_END
+#endif /*IDSTAMP_H_D2078C60_0B6B_439F_B110_087913F54042*/
@@ -39,5 +39,20 @@ static inline uint32_t ucal_TimeToNtp(time_t tt) {
 /// @return      seconds mapped to UNIX time scale
 extern time_t ucal_NtpToTime(uint32_t secs, const time_t* pivot);
 
+/// @brief map a NTP time stamp into nanoseconds in UNIX scale
+///
+/// Like ucal_NtpToTime(), with the Q0.32 fraction of the NTP time stamp rounded to nanoseconds.
+/// @param secs  seconds in NTP time scale with undefined era
+/// @param frac  fraction of the second
+/// @param pivot center time for expansion, nanoseconds in UNIX scale; can be NULL
+/// @return      nanoseconds in UNIX time scale
+extern ucal_ns_t ucal_NtpToNs(uint32_t secs, uint32_t frac, const ucal_ns_t *pivot);
+
+/// @brief map nanoseconds in UNIX scale into the NTP time scale
+/// @param frac  where to store the fraction of the second, Q0.32; can be NULL
+/// @param ns    input time
+/// @return      seconds in NTP time scale
+extern uint32_t ucal_NsToNtp(uint32_t *frac, ucal_ns_t ns);
+
 CDECL_END
 #endif /*NTPDATE_H_D2078C60_0B6B_439F_B110_087913F54042*/
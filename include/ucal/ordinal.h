@@ -0,0 +1,125 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the interface for ISO8601 ordinal dates (year and day-of-year).
+// ----------------------------------------------------------------------------------------------
+#ifndef ORDINAL_H_D2078C60_0B6B_439F_B110_087913F54042
+#define ORDINAL_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+CDECL_BEG
+
+/// @brief Merge the components of an ordinal date to a RataDie Number
+/// @param y    calendar year
+/// @param yd   day of year, [1,366] (can be off-range)
+/// @return     RDN of the date
+extern int32_t ucal_DateToRdnOD(int16_t y, int16_t yd);
+
+/// @brief convert RataDie Number to ordinal date
+///
+/// This function fails if the resulting year is out of the range that can be stored in the date
+/// buffer.
+/// @param into destination
+/// @param rdn  source day number
+/// @return     @c true if successful, @c false if truncated
+extern bool ucal_RdnToDateOD(ucal_OrdinalDateT *into, int32_t rdn);
+
+/// @brief convert an ordinal date to a civil date
+///
+/// @note Sets @c errno to @c EINVAL if the day of year does not exist in the year.
+/// @param into destination
+/// @param od   ordinal date
+/// @return     @c true if successful, @c false if the date is invalid
+extern bool ucal_OrdinalToCivilGD(ucal_CivilDateT *into, ucal_OrdinalDateT const *od);
+
+/// @brief convert a civil date to an ordinal date
+///
+/// @note Sets @c errno to @c EINVAL if the date does not exist.
+/// @param into destination
+/// @param y    calendar year
+/// @param m    calendar month, [1,12]
+/// @param d    day of month, [1,31]
+/// @return     @c true if successful, @c false if the date is invalid
+extern bool ucal_CivilToOrdinalGD(ucal_OrdinalDateT *into, int16_t y, int16_t m, int16_t d);
+
+/// @brief decode an ordinal date in @c YYYYDDD or @c YYYY-DDD format
+///
+/// The form is taken from the 5th character. Exactly 7 or 8 characters are consumed on success.
+///
+/// @note Sets @c errno to @c EINVAL on syntax errors or a day that does not exist in the year.
+/// @param into     destination
+/// @param pstr     pointer to current parse position
+/// @param end      end of parse region; can be @c NULL to stop at @c NUL byte
+/// @return         @c true on success, @c false on error
+extern bool ucal_decOrdinal(ucal_OrdinalDateT *into, const char **pstr, const char *end);
+
+/// @brief encode an ordinal date in @c YYYYDDD or @c YYYY-DDD format
+///
+/// @note Sets @c errno to @c ERANGE if the year is not in [0,9999] or the buffer is too small,
+///       and to @c EINVAL if the day does not exist in the year.
+/// @param buf      destination buffer; gets a NUL terminated string
+/// @param size     size of the buffer, at least 8 (or 9 with @c hyphen)
+/// @param od       ordinal date to encode
+/// @param hyphen   @c true for the extended format with a hyphen
+/// @return         number of characters written (without NUL), zero on error
+extern size_t ucal_encOrdinal(char *buf, size_t size, ucal_OrdinalDateT const *od, bool hyphen);
+
+/// @brief convert RataDie Numbers to ordinal dates
+/// @param into     destination; @c count elements
+/// @param rdn      source day numbers
+/// @param count    number of elements
+/// @return         number of elements converted; less than @c count on error
+extern size_t ucal_RdnToDateODArray(ucal_OrdinalDateT *into, int32_t const *rdn, size_t count);
+
+/// @brief convert ordinal dates to RataDie Numbers
+/// @param into     destination; @c count elements
+/// @param od       source dates (day of year can be off-range)
+/// @param count    number of elements
+extern void ucal_DateToRdnODArray(int32_t *into, ucal_OrdinalDateT const *od, size_t count);
+
+/// @brief decode fixed-width ordinal date fields to RataDie Numbers
+///
+/// Field @c i starts at @c text+i*stride, and is in @c YYYYDDD or @c YYYY-DDD format; the
+/// format may change from field to field. Nothing beyond the date in a field is read.
+///
+/// @note Sets @c errno like @c ucal_decOrdinal().
+/// @param into     destination; @c count elements
+/// @param text     start of the first field
+/// @param stride   distance of the fields in bytes
+/// @param count    number of fields
+/// @return         number of fields decoded; less than @c count on error
+extern size_t ucal_decOrdinalArray(int32_t *into, const char *text, size_t stride, size_t count);
+
+/// @brief encode RataDie Numbers as fixed-width ordinal date fields
+///
+/// Field @c i is written to @c text+i*stride, without NUL termination; the rest of a field is
+/// left untouched.
+///
+/// @note Sets @c errno to @c ERANGE if a year is not in [0,9999] or the stride is too small.
+/// @param text     start of the first field
+/// @param stride   distance of the fields in bytes, at least 7 (or 8 with @c hyphen)
+/// @param rdn      source day numbers
+/// @param count    number of elements
+/// @param hyphen   @c true for the extended format with a hyphen
+/// @return         number of fields encoded; less than @c count on error
+extern size_t ucal_encOrdinalArray(char *text, size_t stride, int32_t const *rdn, size_t count,
+                                   bool hyphen);
+
+CDECL_END
+#endif /*ORDINAL_H_D2078C60_0B6B_439F_B110_087913F54042*/
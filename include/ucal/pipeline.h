@@ -0,0 +1,179 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// Threaded decode -> convert -> format pipeline (optional, needs POSIX threads)
+// ----------------------------------------------------------------------------------------------
+#ifndef PIPELINE_H_D2078C60_0B6B_439F_B110_087913F54042
+#define PIPELINE_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "common.h"
+#include "tzposix.h"
+
+CDECL_BEG
+
+/// @brief number of pipeline stages: decode, convert, split, format
+#define UCAL_PIPE_STAGES 4
+
+/// @brief maximum number of batches a ring between two threads can hold
+#define UCAL_PIPE_RING 16
+
+/// @brief size of a formatted time stamp, including the terminating NUL
+///
+/// The format is @c YYYY-MM-DDThh:mm:ss[.nnnnnnnnn]+hh:mm
+#define UCAL_PIPE_TXTLEN 40
+
+/// @brief a batch of records, column-wise
+///
+/// The caller fills @c text, @c zoneId and @c count; the stages fill the other columns.  Use
+/// @c ucal_PipeBatchInit() to carve the columns from a single buffer.
+typedef struct ucal_PipeBatch_S {
+    size_t            count;    ///< number of records in the batch
+    size_t            capacity; ///< number of records the columns can hold
+    const char      **text;     ///< input: ASN.1 GeneralizedTime strings, NUL terminated
+    uint16_t         *zoneId;   ///< input: zone ids, indices into the context table
+    uint8_t          *status;   ///< record status: 0 or an @c errno value
+    int64_t          *tsUtc;    ///< decode: UTC seconds in UNIX scale
+    int32_t          *nsec;     ///< decode: nanoseconds
+    int32_t          *offs;     ///< convert: offset (local - UTC) in seconds
+    uint8_t          *flags;    ///< convert: @c tziFlag_XXX values
+    ucal_CivilDateT  *date;     ///< split: local civil date
+    ucal_CivilTimeT  *time;     ///< split: local civil time
+    char             *out;      ///< format: @c UCAL_PIPE_TXTLEN bytes per record
+    void             *scratch;  ///< convert: scratch for @c tziBatchUtc2LocalByZone()
+    void             *user;     ///< free for the caller
+} ucal_PipeBatchT;
+
+/// @brief single producer, single consumer ring of batches
+///
+/// The slots, @c head and @c tail are at least 64 bytes apart, so no two of them share a
+/// cache line, whatever the alignment of the ring.  The last pad keeps @c tail away from the
+/// slots of the next ring in an array.
+typedef struct {
+    ucal_PipeBatchT *slot[UCAL_PIPE_RING];
+    char             pad0[64];  ///< keeps @c head off the cache lines of @c slot
+    unsigned         head;      ///< next write position, owned by the producer
+    char             pad1[64];  ///< keeps @c head and @c tail apart
+    unsigned         tail;      ///< next read position, owned by the consumer
+    char             pad2[64];  ///< keeps @c tail off what follows the ring
+} ucal_PipeRingT;
+
+struct ucal_Pipe_S;
+
+/// @brief a stage thread; runs a contiguous range of the stages
+typedef struct {
+    struct ucal_Pipe_S *pipe;
+    pthread_t           thread;
+    unsigned            index;  ///< thread index, reads ring[index], writes ring[index+1]
+    unsigned            sbeg;   ///< first stage to run
+    unsigned            send;   ///< end of stage range
+} ucal_PipeWorkerT;
+
+/// @brief pipeline configuration
+typedef struct {
+    unsigned     nthreads;  ///< number of stage threads, 1..UCAL_PIPE_STAGES
+    unsigned     depth;     ///< batches in flight per ring, 1..UCAL_PIPE_RING
+    tziConvCtxT *ctxTab;    ///< conversion contexts, one per zone; owned by the pipeline
+    size_t       nzones;    ///< number of zones
+} ucal_PipeCfgT;
+
+/// @brief a running pipeline
+///
+/// All fields are internal.  The structure is owned by the caller; it must stay in place
+/// until @c ucal_PipeJoin() returns.
+typedef struct ucal_Pipe_S {
+    ucal_PipeRingT   ring[UCAL_PIPE_STAGES + 1]; ///< ring[0]: input, ring[nthreads]: output
+    ucal_PipeWorkerT worker[UCAL_PIPE_STAGES];
+    ucal_PipeCfgT    cfg;
+} ucal_PipeT;
+
+/// @brief get the buffer size needed for a batch
+/// @param capacity number of records
+/// @param nzones   number of zones
+/// @return         buffer size in bytes
+extern size_t ucal_PipeBatchMemSize(size_t capacity, size_t nzones);
+
+/// @brief set up a batch in a buffer
+/// @param batch    batch to set up
+/// @param mem      buffer of at least @c ucal_PipeBatchMemSize() bytes, aligned for @c int64_t
+/// @param capacity number of records
+/// @param nzones   number of zones
+extern void ucal_PipeBatchInit(ucal_PipeBatchT *batch, void *mem, size_t capacity,
+                               size_t nzones);
+
+/// @brief run all stages on a batch in the calling thread
+///
+/// This is what the pipeline does, without the threads.
+///
+/// @param batch    batch to process
+/// @param cfg      configuration (only the zones are used)
+extern void ucal_PipeProcess(ucal_PipeBatchT *batch, ucal_PipeCfgT const *cfg);
+
+/// @brief start a pipeline
+///
+/// The stages are distributed evenly over the threads, in order.  The threads wait for work by
+/// spinning shortly and then yielding the CPU.
+///
+/// @note Sets @c errno to @c EINVAL for a bad configuration, or returns the error of
+///       @c pthread_create() in @c errno.
+///
+/// @param pipe     pipeline to start
+/// @param cfg      configuration
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_PipeStart(ucal_PipeT *pipe, ucal_PipeCfgT const *cfg);
+
+/// @brief submit a batch to a pipeline
+///
+/// This blocks while the input ring is full (back-pressure).  The batch belongs to the
+/// pipeline until it is received again.
+///
+/// @note The rings can hold @c (nthreads+1)*depth batches.  Keep no more batches in flight, or
+///       receive between submits, otherwise the caller can block here forever while the
+///       output ring is full.
+///
+/// @param pipe     pipeline
+/// @param batch    batch to process
+extern void ucal_PipeSubmit(ucal_PipeT *pipe, ucal_PipeBatchT *batch);
+
+/// @brief try to receive a processed batch
+/// @param pipe     pipeline
+/// @param pbatch   where to store the batch; @c NULL after the end of input
+/// @return         @c true if a batch (or the end of input) was received
+extern bool ucal_PipeTryReceive(ucal_PipeT *pipe, ucal_PipeBatchT **pbatch);
+
+/// @brief receive a processed batch, in submission order
+///
+/// This blocks until a batch is available.
+///
+/// @param pipe     pipeline
+/// @return         the batch, or @c NULL after the end of input
+extern ucal_PipeBatchT* ucal_PipeReceive(ucal_PipeT *pipe);
+
+/// @brief signal the end of input
+///
+/// Once all batches are received, @c ucal_PipeReceive() returns @c NULL.
+///
+/// @param pipe     pipeline
+extern void ucal_PipeClose(ucal_PipeT *pipe);
+
+/// @brief wait for the threads of a closed pipeline to terminate
+/// @param pipe     pipeline
+extern void ucal_PipeJoin(ucal_PipeT *pipe);
+
+CDECL_END
+#endif /*PIPELINE_H_D2078C60_0B6B_439F_B110_087913F54042*/
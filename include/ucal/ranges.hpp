@@ -0,0 +1,503 @@
+// -*- mode: C++; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// C++20 range adaptors for conversion pipelines
+// ----------------------------------------------------------------------------------------------
+#ifndef RANGES_HPP_D2078C60_0B6B_439F_B110_087913F54042
+#define RANGES_HPP_D2078C60_0B6B_439F_B110_087913F54042
+
+/// @file
+/// C++20 range adaptors for conversion pipelines
+///
+/// Lazy views over the C core, for conversions of large spans without buffers in between:
+///
+///     for (ucal_WeekDateT wd : stamps | ucal::views::to_local(zone)
+///                                     | ucal::views::civil
+///                                     | ucal::views::iso_week) {
+///         ...
+///     }
+///
+/// Like the C functions they wrap, the views keep state from one element to the next: the
+/// conversion context of the zone, and the date of the previous element, which is stepped
+/// instead of calculated again when the next element is on the same or the following day.
+/// So the views are single pass (input) ranges, and @c begin() starts afresh.  Contiguous
+/// spans of @c int64_t go to @c tziBatchUtc2Local() in chunks of @c to_local_chunk elements.
+///
+/// The dates live in the iterators, so the compiler can keep them in registers.  The zone
+/// view holds the conversion context and the converted chunk, and its iterators point to it,
+/// so a @c to_local_view must not move while it is iterated.
+
+#if __cplusplus < 202002L
+# error "ranges.hpp needs C++20"
+#endif
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "calconst.h"
+#include "common.h"
+#include "gregorian.h"
+#include "isoweek.h"
+#include "tzposix.h"
+#include "tzbatch.h"
+
+namespace ucal {
+
+/// @brief a UTC time stamp with its local time offset
+struct local_time {
+    int64_t utc;    ///< UTC seconds in UNIX scale
+    int32_t offs;   ///< offset (local - UTC) in seconds
+    uint8_t flags;  ///< @c tziFlag_XXX values
+
+    /// @brief local seconds in UNIX scale
+    constexpr int64_t
+    local() const noexcept
+    {
+        return utc + offs;
+    }
+};
+
+/// @brief a civil date and time
+struct civil_time {
+    ucal_CivilDateT date;   ///< calendar date
+    ucal_CivilTimeT time;   ///< time of day
+    int32_t         rdn;    ///< RDN of @c date
+};
+
+/// @brief number of time stamps @c to_local_view hands to the batch kernel at once
+inline constexpr std::size_t to_local_chunk = 64;
+
+namespace detail {
+
+// local seconds of the inputs 'civil' takes
+constexpr int64_t
+local_seconds(local_time const &lt) noexcept
+{
+    return lt.local();
+}
+
+constexpr int64_t
+local_seconds(int64_t secs) noexcept
+{
+    return secs;
+}
+
+template <class T>
+concept local_input = requires(T const &t) { { local_seconds(t) } -> std::same_as<int64_t>; };
+
+// adaptor closures: 'r | x' is 'x(r)'
+template <class D>
+struct closure {
+    template <std::ranges::viewable_range R>
+        requires std::invocable<D const&, R>
+    friend constexpr auto
+    operator|(R &&r, D const &self)
+    {
+        return self(std::forward<R>(r));
+    }
+};
+
+// sentinel of the views: the sentinel of the base
+template <class S>
+struct sentinel {
+    S end;
+};
+
+} // namespace detail
+
+// -------------------------------------------------------------------------------------
+// UTC -> local time
+
+/// @brief view of UTC time stamps as @c local_time in a zone
+template <std::ranges::input_range V>
+    requires std::ranges::view<V> && std::convertible_to<std::ranges::range_reference_t<V>,
+                                                         int64_t>
+class to_local_view : public std::ranges::view_interface<to_local_view<V>> {
+    static constexpr bool batched = std::ranges::contiguous_range<V>
+                                 && std::ranges::sized_range<V>
+                                 && std::same_as<std::ranges::range_value_t<V>, int64_t>;
+
+    V             base_{};
+    tziPosixZoneT zone_{};
+    tziConvCtxT   ctx_{};
+    // results of the chunk converted last, for contiguous input
+    int32_t       offs_[batched ? to_local_chunk : 1];
+    uint8_t       flags_[batched ? to_local_chunk : 1];
+
+    // convert the chunk starting at 'head'; returns its length
+    std::size_t
+    fill(int64_t const *head)
+    {
+        auto const  left = std::to_address(std::ranges::begin(base_))
+                         + std::ranges::size(base_) - head;
+        std::size_t count = (left < (std::ptrdiff_t)to_local_chunk)
+                          ? static_cast<std::size_t>(left) : to_local_chunk;
+        tziBatchUtc2Local(offs_, flags_, &ctx_, head, count);
+        return count;
+    }
+
+public:
+    /// @brief iterator; the position in the current chunk is kept here
+    class iterator {
+        to_local_view              *parent_ = nullptr;
+        std::ranges::iterator_t<V>  cur_{};
+        mutable int64_t const      *head_  = nullptr;
+        mutable std::size_t         count_ = 0;
+
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type       = local_time;
+        using difference_type  = std::ranges::range_difference_t<V>;
+
+        iterator() = default;
+        iterator(to_local_view *parent, std::ranges::iterator_t<V> cur)
+            : parent_(parent), cur_(std::move(cur)) {}
+
+        local_time
+        operator*() const
+        {
+            if constexpr (batched) {
+                int64_t const *const p = std::to_address(cur_);
+                // no pointer arithmetic on a null head: the first access always fills
+                if ((head_ == nullptr) || (static_cast<std::size_t>(p - head_) >= count_)) {
+                    head_  = p;
+                    count_ = parent_->fill(p);
+                }
+                return { *p, parent_->offs_[p - head_], parent_->flags_[p - head_] };
+            } else {
+                int64_t const utc = static_cast<int64_t>(*cur_);
+                tziConvInfoT  ci;
+                tziGetInfoUtc2Local(&ci, &parent_->ctx_, utc);
+                return { utc, ci.offs, static_cast<uint8_t>((ci.isDst ? tziFlag_DST : 0)
+                                                            | (ci.isHrA ? tziFlag_HrA : 0)
+                                                            | (ci.isHrB ? tziFlag_HrB : 0)) };
+            }
+        }
+
+        iterator &operator++() { ++cur_; return *this; }
+        void      operator++(int) { ++cur_; }
+
+        friend bool
+        operator==(iterator const &it, detail::sentinel<std::ranges::sentinel_t<V>> const &s)
+        {
+            return it.cur_ == s.end;
+        }
+    };
+
+    to_local_view() requires std::default_initializable<V> = default;
+
+    /// @param base     UTC seconds in UNIX scale
+    /// @param zone     zone to convert to
+    constexpr to_local_view(V base, tziPosixZoneT const &zone)
+        : base_(std::move(base)), zone_(zone) {}
+
+    constexpr V base() const & requires std::copy_constructible<V> { return base_; }
+    constexpr V base() && { return std::move(base_); }
+
+    iterator
+    begin()
+    {
+        ctx_      = tziConvCtxT{};
+        ctx_.pTZI = &zone_;
+        return { this, std::ranges::begin(base_) };
+    }
+
+    detail::sentinel<std::ranges::sentinel_t<V>>
+    end()
+    {
+        return { std::ranges::end(base_) };
+    }
+
+    constexpr auto
+    size() requires std::ranges::sized_range<V>
+    {
+        return std::ranges::size(base_);
+    }
+};
+
+template <class R>
+to_local_view(R&&, tziPosixZoneT const&) -> to_local_view<std::views::all_t<R>>;
+
+// -------------------------------------------------------------------------------------
+// seconds -> civil date and time
+
+/// @brief view of local seconds (or @c local_time) as @c civil_time
+template <std::ranges::input_range V>
+    requires std::ranges::view<V> && detail::local_input<std::ranges::range_value_t<V>>
+class civil_view : public std::ranges::view_interface<civil_view<V>> {
+    V base_{};
+
+public:
+    /// @brief iterator; the date of the previous element is kept here
+    class iterator {
+        std::ranges::iterator_t<V> cur_{};
+        mutable ucal_CivilDateT    date_{};
+        mutable int32_t            rdn_   = 0;
+        mutable bool               valid_ = false;
+
+        // step the date to the next day without the calendar if we can; kept out of the
+        // dereference, so that stays small enough to be inlined
+        [[gnu::noinline]] void
+        seek(int32_t rdn) const
+        {
+            if (valid_ && (rdn == rdn_ + 1)
+                && (date_.dMDay < _ucal_mdtab[date_.fLeap != 0][date_.dMonth - 1])) {
+                date_.dMDay += 1;
+                date_.dYDay += 1;
+                date_.dWDay  = date_.dWDay % 7 + 1;
+            } else {
+                ucal_CivilDateT tmp{};
+                (void)ucal_RdnToDateGD(&tmp, rdn);
+                date_ = tmp;
+            }
+            rdn_   = rdn;
+            valid_ = true;
+        }
+
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type       = civil_time;
+        using difference_type  = std::ranges::range_difference_t<V>;
+
+        iterator() = default;
+        explicit iterator(std::ranges::iterator_t<V> cur) : cur_(std::move(cur)) {}
+
+        civil_time
+        operator*() const
+        {
+            int64_t const secs = detail::local_seconds(*cur_);
+            int64_t       days = secs / 86400;
+            int32_t       sod  = static_cast<int32_t>(secs % 86400);
+            if (sod < 0) {
+                sod  += 86400;
+                days -= 1;
+            }
+            int32_t const rdn = static_cast<int32_t>(days + UCAL_rdnUNIX);
+
+            if (!valid_ || (rdn != rdn_)) {
+                seek(rdn);
+            }
+            return { date_,
+                     { static_cast<int8_t>(sod / 3600), static_cast<int8_t>(sod / 60 % 60),
+                       static_cast<int8_t>(sod % 60) },
+                     rdn };
+        }
+
+        iterator &operator++() { ++cur_; return *this; }
+        void      operator++(int) { ++cur_; }
+
+        friend bool
+        operator==(iterator const &it, detail::sentinel<std::ranges::sentinel_t<V>> const &s)
+        {
+            return it.cur_ == s.end;
+        }
+    };
+
+    civil_view() requires std::default_initializable<V> = default;
+
+    /// @param base     local seconds in UNIX scale, or @c local_time
+    constexpr explicit civil_view(V base) : base_(std::move(base)) {}
+
+    constexpr V base() const & requires std::copy_constructible<V> { return base_; }
+    constexpr V base() && { return std::move(base_); }
+
+    iterator
+    begin()
+    {
+        return iterator(std::ranges::begin(base_));
+    }
+
+    detail::sentinel<std::ranges::sentinel_t<V>>
+    end()
+    {
+        return { std::ranges::end(base_) };
+    }
+
+    constexpr auto
+    size() requires std::ranges::sized_range<V>
+    {
+        return std::ranges::size(base_);
+    }
+};
+
+template <class R>
+civil_view(R&&) -> civil_view<std::views::all_t<R>>;
+
+// -------------------------------------------------------------------------------------
+// civil date -> ISO 8601 week date
+
+/// @brief view of @c civil_time as @c ucal_WeekDateT
+template <std::ranges::input_range V>
+    requires std::ranges::view<V>
+          && std::convertible_to<std::ranges::range_reference_t<V>, civil_time>
+class iso_week_view : public std::ranges::view_interface<iso_week_view<V>> {
+    V base_{};
+
+public:
+    /// @brief iterator; the week date of the previous element is kept here
+    class iterator {
+        std::ranges::iterator_t<V> cur_{};
+        mutable ucal_WeekDateT     week_{};
+        mutable int32_t            rdn_   = 0;
+        mutable bool               valid_ = false;
+
+        // Monday to Saturday step to the next day within the week
+        [[gnu::noinline]] void
+        seek(int32_t rdn) const
+        {
+            if (valid_ && (rdn == rdn_ + 1) && (week_.dWDay < 7)) {
+                week_.dWDay += 1;
+            } else {
+                ucal_WeekDateT tmp{};
+                (void)ucal_RdnToDateWD(&tmp, rdn);
+                week_ = tmp;
+            }
+            rdn_   = rdn;
+            valid_ = true;
+        }
+
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type       = ucal_WeekDateT;
+        using difference_type  = std::ranges::range_difference_t<V>;
+
+        iterator() = default;
+        explicit iterator(std::ranges::iterator_t<V> cur) : cur_(std::move(cur)) {}
+
+        ucal_WeekDateT
+        operator*() const
+        {
+            int32_t const rdn = static_cast<civil_time>(*cur_).rdn;
+
+            if (!valid_ || (rdn != rdn_)) {
+                seek(rdn);
+            }
+            return week_;
+        }
+
+        iterator &operator++() { ++cur_; return *this; }
+        void      operator++(int) { ++cur_; }
+
+        friend bool
+        operator==(iterator const &it, detail::sentinel<std::ranges::sentinel_t<V>> const &s)
+        {
+            return it.cur_ == s.end;
+        }
+    };
+
+    iso_week_view() requires std::default_initializable<V> = default;
+
+    /// @param base     civil dates and times
+    constexpr explicit iso_week_view(V base) : base_(std::move(base)) {}
+
+    constexpr V base() const & requires std::copy_constructible<V> { return base_; }
+    constexpr V base() && { return std::move(base_); }
+
+    iterator
+    begin()
+    {
+        return iterator(std::ranges::begin(base_));
+    }
+
+    detail::sentinel<std::ranges::sentinel_t<V>>
+    end()
+    {
+        return { std::ranges::end(base_) };
+    }
+
+    constexpr auto
+    size() requires std::ranges::sized_range<V>
+    {
+        return std::ranges::size(base_);
+    }
+};
+
+template <class R>
+iso_week_view(R&&) -> iso_week_view<std::views::all_t<R>>;
+
+// -------------------------------------------------------------------------------------
+// adaptor objects
+
+namespace views {
+
+namespace detail {
+
+struct to_local_bound : ucal::detail::closure<to_local_bound> {
+    tziPosixZoneT zone;
+
+    template <std::ranges::viewable_range R>
+    constexpr auto
+    operator()(R &&r) const
+    {
+        return to_local_view(std::forward<R>(r), zone);
+    }
+};
+
+struct to_local_fn {
+    template <std::ranges::viewable_range R>
+    constexpr auto
+    operator()(R &&r, tziPosixZoneT const &zone) const
+    {
+        return to_local_view(std::forward<R>(r), zone);
+    }
+
+    constexpr to_local_bound
+    operator()(tziPosixZoneT const &zone) const
+    {
+        to_local_bound b{};
+        b.zone = zone;
+        return b;
+    }
+};
+
+struct civil_fn : ucal::detail::closure<civil_fn> {
+    template <std::ranges::viewable_range R>
+    constexpr auto
+    operator()(R &&r) const
+    {
+        return civil_view(std::forward<R>(r));
+    }
+};
+
+struct iso_week_fn : ucal::detail::closure<iso_week_fn> {
+    template <std::ranges::viewable_range R>
+    constexpr auto
+    operator()(R &&r) const
+    {
+        return iso_week_view(std::forward<R>(r));
+    }
+};
+
+} // namespace detail
+
+/// @brief UTC seconds to @c local_time: @c r|to_local(zone) or @c to_local(r,zone)
+inline constexpr detail::to_local_fn to_local{};
+
+/// @brief local seconds or @c local_time to @c civil_time: @c r|civil or @c civil(r)
+inline constexpr detail::civil_fn civil{};
+
+/// @brief @c civil_time to ISO 8601 week dates: @c r|iso_week or @c iso_week(r)
+inline constexpr detail::iso_week_fn iso_week{};
+
+} // namespace views
+
+} // namespace ucal
+
+#endif /*RANGES_HPP_D2078C60_0B6B_439F_B110_087913F54042*/
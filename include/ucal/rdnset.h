@@ -0,0 +1,169 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the interface for compressed sets of days.
+// ----------------------------------------------------------------------------------------------
+#ifndef RDNSET_H_D2078C60_0B6B_439F_B110_087913F54042
+#define RDNSET_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+CDECL_BEG
+
+/// @brief maximum number of runs in a run container
+#define UCAL_RDNSET_NRUN 12
+
+/// @brief container kinds
+typedef enum {
+    ucal_RdnSetBits,    ///< bitmap, bit @c d for day @c d of the year
+    ucal_RdnSetRuns     ///< sorted, disjoint runs of days @c [lo,hi[ in the year
+} ucal_RdnSetKindT;
+
+/// @brief the days of one calendar year in a set
+///
+/// A container takes the form that needs fewer words to process: runs if there are at most
+/// @c UCAL_RDNSET_NRUN of them, a bitmap otherwise.  Both share a 48-byte union after a
+/// 16-byte header, so a container is 64 bytes, one cache line.  Empty containers are not
+/// kept.
+typedef struct {
+    int16_t  year;      ///< calendar year (Gregorian)
+    uint8_t  kind;      ///< a @c ucal_RdnSetKindT
+    uint8_t  nrun;      ///< number of runs for @c ucal_RdnSetRuns
+    uint16_t card;      ///< number of days in the container
+    uint32_t before;    ///< number of days in the containers before this one
+    union {
+        uint64_t bits[6];                       ///< bitmap, 384 bits
+        uint16_t run[UCAL_RDNSET_NRUN][2];      ///< runs, @c [lo,hi[ days in year
+    } u;
+} ucal_RdnSetContT;
+
+/// @brief a set of days
+///
+/// The containers are kept sorted by year in storage provided by the caller.
+typedef struct {
+    ucal_RdnSetContT *cont;     ///< containers
+    size_t            ncont;    ///< number of containers in use
+    size_t            capacity; ///< number of containers available
+} ucal_RdnSetT;
+
+/// @brief set up an empty set
+/// @param set      set to initialise
+/// @param mem      container storage
+/// @param capacity number of containers in @c mem; one per year that has days in the set
+extern void ucal_RdnSetInit(ucal_RdnSetT *set, ucal_RdnSetContT *mem, size_t capacity);
+
+/// @brief remove all days from a set
+/// @param set      set to clear
+extern void ucal_RdnSetClear(ucal_RdnSetT *set);
+
+/// @brief add a range of days
+/// @note Sets @c errno to @c ERANGE if the range is not within the years -32768..32767 or the
+///       set needs more containers than it has; the set is unchanged then.
+/// @param set      set to modify
+/// @param lo       first day (RDN)
+/// @param hi       day after the last day (RDN)
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_RdnSetAddRange(ucal_RdnSetT *set, int32_t lo, int32_t hi);
+
+/// @brief remove a range of days
+/// @note Sets @c errno to @c ERANGE if the range is not within the years -32768..32767; the set
+///       is unchanged then.
+/// @param set      set to modify
+/// @param lo       first day (RDN)
+/// @param hi       day after the last day (RDN)
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_RdnSetRemoveRange(ucal_RdnSetT *set, int32_t lo, int32_t hi);
+
+/// @brief add the days of a range that fall on given weekdays
+///
+/// Bit @c n of @c wdmask selects the weekday @c n of @c ucal_WeekDayT; Sunday is bit 0 or 7.
+/// So @c 0x3E are the days from Monday to Friday.
+///
+/// @note Sets @c errno like @c ucal_RdnSetAddRange().
+/// @param set      set to modify
+/// @param lo       first day (RDN)
+/// @param hi       day after the last day (RDN)
+/// @param wdmask   weekday mask
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_RdnSetAddWeekdays(ucal_RdnSetT *set, int32_t lo, int32_t hi, unsigned wdmask);
+
+/// @brief check if a day is in a set
+/// @param set      set to check
+/// @param rdn      day
+/// @return         @c true if @c rdn is in the set
+extern bool ucal_RdnSetContains(ucal_RdnSetT const *set, int32_t rdn);
+
+/// @brief get the number of days in a set
+/// @param set      set to check
+/// @return         number of days
+extern size_t ucal_RdnSetCount(ucal_RdnSetT const *set);
+
+/// @brief get the number of days in a set before a given day
+/// @param set      set to check
+/// @param rdn      day
+/// @return         number of days in the set that are less than @c rdn
+extern size_t ucal_RdnSetRank(ucal_RdnSetT const *set, int32_t rdn);
+
+/// @brief get a day of a set by its index
+///
+/// The inverse of ucal_RdnSetRank(): the day that has @c k days of the set before it.
+/// @param into     where to store the day
+/// @param set      set to check
+/// @param k        zero-based index
+/// @return         @c true on success, @c false if the set has @c k days or less
+extern bool ucal_RdnSetSelect(int32_t *into, ucal_RdnSetT const *set, size_t k);
+
+/// @brief get the k-th day of a set after a given day
+///
+/// With @c k=1 this is the next day of the set strictly after @c rdn.
+/// @param into     where to store the day
+/// @param set      set to check
+/// @param rdn      day
+/// @param k        one-based count
+/// @return         @c true on success, @c false if there are not that many days
+extern bool ucal_RdnSetNext(int32_t *into, ucal_RdnSetT const *set, int32_t rdn, size_t k);
+
+/// @brief calculate the union of two sets
+/// @note Sets @c errno to @c EINVAL if @c dst is one of the operands and to @c ERANGE if
+///       @c dst has too few containers; the contents of @c dst are unspecified then.
+/// @param dst      result set; previous contents are dropped
+/// @param a        first operand
+/// @param b        second operand
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_RdnSetUnion(ucal_RdnSetT *dst, ucal_RdnSetT const *a, ucal_RdnSetT const *b);
+
+/// @brief calculate the intersection of two sets
+/// @note Sets @c errno like @c ucal_RdnSetUnion().
+/// @param dst      result set; previous contents are dropped
+/// @param a        first operand
+/// @param b        second operand
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_RdnSetIntersect(ucal_RdnSetT *dst, ucal_RdnSetT const *a,
+                                 ucal_RdnSetT const *b);
+
+/// @brief calculate the difference of two sets
+/// @note Sets @c errno like @c ucal_RdnSetUnion().
+/// @param dst      result set; previous contents are dropped
+/// @param a        minuend
+/// @param b        subtrahend
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_RdnSetDifference(ucal_RdnSetT *dst, ucal_RdnSetT const *a,
+                                  ucal_RdnSetT const *b);
+
+CDECL_END
+#endif /*RDNSET_H_D2078C60_0B6B_439F_B110_087913F54042*/
@@ -0,0 +1,125 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the interface for radio / time code frame decoding.
+// ----------------------------------------------------------------------------------------------
+#ifndef RTCDECODE_H_D2078C60_0B6B_439F_B110_087913F54042
+#define RTCDECODE_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include "common.h"
+
+CDECL_BEG
+
+/// @brief stateful frame decoder
+///
+/// The time codes carry two-digit years only, and in the case of WWVB and IRIG-B a day-of-year
+/// instead of a month/day pair. Resolving the century and the base day of the year (or month)
+/// is the expensive part of a frame decode, so the decoder keeps the last resolution and reuses
+/// it as long as the frames stay in the same year / month.
+///
+/// @note Initialise with @c ucal_RtcDecoderInit() before use. The decoder has no resources;
+///       it can be copied or re-initialised at any time.
+typedef struct {
+    int16_t ybase;      ///< base year for century inference
+    int16_t yFull;      ///< cached full year, @c INT16_MIN if nothing is cached
+    int8_t  yTrunc;     ///< cached year (mod 100)
+    int8_t  mCache;     ///< cached month, zero if no month start is cached
+    int32_t rdnYear;    ///< RDN of Jan,1 of cached year
+    int32_t rdnMonth;   ///< RDN of the day before the 1st of the cached month
+} ucal_RtcDecoderT;
+
+/// @brief status flags of a decoded frame
+enum {
+    ucal_RtcFlag_DST     = 0x01,    ///< transmitted time is DST (summer time)
+    ucal_RtcFlag_DSTAnn  = 0x02,    ///< DST change is announced / pending
+    ucal_RtcFlag_LeapAnn = 0x04,    ///< leap second is announced / pending
+    ucal_RtcFlag_LeapNeg = 0x08     ///< announced leap second is a deletion (IEEE 1344 only)
+};
+
+/// @brief result of a frame decode
+typedef struct {
+    time_t  tsUtc;  ///< time stamp of the encoded instant in UNIX scale
+    int32_t rdn;    ///< RDN of the transmitted (local) civil date
+    int32_t tod;    ///< transmitted seconds since (local) midnight
+    int16_t offs;   ///< offset (local - UTC) of the transmitted time in minutes
+    uint8_t flags;  ///< combination of @c ucal_RtcFlag_XXX values
+} ucal_RtcTimeT;
+
+/// @brief initialise a frame decoder
+/// @param dec      decoder to initialise
+/// @param ybase    base year for century inference; two-digit years are expanded into
+///                 [ybase, ybase+400[ with a day-of-week or [ybase, ybase+100[ without
+extern void ucal_RtcDecoderInit(ucal_RtcDecoderT *dec, int16_t ybase);
+
+/// @brief decode a DCF77 minute frame
+///
+/// Bit @e i of the frame is the bit transmitted in second @e i of the minute.  The three even
+/// parity bits, the start-of-time bit and the zone bits are checked, and all BCD digits must be
+/// valid.  The result is the time of the minute mark @e following the frame, in CET or CEST.
+///
+/// @note Sets @c errno to @c EINVAL if the frame is not valid.
+/// @param into     where to store the result
+/// @param dec      decoder state to use/update
+/// @param frame    the 59 data bits of the frame
+/// @return         @c true on success, @c false on error
+extern bool ucal_RtcDecodeDCF77(ucal_RtcTimeT *into, ucal_RtcDecoderT *dec, uint64_t frame);
+
+/// @brief decode a MSF minute frame
+///
+/// MSF transmits two bits per second. Bit @e i of @c abits and @c bbits is the A / B bit sent in
+/// second @e i of the minute.  The four odd parity bits and the 01111110 minute identifier are
+/// checked.  The result is the time of the minute mark @e following the frame, in GMT or BST.
+///
+/// @note Sets @c errno to @c EINVAL if the frame is not valid.
+/// @param into     where to store the result
+/// @param dec      decoder state to use/update
+/// @param abits    the A bits of the frame
+/// @param bbits    the B bits of the frame
+/// @return         @c true on success, @c false on error
+extern bool ucal_RtcDecodeMSF(ucal_RtcTimeT *into, ucal_RtcDecoderT *dec,
+                              uint64_t abits, uint64_t bbits);
+
+/// @brief decode a WWVB minute frame (amplitude code)
+///
+/// Bit @e i of the frame is the bit transmitted in second @e i; position markers must be given
+/// as zero bits.  WWVB has no parity, so all unused bits must be zero and the leap year
+/// indicator must match the expanded year.  The result is the UTC time of the on-time marker
+/// @e starting the frame.
+///
+/// @note Sets @c errno to @c EINVAL if the frame is not valid.
+/// @param into     where to store the result
+/// @param dec      decoder state to use/update
+/// @param frame    the 60 data bits of the frame
+/// @return         @c true on success, @c false on error
+extern bool ucal_RtcDecodeWWVB(ucal_RtcTimeT *into, ucal_RtcDecoderT *dec, uint64_t frame);
+
+/// @brief decode an IRIG-B frame with year (B00x4..B00x7)
+///
+/// Bit @e i of the 100 bit frame is bit (@e i mod 64) of @c frame[i / 64]; position markers
+/// must be given as zero bits.  The result is the time of the on-time reference marker
+/// @e starting the frame.  With @c ieee1344 set, the control functions are read as defined by
+/// IEEE 1344 / C37.118: the time offset (IRIG time plus offset equals UTC) and the DST and leap
+/// second indicators.  Otherwise the time is taken as UTC.
+///
+/// @note Sets @c errno to @c EINVAL if the frame is not valid.
+/// @param into     where to store the result
+/// @param dec      decoder state to use/update
+/// @param frame    the 100 bits of the frame
+/// @param ieee1344 evaluate IEEE 1344 control functions
+/// @return         @c true on success, @c false on error
+extern bool ucal_RtcDecodeIRIGB(ucal_RtcTimeT *into, ucal_RtcDecoderT *dec,
+                                const uint64_t frame[2], bool ieee1344);
+
+CDECL_END
+#endif /*RTCDECODE_H_D2078C60_0B6B_439F_B110_087913F54042*/
@@ -0,0 +1,193 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// System time zone tracker (optional, needs inotify and POSIX threads)
+// ----------------------------------------------------------------------------------------------
+#ifndef SYSZONE_H_D2078C60_0B6B_439F_B110_087913F54042
+#define SYSZONE_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "common.h"
+#include "tzposix.h"
+
+CDECL_BEG
+
+/// @brief number of snapshots the tracker cycles through
+///
+/// A reader copying a snapshot can overlap with @c UCAL_SYSZONE_SLOTS-2 zone changes before it
+/// has to retry.
+#define UCAL_SYSZONE_SLOTS 4
+
+/// @brief maximum size of a POSIX TZ string, including the terminating NUL
+#define UCAL_SYSZONE_SPECLEN 64
+
+/// @brief maximum size of a path, including the terminating NUL
+#define UCAL_SYSZONE_PATHLEN 256
+
+/// @brief default zone file if @c TZ is not set
+#define UCAL_SYSZONE_LOCALTIME "/etc/localtime"
+
+/// @brief default directory for zone names in @c TZ
+#define UCAL_SYSZONE_ZONEINFO "/usr/share/zoneinfo"
+
+/// @brief a published zone
+typedef struct {
+    tziPosixZoneT zone;                         ///< the zone rules
+    uint32_t      gen;                          ///< generation, counting from 1
+    char          spec[UCAL_SYSZONE_SPECLEN];   ///< POSIX TZ string of the zone
+} ucal_SysZoneSnapT;
+
+/// @brief the system zone tracker
+///
+/// The tracker resolves the system zone like the C library does: from @c TZ if set, from
+/// @c /etc/localtime otherwise.  Zone files must be TZif version 2 or later; their POSIX TZ
+/// footer is used.  The zone file and its directory are watched with inotify.
+///
+/// New zones go to the next snapshot slot, which is then published by an atomic pointer
+/// swap.  Readers never lock; a reader keeps a private copy of the zone in a
+/// @c ucal_SysZoneCtxT and only looks at the tracker again when the generation changes.
+/// Writers (the watcher thread, ucal_SysZoneUpdate(), ucal_SysZoneReload() and
+/// ucal_SysZonePublish()) are serialised by a mutex.
+///
+/// A process usually has one tracker, set up at start and shared by all threads.
+typedef struct {
+    ucal_SysZoneSnapT *cur;         ///< published snapshot
+    uint32_t           gen;         ///< generation of the published snapshot
+    char               pad[64];     ///< keeps @c cur and @c gen, read by every reader, off the
+                                    ///< cache lines the writers fill
+    ucal_SysZoneSnapT  slot[UCAL_SYSZONE_SLOTS];
+    pthread_mutex_t    lock;        ///< serialises the writers
+    pthread_t          thread;      ///< watcher thread
+    bool               running;     ///< watcher thread is running
+    bool               fromEnv;     ///< resolve from @c TZ / @c /etc/localtime on reload
+    int                ifd;         ///< inotify descriptor
+    int                wdDir;       ///< watch on the directory of @c path, or -1
+    int                wdFile;      ///< watch on @c path, or -1
+    uint64_t           fileId[2];   ///< device and inode behind @c wdFile
+    int                stop[2];     ///< pipe to stop the watcher thread
+    char               path[UCAL_SYSZONE_PATHLEN];  ///< zone file; empty for a TZ string
+    char               zdir[UCAL_SYSZONE_PATHLEN];  ///< directory for zone names
+} ucal_SysZoneT;
+
+/// @brief a reader's view of the system zone
+///
+/// Keep one per thread.  The conversion context can be used with all functions that take a
+/// @c tziConvCtxT; get it from ucal_SysZoneSync() before each use.
+typedef struct {
+    tziPosixZoneT zone; ///< private copy of the zone
+    tziConvCtxT   ctx;  ///< conversion context on @c zone
+    uint32_t      gen;  ///< generation of @c zone; 0 if never synced
+} ucal_SysZoneCtxT;
+
+/// @brief set up a tracker and publish the current zone
+///
+/// If the zone cannot be resolved, UTC is published and the zone file is still watched, so
+/// it is picked up when it appears.
+///
+/// @note Sets @c errno to @c EINVAL on invalid arguments or too long paths; other values come
+///       from the inotify calls.
+/// @param sz       tracker to set up
+/// @param path     zone file to track; @c NULL for the system zone
+/// @param zonedir  directory for zone names in @c TZ; @c NULL for @c UCAL_SYSZONE_ZONEINFO
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_SysZoneOpen(ucal_SysZoneT *sz, const char *path, const char *zonedir);
+
+/// @brief stop the watcher thread, if any, and release the resources of a tracker
+/// @param sz       tracker
+extern void ucal_SysZoneClose(ucal_SysZoneT *sz);
+
+/// @brief get the inotify descriptor of a tracker
+///
+/// For callers that have an event loop: when the descriptor becomes readable, call
+/// ucal_SysZoneUpdate().
+/// @param sz       tracker
+/// @return         file descriptor
+extern int ucal_SysZoneFd(ucal_SysZoneT const *sz);
+
+/// @brief process pending change notifications without blocking
+///
+/// If the zone file or its directory entry changed, the zone is resolved again and published
+/// if it differs from the current one.
+/// @note Sets @c errno like ucal_SysZoneReload().
+/// @param sz       tracker
+/// @return         @c false if a reload failed, @c true otherwise
+extern bool ucal_SysZoneUpdate(ucal_SysZoneT *sz);
+
+/// @brief resolve the zone again and publish it if it differs from the current one
+///
+/// With the system zone, @c TZ is read again; use this after changing the environment.  The
+/// watches follow the new zone file.
+///
+/// @note Sets @c errno to @c EINVAL if the zone file is no TZif file with a POSIX TZ footer,
+///       the footer or @c TZ does not parse, or to the error from reading the file.  The
+///       current zone stays published then.
+/// @param sz       tracker
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_SysZoneReload(ucal_SysZoneT *sz);
+
+/// @brief publish a zone given as POSIX TZ string
+///
+/// For zones that come from elsewhere, like a configuration service.  The zone stays until
+/// the next change of the tracked file or the next reload.
+/// @note Sets @c errno to @c EINVAL if @c spec does not parse completely or is too long.
+/// @param sz       tracker
+/// @param spec     POSIX TZ string
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_SysZonePublish(ucal_SysZoneT *sz, const char *spec);
+
+/// @brief start a thread that waits for change notifications and processes them
+/// @note Sets @c errno to @c EINVAL if the thread is running already, or to the error from
+///       creating the thread.
+/// @param sz       tracker
+/// @return         @c true on success, @c false otherwise
+extern bool ucal_SysZoneStart(ucal_SysZoneT *sz);
+
+/// @brief stop the watcher thread
+/// @param sz       tracker
+extern void ucal_SysZoneStop(ucal_SysZoneT *sz);
+
+/// @brief copy the published snapshot
+///
+/// Lock-free; the copy is retried if the tracker has reused the slot meanwhile.
+/// @param into     where to store the copy
+/// @param sz       tracker
+extern void ucal_SysZoneSnapshot(ucal_SysZoneSnapT *into, ucal_SysZoneT const *sz);
+
+/// @brief get the generation of the published zone
+/// @param sz       tracker
+/// @return         generation; increases with every zone change
+extern uint32_t ucal_SysZoneGeneration(ucal_SysZoneT const *sz);
+
+/// @brief copy the published zone into a reader context
+///
+/// The slow path of ucal_SysZoneSync().
+/// @param lc       reader context
+/// @param sz       tracker
+/// @return         conversion context of @c lc
+extern tziConvCtxT* ucal_SysZoneRefresh(ucal_SysZoneCtxT *lc, ucal_SysZoneT const *sz);
+
+/// @brief get the conversion context of a reader for the current zone
+///
+/// Costs a call and one atomic load if the zone has not changed since the last call.
+/// @param lc       reader context; zero it before the first call
+/// @param sz       tracker
+/// @return         conversion context of @c lc
+extern tziConvCtxT* ucal_SysZoneSync(ucal_SysZoneCtxT *lc, ucal_SysZoneT const *sz);
+
+CDECL_END
+#endif /*SYSZONE_H_D2078C60_0B6B_439F_B110_087913F54042*/
@@ -18,8 +18,10 @@
 #define TSDECODE_H_D2078C60_0B6B_439F_B110_087913F54042
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "common.h"
+#include "tzposix.h"
 
 CDECL_BEG
 
@@ -64,5 +66,142 @@ extern bool ucal_decASN1UtcTime23(struct timespec *into, const char** pstr, cons
 /// @return         @c true on success, @c false on error
 extern bool ucal_decASN1GenTime24(struct timespec *into, const char** pstr, const char *end);
 
+/// @brief decode an RFC 5322 mail date
+///
+/// Decodes the value of a @c Date: header as written by mail and news software over the years:
+/// RFC 5322 syntax plus the obsolete forms of RFC 2822 and RFC 822.  That is, an optional day
+/// name, a day of month, an English month name, a year with 2, 3 or 4 digits, the time of day
+/// with or without seconds, and a zone.  Comments and folding white space are skipped wherever
+/// they can appear.  Day and month names are the three letter abbreviations or the full English
+/// names; names are matched without regard to case and without the locale.
+///
+/// Years with 2 digits are taken as 1950..2049, years with 3 digits are offset by 1900.  The
+/// zone can be a numeric offset, @c UT, @c GMT, one of the North American zone names or a
+/// military letter; military letters and other unknown names are taken as UTC (RFC 5322,
+/// section 4.3).  If a conversion context is given, the standard and DST names of its zone
+/// are recognised first, and a date without any zone is taken as local time in that zone.
+/// Without a context, a missing zone means UTC.  The day name is not checked against the date.
+///
+/// @param into     time value storage
+/// @param pstr     pointer to current parse position; unchanged on error
+/// @param end      end of parse region; can be @c NULL to stop at @c NUL byte
+/// @param ctx      conversion context for the local zone; can be @c NULL
+/// @return         @c true on success, @c false on error
+extern bool ucal_decRFC5322Date(struct timespec *into, const char **pstr, const char *end,
+                                tziConvCtxT *ctx);
+
+/// @brief time stamp text formats known to the format detector
+typedef enum {
+    ucal_DecFmt_None,       ///< not recognised
+    ucal_DecFmt_ASN1Utc,    ///< ASN.1 UTCTime, @c YYMMDDhhmm[ss][.f](Z|±hhmm)
+    ucal_DecFmt_ASN1Gen,    ///< ASN.1 GeneralizedTime, @c YYYYMMDDhh[mm[ss]][.f](Z|±hhmm)
+    ucal_DecFmt_RFC3339,    ///< @c YYYY-MM-DD(T|t| )hh:mm:ss[.f][Z|±hh:mm|±hhmm]
+    ucal_DecFmt_HTTPDate,   ///< IMF-fixdate of HTTP, @c "Sun, 06 Nov 1994 08:49:37 GMT"
+    ucal_DecFmt_Mail,       ///< any other RFC 5322 date, see ucal_decRFC5322Date()
+    ucal_DecFmt_Epoch       ///< @c [±]digits[.f], (sub)seconds since 1970-01-01T00:00:00Z
+} ucal_DecFormatT;
+
+/// @brief zone styles of the fixed layouts
+typedef enum {
+    ucal_DecZone_None,      ///< no zone, local time
+    ucal_DecZone_Z,         ///< @c Z
+    ucal_DecZone_Offs,      ///< @c ±hhmm
+    ucal_DecZone_OffsColon  ///< @c ±hh:mm
+} ucal_DecZoneT;
+
+/// @brief layout of a time stamp text
+///
+/// Two values with the same layout have their fields at the same offsets.  The layouts are
+/// compared bytewise.
+typedef struct {
+    uint8_t format;     ///< a @c ucal_DecFormatT
+    uint8_t length;     ///< characters of the date and time fields; 0 for variable length
+    uint8_t fracWidth;  ///< digits in the fraction of the seconds, 0 for none
+    uint8_t zone;       ///< a @c ucal_DecZoneT
+    uint8_t tsep;       ///< date/time separator of RFC 3339
+    uint8_t unit;       ///< decimal exponent of the epoch unit: 0 (s), 3 (ms), 6 (µs), 9 (ns)
+} ucal_DecLayoutT;
+
+/// @brief a time stamp decoder bound to the layout of a column
+///
+/// Set up with ucal_decDetectInit() and ucal_decDetect(); then ucal_decColumn() decodes values
+/// of the detected layout with a decoder for exactly that layout.
+typedef struct {
+    ucal_DecLayoutT layout; ///< layout of the column
+    tziConvCtxT    *ctx;    ///< zone for values without one; can be @c NULL
+    int             ybase;  ///< year base for the century expansion of UTCTime
+    size_t          nslow;  ///< number of values that needed a classification of their own
+} ucal_DecDetectT;
+
+/// @brief find the layout of a single time stamp text
+///
+/// This is a syntactic check only; the field values are checked on decoding.  Digit strings
+/// without a zone are taken as epoch values, whose unit follows from the number of digits:
+/// up to 11 digits are seconds, up to 14 milliseconds, up to 17 microseconds, and up to 19
+/// nanoseconds; a fraction is only possible with seconds.  A 10 or 12 digit ASN.1 time is
+/// UTCTime if its second field is a valid month, and GeneralizedTime otherwise.
+///
+/// @param into     layout storage
+/// @param str      text to classify
+/// @param end      end of text; can be @c NULL to stop at @c NUL byte
+/// @return         @c true if a layout was found, @c false if not
+extern bool ucal_decClassify(ucal_DecLayoutT *into, const char *str, const char *end);
+
+/// @brief set up a column decoder
+///
+/// Values without a zone are local time in the zone of @c ctx.  Without a context, they are
+/// system local time for the ASN.1 and RFC 3339 layouts like in ucal_decASN1GenTime24(), and
+/// UTC for mail dates like in ucal_decRFC5322Date().
+///
+/// @param det      decoder to set up
+/// @param ctx      conversion context for the local zone; can be @c NULL
+/// @param ybase    year base for UTCTime, e.g. 1950 for X.509
+extern void ucal_decDetectInit(ucal_DecDetectT *det, tziConvCtxT *ctx, int ybase);
+
+/// @brief detect the layout of a column from a sample of its values
+///
+/// Classifies the sample and binds the layout most of the sample values have; on a tie, the
+/// one seen first.
+///
+/// @note Sets @c errno to @c EINVAL if no value of the sample has a known layout.
+/// @param det      decoder set up by ucal_decDetectInit()
+/// @param str      sample values; usually the first few values of the column
+/// @param len      lengths of the values; can be @c NULL for @c NUL terminated values
+/// @param count    number of sample values
+/// @return         @c true if a layout was bound, @c false if not
+extern bool ucal_decDetect(ucal_DecDetectT *det, const char *const *str, const size_t *len,
+                           size_t count);
+
+/// @brief decode a column of time stamp texts
+///
+/// Values in the bound layout go through a decoder for just that layout, which only checks the
+/// separators at their offsets and the digits in between.  Other values are classified on
+/// their own and decoded in their layout; they are counted in @c nslow.  Each value must be
+/// consumed completely.
+///
+/// @note Sets @c errno to @c EINVAL on a value that cannot be decoded in any layout.
+/// @param into     destination; @c count elements
+/// @param det      decoder with a bound layout
+/// @param str      values
+/// @param len      lengths of the values; can be @c NULL for @c NUL terminated values
+/// @param count    number of values
+/// @return         number of values decoded; less than @c count on error
+extern size_t ucal_decColumn(struct timespec *into, ucal_DecDetectT *det,
+                             const char *const *str, const size_t *len, size_t count);
+
+/// @brief decode a column of time stamps to nanoseconds
+///
+/// Like ucal_decColumn(), storing nanoseconds in UNIX scale.
+/// @note Sets @c errno to @c EINVAL on a value that cannot be decoded in any layout and to
+///       @c ERANGE on a time stamp that is not representable in nanoseconds.
+/// @param into     destination; @c count elements
+/// @param det      decoder with a bound layout
+/// @param str      values
+/// @param len      lengths of the values; can be @c NULL for @c NUL terminated values
+/// @param count    number of values
+/// @return         number of values decoded; less than @c count on error
+extern size_t ucal_decColumnNs(ucal_ns_t *into, ucal_DecDetectT *det,
+                               const char *const *str, const size_t *len, size_t count);
+
 CDECL_END
 #endif /*TSDECODE_H_D2078C60_0B6B_439F_B110_087913F54042*/
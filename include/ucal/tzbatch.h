@@ -0,0 +1,242 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// Bulk time zone conversions
+// ----------------------------------------------------------------------------------------------
+#ifndef TZBATCH_H_D2078C60_0B6B_439F_B110_087913F54042
+#define TZBATCH_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "tzposix.h"
+
+CDECL_BEG
+
+/// @brief number of zones packed into one zone block
+#define TZI_LANES 8
+
+/// @brief number of zone blocks needed to hold @c n zones
+#define TZI_BLOCKS(n) (((n) + TZI_LANES - 1) / TZI_LANES)
+
+/// @brief packed zone rules, structure-of-arrays layout
+///
+/// A zone block holds the data of @c TZI_LANES zones, with every field stored as an array over
+/// the zones.  The rules are pre-digested so that evaluating them for a given year needs only a
+/// few additions and masks per zone, without branches, divisions or table lookups; this lets
+/// the compiler process all lanes of a block in parallel.  All fields have the same width for
+/// the same reason.
+///
+/// @note Use @c tziPackZones() or @c tziPackZone() to fill the blocks. The layout is internal
+///       and may change.
+typedef struct tziZoneBlock_S {
+    int32_t offsSTD[TZI_LANES]; ///< offset (local - UTC) in seconds, STD
+    int32_t offsDST[TZI_LANES]; ///< offset (local - UTC) in seconds, DST
+    int32_t ovlSecs[TZI_LANES]; ///< length of the overlap in seconds, zero without rules
+    int32_t ovlSTD[TZI_LANES];  ///< overlap happens at DST->STD (-1) or STD->DST (0)
+    int32_t fixMode[TZI_LANES]; ///< 0: with transitions, 1: all-year STD, 2: all-year DST
+    int32_t dayDST[TZI_LANES];  ///< STD->DST base day-in-year (zero-based) in a regular year
+    int32_t lpiDST[TZI_LANES];  ///< STD->DST base day shift in leap years (-1 or 0)
+    int32_t wdcDST[TZI_LANES];  ///< STD->DST weekday constant, (wd - day) mod 7
+    int32_t wdmDST[TZI_LANES];  ///< STD->DST weekday mask, zero for a fixed day
+    int32_t locDST[TZI_LANES];  ///< STD->DST transition time in minutes, UTC based
+    int32_t daySTD[TZI_LANES];  ///< DST->STD base day-in-year in a regular year
+    int32_t lpiSTD[TZI_LANES];  ///< DST->STD base day shift in leap years
+    int32_t wdcSTD[TZI_LANES];  ///< DST->STD weekday constant
+    int32_t wdmSTD[TZI_LANES];  ///< DST->STD weekday mask
+    int32_t locSTD[TZI_LANES];  ///< DST->STD transition time in minutes, UTC based
+} tziZoneBlockT;
+
+/// @brief conversion flags for bulk conversions
+///
+/// These are the bits of @c tziConvInfoT, packed into a byte.
+enum {
+    tziFlag_DST = 0x01, ///< time is in DST range
+    tziFlag_HrA = 0x02, ///< time is in overlap before transition
+    tziFlag_HrB = 0x04, ///< time is in overlap after transition
+    tziFlag_Gap = 0x08, ///< local time was in the gap and moved forward
+    tziFlag_Bck = 0x10  ///< local time resolves to a time before the previous one
+};
+
+/// @brief pack a single zone into a zone block array
+///
+/// @param blocks   zone blocks to update
+/// @param idx      index of the zone; lands in lane @c idx%TZI_LANES of block @c idx/TZI_LANES
+/// @param zone     zone to pack
+extern void tziPackZone(tziZoneBlockT *blocks, size_t idx, tziPosixZoneT const *zone);
+
+/// @brief pack an array of zones into zone blocks
+///
+/// The lanes of the last block not covered by @c zones are filled with UTC.
+///
+/// @param blocks   zone blocks to fill; must hold @c TZI_BLOCKS(count) elements
+/// @param zones    zones to pack
+/// @param count    number of zones
+extern void tziPackZones(tziZoneBlockT *blocks, tziPosixZoneT const *zones, size_t count);
+
+/// @brief convert one UTC time stamp to local time in many zones
+///
+/// This is the equivalent of calling @c tziGetInfoUtc2Local() for every zone, but the calendar
+/// work that does not depend on the zone (the year, its start, weekday and leap year property)
+/// is done only once per call.
+///
+/// @note Sets @c errno to @c EINVAL for @c NULL arguments and to @c ERANGE if the year of the
+///       time stamp is out of range.
+///
+/// @param offs     where to store the offsets (local - UTC) in seconds; @c count elements
+/// @param flags    where to store the @c tziFlag_XXX values; @c count elements or @c NULL
+/// @param blocks   packed zones, as filled by @c tziPackZones()
+/// @param count    number of zones
+/// @param tsfrom   time stamp in UNIX scale
+/// @return         @c true on success, @c false otherwise
+extern bool tziFanOutUtc2Local(int32_t *offs, uint8_t *flags, tziZoneBlockT const *blocks,
+                               size_t count, int64_t tsfrom);
+
+/// @brief convert a run of UTC time stamps to local time in one zone
+///
+/// This is the equivalent of calling @c tziGetInfoUtc2Local() for every time stamp.  Along
+/// with the conversion info, the interval around the time stamp where the info does not change
+/// is established, and following time stamps in that interval just copy the result.  The time
+/// stamps can come in any order, but runs of ascending (or descending) time stamps convert best.
+///
+/// @note Sets @c errno to @c EINVAL for @c NULL arguments.
+///
+/// @param offs     where to store the offsets (local - UTC) in seconds; @c count elements
+/// @param flags    where to store the @c tziFlag_XXX values; @c count elements or @c NULL
+/// @param ctx      conversion context to use/update
+/// @param tsfrom   time stamps in UNIX scale
+/// @param count    number of time stamps
+/// @return         @c true on success, @c false otherwise
+extern bool tziBatchUtc2Local(int32_t *offs, uint8_t *flags, tziConvCtxT *ctx,
+                              int64_t const *tsfrom, size_t count);
+
+/// @brief get the scratch size needed by @c tziBatchUtc2LocalByZone()
+/// @param count    number of records
+/// @param nzones   number of zones
+/// @return         scratch buffer size in bytes
+extern size_t tziBatchScratchSize(size_t count, size_t nzones);
+
+/// @brief convert records of UTC time stamps and zone ids to local time
+///
+/// The records are partitioned by zone with a stable counting sort, each partition is converted
+/// with the run conversion of @c tziBatchUtc2Local(), and the results are scattered back to the
+/// record order.  This is done in chunks of a few thousand records to keep the partitions in
+/// the cache; the unchanged interval of each zone is kept from one chunk to the next.  Since the
+/// sort is stable, time ordered records make time ordered partitions.
+///
+/// The caller supplies a scratch buffer of at least @c tziBatchScratchSize(count,nzones) bytes,
+/// aligned for @c int64_t, and one conversion context per zone.  The contexts keep their
+/// caches between calls.
+///
+/// @note Sets @c errno to @c EINVAL for @c NULL arguments or zone ids out of range.
+///
+/// @param offs     where to store the offsets (local - UTC) in seconds; @c count elements
+/// @param flags    where to store the @c tziFlag_XXX values; @c count elements or @c NULL
+/// @param tsfrom   time stamps in UNIX scale
+/// @param zoneId   zone ids, indices into @c ctxTab
+/// @param count    number of records
+/// @param ctxTab   conversion contexts, one per zone
+/// @param nzones   number of zones
+/// @param scratch  scratch buffer
+/// @return         @c true on success, @c false otherwise
+extern bool tziBatchUtc2LocalByZone(int32_t *offs, uint8_t *flags, int64_t const *tsfrom,
+                                    uint16_t const *zoneId, size_t count,
+                                    tziConvCtxT *ctxTab, size_t nzones, void *scratch);
+
+/// @brief state of a stream of local time stamps in one zone
+///
+/// Local time stamps from a source that counts forward (a meter, a logger) can be resolved
+/// in the autumn overlap by looking at the previous result.  The stream keeps that result as
+/// the pivot, and a cached interval where the offset is unique so that most time stamps are
+/// converted with a compare and an addition.
+///
+/// @note Use @c tziStreamInit() to set up the state.  The fields are internal.
+typedef struct tziStream_S {
+    tziConvCtxT *ctx;       ///< conversion context of the zone
+    int64_t      pivot;     ///< last resolved UTC time stamp
+    int64_t      segLo;     ///< start of the cached interval, UTC
+    int64_t      segHi;     ///< end of the cached interval, UTC
+    int32_t      segOffs;   ///< offset (local - UTC) in the cached interval
+    uint8_t      segFlags;  ///< @c tziFlag_XXX values in the cached interval
+} tziStreamT;
+
+/// @brief set up a stream of local time stamps
+/// @param strm     stream state to set up
+/// @param ctx      conversion context of the zone; used and updated by the stream
+/// @param pivot    UTC time stamp preceding the stream, or @c INT64_MIN if not known
+extern void tziStreamInit(tziStreamT *strm, tziConvCtxT *ctx, int64_t pivot);
+
+/// @brief convert local time stamps of a stream to UTC
+///
+/// A local time stamp in the autumn overlap has two UTC candidates; the first one after the
+/// pivot is taken, flagged with @c tziFlag_HrA or @c tziFlag_HrB.  A local time in
+/// the spring gap does not exist; it is resolved with the offset before the transition, which
+/// moves it forward by the length of the gap, and flagged with @c tziFlag_Gap.  If the result
+/// is still before the pivot, the source stepped back (or the data is out of order); the result
+/// is flagged with @c tziFlag_Bck and taken as the new pivot anyway.  @c tziFlag_DST tells the
+/// zone of the result.
+///
+/// @note Sets @c errno to @c EINVAL for @c NULL arguments; the conversion stops at the first
+///       time stamp that fails.
+///
+/// @param utc      where to store the UTC time stamps; @c count elements, can be @c tsloc
+/// @param flags    where to store the @c tziFlag_XXX values; @c count elements or @c NULL
+/// @param strm     stream state to use/update
+/// @param tsloc    local time stamps, seconds in UNIX scale
+/// @param count    number of time stamps
+/// @return         number of time stamps converted
+extern size_t tziStreamLocal2Utc(int64_t *utc, uint8_t *flags, tziStreamT *strm,
+                                 int64_t const *tsloc, size_t count);
+
+/// @brief maximum number of resolutions for @c tziAlignedLocalRanges()
+#define TZI_MAX_WINDOWS 8
+
+/// @brief a resolution of aligned local windows
+typedef struct tziWindow_S {
+    int32_t period;     ///< window length in seconds, (0,7d]
+    int32_t phi;        ///< phase shift in seconds, see @c tziAlignedLocalRange()
+} tziWindowT;
+
+/// @brief align windows of several resolutions around a run of time stamps
+///
+/// This is the equivalent of calling @c tziAlignedLocalRange() for every time stamp and every
+/// resolution, in that order, including the clamping of windows at the transitions.  The zone
+/// offset is looked up once per time stamp (and reused over the interval where it does not
+/// change), and a window is reused for the following time stamps in it as long as it does not
+/// contain a transition.
+///
+/// The window number is @c floor((local+phi)/period) with @c local the local time of the time
+/// stamp.  It numbers the windows of a resolution in local time, and so it repeats in the
+/// autumn overlap; the boundaries tell these windows apart.
+///
+/// @note Sets @c errno to @c EINVAL for @c NULL arguments, too many resolutions or a period
+///       out of range.
+///
+/// @param tlohi    where to store the windows, @c [lo,hi[ pairs in UTC; for time stamp @c i
+///                 and resolution @c k at @c tlohi[2*(i*nwin+k)]; can be @c NULL
+/// @param widx     where to store the window numbers, at @c widx[i*nwin+k]; can be @c NULL
+/// @param ctx      conversion context to use/update
+/// @param win      resolutions; at most @c TZI_MAX_WINDOWS
+/// @param nwin     number of resolutions
+/// @param tsfrom   time stamps in UNIX scale
+/// @param count    number of time stamps
+/// @return         @c true on success, @c false otherwise
+extern bool tziAlignedLocalRanges(int64_t *tlohi, int64_t *widx, tziConvCtxT *ctx,
+                                  tziWindowT const *win, size_t nwin,
+                                  int64_t const *tsfrom, size_t count);
+
+CDECL_END
+#endif /*TZBATCH_H_D2078C60_0B6B_439F_B110_087913F54042*/
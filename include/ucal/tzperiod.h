@@ -0,0 +1,146 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// Local period numbers (day, week, month, quarter, year) of UTC time stamps in a zone
+// ----------------------------------------------------------------------------------------------
+#ifndef TZPERIOD_H_D2078C60_0B6B_439F_B110_087913F54042
+#define TZPERIOD_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "tzposix.h"
+
+CDECL_BEG
+
+/// @brief local calendar periods
+///
+/// All periods are counted from the one containing 1970-01-01 in local time, which has
+/// index zero.
+typedef enum tziPeriod_E {
+    tziPeriod_Day,      ///< local days
+    tziPeriod_Week,     ///< ISO weeks, Monday to Sunday; week zero starts on 1969-12-29
+    tziPeriod_Month,    ///< calendar months
+    tziPeriod_Year,     ///< calendar years
+    tziPeriod_Quarter   ///< calendar quarters, starting in January, April, July and October
+} tziPeriodT;
+
+/// @brief get the index of the local period containing a time stamp
+///
+/// The local time is split by the period directly; no civil date is built on the way unless
+/// months or years are asked for.
+///
+/// @note Sets @c errno to @c EINVAL for @c NULL arguments or an unknown period and to
+///       @c ERANGE if the index does not fit.
+///
+/// @param into     where to store the index
+/// @param ctx      conversion context to use/update
+/// @param tsfrom   time stamp, UTC seconds in UNIX scale
+/// @param unit     kind of period
+/// @return         @c true on success, @c false otherwise
+extern bool tziPeriodIndex(int32_t *into, tziConvCtxT *ctx, int64_t tsfrom, tziPeriodT unit);
+
+/// @brief get the UTC start of a local period
+///
+/// This is the inverse of @c tziPeriodIndex(): the first instant whose local time is in the
+/// period.  Where local midnight is in a gap, that is the transition ending the gap; where it
+/// is shown twice, it is the first occurrence.
+///
+/// @note Sets @c errno like @c tziPeriodIndex().
+///
+/// @param into     where to store the time stamp, UTC seconds in UNIX scale
+/// @param ctx      conversion context to use/update
+/// @param index    index of the period
+/// @param unit     kind of period
+/// @return         @c true on success, @c false otherwise
+extern bool tziPeriodStart(int64_t *into, tziConvCtxT *ctx, int32_t index, tziPeriodT unit);
+
+/// @brief get the local period indices of an array of time stamps
+///
+/// Like @c tziPeriodIndex() for every time stamp.  The UTC bounds of the last period found are
+/// kept, so for mostly ordered input a time stamp costs two compares until it leaves the
+/// period.
+///
+/// @note Sets @c errno like @c tziPeriodIndex(); the conversion stops at the first time stamp
+///       that fails.
+///
+/// @param into     where to store the indices; @c count elements
+/// @param ctx      conversion context to use/update
+/// @param tsfrom   time stamps, UTC seconds in UNIX scale
+/// @param count    number of time stamps
+/// @param unit     kind of period
+/// @return         number of time stamps converted
+extern size_t tziPeriodIndexArray(int32_t *into, tziConvCtxT *ctx, int64_t const *tsfrom,
+                                  size_t count, tziPeriodT unit);
+
+/// @brief cached local period of a time stamp
+///
+/// Keeps the last period looked up with its UTC bounds, so time stamps in the same period are
+/// done with two compares.
+///
+/// @note Use @c tziPeriodCacheInit() to set up the cache.  The fields are internal.
+typedef struct tziPeriodCache_S {
+    tziConvCtxT *ctx;       ///< conversion context of the zone
+    tziPeriodT   unit;      ///< kind of period
+    int32_t      index;     ///< index of the cached period
+    int64_t      lo;        ///< start of the cached period, UTC
+    int64_t      hi;        ///< start of the next period, UTC
+} tziPeriodCacheT;
+
+/// @brief set up a period cache
+/// @param cache    cache to set up
+/// @param ctx      conversion context of the zone; used and updated by the cache
+/// @param unit     kind of period
+extern void tziPeriodCacheInit(tziPeriodCacheT *cache, tziConvCtxT *ctx, tziPeriodT unit);
+
+/// @brief get the UTC bounds of the local period containing a time stamp
+///
+/// The bounds are the starts of the period and the next one as given by @c tziPeriodStart(),
+/// so the DST transitions at the edges are taken care of.  Unlike @c tziAlignedLocalRange(),
+/// this works for calendar units of any length.
+///
+/// @note A period is not contiguous in UTC if the clock steps back over its start; a time
+///       stamp in the repeated part is outside of the bounds returned (and not cached).
+/// @note Sets @c errno to @c EINVAL for @c NULL arguments or an unknown period and to
+///       @c ERANGE if the period or its bounds are out of range.
+///
+/// @param tlohi    where to store the bounds, @c [lo,hi[ in UTC seconds in UNIX scale
+/// @param index    where to store the index of the period; can be @c NULL
+/// @param cache    period cache to use/update
+/// @param tsfrom   time stamp, UTC seconds in UNIX scale
+/// @return         @c true on success, @c false otherwise
+extern bool tziPeriodRange(int64_t tlohi[2], int32_t *index, tziPeriodCacheT *cache,
+                           int64_t tsfrom);
+
+/// @brief get the UTC bounds of the local periods of an array of time stamps
+///
+/// Like @c tziPeriodRange() for every time stamp.  The input should be sorted (or at least
+/// grouped by period) to make the most of the cache.
+///
+/// @note Sets @c errno like @c tziPeriodRange(); the conversion stops at the first time stamp
+///       that fails.
+///
+/// @param tlohi    where to store the bounds; @c 2*count elements, @c [lo,hi[ pairs
+/// @param index    where to store the period indices; @c count elements or @c NULL
+/// @param cache    period cache to use/update
+/// @param tsfrom   time stamps, UTC seconds in UNIX scale
+/// @param count    number of time stamps
+/// @return         number of time stamps converted
+extern size_t tziPeriodRangeArray(int64_t *tlohi, int32_t *index, tziPeriodCacheT *cache,
+                                  int64_t const *tsfrom, size_t count);
+
+CDECL_END
+#endif /*TZPERIOD_H_D2078C60_0B6B_439F_B110_087913F54042*/
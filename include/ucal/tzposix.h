@@ -182,6 +182,9 @@ extern bool tziGetInfoUtc2Local(tziConvInfoT *into, tziConvCtxT *ctx, int64_t ts
 /// @note The phase shift 'phi' is zero for most applications.  It may be needed to align cycles
 /// that are multiples of days or cycles that do not cleanly divide a day.
 ///
+/// @note Periods are limited to a week. Calendar units (months, quarters, years) have no fixed
+/// length; see @c tziPeriodRange() in tzperiod.h for those.
+///
 /// @param tlohi    lo/hi range boundaries
 /// @param cvInfo   conversion info at query point
 /// @param ctx      conversion context to evaluate/update
@@ -192,5 +195,16 @@ extern bool tziGetInfoUtc2Local(tziConvInfoT *into, tziConvCtxT *ctx, int64_t ts
 extern bool tziAlignedLocalRange(int64_t tlohi[2], tziConvInfoT *cvInfo, tziConvCtxT *ctx,
                                  int64_t const tsfrom, int32_t period, int32_t phi);
 
+/// @brief get the transition times of a zone for a year
+///
+/// Evaluates the transition rules of a zone for a given year.
+///
+/// @param tt       where to store the transitions, UTC seconds in UNIX scale: STD->DST in
+///                 element 0, DST->STD in element 1
+/// @param zone     zone to evaluate
+/// @param year     calendar year
+/// @return         @c true if the zone has transitions, @c false for fixed zones
+extern bool tziGetTransitions(int64_t tt[2], tziPosixZoneT const *zone, int16_t year);
+
 CDECL_END
 #endif /*TZPOSIX_H_D2078C60_0B6B_439F_B110_087913F54042*/
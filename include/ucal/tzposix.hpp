@@ -0,0 +1,417 @@
+// -*- mode: C++; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// Compile-time POSIX time zone strings for C++20
+// ----------------------------------------------------------------------------------------------
+#ifndef TZPOSIX_HPP_D2078C60_0B6B_439F_B110_087913F54042
+#define TZPOSIX_HPP_D2078C60_0B6B_439F_B110_087913F54042
+
+/// @file
+/// compile-time POSIX time zone strings
+///
+/// A @c constexpr port of @c tziFromPosixSpec() and of the rule evaluation in tzposix.c, for
+/// firmware and services with a fixed zone.  The result is the plain @c tziPosixZoneT of the
+/// C interface, so a zone parsed at compile time can go straight into a conversion context:
+///
+///     constexpr tziPosixZoneT zone = ucal::posix_zone("CET-1CEST,M3.5.0,M10.5.0/3");
+///     tziConvCtxT ctx = { 0, 0, 0, 0, &zone };
+///
+/// The transitions of a range of years can be tabulated at compile time, too.  The code
+/// follows the C implementation step by step; both must give identical results.
+
+#if __cplusplus < 202002L
+# error "tzposix.hpp needs C++20"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include "calconst.h"
+#include "tzposix.h"
+
+namespace ucal {
+
+namespace detail {
+
+// -------------------------------------------------------------------------------------
+// calendar helpers, following ucal_DateToRdnGD(), ucal_WdLE() and ucal_WdGE()
+
+constexpr int64_t
+floor_div(int64_t a, int64_t b) noexcept
+{
+    return a / b - ((a % b) < 0);
+}
+
+constexpr int32_t
+mod7(int32_t a) noexcept
+{
+    return static_cast<int32_t>(a - floor_div(a, 7) * 7);
+}
+
+// RDN of a date; month and day can be off-range
+constexpr int32_t
+date_to_rdn(int32_t y, int32_t m, int32_t d) noexcept
+{
+    int64_t yy = y + floor_div(m - 1, 12);
+    int64_t mm = (m - 1) - floor_div(m - 1, 12) * 12;   // [0,11], March based below
+    if (mm < 2) {
+        mm += 10;
+        yy -= 1;
+    } else {
+        mm -= 2;
+    }
+    int64_t era = floor_div(yy, 400);
+    int64_t yoe = yy - era * 400;
+    int64_t doy = (153 * mm + 2) / 5;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    // day zero of the March based era calendar is 0000-03-01, which is RDN -305
+    return static_cast<int32_t>(era * 146097 + doe - 305 + d - 1);
+}
+
+constexpr int32_t
+wd_le(int32_t rdn, int wd) noexcept
+{
+    return rdn - mod7(rdn - wd);
+}
+
+constexpr int32_t
+wd_ge(int32_t rdn, int wd) noexcept
+{
+    return rdn + mod7(wd - rdn);
+}
+
+constexpr int64_t
+dm2s(int32_t days, int mins) noexcept
+{
+    return 60 * (static_cast<int64_t>(days) * 1440 + mins);
+}
+
+// -------------------------------------------------------------------------------------
+// the parser, following the tzi_ParseXXX() functions
+
+constexpr bool is_upper(int c) noexcept { return (c >= 'A') && (c <= 'Z'); }
+constexpr bool is_digit(int c) noexcept { return (c >= '0') && (c <= '9'); }
+
+struct spec_parser {
+    std::string_view text;
+    std::size_t      pos = 0;
+
+    constexpr int
+    at(std::size_t idx) const noexcept
+    {
+        return static_cast<unsigned char>(text[idx]);
+    }
+
+    constexpr int
+    peek() const noexcept
+    {
+        return (pos != text.size()) ? at(pos) : -1;
+    }
+
+    constexpr bool
+    accept(int xch) noexcept
+    {
+        if (pos == text.size()) {
+            return (-1 == xch);
+        }
+        if (peek() == xch) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    template <std::size_t N>
+    constexpr bool
+    name(char (&into)[N]) noexcept
+    {
+        std::size_t head = pos, ccnt = 0;
+        bool        retv;
+        int         xch;
+
+        if (head == text.size()) {
+            return false;
+        }
+        xch = at(head);
+        if ('<' == xch) {
+            while ((++head != text.size()) && ('>' != (xch = at(head)))) {
+                if ('<' == xch) {
+                    break;
+                } else if (ccnt < N - 1) {
+                    into[ccnt++] = static_cast<char>(xch);
+                }
+            }
+            retv  = (head != text.size()) && ('>' == text[head]);
+            head += retv;
+        } else if (is_upper(xch)) {
+            do {
+                if (ccnt < N - 1) {
+                    into[ccnt++] = static_cast<char>(xch);
+                }
+            } while ((++head != text.size()) && is_upper(xch = at(head)));
+            retv = (3 <= ccnt);
+        } else {
+            retv = false;
+        }
+        if (retv) {
+            pos = head;
+        }
+        return retv;
+    }
+
+    constexpr bool
+    num_bound(int &into, int vmin, int vmax) noexcept
+    {
+        bool cvt = false;
+        int  tmp = 0, xch;
+        while (is_digit(xch = peek())) {
+            cvt = true;
+            tmp = 10 * tmp + (xch - '0');
+            if (tmp > vmax) {
+                tmp /= 10;
+                break;
+            }
+            ++pos;
+        }
+        into = tmp;
+        return cvt && (tmp >= vmin) && (tmp <= vmax);
+    }
+
+    constexpr bool
+    time(int16_t &into, bool isRuleTime) noexcept
+    {
+        constexpr int limits[2][3] = { { 23, 59, 0 }, { 168, 59, 0 } };
+
+        bool nsig = false;
+        bool retv;
+        int  idx = 0, hms[3] = { 0, 0, 0 };
+
+        switch (peek()) {
+        case '-': nsig = true; [[fallthrough]];
+        case '+': ++pos; break;
+        default:  break;
+        }
+        do {
+            retv = num_bound(hms[idx], 0, limits[isRuleTime][idx]);
+        } while (retv && (++idx < 3) && accept(':'));
+        hms[2] = retv ? (60 * hms[0] + hms[1]) : 0;
+        into = static_cast<int16_t>(nsig ? -hms[2] : hms[2]);
+        return retv;
+    }
+
+    constexpr bool
+    rule(tziPosixRuleT &into) noexcept
+    {
+        constexpr int16_t mstart[13] = {
+            0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365
+        };
+
+        bool ret = false;
+        int  mdw[3] = { 0, 0, 0 };
+        int  xch = peek();
+
+        if ('M' == xch) {
+            ++pos;
+            ret = num_bound(mdw[0], 1, 12) && accept('.')
+               && num_bound(mdw[1], 1,  5) && accept('.')
+               && num_bound(mdw[2], 0,  6);
+            if (ret) {
+                into.rt_month = mdw[0];
+                into.rt_mdmw  = mdw[1];
+                into.rt_wday  = ((mdw[2] + 6u) % 7u) + 1;
+            }
+        } else if ('J' == xch) {
+            ++pos;
+            ret = num_bound(mdw[1], 1, 365);
+            if (ret) {
+                int m = 0;
+                while (mstart[m + 1] < mdw[1]) {
+                    ++m;
+                }
+                into.rt_month = m + 1;
+                into.rt_mdmw  = mdw[1] - mstart[m];
+                into.rt_wday  = 0;
+            }
+        } else if (is_digit(xch)) {
+            ret = num_bound(mdw[1], 0, 365);
+            if (ret) {
+                into.rt_month = 1;
+                into.rt_mdmw  = mdw[1] + 1;
+                into.rt_wday  = 0;
+            }
+        }
+        if (ret && accept('/')) {
+            int16_t tmp = 0;
+            ret = time(tmp, true);
+            into.rt_ttloc = tmp;
+        } else {
+            into.rt_ttloc = 120;
+        }
+        return ret;
+    }
+};
+
+} // namespace detail
+
+// -------------------------------------------------------------------------------------
+
+/// @brief parse a POSIX zone spec, like @c tziFromPosixSpec()
+/// @param into     time zone info to fill
+/// @param spec     zone spec
+/// @return         number of characters consumed, or @c std::string_view::npos on error
+constexpr std::size_t
+from_posix_spec(tziPosixZoneT &into, std::string_view spec) noexcept
+{
+    detail::spec_parser ctx{ spec };
+    std::size_t         head;
+    bool                retv;
+
+    into = tziPosixZoneT{};
+    retv = ctx.name(into.stdName) && ctx.time(into.stdOffs, false);
+    if (retv && ctx.name(into.dstName)) {
+        // POSIX / US default rules
+        into.dstRule = tziPosixRuleT{ 3, 2, 7, 120 };
+        into.stdRule = tziPosixRuleT{ 11, 1, 7, 120 };
+
+        head = ctx.pos;
+        if (!ctx.time(into.dstOffs, false)) {
+            ctx.pos = head;
+            into.dstOffs = static_cast<int16_t>(into.stdOffs - 60);
+        }
+        if (retv && (',' == ctx.peek())) {
+            retv = ctx.accept(',') && ctx.rule(into.dstRule)
+                && ctx.accept(',') && ctx.rule(into.stdRule);
+        }
+        if (  retv
+           && (1 == into.dstRule.rt_month) && (1 == into.dstRule.rt_mdmw)
+           && (0 == into.dstRule.rt_wday) && (0 == into.dstRule.rt_ttloc)) {
+            into.stdRule = tziPosixRuleT{};
+        }
+    }
+    return retv ? ctx.pos : std::string_view::npos;
+}
+
+/// @brief parse a complete POSIX zone spec
+///
+/// In a constant expression, an invalid spec stops the compilation.
+/// @param spec     zone spec; must be consumed completely
+/// @return         the zone
+/// @throw std::invalid_argument if the spec is invalid
+constexpr tziPosixZoneT
+posix_zone(std::string_view spec)
+{
+    tziPosixZoneT zone{};
+    if (from_posix_spec(zone, spec) != spec.size()) {
+        throw std::invalid_argument("invalid POSIX time zone spec");
+    }
+    return zone;
+}
+
+/// @brief compare two zones field by field
+constexpr bool
+same_zone(tziPosixZoneT const &a, tziPosixZoneT const &b) noexcept
+{
+    auto sameRule = [](tziPosixRuleT const &x, tziPosixRuleT const &y) {
+        return (x.rt_month == y.rt_month) && (x.rt_mdmw == y.rt_mdmw)
+            && (x.rt_wday == y.rt_wday) && (x.rt_ttloc == y.rt_ttloc);
+    };
+    for (std::size_t i = 0; i < sizeof(a.stdName); ++i) {
+        if ((a.stdName[i] != b.stdName[i]) || (a.dstName[i] != b.dstName[i])) {
+            return false;
+        }
+    }
+    return (a.stdOffs == b.stdOffs) && (a.dstOffs == b.dstOffs)
+        && sameRule(a.stdRule, b.stdRule) && sameRule(a.dstRule, b.dstRule);
+}
+
+/// @brief evaluate a transition rule for a year
+/// @param rule     rule to evaluate
+/// @param year     calendar year
+/// @return         RDN of the transition day
+constexpr int32_t
+eval_rule(tziPosixRuleT const &rule, int16_t year) noexcept
+{
+    int32_t rdn;
+    if (rule.rt_wday) {
+        if (5 == rule.rt_mdmw) {
+            rdn = detail::date_to_rdn(year, rule.rt_month + 1, 0);
+            rdn = detail::wd_le(rdn, rule.rt_wday);
+        } else {
+            rdn = detail::date_to_rdn(year, rule.rt_month, 1);
+            rdn = detail::wd_ge(rdn, rule.rt_wday);
+            rdn += (rule.rt_mdmw - 1) * 7;
+        }
+    } else {
+        rdn = detail::date_to_rdn(year, rule.rt_month, rule.rt_mdmw);
+    }
+    return rdn;
+}
+
+/// @brief get the transition times of a zone for a year, like @c tziGetTransitions()
+/// @param zone     zone to evaluate
+/// @param year     calendar year
+/// @return         UTC seconds in UNIX scale, STD->DST first and DST->STD second; nothing
+///                 for fixed zones
+constexpr std::optional<std::array<int64_t, 2>>
+transitions(tziPosixZoneT const &zone, int16_t year) noexcept
+{
+    if ((0 == zone.dstRule.rt_month) || (0 == zone.stdRule.rt_month)) {
+        return std::nullopt;
+    }
+    return std::array<int64_t, 2>{
+        detail::dm2s(eval_rule(zone.dstRule, year) - UCAL_rdnUNIX,
+                     zone.dstRule.rt_ttloc + zone.stdOffs),
+        detail::dm2s(eval_rule(zone.stdRule, year) - UCAL_rdnUNIX,
+                     zone.stdRule.rt_ttloc + zone.dstOffs)
+    };
+}
+
+/// @brief transitions of one year
+struct year_transitions {
+    int16_t year;   ///< calendar year
+    int64_t ttDST;  ///< transition STD --> DST, UTC seconds in UNIX scale
+    int64_t ttSTD;  ///< transition DST --> STD, UTC seconds in UNIX scale
+};
+
+/// @brief tabulate the transitions of a zone for a range of years
+/// @tparam Y0      first year
+/// @tparam N       number of years
+/// @param zone     zone to evaluate
+/// @return         the transitions of the years @c Y0 to @c Y0+N-1
+/// @throw std::invalid_argument if the zone has no transitions
+template <int16_t Y0, std::size_t N>
+constexpr std::array<year_transitions, N>
+transition_table(tziPosixZoneT const &zone)
+{
+    static_assert(Y0 + static_cast<int32_t>(N) - 1 <= INT16_MAX, "year range overflow");
+
+    std::array<year_transitions, N> tab{};
+    for (std::size_t i = 0; i < N; ++i) {
+        int16_t const year = static_cast<int16_t>(Y0 + i);
+        auto const    tt   = transitions(zone, year);
+        if (!tt) {
+            throw std::invalid_argument("zone has no transitions");
+        }
+        tab[i] = year_transitions{ year, (*tt)[0], (*tt)[1] };
+    }
+    return tab;
+}
+
+} // namespace ucal
+
+#endif /*TZPOSIX_HPP_D2078C60_0B6B_439F_B110_087913F54042*/
@@ -0,0 +1,82 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// Re-zoning of stored local time stamps after a change of the zone rules
+// ----------------------------------------------------------------------------------------------
+#ifndef TZREZONE_H_D2078C60_0B6B_439F_B110_087913F54042
+#define TZREZONE_H_D2078C60_0B6B_439F_B110_087913F54042
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "tzposix.h"
+
+CDECL_BEG
+
+/// @brief an interval where old and new zone rules give different offsets
+///
+/// The interval is given in UTC and in the local time of the old rules.  Where the old rules
+/// step back at the start of the interval, the local times shown twice are left to the
+/// interval before: a stored local time in an overlap is taken as its first occurrence.
+typedef struct tziRezone_S {
+    int64_t utcLo;      ///< start of the interval, UTC seconds in UNIX scale
+    int64_t utcHi;      ///< end of the interval (exclusive)
+    int64_t locLo;      ///< start of the interval, old local time
+    int64_t locHi;      ///< end of the interval (exclusive), old local time
+    int32_t offsOld;    ///< offset (local - UTC) in seconds with the old rules
+    int32_t offsNew;    ///< offset (local - UTC) in seconds with the new rules
+} tziRezoneT;
+
+/// @brief find the intervals where two zone descriptions differ
+///
+/// Sweeps over the transitions of both zones, year by year, and collects the UTC intervals
+/// where the offsets differ, in ascending order.  Adjacent intervals with the same offsets are
+/// merged.  The result covers the calendar years @c ylo to @c yhi, taken in UTC.
+///
+/// Like @c snprintf(), the function returns the number of intervals found, even if that is
+/// more than @c cap; only the first @c cap of them are stored.
+///
+/// @note Sets @c errno to @c EINVAL for @c NULL zones or @c ylo>yhi.
+///
+/// @param into     where to store the intervals; can be @c NULL if @c cap is zero
+/// @param cap      number of intervals @c into can hold
+/// @param zold     zone description the stored time stamps were made with
+/// @param znew     new zone description
+/// @param ylo      first year to cover
+/// @param yhi      last year to cover
+/// @return         number of intervals; zero on error
+extern size_t tziRezoneIntervals(tziRezoneT *into, size_t cap, tziPosixZoneT const *zold,
+                                 tziPosixZoneT const *znew, int16_t ylo, int16_t yhi);
+
+/// @brief rewrite a column of local time stamps for new zone rules
+///
+/// The column holds local time stamps made with the old rules, sorted ascending.  For every
+/// interval, the rows in its old local time range are found with a galloping search from the
+/// end of the previous interval, and moved by the difference of the offsets.  The work is
+/// proportional to the number of rows changed, plus a logarithmic search per interval.
+///
+/// Rows in a gap of the old rules do not map to a UTC instant and stay as they are.  The
+/// column may be out of order afterwards, where the new rules step back.
+///
+/// @param tsloc    local time stamps, seconds in UNIX scale; sorted ascending
+/// @param count    number of rows
+/// @param iv       intervals from @c tziRezoneIntervals()
+/// @param niv      number of intervals
+/// @return         number of rows changed
+extern size_t tziRezoneColumn(int64_t *tsloc, size_t count, tziRezoneT const *iv, size_t niv);
+
+CDECL_END
+#endif /*TZREZONE_H_D2078C60_0B6B_439F_B110_087913F54042*/
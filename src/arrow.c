@@ -0,0 +1,520 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module converts Apache Arrow temporal arrays.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// conversions on Arrow arrays
+///
+/// The input is read in place, through its offset and validity bitmap.  It is converted in
+/// chunks: the values are scaled to seconds, nulls and values out of range are replaced by
+/// the last good value so they do not disturb the zone cache, the chunk goes through
+/// @c tziBatchUtc2Local(), and the results are written to the caller's buffers.  The export
+/// only describes those buffers; nothing is allocated, and the release callbacks just mark
+/// the structures released.
+
+#include <errno.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzbatch.h"
+#include "ucal/arrow.h"
+
+// elements per chunk; a multiple of 8, so chunks start on validity bytes
+#define ARW_CHUNK 256
+
+// Days around 1970 the conversions accept.  This keeps the years, and the years next to them
+// the zone rules look at, well inside 16 bits.
+#define ARW_DAYLIM INT64_C(11000000)
+
+// the input, with the offset applied
+typedef struct {
+    const uint8_t  *valid;  // validity bitmap, or NULL if all valid
+    int64_t         vbit;   // bit of the first element in 'valid'
+    const void     *data;   // first value
+    ucal_ArrowTypeT type;
+    int32_t         perSec;
+    tziConvCtxT    *ctx;    // zone to convert to, NULL for none
+    int64_t         last;   // last good value, in seconds
+} arw_SrcT;
+
+static const char * const s_fieldName[UCAL_ARROW_FIELDS] = {
+    "year", "month", "day", "hour", "minute", "second"
+};
+
+// floor division by a positive divisor
+static inline int64_t
+arw_FloorDiv(
+    int64_t v,
+    int64_t d)
+{
+    int64_t const q = v / d;
+    return q - ((v % d) < 0);
+}
+
+static inline bool
+arw_IsValid(
+    arw_SrcT const *src,
+    size_t          idx)
+{
+    uint64_t const bit = (uint64_t)src->vbit + idx;
+    return !src->valid || ((src->valid[bit >> 3] >> (bit & 7)) & 1);
+}
+
+// the value in seconds; cannot overflow, as the largest values are int32 days
+static inline int64_t
+arw_Seconds(
+    arw_SrcT const *src,
+    size_t          idx)
+{
+    switch (src->type) {
+    case ucal_ArrowType_Date32:
+        return (int64_t)((int32_t const*)src->data)[idx] * 86400;
+    case ucal_ArrowType_Date64:
+        return arw_FloorDiv(((int64_t const*)src->data)[idx], 1000);
+    default:
+        return arw_FloorDiv(((int64_t const*)src->data)[idx], src->perSec);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// Get the local seconds of a chunk.  'ok' tells the good elements; the others have the
+// seconds of the last good one.  With 'valid', the validity goes there, too.
+static bool
+arw_Chunk(
+    int64_t  *secs ,
+    uint8_t  *ok   ,
+    uint8_t  *valid,
+    size_t   *nfail,
+    arw_SrcT *src  ,
+    size_t    beg  ,
+    size_t    n    )
+{
+    int32_t offs[ARW_CHUNK];
+    size_t  idx;
+
+    for (idx = 0; idx < n; ++idx) {
+        bool good = arw_IsValid(src, beg + idx);
+        if (good) {
+            int64_t const s = arw_Seconds(src, beg + idx);
+            if ((s >= -ARW_DAYLIM * 86400) && (s < ARW_DAYLIM * 86400)) {
+                src->last = s;
+            } else {
+                good    = false;
+                *nfail += 1;
+            }
+        }
+        secs[idx] = src->last;
+        ok[idx]   = good;
+    }
+    if (valid) {
+        for (idx = 0; idx < n; idx += 8) {
+            uint8_t byte = 0;
+            size_t  bit;
+            for (bit = 0; (bit < 8) && (idx + bit < n); ++bit) {
+                byte |= (uint8_t)(ok[idx + bit] << bit);
+            }
+            valid[(beg + idx) >> 3] = byte;
+        }
+    }
+    if (src->ctx) {
+        if (!tziBatchUtc2Local(offs, NULL, src->ctx, secs, n)) {
+            return false;
+        }
+        for (idx = 0; idx < n; ++idx) {
+            secs[idx] += offs[idx];
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// Check the arguments and set up the source.  'zone' and 'zctx' take the zone of the type if
+// there is no context.
+static bool
+arw_Setup(
+    arw_SrcT                *src ,
+    tziPosixZoneT           *zone,
+    tziConvCtxT             *zctx,
+    tziConvCtxT             *ctx ,
+    struct ArrowArray const *in  ,
+    ucal_ArrowTimeT const   *type)
+{
+    if ((NULL == in) || (NULL == type) || (NULL == in->release) || (in->length < 0)
+        || (in->offset < 0) || (in->n_buffers != 2) || (NULL == in->buffers)
+        || (in->length && (NULL == in->buffers[1])) || (ctx && (NULL == ctx->pTZI))) {
+        errno = EINVAL;
+        return false;
+    }
+    memset(src, 0, sizeof(*src));
+    src->type   = type->type;
+    src->perSec = type->perSec;
+    if ((ucal_ArrowType_Timestamp == type->type) && (src->perSec <= 0)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (in->null_count && in->buffers[0]) {
+        src->valid = (const uint8_t*)in->buffers[0];
+        src->vbit  = in->offset;
+    }
+    if (ucal_ArrowType_Date32 == type->type) {
+        src->data = (int32_t const*)in->buffers[1] + in->offset;
+    } else {
+        src->data = (int64_t const*)in->buffers[1] + in->offset;
+    }
+
+    // only time stamps with a zone are UTC; the others are local already
+    if ((ucal_ArrowType_Timestamp == type->type) && type->tzname) {
+        if (NULL == ctx) {
+            if (!ucal_ArrowZone(zone, type->tzname)) {
+                return false;
+            }
+            memset(zctx, 0, sizeof(*zctx));
+            zctx->pTZI = zone;
+            ctx = zctx;
+        }
+        src->ctx = ctx;
+    }
+    return true;
+}
+
+// Decide on the validity of the result: none, the bitmap of the input, or the combined one.
+static bool
+arw_Validity(
+    const void    **into ,
+    int64_t        *nulls,
+    uint8_t const  *valid,
+    arw_SrcT const *src  ,
+    size_t          nbad ,
+    size_t          nfail)
+{
+    *nulls = (int64_t)nbad;
+    if (0 == nbad) {
+        *into = NULL;
+    } else if ((0 == nfail) && (0 == (src->vbit & 7))) {
+        *into = src->valid + (src->vbit >> 3);
+    } else if (valid) {
+        *into = valid;
+    } else {
+        errno = nfail ? ERANGE : EINVAL;
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// export
+// ----------------------------------------------------------------------------------------------
+
+static void
+arw_ReleaseArray(
+    struct ArrowArray *arr)
+{
+    ucal_ArrowOutT * const out = (ucal_ArrowOutT*)arr->private_data;
+    int64_t                idx;
+
+    for (idx = 0; idx < arr->n_children; ++idx) {
+        struct ArrowArray * const ch = arr->children[idx];
+        if (ch->release) {
+            ch->release(ch);
+        }
+    }
+    arr->release = NULL;
+    if (out && out->onRelease) {
+        out->onRelease(out->arg);
+    }
+}
+
+static void
+arw_ReleaseSchema(
+    struct ArrowSchema *sch)
+{
+    int64_t idx;
+
+    for (idx = 0; idx < sch->n_children; ++idx) {
+        struct ArrowSchema * const ch = sch->children[idx];
+        if (ch->release) {
+            ch->release(ch);
+        }
+    }
+    sch->release = NULL;
+}
+
+// fill an array and its schema; 'owner' is set for the top level only
+static void
+arw_Describe(
+    struct ArrowArray  *arr     ,
+    struct ArrowSchema *sch     ,
+    const void        **buffers ,
+    int64_t             nbuffers,
+    ucal_ArrowOutT     *owner   ,
+    const char         *format  ,
+    const char         *name    ,
+    int64_t             length  ,
+    int64_t             nulls   )
+{
+    memset(arr, 0, sizeof(*arr));
+    arr->length       = length;
+    arr->null_count   = nulls;
+    arr->n_buffers    = nbuffers;
+    arr->buffers      = buffers;
+    arr->release      = arw_ReleaseArray;
+    arr->private_data = owner;
+
+    memset(sch, 0, sizeof(*sch));
+    sch->format       = format;
+    sch->name         = name;
+    sch->flags        = ARROW_FLAG_NULLABLE;
+    sch->release      = arw_ReleaseSchema;
+    sch->private_data = owner;
+}
+
+// ----------------------------------------------------------------------------------------------
+// API
+// ----------------------------------------------------------------------------------------------
+
+bool
+ucal_ArrowGetType(
+    ucal_ArrowTimeT          *into  ,
+    struct ArrowSchema const *schema)
+{
+    const char *fmt;
+
+    if ((NULL == into) || (NULL == schema) || (NULL == (fmt = schema->format))) {
+        errno = EINVAL;
+        return false;
+    }
+    memset(into, 0, sizeof(*into));
+    if (!strcmp(fmt, "tdD")) {
+        into->type = ucal_ArrowType_Date32;
+    } else if (!strcmp(fmt, "tdm")) {
+        into->type   = ucal_ArrowType_Date64;
+        into->perSec = 1000;
+    } else if (!strncmp(fmt, "ts", 2) && fmt[2] && (':' == fmt[3])) {
+        into->type = ucal_ArrowType_Timestamp;
+        switch (fmt[2]) {
+        case 's': into->perSec = 1;          break;
+        case 'm': into->perSec = 1000;       break;
+        case 'u': into->perSec = 1000000;    break;
+        case 'n': into->perSec = 1000000000; break;
+        default :
+            errno = EINVAL;
+            return false;
+        }
+        into->tzname = fmt[4] ? fmt + 4 : NULL;
+    } else {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+ucal_ArrowZone(
+    tziPosixZoneT *into  ,
+    const char    *tzname)
+{
+    const char *end;
+    char        spec[16];
+
+    if ((NULL == into) || (NULL == tzname)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!strcmp(tzname, "UTC") || !strcmp(tzname, "Etc/UTC") || !strcmp(tzname, "Z")) {
+        tzname = "UTC0";
+    } else if ((('+' == tzname[0]) || ('-' == tzname[0])) && (6 == strlen(tzname))) {
+        // '+hh:mm' is east of Greenwich; POSIX counts the other way round
+        if ((tzname[1] < '0') || (tzname[1] > '2') || (tzname[2] < '0') || (tzname[2] > '9')
+            || (':' != tzname[3]) || (tzname[4] < '0') || (tzname[4] > '5')
+            || (tzname[5] < '0') || (tzname[5] > '9')) {
+            errno = EINVAL;
+            return false;
+        }
+        spec[0] = '<';
+        memcpy(spec + 1, tzname, 6);
+        spec[7] = '>';
+        spec[8] = ('+' == tzname[0]) ? '-' : '+';
+        memcpy(spec + 9, tzname + 1, 5);
+        spec[14] = '\0';
+        tzname   = spec;
+    }
+    end = tziFromPosixSpec(into, tzname, NULL);
+    if ((NULL == end) || *end) {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+ucal_ArrowToDate32(
+    ucal_ArrowOutT          *out  ,
+    int32_t                 *days ,
+    uint8_t                 *valid,
+    tziConvCtxT             *ctx  ,
+    struct ArrowArray const *in   ,
+    ucal_ArrowTimeT const   *type )
+{
+    int64_t       secs[ARW_CHUNK];
+    uint8_t       ok[ARW_CHUNK];
+    arw_SrcT      src;
+    tziPosixZoneT zone;
+    tziConvCtxT   zctx;
+    size_t        len, beg, idx, nbad = 0, nfail = 0;
+    int64_t       nulls;
+
+    if ((NULL == out) || ((NULL == days) && in && in->length)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!arw_Setup(&src, &zone, &zctx, ctx, in, type)) {
+        return false;
+    }
+    len = (size_t)in->length;
+    for (beg = 0; beg < len; beg += ARW_CHUNK) {
+        size_t const n = (len - beg < ARW_CHUNK) ? (len - beg) : ARW_CHUNK;
+        if (!arw_Chunk(secs, ok, valid, &nfail, &src, beg, n)) {
+            return false;
+        }
+        for (idx = 0; idx < n; ++idx) {
+            days[beg + idx] = ok[idx] ? (int32_t)arw_FloorDiv(secs[idx], 86400) : 0;
+            nbad += !ok[idx];
+        }
+    }
+    if (!arw_Validity(&out->buf[0], &nulls, valid, &src, nbad, nfail)) {
+        return false;
+    }
+    out->buf[1] = days;
+    arw_Describe(&out->array, &out->schema, out->buf, 2, out, "tdD", NULL, in->length, nulls);
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+ucal_ArrowToFields(
+    ucal_ArrowOutT          *out   ,
+    ucal_ArrowFieldsT const *fields,
+    uint8_t                 *valid ,
+    tziConvCtxT             *ctx   ,
+    struct ArrowArray const *in    ,
+    ucal_ArrowTimeT const   *type  )
+{
+    int64_t         secs[ARW_CHUNK];
+    uint8_t         ok[ARW_CHUNK];
+    arw_SrcT        src;
+    tziPosixZoneT   zone;
+    tziConvCtxT     zctx;
+    ucal_CivilDateT cd;
+    int64_t         dcur = INT64_MIN;
+    size_t          len, beg, idx, nbad = 0, nfail = 0;
+    int64_t         nulls, nch;
+    void           *data[UCAL_ARROW_FIELDS];
+
+    if ((NULL == out) || (NULL == fields)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!arw_Setup(&src, &zone, &zctx, ctx, in, type)) {
+        return false;
+    }
+    data[0] = fields->year;
+    data[1] = fields->month;
+    data[2] = fields->day;
+    data[3] = fields->hour;
+    data[4] = fields->minute;
+    data[5] = fields->second;
+    for (idx = 0, nch = 0; idx < UCAL_ARROW_FIELDS; ++idx) {
+        nch += (NULL != data[idx]);
+    }
+    if (0 == nch) {
+        errno = EINVAL;
+        return false;
+    }
+
+    memset(&cd, 0, sizeof(cd));
+    len = (size_t)in->length;
+    for (beg = 0; beg < len; beg += ARW_CHUNK) {
+        size_t const n = (len - beg < ARW_CHUNK) ? (len - beg) : ARW_CHUNK;
+        if (!arw_Chunk(secs, ok, valid, &nfail, &src, beg, n)) {
+            return false;
+        }
+        for (idx = 0; idx < n; ++idx) {
+            size_t const k   = beg + idx;
+            int32_t      sod = 0;
+            int16_t      y   = 0;
+            int8_t       m   = 0, d = 0;
+            if (ok[idx]) {
+                int64_t const day = arw_FloorDiv(secs[idx], 86400);
+                if (day != dcur) {
+                    (void)ucal_RdnToDateGD(&cd, (int32_t)day + UCAL_rdnUNIX);
+                    dcur = day;
+                }
+                sod = (int32_t)(secs[idx] - day * 86400);
+                y   = cd.dYear;
+                m   = cd.dMonth;
+                d   = cd.dMDay;
+            } else {
+                nbad += 1;
+            }
+            if (fields->year) {
+                fields->year[k] = y;
+            }
+            if (fields->month) {
+                fields->month[k] = m;
+            }
+            if (fields->day) {
+                fields->day[k] = d;
+            }
+            if (fields->hour) {
+                fields->hour[k] = (int8_t)(sod / 3600);
+            }
+            if (fields->minute) {
+                fields->minute[k] = (int8_t)(sod / 60 % 60);
+            }
+            if (fields->second) {
+                fields->second[k] = (int8_t)(sod % 60);
+            }
+        }
+    }
+    if (!arw_Validity(&out->buf[0], &nulls, valid, &src, nbad, nfail)) {
+        return false;
+    }
+
+    // the children share the validity of the struct
+    arw_Describe(&out->array, &out->schema, out->buf, 1, out, "+s", NULL, in->length, nulls);
+    out->array.n_children  = nch;
+    out->array.children    = out->childArr;
+    out->schema.n_children = nch;
+    out->schema.children   = out->childSch;
+    for (idx = 0, nch = 0; idx < UCAL_ARROW_FIELDS; ++idx) {
+        if (data[idx]) {
+            out->childBuf[nch][0] = out->buf[0];
+            out->childBuf[nch][1] = data[idx];
+            out->childArr[nch]    = &out->child[nch];
+            out->childSch[nch]    = &out->childSchema[nch];
+            arw_Describe(&out->child[nch], &out->childSchema[nch], out->childBuf[nch], 2, NULL,
+                         idx ? "c" : "s", s_fieldName[idx], in->length, nulls);
+            ++nch;
+        }
+    }
+    return true;
+}
+
+// -*- that's all folks -*-
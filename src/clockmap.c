@@ -0,0 +1,292 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the monotonic clock to UTC mapping and the nanosecond civil split.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// mapping trace clocks to civil time
+///
+/// Kernel and perf traces stamp events with CLOCK_MONOTONIC or CLOCK_BOOTTIME nanoseconds.
+/// Mapping them to UTC needs anchor pairs (both clocks read at the same instant) and, between
+/// the anchors, a correction for the drift of the real time clock against the monotonic one
+/// (which is what NTP disciplines).  The map is piecewise linear: every segment has an anchor
+/// and a rate, and the rate is stored as a small fixed point deviation from one.  Applying it
+/// needs two integer multiplications, exact to the floor, and no floating point at all.
+///
+/// With @c UCAL_CLK_DRIFT_BITS fraction bits in a 32bit drift, deviations of up to 1/512 can
+/// be expressed with a resolution of about 1ns per 1000s.  Anything beyond is not drift, but a
+/// step of the real time clock.
+
+#include <errno.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/clockmap.h"
+
+static const int64_t clk_nsDay = INT64_C(86400000000000);
+static const int32_t clk_nsSec = INT32_C(1000000000);
+
+// ----------------------------------------------------------------------------------------------
+// clock map
+// ----------------------------------------------------------------------------------------------
+
+// Scale a time difference by the drift: floor(dm * drift / 2^UCAL_CLK_DRIFT_BITS).  The
+// difference is split into 32bit halves to keep all products in 64 bits; since the high
+// part scales by a power of two, the floor of the sum is exact.
+static inline int64_t
+clk_Scale(
+    int64_t dm   ,
+    int32_t drift)
+{
+    int64_t hi = ucal_i64Asr(dm, 32);
+    int64_t lo = (int64_t)(uint32_t)dm;
+    int64_t p  = hi * drift + ucal_i64Asr(lo * drift, 32);
+    return ucal_i64Asr(p, UCAL_CLK_DRIFT_BITS - 32);
+}
+
+static inline int64_t
+clk_Apply(
+    ucal_ClkSegT const *seg ,
+    int64_t             mono)
+{
+    int64_t dm = mono - seg->mono;
+    return seg->real + dm + clk_Scale(dm, seg->drift);
+}
+
+// Find the segment for a time stamp: the last one starting at or before it, or the first one.
+static size_t
+clk_Find(
+    ucal_ClockMapT const *map ,
+    int64_t               mono)
+{
+    size_t lo = 0, hi = map->nseg;
+
+    while (hi - lo > 1) {
+        size_t mid = lo + ((hi - lo) >> 1);
+        if (map->seg[mid].mono <= mono) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Fit the drift of a segment from the time differences of its anchors.  The quotient
+// (dr - dm) * 2^UCAL_CLK_DRIFT_BITS / dm is done as a long division in chunks of as many bits as
+// the remainder can be shifted up without overflow.
+static bool
+clk_Fit(
+    int32_t *into,
+    uint64_t dm  ,
+    int64_t  dr  )
+{
+    int64_t  dev = dr - (int64_t)dm;
+    uint64_t r   = (dev < 0) ? -(uint64_t)dev : (uint64_t)dev;
+    uint64_t q   = 0;
+    unsigned bits, room;
+
+    if ((dm > INT64_MAX) || (r >= (dm >> 9))) {
+        return false;
+    }
+    for (room = 0; 0 == (dm >> (63 - room)); ++room) {
+        // count the leading zeros of the divider
+    }
+    for (bits = UCAL_CLK_DRIFT_BITS; bits; ) {
+        unsigned s = (bits < room) ? bits : room;
+        r <<= s;
+        q   = (q << s) + r / dm;
+        r  %= dm;
+        bits -= s;
+    }
+    q += (r >= dm - r);     // round to nearest
+    if (q > INT32_MAX) {
+        q = INT32_MAX;      // rounding right at the limit
+    }
+    *into = (dev < 0) ? -(int32_t)q : (int32_t)q;
+    return true;
+}
+
+void
+ucal_ClockMapInit(
+    ucal_ClockMapT *map,
+    ucal_ClkSegT   *buf,
+    size_t          cap)
+{
+    map->seg  = buf;
+    map->nseg = 0;
+    map->cap  = cap;
+}
+
+bool
+ucal_ClockMapAddAnchor(
+    ucal_ClockMapT *map ,
+    int64_t         mono,
+    int64_t         real)
+{
+    ucal_ClkSegT *seg;
+
+    if ((NULL == map) || (map->nseg && (mono <= map->seg[map->nseg - 1].mono))) {
+        errno = EINVAL;
+        return false;
+    }
+    if (map->nseg >= map->cap) {
+        errno = ERANGE;
+        return false;
+    }
+
+    seg = &map->seg[map->nseg];
+    seg->mono  = mono;
+    seg->real  = real;
+    seg->drift = 0;
+    if (map->nseg) {
+        // close the previous segment; on a step, it keeps the rate it was extrapolated with
+        ucal_ClkSegT *prev = seg - 1;
+        int32_t       drift;
+        if (clk_Fit(&drift, (uint64_t)mono - (uint64_t)prev->mono, real - prev->real)) {
+            prev->drift = drift;
+        }
+        seg->drift = prev->drift;
+    }
+    ++map->nseg;
+    return true;
+}
+
+int64_t
+ucal_ClockMapToReal(
+    ucal_ClockMapT const *map ,
+    int64_t               mono)
+{
+    if (0 == map->nseg) {
+        return mono;
+    }
+    return clk_Apply(&map->seg[clk_Find(map, mono)], mono);
+}
+
+void
+ucal_ClockMapConvert(
+    ucal_ClockMapT const *map  ,
+    int64_t              *real ,
+    int64_t const        *mono ,
+    size_t                count)
+{
+    ucal_ClkSegT const *seg;
+    int64_t             lo, hi;     // range of the current segment
+    size_t              idx, sidx;
+
+    if (0 == map->nseg) {
+        memmove(real, mono, count * sizeof(*real));
+        return;
+    }
+
+    lo = 1;
+    hi = 0;
+    seg = map->seg;
+    for (idx = 0; idx < count; ++idx) {
+        int64_t m = mono[idx];
+        if ((m < lo) || (m >= hi)) {
+            sidx = clk_Find(map, m);
+            seg  = &map->seg[sidx];
+            lo   = sidx ? seg->mono : INT64_MIN;
+            hi   = (sidx + 1 < map->nseg) ? seg[1].mono : INT64_MAX;
+        }
+        real[idx] = clk_Apply(seg, m);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// fused civil split
+// ----------------------------------------------------------------------------------------------
+
+// split nanoseconds of the day into time and nanoseconds; the divisions are by constants
+static inline void
+clk_SplitDay(
+    ucal_CivilTimeT *time,
+    uint32_t        *nsec,
+    int64_t          nsd )
+{
+    uint32_t s = (uint32_t)(nsd / clk_nsSec);
+    uint32_t h = s / 3600u;
+    uint32_t r = s - h * 3600u;
+    uint32_t m = r / 60u;
+
+    time->tHour = (int8_t)h;
+    time->tMin  = (int8_t)m;
+    time->tSec  = (int8_t)(r - m * 60u);
+    if (nsec) {
+        *nsec = (uint32_t)(nsd - (int64_t)s * clk_nsSec);
+    }
+}
+
+// floor division by the length of a day
+static inline int64_t
+clk_SplitNs(
+    int64_t *nsd,
+    int64_t  ns )
+{
+    int64_t d = ns / clk_nsDay;
+    int64_t r = ns % clk_nsDay;
+
+    if (r < 0) {
+        r += clk_nsDay;
+        --d;
+    }
+    *nsd = r;
+    return d;
+}
+
+void
+ucal_NsToCivilGD(
+    ucal_CivilDateT *date,
+    ucal_CivilTimeT *time,
+    uint32_t        *nsec,
+    int64_t          ns  )
+{
+    int64_t nsd;
+    int64_t d = clk_SplitNs(&nsd, ns);
+
+    // +/-292 years around 1970 always fit the date
+    (void)ucal_RdnToDateGD(date, (int32_t)d + UCAL_rdnUNIX);
+    clk_SplitDay(time, nsec, nsd);
+}
+
+void
+ucal_NsToCivilArrayGD(
+    ucal_CivilDateT *date ,
+    ucal_CivilTimeT *time ,
+    uint32_t        *nsec ,
+    int64_t const   *ns   ,
+    size_t           count)
+{
+    ucal_CivilDateT cd;
+    int64_t         dcur = INT64_MIN;   // current day, since 1970
+    size_t          idx;
+
+    memset(&cd, 0, sizeof(cd));
+    for (idx = 0; idx < count; ++idx) {
+        int64_t nsd;
+        int64_t d = clk_SplitNs(&nsd, ns[idx]);
+        if (d != dcur) {
+            (void)ucal_RdnToDateGD(&cd, (int32_t)d + UCAL_rdnUNIX);
+            dcur = d;
+        }
+        date[idx] = cd;
+        clk_SplitDay(&time[idx], nsec ? &nsec[idx] : NULL, nsd);
+    }
+}
+
+// -*- that's all folks -*-
@@ -235,6 +235,62 @@ ucal_TimeToRdn(
     return qr;
 }
 
+ucal_i64u32DivT
+ucal_NsToSecs(
+    ucal_ns_t ns)
+{
+    if (sizeof(ucal_ns_t) <= sizeof(size_t)) {
+        // unsigned floor division by a constant; the compiler makes a multiplication of it
+        size_t m = -(ns < 0);
+        size_t q = m ^ ((m ^ (size_t)ns) / 1000000000u);
+        return (ucal_i64u32DivT){
+            .q = m ? -(int64_t)(~q) - 1 : (int64_t)q,
+            .r = (uint32_t)ns - (uint32_t)q * 1000000000u
+        };
+    } else {
+        // 10⁹ shifted left by 2 is normalised
+        return ucal_i64u32DivGM(ns, UINT32_C(0xee6b2800), UINT32_C(0x12e0be82), 2);
+    }
+}
+
+ucal_TimeDivT
+ucal_NsToRdn(
+    ucal_ns_t ns  ,
+    uint32_t *nsec)
+{
+    ucal_i64u32DivT sn = ucal_NsToSecs(ns);
+    ucal_TimeDivT   qr;
+
+    // The seconds may not fit a 32-bit 'time_t', so split the days in 64 bits; the days
+    // themselves always fit.
+    ucal_i64u32DivT ds = ucal_i64u32DivGM(sn.q, 0xa8c00000, 0x845c8a0c, 15);
+    qr.q = (time_t)ds.q + UCAL_rdnUNIX;
+    qr.r = ds.r;
+    if (nsec) {
+        *nsec = sn.r;
+    }
+    return qr;
+}
+
+ucal_ns_t
+ucal_TimespecToNs(
+    const struct timespec *ts)
+{
+    // unsigned, as the product alone overflows for the lowest second of the range
+    return ucal_u64_i64((uint64_t)ts->tv_sec * 1000000000u + (uint64_t)ts->tv_nsec);
+}
+
+void
+ucal_NsToTimespec(
+    struct timespec *into,
+    ucal_ns_t        ns  )
+{
+    ucal_i64u32DivT sn = ucal_NsToSecs(ns);
+
+    into->tv_sec  = (time_t)sn.q;
+    into->tv_nsec = (long)sn.r;
+}
+
 ucal_iu32DivT
 ucal_DaysToMonth(
     uint_fast16_t ed  ,
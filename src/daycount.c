@@ -0,0 +1,315 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains financial day count conventions.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// financial day count conventions
+///
+/// All conventions work on RDN pairs.  The ACT conventions need no calendar at all, except
+/// ACT/ACT ISDA, which needs the year and the day in year of both dates; that is what
+/// @c ucal_DaysToYearsGD() delivers without going through months.  Only the 30/360 family needs
+/// months and days, and those come from the day in year with @c ucal_DaysToMonth().
+///
+/// The fractions are exact: ACT/ACT ISDA uses the common denominator 365*366.  The array
+/// functions remember the span of the last year seen for each of the two date streams, since
+/// the dates of a cash flow schedule cluster in few years; the ACT/360 and ACT/365F loops are
+/// plain differences the compiler can vectorise.
+
+#include <errno.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/daycount.h"
+
+// ----------------------------------------------------------------------------------------------
+// the year span cache
+// ----------------------------------------------------------------------------------------------
+
+typedef struct {
+    int32_t ylo;    // RDN of Jan,1
+    int32_t yhi;    // RDN of Jan,1 of the next year
+    int32_t year;   // calendar year
+    bool    isLY;   // leap year
+} dcn_YearT;
+
+static inline void
+dcn_Year(
+    dcn_YearT *yc ,
+    int32_t    rdn)
+{
+    if ((rdn < yc->ylo) || (rdn >= yc->yhi)) {
+        ucal_iu32DivT yd = ucal_DaysToYearsGD(rdn, &yc->isLY);
+        yc->year = yd.q + 1;
+        yc->ylo  = rdn - (int32_t)yd.r;
+        yc->yhi  = yc->ylo + 365 + yc->isLY;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// numerators
+// ----------------------------------------------------------------------------------------------
+
+static inline int64_t
+dcn_ActAct(
+    dcn_YearT *c1,
+    dcn_YearT *c2,
+    int32_t    r1,
+    int32_t    r2)
+{
+    dcn_Year(c1, r1);
+    dcn_Year(c2, r2);
+    if (c1->year == c2->year) {
+        return ((int64_t)r2 - r1) * (365 + !c1->isLY);
+    }
+    return (int64_t)(c1->yhi - r1) * (365 + !c1->isLY)
+         + (int64_t)(c2->year - c1->year - 1) * UCAL_DC_ACTACT_DEN
+         + (int64_t)(r2 - c2->ylo) * (365 + !c2->isLY);
+}
+
+typedef struct {
+    int32_t y;      // year
+    int32_t m;      // month, 1..12
+    int32_t d;      // day of month, 1..31
+    bool    eom;    // last day of month
+} dcn_DateT;
+
+static inline void
+dcn_Split(
+    dcn_DateT *into,
+    dcn_YearT *yc  ,
+    int32_t    rdn )
+{
+    ucal_iu32DivT md;
+
+    dcn_Year(yc, rdn);
+    md = ucal_DaysToMonth((uint_fast16_t)(rdn - yc->ylo), yc->isLY);
+    into->y   = yc->year;
+    into->m   = md.q + 1;
+    into->d   = md.r + 1;
+    into->eom = (into->d == _ucal_mdtab[yc->isLY][md.q]);
+}
+
+static inline int64_t
+dcn_30_360(
+    int        dc,
+    dcn_YearT *c1,
+    dcn_YearT *c2,
+    int32_t    r1,
+    int32_t    r2)
+{
+    dcn_DateT a, b;
+
+    dcn_Split(&a, c1, r1);
+    dcn_Split(&b, c2, r2);
+    switch (dc) {
+    case ucal_Dc30_360:
+        a.d -= (31 == a.d);
+        b.d -= (31 == b.d) && (30 == a.d);
+        break;
+    case ucal_Dc30_360US:
+        if (a.eom && (2 == a.m)) {
+            if (b.eom && (2 == b.m)) {
+                b.d = 30;
+            }
+            a.d = 30;
+        }
+        b.d -= (31 == b.d) && (a.d >= 30);
+        a.d -= (31 == a.d);
+        break;
+    case ucal_Dc30E_360:
+        a.d -= (31 == a.d);
+        b.d -= (31 == b.d);
+        break;
+    default:
+        if (a.eom) {
+            a.d = 30;
+        }
+        if (b.eom && ((ucal_Dc30E_360ISDA == dc) || (2 != b.m))) {
+            b.d = 30;
+        }
+        break;
+    }
+    return (int64_t)(b.y - a.y) * 360 + (b.m - a.m) * 30 + (b.d - a.d);
+}
+
+// numerator for any convention but the plain ACT ones; dates in any order
+static inline int64_t
+dcn_Num(
+    int        dc,
+    dcn_YearT *c1,
+    dcn_YearT *c2,
+    int32_t    r1,
+    int32_t    r2)
+{
+    if (r2 < r1) {
+        return (ucal_DcActActISDA == dc)
+            ? -dcn_ActAct(c2, c1, r2, r1)
+            : -dcn_30_360(dc, c2, c1, r2, r1);
+    }
+    return (ucal_DcActActISDA == dc)
+        ? dcn_ActAct(c1, c2, r1, r2)
+        : dcn_30_360(dc, c1, c2, r1, r2);
+}
+
+static int64_t
+dcn_Den(
+    int dc)
+{
+    switch (dc) {
+    case ucal_DcAct365F:
+        return 365;
+    case ucal_DcActActISDA:
+        return UCAL_DC_ACTACT_DEN;
+    case ucal_DcAct360:
+    case ucal_Dc30_360:
+    case ucal_Dc30_360US:
+    case ucal_Dc30E_360:
+    case ucal_Dc30E_360ISDA:
+    case ucal_Dc30E_360ISDAMat:
+        return 360;
+    default:
+        errno = EINVAL;
+        return 0;
+    }
+}
+
+// fixed point with 32 fraction bits, rounded; needs den < 2^31
+static inline int64_t
+dcn_Q32(
+    int64_t num,
+    int64_t den)
+{
+    int64_t q = num / den;
+    int64_t r = num % den;
+
+    if (r < 0) {
+        --q;
+        r += den;
+    }
+    return q * INT64_C(0x100000000) + ((r << 32) + den / 2) / den;
+}
+
+// ----------------------------------------------------------------------------------------------
+// API
+// ----------------------------------------------------------------------------------------------
+
+bool
+ucal_YearFrac(
+    ucal_YearFracT *into,
+    int             dc  ,
+    int32_t         d1  ,
+    int32_t         d2  )
+{
+    dcn_YearT c1 = { 1, 0, 0, false };
+    dcn_YearT c2 = { 1, 0, 0, false };
+
+    if (0 == (into->den = dcn_Den(dc))) {
+        return false;
+    }
+    if ((ucal_DcAct360 == dc) || (ucal_DcAct365F == dc)) {
+        into->num = (int64_t)d2 - d1;
+    } else {
+        into->num = dcn_Num(dc, &c1, &c2, d1, d2);
+    }
+    return true;
+}
+
+bool
+ucal_YearFracICMA(
+    ucal_YearFracT *into,
+    int32_t         d1  ,
+    int32_t         d2  ,
+    int32_t         ps  ,
+    int32_t         pe  ,
+    unsigned        freq)
+{
+    int64_t den = ((int64_t)pe - ps) * freq;
+
+    if ((den <= 0) || (den > INT32_MAX)) {
+        errno = EINVAL;
+        return false;
+    }
+    into->num = (int64_t)d2 - d1;
+    into->den = den;
+    return true;
+}
+
+int64_t
+ucal_YearFracQ32(
+    ucal_YearFracT const *yf)
+{
+    return dcn_Q32(yf->num, yf->den);
+}
+
+size_t
+ucal_YearFracArray(
+    ucal_YearFracT *into ,
+    int             dc   ,
+    int32_t const  *d1   ,
+    int32_t const  *d2   ,
+    size_t          count)
+{
+    dcn_YearT c1  = { 1, 0, 0, false };
+    dcn_YearT c2  = { 1, 0, 0, false };
+    int64_t   den = dcn_Den(dc);
+    size_t    idx;
+
+    if (0 == den) {
+        return 0;
+    }
+    if ((ucal_DcAct360 == dc) || (ucal_DcAct365F == dc)) {
+        for (idx = 0; idx < count; ++idx) {
+            into[idx].num = (int64_t)d2[idx] - d1[idx];
+            into[idx].den = den;
+        }
+    } else {
+        for (idx = 0; idx < count; ++idx) {
+            into[idx].num = dcn_Num(dc, &c1, &c2, d1[idx], d2[idx]);
+            into[idx].den = den;
+        }
+    }
+    return count;
+}
+
+size_t
+ucal_YearFracQ32Array(
+    int64_t        *into ,
+    int             dc   ,
+    int32_t const  *d1   ,
+    int32_t const  *d2   ,
+    size_t          count)
+{
+    dcn_YearT c1  = { 1, 0, 0, false };
+    dcn_YearT c2  = { 1, 0, 0, false };
+    int64_t   den = dcn_Den(dc);
+    size_t    idx;
+
+    if (0 == den) {
+        return 0;
+    }
+    if ((ucal_DcAct360 == dc) || (ucal_DcAct365F == dc)) {
+        for (idx = 0; idx < count; ++idx) {
+            into[idx] = dcn_Q32((int64_t)d2[idx] - d1[idx], den);
+        }
+    } else {
+        for (idx = 0; idx < count; ++idx) {
+            into[idx] = dcn_Q32(dcn_Num(dc, &c1, &c2, d1[idx], d2[idx]), den);
+        }
+    }
+    return count;
+}
+
+// -*- that's all folks -*-
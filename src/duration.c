@@ -0,0 +1,650 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains ISO 8601 duration parsing and arithmetic.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// ISO 8601 durations
+///
+/// A duration like @c P1Y2M10DT2H30M mixes nominal units (years, months, weeks, days), whose
+/// length depends on the calendar and the zone, with exact units (hours, minutes, seconds).
+/// They are kept apart: the nominal part is applied to the (local) date, with the day of month
+/// clamped to the end of a shorter month, and the exact part is added to the resulting time
+/// stamp.  This is the order XML Schema and RFC 5545 use, and it is what people expect: the
+/// end of a one-month subscription that starts on Jan,31 is Feb,28 (or 29), and a daily event
+/// stays at the same wall clock time over a DST transition.
+///
+/// Month arithmetic never goes through @c struct @c tm normalisation; it is a floor division of
+/// the month count by 12 and a clamp against the month length table.
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tsdecode.h"
+#include "ucal/duration.h"
+
+// EOF is defined in stdio.h, but we don't want that one here...
+#ifndef EOF
+# define EOF (-1)
+#endif
+
+// peek into string, return next char with proper expansion or EOF
+static inline int
+str_peek(const char ** const head, const char *tail) {
+    return (*head != tail) ? (uint8_t)**head : EOF;
+}
+
+// floor division of a 64bit value by a positive 32bit divider
+static inline ucal_i64u32DivT
+dur_Div(
+    int64_t  n,
+    uint32_t d)
+{
+    int64_t q = n / d;
+    int64_t r = n % d;
+    if (r < 0) {
+        r += d;
+        --q;
+    }
+    return (ucal_i64u32DivT){ .q = q, .r = (uint32_t)r };
+}
+
+// add seconds to a time stamp, checking for overflow
+static inline bool
+dur_AddSecs(
+    int64_t *into,
+    int64_t  ts  ,
+    int64_t  secs)
+{
+    if ((secs > 0) ? (ts > INT64_MAX - secs) : (ts < INT64_MIN - secs)) {
+        errno = ERANGE;
+        return false;
+    }
+    *into = ts + secs;
+    return true;
+}
+
+// convert seconds plus nanoseconds to nanoseconds, checking the range
+static inline bool
+dur_SecsToNs(
+    int64_t *into,
+    int64_t  secs,
+    int64_t  nsec)
+{
+    if ((secs < INT64_MIN / 1000000000 + 1) || (secs > INT64_MAX / 1000000000 - 1)) {
+        errno = ERANGE;
+        return false;
+    }
+    *into = secs * 1000000000 + nsec;
+    return true;
+}
+
+// the exact part of a duration in nanoseconds, fraction rounded
+static inline bool
+dur_ExactNs(
+    int64_t              *into,
+    ucal_DurationT const *dur )
+{
+    return dur_SecsToNs(into, dur->secs,
+                        (int64_t)(((uint64_t)dur->frac * 1000000000u + 0x80000000u) >> 32));
+}
+
+// ----------------------------------------------------------------------------------------------
+// parsing
+// ----------------------------------------------------------------------------------------------
+
+void
+ucal_DurationNegate(
+    ucal_DurationT *dur)
+{
+    // The components come from the parser or are built by the caller; negating INT32_MIN is
+    // out of the question for the parser, since it limits the sums to +/-INT32_MAX.
+    dur->months = -dur->months;
+    dur->days   = -dur->days;
+    if (dur->frac) {
+        dur->secs = -dur->secs - 1;
+        dur->frac = -dur->frac;
+    } else {
+        dur->secs = -dur->secs;
+    }
+}
+
+bool
+ucal_decDuration(
+    ucal_DurationT *into,
+    const char    **pstr,
+    const char     *end )
+{
+    // designators in their mandatory order, per part; and the seconds per time unit
+    static const char     s_ddes[] = "YMWD";
+    static const char     s_tdes[] = "HMS";
+    static const uint32_t s_tmul[] = { 3600, 60, 1 };
+
+    const char   *str;
+    const char   *des;      // designators of current part
+    unsigned      next;     // index of next allowed designator
+    unsigned      ncomp;    // components in current part
+    int64_t       months = 0, days = 0, secs = 0;
+    uint32_t      frac = 0;
+    bool          neg = false, tpart = false, fdone = false;
+    int           xch;
+
+    if ((NULL == into) || (NULL == pstr) || (NULL == (str = *pstr))) {
+        errno = EINVAL;
+        return false;
+    }
+    if (NULL == end) {
+        end = str + strnlen(str, 128);
+    }
+
+    switch (str_peek(&str, end)) {
+    case '-':   neg = true;
+            // FALLTHROUGH
+    case '+':   ++str;
+            // FALLTHROUGH
+    default:    break;
+    }
+    if ('P' != str_peek(&str, end)) {
+        goto syntax;
+    }
+    ++str;
+
+    des   = s_ddes;
+    next  = 0;
+    ncomp = 0;
+    for (;;) {
+        uint64_t     val = 0;
+        ucal_u32DivT fra = { 0, 0 };
+        bool         fsep;
+        unsigned     idx;
+
+        xch = str_peek(&str, end);
+        if (('T' == xch) && !tpart) {
+            if (fdone) {
+                goto syntax;
+            }
+            ++str;
+            tpart = true;
+            des   = s_tdes;
+            next  = 0;
+            ncomp = 0;
+            continue;
+        }
+        if (!isdigit(xch)) {
+            break;
+        }
+        if (fdone) {
+            goto syntax;    // nothing may follow a fraction
+        }
+
+        // the integral number; keep eating digits on overflow, but remember it
+        while (isdigit(xch = str_peek(&str, end))) {
+            ++str;
+            if (val <= INT32_MAX) {
+                val = val * 10 + (unsigned)(xch - '0');
+            }
+        }
+        if (val > INT32_MAX) {
+            goto range;
+        }
+
+        // a decimal fraction, dot or comma
+        fsep = ('.' == xch) || (',' == xch);
+        if (fsep) {
+            const char *fbeg = ++str;
+            fra = ucal_decFrac_raw(&str, end);
+            if (str == fbeg) {
+                goto syntax;
+            }
+            fdone = true;
+        }
+
+        // the designator, which must come after the previous one
+        xch = str_peek(&str, end);
+        for (idx = next; des[idx] && (des[idx] != xch); ++idx) {
+            // just search
+        }
+        if (!des[idx]) {
+            goto syntax;
+        }
+        ++str;
+        next = idx + 1;
+        ++ncomp;
+
+        if (tpart) {
+            // exact units: split the scaled fraction into seconds and fraction
+            uint64_t fs = (uint64_t)fra.r * s_tmul[idx];
+            secs += (int64_t)(val + fra.q) * s_tmul[idx] + (int64_t)(fs >> 32);
+            frac  = (uint32_t)fs;
+        } else if (fsep) {
+            goto syntax;    // no fractions of nominal units
+        } else {
+            switch (des[idx]) {
+            case 'Y':   months += (int64_t)val * 12; break;
+            case 'M':   months += (int64_t)val;      break;
+            case 'W':   days   += (int64_t)val * 7;  break;
+            default:    days   += (int64_t)val;      break;
+            }
+        }
+    }
+
+    // at least one component, and 'T' must be followed by one
+    if (0 == ncomp) {
+        goto syntax;
+    }
+    if ((months > INT32_MAX) || (days > INT32_MAX)) {
+        goto range;
+    }
+
+    into->months = (int32_t)months;
+    into->days   = (int32_t)days;
+    into->secs   = secs;
+    into->frac   = frac;
+    if (neg) {
+        ucal_DurationNegate(into);
+    }
+    *pstr = str;
+    return true;
+
+  syntax:
+    errno = EINVAL;
+    return false;
+  range:
+    errno = ERANGE;
+    return false;
+}
+
+// ----------------------------------------------------------------------------------------------
+// application
+// ----------------------------------------------------------------------------------------------
+
+// Add months and days to a day number.  The months are added to the (zero-based) month count
+// since the epoch and split again by a floor division by 12; the day in month is clamped to
+// the length of the target month.
+static bool
+dur_AddNominal(
+    int32_t *into  ,
+    int32_t  rdn   ,
+    int32_t  months,
+    int32_t  days  )
+{
+    int64_t res = rdn;
+
+    if (months) {
+        bool            isLY;
+        ucal_iu32DivT   yd = ucal_DaysToYearsGD(rdn, &isLY);
+        ucal_iu32DivT   md = ucal_DaysToMonth(yd.r, isLY);
+        ucal_i64u32DivT ym = dur_Div((int64_t)yd.q * 12 + md.q + months, 12);
+        int64_t         y  = ym.q + 1;
+        unsigned        d  = md.r + 1;
+
+        if ((y < INT16_MIN) || (y > INT16_MAX)) {
+            errno = ERANGE;
+            return false;
+        }
+        if (d > _ucal_mdtab[ucal_IsLeapYearGD((int32_t)y)][ym.r]) {
+            d = _ucal_mdtab[ucal_IsLeapYearGD((int32_t)y)][ym.r];
+        }
+        res = ucal_DateToRdnGD((int16_t)y, (int16_t)(ym.r + 1), (int16_t)d);
+    }
+    res += days;
+    if ((res < INT32_MIN) || (res > INT32_MAX)) {
+        errno = ERANGE;
+        return false;
+    }
+    *into = (int32_t)res;
+    return true;
+}
+
+// apply the nominal part to a time stamp, keeping the time of day
+static bool
+dur_AddNominalTs(
+    int64_t              *into,
+    int64_t               ts  ,
+    ucal_DurationT const *dur )
+{
+    ucal_i64u32DivT sd = dur_Div(ts, 86400);
+    int32_t         rdn;
+
+    if ((sd.q < INT32_MIN + UCAL_rdnUNIX) || (sd.q > INT32_MAX - UCAL_rdnUNIX)) {
+        errno = ERANGE;
+        return false;
+    }
+    if (!dur_AddNominal(&rdn, (int32_t)(sd.q + UCAL_rdnUNIX), dur->months, dur->days)) {
+        return false;
+    }
+    *into = ((int64_t)rdn - UCAL_rdnUNIX) * 86400 + sd.r;
+    return true;
+}
+
+bool
+ucal_DurationAddRdn(
+    int32_t              *into,
+    int32_t               rdn ,
+    ucal_DurationT const *dur )
+{
+    if ((NULL == into) || (NULL == dur) || dur->secs || dur->frac) {
+        errno = EINVAL;
+        return false;
+    }
+    return dur_AddNominal(into, rdn, dur->months, dur->days);
+}
+
+bool
+ucal_DurationAddTime(
+    time_t               *into,
+    time_t                tt  ,
+    ucal_DurationT const *dur )
+{
+    int64_t ts = tt;
+
+    if ((NULL == into) || (NULL == dur)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (ucal_DurationIsNominal(dur) && !dur_AddNominalTs(&ts, ts, dur)) {
+        return false;
+    }
+    if (!dur_AddSecs(&ts, ts, dur->secs)) {
+        return false;
+    }
+    if ((time_t)ts != ts) {
+        errno = ERANGE;
+        return false;
+    }
+    *into = (time_t)ts;
+    return true;
+}
+
+// Zoned application with separate contexts for the start and the target side.  A context
+// caches one year, and with durations of months or more the two sides are usually in
+// different years; one context would be recalculated twice per call.
+static bool
+dur_AddZoned(
+    int64_t              *into,
+    tziConvCtxT          *csrc,
+    tziConvCtxT          *cdst,
+    int64_t               ts  ,
+    ucal_DurationT const *dur ,
+    tziCvtHintT           hint)
+{
+    if (ucal_DurationIsNominal(dur)) {
+        tziConvInfoT ci;
+        int64_t      loc;
+
+        if (!tziGetInfoUtc2Local(&ci, csrc, ts)) {
+            return false;
+        }
+        if (!dur_AddNominalTs(&loc, ts + ci.offs, dur)) {
+            return false;
+        }
+        if (!tziGetInfoLocal2Utc(&ci, cdst, loc, hint)) {
+            errno = EINVAL; // gap or overlap without a hint
+            return false;
+        }
+        ts = loc + ci.offs;
+    }
+    return dur_AddSecs(into, ts, dur->secs);
+}
+
+bool
+tziDurationAdd(
+    int64_t              *into  ,
+    tziConvCtxT          *ctx   ,
+    int64_t               tsfrom,
+    ucal_DurationT const *dur   ,
+    tziCvtHintT           hint  )
+{
+    if ((NULL == into) || (NULL == ctx) || (NULL == ctx->pTZI) || (NULL == dur)) {
+        errno = EINVAL;
+        return false;
+    }
+    return dur_AddZoned(into, ctx, ctx, tsfrom, dur, hint);
+}
+
+// ----------------------------------------------------------------------------------------------
+// batch application
+// ----------------------------------------------------------------------------------------------
+
+size_t
+ucal_DurationAddRdnBatch(
+    int32_t              *into ,
+    int32_t const        *rdn  ,
+    size_t                count,
+    ucal_DurationT const *dur  )
+{
+    size_t idx;
+
+    if ((NULL == into) || (NULL == rdn) || (NULL == dur) || dur->secs || dur->frac) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    if (0 == dur->months) {
+        // Plain addition.  Check the range in a separate pass, so both loops stay simple
+        // enough to be vectorised; on overflow, the slow path below finds the culprit.
+        int32_t const lim = (dur->days > 0) ? INT32_MAX - dur->days : INT32_MIN - dur->days;
+        int32_t       bad = 0;
+        if (dur->days > 0) {
+            for (idx = 0; idx < count; ++idx) {
+                bad |= (rdn[idx] > lim);
+            }
+        } else {
+            for (idx = 0; idx < count; ++idx) {
+                bad |= (rdn[idx] < lim);
+            }
+        }
+        if (!bad) {
+            for (idx = 0; idx < count; ++idx) {
+                into[idx] = (int32_t)((uint32_t)rdn[idx] + (uint32_t)dur->days);
+            }
+            return count;
+        }
+    }
+
+    // With months: remember the last day converted; sorted input has many repetitions.
+    {
+        int32_t last = 0, lres = 0;
+        bool    have = false;
+        for (idx = 0; idx < count; ++idx) {
+            int32_t cur = rdn[idx];
+            if (!(have && (cur == last))) {
+                if (!dur_AddNominal(&lres, cur, dur->months, dur->days)) {
+                    break;
+                }
+                last = cur;
+                have = true;
+            }
+            into[idx] = lres;
+        }
+    }
+    return idx;
+}
+
+size_t
+ucal_DurationAddTimeBatch(
+    time_t               *into ,
+    time_t const         *tt   ,
+    size_t                count,
+    ucal_DurationT const *dur  )
+{
+    int64_t dlo = 1, dhi = 0, shift = 0;    // current day range and its shift
+    size_t  idx;
+
+    if ((NULL == into) || (NULL == tt) || (NULL == dur)) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    if (0 == dur->months) {
+        // a fixed shift; just watch the range
+        shift = (int64_t)dur->days * 86400 + dur->secs;
+        for (idx = 0; idx < count; ++idx) {
+            int64_t ts;
+            if (!dur_AddSecs(&ts, tt[idx], shift) || ((time_t)ts != ts)) {
+                errno = ERANGE;
+                break;
+            }
+            into[idx] = (time_t)ts;
+        }
+        return idx;
+    }
+
+    // The shift is constant over a UTC day; cache it for the current day.
+    for (idx = 0; idx < count; ++idx) {
+        int64_t ts = tt[idx];
+        if ((ts < dlo) || (ts > dhi)) {
+            int64_t tr;
+            dlo = ts - dur_Div(ts, 86400).r;
+            dhi = dlo + 86399;
+            if (!dur_AddNominalTs(&tr, dlo, dur) || !dur_AddSecs(&tr, tr, dur->secs)) {
+                break;
+            }
+            shift = tr - dlo;
+        }
+        ts += shift;
+        if ((time_t)ts != ts) {
+            errno = ERANGE;
+            break;
+        }
+        into[idx] = (time_t)ts;
+    }
+    return idx;
+}
+
+size_t
+tziDurationAddBatch(
+    int64_t              *into  ,
+    tziConvCtxT          *ctx   ,
+    int64_t const        *tsfrom,
+    size_t                count ,
+    ucal_DurationT const *dur   ,
+    tziCvtHintT           hint  )
+{
+    tziConvCtxT cdst;
+    size_t      idx;
+
+    if ((NULL == into) || (NULL == ctx) || (NULL == ctx->pTZI) || (NULL == tsfrom) ||
+        (NULL == dur))
+    {
+        errno = EINVAL;
+        return 0;
+    }
+    if (!ucal_DurationIsNominal(dur)) {
+        for (idx = 0; idx < count; ++idx) {
+            if (!dur_AddSecs(&into[idx], tsfrom[idx], dur->secs)) {
+                break;
+            }
+        }
+        return idx;
+    }
+
+    // a private context for the target side, see 'dur_AddZoned()'
+    cdst = *ctx;
+    for (idx = 0; idx < count; ++idx) {
+        if (!dur_AddZoned(&into[idx], ctx, &cdst, tsfrom[idx], dur, hint)) {
+            break;
+        }
+    }
+    return idx;
+}
+
+bool
+ucal_DurationAddNs(
+    ucal_ns_t            *into,
+    ucal_ns_t             ns  ,
+    ucal_DurationT const *dur )
+{
+    int64_t exact;
+
+    if ((NULL == into) || (NULL == dur)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (ucal_DurationIsNominal(dur)) {
+        ucal_i64u32DivT sn = ucal_NsToSecs(ns);
+        int64_t         ts;
+        if (!dur_AddNominalTs(&ts, sn.q, dur) || !dur_SecsToNs(&ns, ts, sn.r)) {
+            return false;
+        }
+    }
+    if (!dur_ExactNs(&exact, dur) || !dur_AddSecs(&ns, ns, exact)) {
+        return false;
+    }
+    *into = ns;
+    return true;
+}
+
+size_t
+ucal_DurationAddNsBatch(
+    ucal_ns_t            *into ,
+    ucal_ns_t const      *ns   ,
+    size_t                count,
+    ucal_DurationT const *dur  )
+{
+    int64_t dlo = 1, dhi = 0, shift = 0, exact; // current day range and its shift
+    size_t  idx;
+
+    if ((NULL == into) || (NULL == ns) || (NULL == dur)) {
+        errno = EINVAL;
+        return 0;
+    }
+    if (!dur_ExactNs(&exact, dur)) {
+        return 0;
+    }
+
+    if (0 == dur->months) {
+        // a fixed shift; just watch the range
+        if (!dur_SecsToNs(&shift, (int64_t)dur->days * 86400, 0)
+            || !dur_AddSecs(&shift, shift, exact)) {
+            return 0;
+        }
+        for (idx = 0; idx < count; ++idx) {
+            if (!dur_AddSecs(&into[idx], ns[idx], shift)) {
+                break;
+            }
+        }
+        return idx;
+    }
+
+    // The shift is constant over a UTC day; cache it for the current day.  The day limits
+    // saturate at the ends of the range.
+    for (idx = 0; idx < count; ++idx) {
+        ucal_ns_t v = ns[idx];
+        if ((v < dlo) || (v > dhi)) {
+            ucal_i64u32DivT sn = ucal_NsToSecs(v);
+            int64_t         ds = sn.q - dur_Div(sn.q, 86400).r;
+            int64_t         tr;
+            if (!dur_AddNominalTs(&tr, ds, dur) || !dur_SecsToNs(&shift, tr - ds, 0)
+                || !dur_AddSecs(&shift, shift, exact)) {
+                break;
+            }
+            dlo = (ds > INT64_MIN / 1000000000) ? ds * 1000000000 : INT64_MIN;
+            dhi = (ds < INT64_MAX / 1000000000 - 86400) ? (ds + 86400) * 1000000000 - 1
+                                                         : INT64_MAX;
+        }
+        if (!dur_AddSecs(&into[idx], v, shift)) {
+            break;
+        }
+    }
+    return idx;
+}
+
+// -*- that's all folks -*-
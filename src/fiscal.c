@@ -0,0 +1,277 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains support for 52/53-week fiscal calendars.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// 52/53-week fiscal calendars
+///
+/// The ISO8601 week calendar has closed forms for the year start and the week split, since
+/// its anchor is fixed.  For a configurable anchor, the year start is taken from the Gregorian
+/// calendar instead: the anchor date gives a day number, and the weekday rule moves it by at
+/// most six days.  Splitting a day number needs the Gregorian year of the day, shifted back by
+/// the anchor's day of year; the fiscal year is then either that year or a neighbour, which
+/// one more year start settles.  Weeks and periods come from tables set up once per calendar,
+/// one for each year length.  No step depends on the distance from the epoch.
+///
+/// The array functions remember the span of the last fiscal year seen.
+
+#include <errno.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/fiscal.h"
+
+// cumulated month lengths in a regular year
+static const int16_t s_mstart[13] = {
+    0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365
+};
+
+// ----------------------------------------------------------------------------------------------
+// year starts
+// ----------------------------------------------------------------------------------------------
+
+// RDN of the first day of a fiscal year.  The anchor year is reduced into [0,400) first, so the
+// Gregorian conversion cannot overflow for any fiscal year.
+static int32_t
+fsc_Start(
+    ucal_FiscalCalT const *cal,
+    int32_t                fy )
+{
+    ucal_iu32DivT cy  = ucal_iu32Div(fy - cal->yearOffs, 400u);
+    int32_t       rdn = cy.q * INT32_C(146097)
+                      + ucal_DateToRdnGD((int16_t)cy.r, cal->aMonth, cal->aMDay);
+
+    switch (cal->rule) {
+    case ucal_FiscalLast:
+        return ucal_WdLE(rdn, cal->aWDay);
+    case ucal_FiscalFirst:
+        return ucal_WdGE(rdn, cal->aWDay);
+    default:
+        return ucal_WdNear(rdn, cal->aWDay);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// the year span cache
+// ----------------------------------------------------------------------------------------------
+
+typedef struct {
+    int32_t ylo;    // RDN of the first day
+    int32_t yhi;    // RDN of the first day of the next year
+    int32_t year;   // fiscal year
+} fsc_YearT;
+
+static bool
+fsc_SetYear(
+    fsc_YearT             *yc ,
+    ucal_FiscalCalT const *cal,
+    int32_t                rdn)
+{
+    bool          isLY;
+    ucal_iu32DivT yd = ucal_DaysToYearsGD(rdn - cal->aYDay, &isLY);
+    int32_t       fy = yd.q + 1 + cal->yearOffs;
+    int32_t       lo = fsc_Start(cal, fy);
+    int32_t       hi;
+
+    // the start is within a week of the anchor date, so we are off by one year at most
+    if (rdn < lo) {
+        hi = lo;
+        lo = fsc_Start(cal, --fy);
+    } else {
+        hi = fsc_Start(cal, fy + 1);
+        if (rdn >= hi) {
+            lo = hi;
+            hi = fsc_Start(cal, ++fy + 1);
+        }
+    }
+    if (fy < INT16_MIN || fy > INT16_MAX) {
+        errno = ERANGE;
+        return false;
+    }
+    yc->ylo  = lo;
+    yc->yhi  = hi;
+    yc->year = fy;
+    return true;
+}
+
+static inline bool
+fsc_Split(
+    ucal_FiscalDateT      *into,
+    fsc_YearT             *yc  ,
+    ucal_FiscalCalT const *cal ,
+    int32_t                rdn )
+{
+    uint32_t yd, w;
+    unsigned is53, p;
+
+    if (((rdn < yc->ylo) || (rdn >= yc->yhi)) && !fsc_SetYear(yc, cal, rdn)) {
+        return false;
+    }
+    is53 = (yc->yhi - yc->ylo) > 364;
+    yd   = (uint32_t)(rdn - yc->ylo);
+    w    = yd / 7u;
+    p    = cal->wPeriod[is53][w];
+
+    into->dYear   = (int16_t)yc->year;
+    into->dYDay   = (int16_t)(yd + 1);
+    into->dWeek   = (int8_t)(w + 1);
+    into->dPeriod = (int8_t)(p + 1);
+    into->dPWeek  = (int8_t)(w - cal->pStart[is53][p] + 1);
+    into->dWDay   = (int8_t)(yd - w * 7u + 1);
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// API
+// ----------------------------------------------------------------------------------------------
+
+bool
+ucal_FiscalInit(
+    ucal_FiscalCalT *cal)
+{
+    unsigned is53, p, w, sum;
+
+    if ((cal->aMonth < 1) || (cal->aMonth > 12) || (cal->aMDay < 1)
+        || (cal->aMDay > s_mstart[cal->aMonth] - s_mstart[cal->aMonth - 1])
+        || (cal->aWDay < 1) || (cal->aWDay > 7)
+        || (cal->rule < ucal_FiscalNearest) || (cal->rule > ucal_FiscalFirst)
+        || (cal->nPeriods < 1) || (cal->nPeriods > 13)
+        || (cal->leapPeriod < 1) || (cal->leapPeriod > cal->nPeriods)) {
+        errno = EINVAL;
+        return false;
+    }
+    for (sum = p = 0; p < (unsigned)cal->nPeriods; ++p) {
+        if (0 == cal->pWeeks[p]) {
+            errno = EINVAL;
+            return false;
+        }
+        sum += cal->pWeeks[p];
+    }
+    if (52 != sum) {
+        errno = EINVAL;
+        return false;
+    }
+
+    cal->aYDay = s_mstart[cal->aMonth - 1] + cal->aMDay - 1;
+    for (is53 = 0; is53 < 2; ++is53) {
+        w = 0;
+        for (p = 0; p < 14; ++p) {
+            cal->pStart[is53][p] = (uint8_t)w;
+            if (p < (unsigned)cal->nPeriods) {
+                unsigned wend = w + cal->pWeeks[p]
+                              + (is53 && (p + 1 == (unsigned)cal->leapPeriod));
+                while (w < wend) {
+                    cal->wPeriod[is53][w++] = (uint8_t)p;
+                }
+            }
+        }
+        if (!is53) {
+            cal->wPeriod[0][52] = (uint8_t)(cal->nPeriods - 1);
+        }
+    }
+    return true;
+}
+
+int32_t
+ucal_YearStartFC(
+    ucal_FiscalCalT const *cal,
+    int16_t                y  )
+{
+    return fsc_Start(cal, y);
+}
+
+int
+ucal_YearWeeksFC(
+    ucal_FiscalCalT const *cal,
+    int16_t                y  )
+{
+    return (fsc_Start(cal, (int32_t)y + 1) - fsc_Start(cal, y)) / 7;
+}
+
+int32_t
+ucal_DateToRdnFC(
+    ucal_FiscalCalT const *cal,
+    int16_t                y  ,
+    int16_t                p  ,
+    int16_t                w  ,
+    int16_t                d  )
+{
+    ucal_iu32DivT pq   = ucal_iu32SubDiv(p, 1, (uint32_t)cal->nPeriods);
+    int32_t       fy   = y + pq.q;
+    int32_t       lo   = fsc_Start(cal, fy);
+    unsigned      is53 = 0;
+
+    // the leap week only moves the periods after the leap period
+    if (pq.r >= (uint32_t)cal->leapPeriod) {
+        is53 = (fsc_Start(cal, fy + 1) - lo) > 364;
+    }
+    return lo + (cal->pStart[is53][pq.r] + w - 1) * 7 + d - 1;
+}
+
+bool
+ucal_RdnToDateFC(
+    ucal_FiscalDateT      *into,
+    ucal_FiscalCalT const *cal ,
+    int32_t                rdn )
+{
+    fsc_YearT yc = { 1, 0, 0 };
+
+    return fsc_Split(into, &yc, cal, rdn);
+}
+
+size_t
+ucal_RdnToDateFCArray(
+    ucal_FiscalDateT      *into ,
+    ucal_FiscalCalT const *cal  ,
+    int32_t const         *rdn  ,
+    size_t                 count)
+{
+    fsc_YearT yc = { 1, 0, 0 };
+    size_t    idx;
+
+    for (idx = 0; idx < count; ++idx) {
+        if (!fsc_Split(&into[idx], &yc, cal, rdn[idx])) {
+            break;
+        }
+    }
+    return idx;
+}
+
+void
+ucal_DateToRdnFCArray(
+    int32_t                *into ,
+    ucal_FiscalCalT const  *cal  ,
+    ucal_FiscalDateT const *fd   ,
+    size_t                  count)
+{
+    int32_t  year = INT32_MIN;
+    int32_t  ylo  = 0;
+    unsigned is53 = 0;
+    size_t   idx;
+
+    for (idx = 0; idx < count; ++idx) {
+        ucal_iu32DivT pq = ucal_iu32SubDiv(fd[idx].dPeriod, 1, (uint32_t)cal->nPeriods);
+        int32_t       fy = fd[idx].dYear + pq.q;
+        if (fy != year) {
+            year = fy;
+            ylo  = fsc_Start(cal, fy);
+            is53 = (fsc_Start(cal, fy + 1) - ylo) > 364;
+        }
+        into[idx] = ylo + (cal->pStart[is53][pq.r] + fd[idx].dPWeek - 1) * 7 + fd[idx].dWDay - 1;
+    }
+}
+
+// -*- that's all folks -*-
@@ -24,6 +24,7 @@
 #include "ucal/gpsdate.h"
 #include "ucal/gregorian.h"
 #include "ucal/calconst.h"
+#include "probes.h"
 
 // ----------------------------------------------------------------------------------------------
 ucal_GpsRawTimeT
@@ -53,6 +54,34 @@ ucal_GpsMapTime(
     return (ucal_GpsRawTimeT){ .w = (qr.q & 1023), .t = qr.r };
 }
 
+// ----------------------------------------------------------------------------------------------
+ucal_GpsRawTimeT
+ucal_GpsMapNs(
+    ucal_ns_t ns  ,
+    int16_t   ls  ,
+    uint32_t *nsec)
+{
+    // Same as above, after splitting off the nanoseconds.  The seconds may not fit a 32bit
+    // 'time_t', so the era reduction is done here in 64 bit.
+
+    ucal_i64u32DivT sn = ucal_NsToSecs(ns);
+    ucal_iu32DivT   qr;
+    int32_t         secs;
+
+    if (nsec) {
+        *nsec = sn.r;
+    }
+    if (sizeof(size_t) >= sizeof(int64_t)) {
+        secs = (int32_t)(sn.q % (1024 * 604800));
+    } else {
+        secs = (int32_t)ucal_i64u32DivGM(sn.q, 0x93a80000, 0xbbd77933, 2).r;
+    }
+    secs -= UCAL_sysPhiGPS;
+    secs += ls;
+    qr = ucal_iu32Div(secs, 604800);
+    return (ucal_GpsRawTimeT){ .w = (qr.q & 1023), .t = qr.r };
+}
+
 // ----------------------------------------------------------------------------------------------
 ucal_iu32DivT
 ucal_GpsMapRaw1(
@@ -90,6 +119,37 @@ ucal_GpsMapRaw1(
     return dt;
 }
 
+// ----------------------------------------------------------------------------------------------
+// Unfold seconds of a GPS cycle, aligned to the UNIX epoch, around a base time in UNIX scale.
+// The base is 64 bits wide whatever the width of 'time_t'.
+static int64_t
+gps_Unfold(
+    int32_t secs ,
+    int64_t tbase)
+{
+    static const int32_t fcycle = INT32_C(604800) * 1024;	// seconds in a full cycle
+
+    if (tbase < UCAL_sysPhiGPS) {
+        tbase = UCAL_sysPhiGPS;
+    }
+
+    // Calculate cycle difference MOD full cycle length in 64 bit:
+    int64_t r = (int64_t)secs - tbase;
+    if (sizeof(size_t) >= sizeof(int64_t)) {
+        // we can do the division directly
+        size_t m = -(r < 0);
+        size_t q = m ^ ((m ^ r) / fcycle);
+        secs = (int32_t)(r - q * fcycle);
+    } else {
+        // We do an extended floor division step
+        secs = ucal_i64u32DivGM(
+            r, UINT32_C(0x93a80000), UINT32_C(0xbbd77933), 2).r;
+    }
+
+    // Just glue the parts together:
+    return tbase + secs;
+}
+
 // ----------------------------------------------------------------------------------------------
 time_t
 ucal_GpsMapRaw2(
@@ -115,29 +175,33 @@ ucal_GpsMapRaw2(
     // Get & trim the expansion / unfolding base:
     if (!base) {
         time(&tbase);
+        UCAL_PROBE1(gps_era_time, tbase);
         tbase -= (fcycle >> 1);
     } else {
         tbase = *base;
     }
-    if (tbase < UCAL_sysPhiGPS) {
-        tbase = UCAL_sysPhiGPS;
-    }
+    return (time_t)gps_Unfold(secs, (int64_t)tbase);
+}
 
-    // Calculate cycle difference MOD full cycle length in 64 bit:
-    int64_t r = (int64_t)secs - tbase;
-    if (sizeof(size_t) >= sizeof(int64_t)) {
-        // we can do the division directly
-        size_t m = -(r < 0);
-        size_t q = m ^ ((m ^ r) / fcycle);
-        secs = (int32_t)(r - q * fcycle);
+// ----------------------------------------------------------------------------------------------
+ucal_ns_t
+ucal_GpsMapRaw2Ns(
+    uint16_t         w    ,
+    uint32_t         t    ,
+    uint32_t         nsec ,
+    int16_t          ls   ,
+    const ucal_ns_t *base )
+{
+    int64_t tt;
+
+    // a base is unfolded in 64 bits, even with a 32-bit 'time_t'
+    if (base) {
+        tt = gps_Unfold((int32_t)(((w & 1023) * INT32_C(604800)) + t - ls + UCAL_sysPhiGPS),
+                        ucal_NsToSecs(*base).q);
     } else {
-        // We do an extended floor division step
-        secs = ucal_i64u32DivGM(
-            r, UINT32_C(0x93a80000), UINT32_C(0xbbd77933), 2).r;
+        tt = (int64_t)ucal_GpsMapRaw2(w, t, ls, NULL);
     }
-
-    // Just glue the parts together:
-    return tbase + secs;
+    return tt * 1000000000 + (int32_t)nsec;
 }
 
 // ----------------------------------------------------------------------------------------------
@@ -0,0 +1,422 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains time stamp extraction from time-ordered identifiers.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// time stamps of time-ordered identifiers
+///
+/// UUIDs, ULIDs, ObjectIds and Snowflake IDs carry their creation time in their leading bits.
+/// Getting it out is a matter of byte order and scale, except for UUID versions 1 and 6: they
+/// count 100ns ticks since the Gregorian reform, so the epoch shift comes from the calendar
+/// constants.
+///
+/// The text forms are decoded without a loop over the characters where possible: eight hex
+/// digits are loaded into a 64bit word, checked and folded into 32 bits with SWAR (SIMD within
+/// a register) arithmetic, like the ordinal date codec does with decimal digits.  Base32 goes
+/// through a table, but collects the error flags of all digits and checks them once.
+
+#include <errno.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/clockmap.h"
+#include "ucal/idstamp.h"
+
+// smallest field width in binary and text form, by ID kind
+static const uint8_t s_bmin[4] = { 16, 16, 12, 8 };
+static const uint8_t s_tmin[4] = { 32, 26, 24, 1 };
+
+// block size for the fused civil conversions
+#define IDS_BLOCK 128
+
+// Crockford base32 digit values plus one; zero marks an invalid character
+#define B32(c, v) [c] = (v) + 1
+static const uint8_t s_b32[256] = {
+    B32('0',  0), B32('1',  1), B32('2',  2), B32('3',  3), B32('4',  4),
+    B32('5',  5), B32('6',  6), B32('7',  7), B32('8',  8), B32('9',  9),
+    B32('A', 10), B32('B', 11), B32('C', 12), B32('D', 13), B32('E', 14), B32('F', 15),
+    B32('G', 16), B32('H', 17), B32('J', 18), B32('K', 19), B32('M', 20), B32('N', 21),
+    B32('P', 22), B32('Q', 23), B32('R', 24), B32('S', 25), B32('T', 26), B32('V', 27),
+    B32('W', 28), B32('X', 29), B32('Y', 30), B32('Z', 31),
+    B32('a', 10), B32('b', 11), B32('c', 12), B32('d', 13), B32('e', 14), B32('f', 15),
+    B32('g', 16), B32('h', 17), B32('j', 18), B32('k', 19), B32('m', 20), B32('n', 21),
+    B32('p', 22), B32('q', 23), B32('r', 24), B32('s', 25), B32('t', 26), B32('v', 27),
+    B32('w', 28), B32('x', 29), B32('y', 30), B32('z', 31),
+    B32('I',  1), B32('i',  1), B32('L',  1), B32('l',  1), B32('O',  0), B32('o',  0)
+};
+#undef B32
+
+// ----------------------------------------------------------------------------------------------
+// scaling
+// ----------------------------------------------------------------------------------------------
+
+static inline bool
+ids_MsToNs(
+    int64_t *into,
+    int64_t  ms  )
+{
+    if ((ms > INT64_MAX / 1000000) || (ms < INT64_MIN / 1000000)) {
+        errno = ERANGE;
+        return false;
+    }
+    *into = ms * 1000000;
+    return true;
+}
+
+// UUID from its first 8 bytes in big endian order
+static inline bool
+ids_Uuid(
+    int64_t *into,
+    uint64_t w   )
+{
+    int64_t ticks;
+
+    switch ((w >> 12) & 15u) {
+    case 1: // time_low, time_mid, time_hi
+        ticks = (int64_t)(((w & 0xFFFu) << 48) | (((w >> 16) & 0xFFFFu) << 32) | (w >> 32));
+        break;
+    case 6: // time_high, time_mid, time_low
+        ticks = (int64_t)(((w >> 16) << 12) | (w & 0xFFFu));
+        break;
+    case 7: // UNIX ms
+        return ids_MsToNs(into, (int64_t)(w >> 16));
+    default:
+        errno = EINVAL;
+        return false;
+    }
+    ticks -= (int64_t)UCAL_sysPhiUUID;
+    if ((ticks > INT64_MAX / 100) || (ticks < INT64_MIN / 100)) {
+        errno = ERANGE;
+        return false;
+    }
+    *into = ticks * 100;
+    return true;
+}
+
+static inline bool
+ids_Snowflake(
+    int64_t              *into,
+    ucal_IdFormatT const *fmt ,
+    uint64_t              id  )
+{
+    id >>= fmt->shift;
+    if (id > (uint64_t)(INT64_MAX / 1000000)) {
+        errno = ERANGE;
+        return false;
+    }
+    return ids_MsToNs(into, (int64_t)id + fmt->epoch);
+}
+
+static inline uint64_t
+ids_BE(
+    const uint8_t *p,
+    unsigned       n)
+{
+    uint64_t w = 0;
+
+    while (n--) {
+        w = (w << 8) | *p++;
+    }
+    return w;
+}
+
+// ----------------------------------------------------------------------------------------------
+// SWAR text conversion
+// ----------------------------------------------------------------------------------------------
+
+static inline uint32_t
+ids_Load4(
+    const char *str)
+{
+    const uint8_t *p = (const uint8_t*)str;
+    uint32_t       w;
+
+#   if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    memcpy(&w, p, 4);
+#   else
+    w = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+#   endif
+    return w;
+}
+
+// Decode eight hex digits held in a word in little endian order.  A byte below 0x80 is at
+// least 'c' if adding (0x80 - c) sets its high bit; no carry crosses into the next byte.
+static inline bool
+ids_Hex8(
+    uint32_t *into,
+    uint64_t  w   )
+{
+    const uint64_t ones = UINT64_C(0x0101010101010101);
+    const uint64_t high = ones * 0x80;
+    uint64_t       l    = w | (ones * 0x20);    // letters to lower case
+    uint64_t       dig  = (w + ones * (0x80 - '0')) & ~(w + ones * (0x80 - '9' - 1));
+    uint64_t       let  = (l + ones * (0x80 - 'a')) & ~(l + ones * (0x80 - 'f' - 1));
+    uint64_t       v;
+
+    if ((w & high) || (((dig | let) & high) != high)) {
+        errno = EINVAL;
+        return false;
+    }
+    v = (w & (ones * 0x0F)) + ((w >> 6) & ones) * 9;                // nibble values
+    v = ((v << 4) | (v >>  8)) & UINT64_C(0x00FF00FF00FF00FF);      // bytes
+    v = ((v << 8) | (v >> 16)) & UINT64_C(0x0000FFFF0000FFFF);      // 16bit groups
+    *into = (uint32_t)((v << 16) | (v >> 32));
+    return true;
+}
+
+static inline bool
+ids_TextUuid(
+    int64_t    *into  ,
+    const char *str   ,
+    size_t      stride)
+{
+    bool     hyphen = (stride >= 36) && ('-' == str[8]);
+    uint64_t lo     = ids_Load4(str) | ((uint64_t)ids_Load4(str + 4) << 32);
+    uint64_t hi;
+    uint32_t a, b;
+
+    if (hyphen) {
+        if (('-' != str[13]) || ('-' != str[18]) || ('-' != str[23])) {
+            errno = EINVAL;
+            return false;
+        }
+        hi = ids_Load4(str + 9) | ((uint64_t)ids_Load4(str + 14) << 32);
+    } else {
+        hi = ids_Load4(str + 8) | ((uint64_t)ids_Load4(str + 12) << 32);
+    }
+    return ids_Hex8(&a, lo) && ids_Hex8(&b, hi) && ids_Uuid(into, ((uint64_t)a << 32) | b);
+}
+
+static inline bool
+ids_TextUlid(
+    int64_t    *into,
+    const char *str )
+{
+    const uint8_t *p   = (const uint8_t*)str;
+    uint64_t       acc = 0;
+    unsigned       bad = 0, d, idx;
+
+    for (idx = 0; idx < 10; ++idx) {
+        d    = s_b32[p[idx]] - 1u;
+        bad |= d;
+        acc  = (acc << 5) | (d & 31u);
+    }
+    if ((bad & ~31u) || (acc >> 48)) {
+        errno = EINVAL;
+        return false;
+    }
+    return ids_MsToNs(into, (int64_t)acc);
+}
+
+static inline bool
+ids_TextSnowflake(
+    int64_t              *into  ,
+    ucal_IdFormatT const *fmt   ,
+    const char           *str   ,
+    size_t                stride)
+{
+    uint64_t id = 0;
+    unsigned d;
+    size_t   idx;
+
+    for (idx = 0; (idx < stride) && ((d = (uint8_t)str[idx] - (unsigned)'0') < 10u); ++idx) {
+        if (id > (UINT64_MAX - d) / 10u) {
+            errno = ERANGE;
+            return false;
+        }
+        id = id * 10u + d;
+    }
+    if (0 == idx) {
+        errno = EINVAL;
+        return false;
+    }
+    return ids_Snowflake(into, fmt, id);
+}
+
+// ----------------------------------------------------------------------------------------------
+// single identifiers
+// ----------------------------------------------------------------------------------------------
+
+static bool
+ids_Check(
+    ucal_IdFormatT const *fmt   ,
+    size_t                stride,
+    const uint8_t         wmin[4])
+{
+    if ((fmt->kind > ucal_IdSnowflake) || (stride < wmin[fmt->kind])
+        || ((ucal_IdSnowflake == fmt->kind)
+            && ((fmt->shift > 63) || (fmt->epoch > INT64_MAX / 2000000)
+                || (fmt->epoch < INT64_MIN / 2000000)))) {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+static inline bool
+ids_Bin(
+    int64_t              *into,
+    ucal_IdFormatT const *fmt ,
+    const uint8_t        *id  )
+{
+    uint64_t sf;
+
+    switch (fmt->kind) {
+    case ucal_IdUUID:
+        return ids_Uuid(into, ids_BE(id, 8));
+    case ucal_IdULID:
+        return ids_MsToNs(into, (int64_t)ids_BE(id, 6));
+    case ucal_IdObjectId:
+        *into = (int64_t)ids_BE(id, 4) * 1000000000;
+        return true;
+    default:
+        memcpy(&sf, id, sizeof(sf));
+        return ids_Snowflake(into, fmt, sf);
+    }
+}
+
+static inline bool
+ids_Text(
+    int64_t              *into  ,
+    ucal_IdFormatT const *fmt   ,
+    const char           *str   ,
+    size_t                stride)
+{
+    uint32_t secs;
+
+    switch (fmt->kind) {
+    case ucal_IdUUID:
+        return ids_TextUuid(into, str, stride);
+    case ucal_IdULID:
+        return ids_TextUlid(into, str);
+    case ucal_IdObjectId:
+        if (!ids_Hex8(&secs, ids_Load4(str) | ((uint64_t)ids_Load4(str + 4) << 32))) {
+            return false;
+        }
+        *into = (int64_t)secs * 1000000000;
+        return true;
+    default:
+        return ids_TextSnowflake(into, fmt, str, stride);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// API
+// ----------------------------------------------------------------------------------------------
+
+bool
+ucal_IdToNs(
+    int64_t              *into,
+    ucal_IdFormatT const *fmt ,
+    const uint8_t        *id  )
+{
+    return ids_Check(fmt, SIZE_MAX, s_bmin) && ids_Bin(into, fmt, id);
+}
+
+size_t
+ucal_IdToNsArray(
+    int64_t              *into  ,
+    ucal_IdFormatT const *fmt   ,
+    const uint8_t        *ids   ,
+    size_t                stride,
+    size_t                count )
+{
+    size_t idx;
+
+    if (!ids_Check(fmt, stride, s_bmin)) {
+        return 0;
+    }
+    for (idx = 0; idx < count; ++idx, ids += stride) {
+        if (!ids_Bin(&into[idx], fmt, ids)) {
+            break;
+        }
+    }
+    return idx;
+}
+
+size_t
+ucal_decIdArray(
+    int64_t              *into  ,
+    ucal_IdFormatT const *fmt   ,
+    const char           *text  ,
+    size_t                stride,
+    size_t                count )
+{
+    size_t idx;
+
+    if (!ids_Check(fmt, stride, s_tmin)) {
+        return 0;
+    }
+    for (idx = 0; idx < count; ++idx, text += stride) {
+        if (!ids_Text(&into[idx], fmt, text, stride)) {
+            break;
+        }
+    }
+    return idx;
+}
+
+size_t
+ucal_IdToCivilArray(
+    ucal_CivilDateT      *date  ,
+    ucal_CivilTimeT      *time  ,
+    uint32_t             *nsec  ,
+    ucal_IdFormatT const *fmt   ,
+    const uint8_t        *ids   ,
+    size_t                stride,
+    size_t                count )
+{
+    int64_t buf[IDS_BLOCK];
+    size_t  done = 0, todo, got;
+
+    while (done < count) {
+        todo = (count - done < IDS_BLOCK) ? (count - done) : IDS_BLOCK;
+        got  = ucal_IdToNsArray(buf, fmt, ids + done * stride, stride, todo);
+        ucal_NsToCivilArrayGD(date + done, time + done, (nsec ? nsec + done : NULL), buf, got);
+        done += got;
+        if (got != todo) {
+            break;
+        }
+    }
+    return done;
+}
+
+size_t
+ucal_decIdCivilArray(
+    ucal_CivilDateT      *date  ,
+    ucal_CivilTimeT      *time  ,
+    uint32_t             *nsec  ,
+    ucal_IdFormatT const *fmt   ,
+    const char           *text  ,
+    size_t                stride,
+    size_t                count )
+{
+    int64_t buf[IDS_BLOCK];
+    size_t  done = 0, todo, got;
+
+    while (done < count) {
+        todo = (count - done < IDS_BLOCK) ? (count - done) : IDS_BLOCK;
+        got  = ucal_decIdArray(buf, fmt, text + done * stride, stride, todo);
+        ucal_NsToCivilArrayGD(date + done, time + done, (nsec ? nsec + done : NULL), buf, got);
+        done += got;
+        if (got != todo) {
+            break;
+        }
+    }
+    return done;
+}
+
+// -*- that's all folks -*-
@@ -18,10 +18,29 @@
 #include "ucal/common.h"
 #include "ucal/calconst.h"
 #include "ucal/ntpdate.h"
+#include "probes.h"
 
 /// @file
 /// NTP time scale mappings
 
+// Unfold NTP seconds around a base time in UNIX scale; the base is 64 bits wide whatever the
+// width of 'time_t'.
+static int64_t
+ntp_Unfold(
+    uint32_t secs ,
+    int64_t  tbase)
+{
+    if (tbase > INT64_C(0x80000000)) {
+        tbase -= INT64_C(0x80000000);
+    } else {
+        tbase = 0;
+    }
+    // now do a periodic expansion (mod 2³²). Which is dead-pan easy :)
+    secs += UCAL_sysPhiNTP;     // align NTP scale to Unix scale (implicit mod 2³²!)
+    secs -= (uint32_t)tbase;    // get cycle difference          (implicit mod 2³²!)
+    return tbase + secs;        // add difference to base, and that's it!
+}
+
 time_t
 ucal_NtpToTime(
     uint32_t      secs,
@@ -29,20 +48,49 @@ ucal_NtpToTime(
 {
     if (sizeof(time_t) > sizeof(uint32_t)) {
         // we have some real work to do... start with getting the expansion base.
-        time_t tbase = pivot ? *pivot : time(NULL);
-        if (tbase > UINT32_C(0x80000000)) {
-            tbase -= UINT32_C(0x80000000);
+        time_t tbase;
+        if (pivot) {
+            tbase = *pivot;
         } else {
-            tbase = 0;
+            tbase = time(NULL);
+            UCAL_PROBE1(ntp_era_time, tbase);
         }
-        // now do a periodic expansion (mod 2³²). Which is dead-pan easy :)
-        secs += UCAL_sysPhiNTP;     // align NTP scale to Unix scale (implicit mod 2³²!)
-        secs -= tbase;              // get cycle difference          (implicit mod 2³²!)
-        return tbase + secs;        // add difference to base, and that's it!
+        return (time_t)ntp_Unfold(secs, (int64_t)tbase);
     } else {
         // Hmpf. This system will have trouble soon... but here we go anyway:
         return ucal_u32_i32(secs += UCAL_sysPhiNTP);
     }
 }
 
+ucal_ns_t
+ucal_NtpToNs(
+    uint32_t         secs ,
+    uint32_t         frac ,
+    const ucal_ns_t *pivot)
+{
+    int64_t const nsec = (int64_t)(((uint64_t)frac * 1000000000u + 0x80000000u) >> 32);
+    int64_t       tt;
+
+    // a pivot is unfolded in 64 bits, even with a 32-bit 'time_t'
+    if (pivot) {
+        tt = ntp_Unfold(secs, ucal_NsToSecs(*pivot).q);
+    } else {
+        tt = (int64_t)ucal_NtpToTime(secs, NULL);
+    }
+    return tt * 1000000000 + nsec;
+}
+
+uint32_t
+ucal_NsToNtp(
+    uint32_t *frac,
+    ucal_ns_t ns  )
+{
+    ucal_i64u32DivT sn = ucal_NsToSecs(ns);
+
+    if (frac) {
+        *frac = (uint32_t)((((uint64_t)sn.r << 32) + 500000000u) / 1000000000u);
+    }
+    return (uint32_t)sn.q - (uint32_t)UCAL_sysPhiNTP;
+}
+
 // -*- that's all folks -*-
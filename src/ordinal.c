@@ -0,0 +1,390 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains support for ISO8601 ordinal dates.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// ISO8601 ordinal dates
+///
+/// An ordinal date is a year and the day in that year, as used by seismic, satellite and
+/// mainframe data (@c YYYYDDD or @c YYYY-DDD).  The calendar part is trivial; the text part is
+/// done with SWAR (SIMD within a register) arithmetic: the eight characters of a date are
+/// loaded into a 64bit word, checked for digits and folded into two binary numbers in three
+/// steps, without a loop over the digits.  The encoder runs the same steps backwards.
+///
+/// The array functions remember the span of the last year seen, since real data rarely jumps
+/// between years; the full year split is only done when a date leaves that span.
+
+#include <errno.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/ordinal.h"
+
+// cumulated month lengths in a regular year
+static const int16_t s_mstart[12] = {
+    0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
+};
+
+// ----------------------------------------------------------------------------------------------
+// the year span cache
+// ----------------------------------------------------------------------------------------------
+
+typedef struct {
+    int32_t ylo;    // RDN of Jan,1
+    int32_t yhi;    // RDN of Dec,31
+    int16_t year;   // calendar year
+} ord_YearT;
+
+static inline bool
+ord_SetYear(
+    ord_YearT *yc  ,
+    int32_t    rdn )
+{
+    bool          isLY;
+    ucal_iu32DivT yd = ucal_DaysToYearsGD(rdn, &isLY);
+
+    ++yd.q; // from elapsed to calendar year!
+    if (yd.q < INT16_MIN || yd.q > INT16_MAX) {
+        errno = ERANGE;
+        return false;
+    }
+    yc->year = (int16_t)yd.q;
+    yc->ylo  = rdn - (int32_t)yd.r;
+    yc->yhi  = yc->ylo + 364 + isLY;
+    return true;
+}
+
+static inline bool
+ord_Split(
+    ucal_OrdinalDateT *into,
+    ord_YearT         *yc  ,
+    int32_t            rdn )
+{
+    if (((rdn < yc->ylo) || (rdn > yc->yhi)) && !ord_SetYear(yc, rdn)) {
+        return false;
+    }
+    into->dYear = yc->year;
+    into->dYDay = (int16_t)(rdn - yc->ylo + 1);
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// SWAR text conversion
+// ----------------------------------------------------------------------------------------------
+
+// Decode 'YYYY?DDD', held in a word in little endian order with the separator replaced by a
+// '0'.  That gives two four-digit numbers in the two halves of the word.
+static inline bool
+ord_SwarDec(
+    ucal_OrdinalDateT *into,
+    uint64_t           w   )
+{
+    uint64_t v = w - UINT64_C(0x3030303030303030);
+    uint32_t y, d;
+
+    // a byte is a digit if neither (b - '0') nor (b + 0x46) has the high bit set
+    if (((w + UINT64_C(0x4646464646464646)) | v) & UINT64_C(0x8080808080808080)) {
+        errno = EINVAL;
+        return false;
+    }
+    v = (v * 10  + (v >> 8))  & UINT64_C(0x00FF00FF00FF00FF);    // 2-digit groups
+    v = (v * 100 + (v >> 16)) & UINT64_C(0x0000FFFF0000FFFF);    // 4-digit groups
+    y = (uint32_t)v;
+    d = (uint32_t)(v >> 32);
+    if ((d < 1) || (d > 365u + ucal_IsLeapYearGD(y))) {
+        errno = EINVAL;
+        return false;
+    }
+    into->dYear = (int16_t)y;
+    into->dYDay = (int16_t)d;
+    return true;
+}
+
+// Encode year (0..9999) and day (0..9999) as 'YYYY0DDD' in little endian order. The numbers
+// are split into halves by 100 and then into digits by 10, with all parts in parallel; the
+// divisions are done by reciprocal multiplication.
+static inline uint64_t
+ord_SwarEnc(
+    uint32_t y,
+    uint32_t d)
+{
+    uint64_t w = y | ((uint64_t)d << 32);
+    uint64_t q = ((w * 5243) >> 19) & UINT64_C(0x0000007F0000007F);    // n / 100
+    w = q | ((w - q * 100) << 16);
+    q = ((w * 103) >> 10) & UINT64_C(0x000F000F000F000F);              // n / 10
+    w = q | ((w - q * 10) << 8);
+    return w + UINT64_C(0x3030303030303030);
+}
+
+// Load a field as little endian word, with the separator set to '0'; 'hyphen' selects the
+// format.  The day part is loaded with the byte before it, which is then replaced; this gives
+// two overlapping 32bit loads.  Only the little endian path can use plain loads.
+static inline uint64_t
+ord_Load(
+    const char *str   ,
+    bool        hyphen)
+{
+    const uint8_t *p = (const uint8_t*)str;
+    uint32_t       lo, hi;
+
+#   if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    memcpy(&lo, p, 4);
+    memcpy(&hi, p + 3 + hyphen, 4);
+#   else
+    lo = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    p += 3 + hyphen;
+    hi = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+#   endif
+    hi = (hi & ~UINT32_C(0xFF)) | '0';
+    return lo | ((uint64_t)hi << 32);
+}
+
+static inline void
+ord_Store(
+    char    *str   ,
+    uint64_t w     ,
+    bool     hyphen)
+{
+    str[0] = (char)(w      );
+    str[1] = (char)(w >>  8);
+    str[2] = (char)(w >> 16);
+    str[3] = (char)(w >> 24);
+    if (hyphen) {
+        str[4] = '-';
+        ++str;
+    }
+    str[4] = (char)(w >> 40);
+    str[5] = (char)(w >> 48);
+    str[6] = (char)(w >> 56);
+}
+
+// ----------------------------------------------------------------------------------------------
+// calendar conversions
+// ----------------------------------------------------------------------------------------------
+
+int32_t
+ucal_DateToRdnOD(
+    int16_t y ,
+    int16_t yd)
+{
+    return ucal_YearStartGD(y) + yd - 1;
+}
+
+bool
+ucal_RdnToDateOD(
+    ucal_OrdinalDateT *into,
+    int32_t            rdn )
+{
+    ord_YearT yc;
+
+    if (!ord_SetYear(&yc, rdn)) {
+        return false;
+    }
+    into->dYear = yc.year;
+    into->dYDay = (int16_t)(rdn - yc.ylo + 1);
+    return true;
+}
+
+bool
+ucal_OrdinalToCivilGD(
+    ucal_CivilDateT         *into,
+    ucal_OrdinalDateT const *od  )
+{
+    bool          isLY = ucal_IsLeapYearGD(od->dYear);
+    ucal_iu32DivT md;
+
+    if ((od->dYDay < 1) || (od->dYDay > 365 + isLY)) {
+        errno = EINVAL;
+        return false;
+    }
+    md = ucal_DaysToMonth(od->dYDay - 1, isLY);
+    into->dYear  = od->dYear;
+    into->dYDay  = od->dYDay;
+    into->fLeap  = isLY;
+    into->dWDay  = ucal_i32SubMod7(ucal_DateToRdnOD(od->dYear, od->dYDay), 1) + 1;
+    into->dMonth = (int8_t)(md.q + 1);
+    into->dMDay  = (int8_t)(md.r + 1);
+    return true;
+}
+
+bool
+ucal_CivilToOrdinalGD(
+    ucal_OrdinalDateT *into,
+    int16_t            y   ,
+    int16_t            m   ,
+    int16_t            d   )
+{
+    bool isLY = ucal_IsLeapYearGD(y);
+
+    if ((m < 1) || (m > 12) || (d < 1) || (d > _ucal_mdtab[isLY][m - 1])) {
+        errno = EINVAL;
+        return false;
+    }
+    into->dYear = y;
+    into->dYDay = s_mstart[m - 1] + (isLY && (m > 2)) + d;
+    return true;
+}
+
+size_t
+ucal_RdnToDateODArray(
+    ucal_OrdinalDateT *into ,
+    int32_t const     *rdn  ,
+    size_t             count)
+{
+    ord_YearT yc = { 1, 0, 0 };
+    size_t    idx;
+
+    for (idx = 0; idx < count; ++idx) {
+        if (!ord_Split(&into[idx], &yc, rdn[idx])) {
+            break;
+        }
+    }
+    return idx;
+}
+
+void
+ucal_DateToRdnODArray(
+    int32_t                 *into ,
+    ucal_OrdinalDateT const *od   ,
+    size_t                   count)
+{
+    int32_t ylo  = ucal_YearStartGD(0);
+    int16_t year = 0;
+    size_t  idx;
+
+    for (idx = 0; idx < count; ++idx) {
+        if (od[idx].dYear != year) {
+            year = od[idx].dYear;
+            ylo  = ucal_YearStartGD(year);
+        }
+        into[idx] = ylo + od[idx].dYDay - 1;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// text conversions
+// ----------------------------------------------------------------------------------------------
+
+bool
+ucal_decOrdinal(
+    ucal_OrdinalDateT *into,
+    const char       **pstr,
+    const char        *end )
+{
+    const char *str = *pstr;
+    size_t      len;
+    bool        hyphen;
+
+    len = (NULL == end) ? strnlen(str, 8) : (size_t)(end - str);
+    if (len < 7) {
+        errno = EINVAL;
+        return false;
+    }
+    hyphen = ('-' == str[4]);
+    if (hyphen && (len < 8)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!ord_SwarDec(into, ord_Load(str, hyphen))) {
+        return false;
+    }
+    *pstr = str + 7 + hyphen;
+    return true;
+}
+
+size_t
+ucal_encOrdinal(
+    char                    *buf   ,
+    size_t                   size  ,
+    ucal_OrdinalDateT const *od    ,
+    bool                     hyphen)
+{
+    size_t len = 7u + hyphen;
+
+    if ((size <= len) || (od->dYear < 0) || (od->dYear > 9999)) {
+        errno = ERANGE;
+        return 0;
+    }
+    if ((od->dYDay < 1) || (od->dYDay > 365 + ucal_IsLeapYearGD(od->dYear))) {
+        errno = EINVAL;
+        return 0;
+    }
+    ord_Store(buf, ord_SwarEnc((uint32_t)od->dYear, (uint32_t)od->dYDay), hyphen);
+    buf[len] = '\0';
+    return len;
+}
+
+size_t
+ucal_decOrdinalArray(
+    int32_t    *into  ,
+    const char *text  ,
+    size_t      stride,
+    size_t      count )
+{
+    ucal_OrdinalDateT od;
+    int32_t           ylo  = ucal_YearStartGD(0);
+    int16_t           year = 0;
+    size_t            idx;
+
+    if (stride < 7) {
+        errno = EINVAL;
+        return 0;
+    }
+    for (idx = 0; idx < count; ++idx, text += stride) {
+        bool hyphen = ('-' == text[4]) && (stride > 7);
+        if (!ord_SwarDec(&od, ord_Load(text, hyphen))) {
+            break;
+        }
+        if (od.dYear != year) {
+            year = od.dYear;
+            ylo  = ucal_YearStartGD(year);
+        }
+        into[idx] = ylo + od.dYDay - 1;
+    }
+    return idx;
+}
+
+size_t
+ucal_encOrdinalArray(
+    char          *text  ,
+    size_t         stride,
+    int32_t const *rdn   ,
+    size_t         count ,
+    bool           hyphen)
+{
+    ucal_OrdinalDateT od;
+    ord_YearT         yc = { 1, 0, 0 };
+    size_t            idx;
+
+    if (stride < 7u + hyphen) {
+        errno = ERANGE;
+        return 0;
+    }
+    for (idx = 0; idx < count; ++idx, text += stride) {
+        if (!ord_Split(&od, &yc, rdn[idx])) {
+            break;
+        }
+        if ((od.dYear < 0) || (od.dYear > 9999)) {
+            errno = ERANGE;
+            break;
+        }
+        ord_Store(text, ord_SwarEnc((uint32_t)od.dYear, (uint32_t)od.dYDay), hyphen);
+    }
+    return idx;
+}
+
+// -*- that's all folks -*-
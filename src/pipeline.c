@@ -0,0 +1,407 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains a threaded decode -> convert -> format pipeline.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// threaded record pipeline
+///
+/// Records travel in batches through four stages: decode (ASN.1 GeneralizedTime to UTC), zone
+/// conversion, split into local civil date/time, and formatting as ISO 8601 text.  The stages
+/// are distributed over 1..4 threads; consecutive threads are connected by lock-free single
+/// producer / single consumer rings of batch pointers.  A full ring blocks the producer, so a
+/// slow stage throttles everything upstream.
+///
+/// C99 has no atomics, so the rings use the GCC/Clang @c __atomic builtins.  Waiting is done by
+/// spinning for a short while and then yielding the CPU, which keeps the latency low on a
+/// loaded pipe without burning a core on an idle one.
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/tsdecode.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzbatch.h"
+#include "ucal/pipeline.h"
+
+#if !defined(__GNUC__)
+# error "the pipeline needs the GCC/Clang __atomic builtins"
+#endif
+
+// ----------------------------------------------------------------------------------------------
+// batches
+// ----------------------------------------------------------------------------------------------
+
+// Column layout, ordered by alignment: tsUtc, scratch (8 byte aligned), text, nsec, offs,
+// date, zoneId, time, status, flags, out.
+
+size_t
+ucal_PipeBatchMemSize(
+    size_t capacity,
+    size_t nzones  )
+{
+    size_t scratch = tziBatchScratchSize(capacity, nzones);
+    scratch = (scratch + 7u) & ~(size_t)7u;
+    return capacity * (sizeof(int64_t) + sizeof(const char*) + 2 * sizeof(int32_t)
+                       + sizeof(ucal_CivilDateT) + sizeof(uint16_t) + sizeof(ucal_CivilTimeT)
+                       + 2 * sizeof(uint8_t) + UCAL_PIPE_TXTLEN)
+         + scratch;
+}
+
+void
+ucal_PipeBatchInit(
+    ucal_PipeBatchT *batch   ,
+    void            *mem     ,
+    size_t           capacity,
+    size_t           nzones  )
+{
+    size_t scratch = tziBatchScratchSize(capacity, nzones);
+    char  *cp      = (char*)mem;
+
+    scratch = (scratch + 7u) & ~(size_t)7u;
+    memset(batch, 0, sizeof(*batch));
+    batch->capacity = capacity;
+    batch->tsUtc    = (int64_t*)cp;          cp += capacity * sizeof(int64_t);
+    batch->scratch  = cp;                    cp += scratch;
+    batch->text     = (const char**)cp;      cp += capacity * sizeof(const char*);
+    batch->nsec     = (int32_t*)cp;          cp += capacity * sizeof(int32_t);
+    batch->offs     = (int32_t*)cp;          cp += capacity * sizeof(int32_t);
+    batch->date     = (ucal_CivilDateT*)cp;  cp += capacity * sizeof(ucal_CivilDateT);
+    batch->zoneId   = (uint16_t*)cp;         cp += capacity * sizeof(uint16_t);
+    batch->time     = (ucal_CivilTimeT*)cp;  cp += capacity * sizeof(ucal_CivilTimeT);
+    batch->status   = (uint8_t*)cp;          cp += capacity * sizeof(uint8_t);
+    batch->flags    = (uint8_t*)cp;          cp += capacity * sizeof(uint8_t);
+    batch->out      = cp;
+}
+
+// ----------------------------------------------------------------------------------------------
+// stages
+// ----------------------------------------------------------------------------------------------
+
+static void
+pipe_Decode(ucal_PipeBatchT *b, ucal_PipeCfgT const *cfg)
+{
+    struct timespec ts;
+    size_t          idx;
+
+    (void)cfg;
+    for (idx = 0; idx < b->count; ++idx) {
+        const char *cp = b->text[idx];
+        errno = 0;
+        if (cp && ucal_decASN1GenTime24(&ts, &cp, NULL)) {
+            b->tsUtc[idx]  = ts.tv_sec;
+            b->nsec[idx]   = (int32_t)ts.tv_nsec;
+            b->status[idx] = 0;
+        } else {
+            b->tsUtc[idx]  = 0;
+            b->nsec[idx]   = 0;
+            b->status[idx] = errno ? (uint8_t)errno : EINVAL;
+        }
+    }
+}
+
+static void
+pipe_Convert(ucal_PipeBatchT *b, ucal_PipeCfgT const *cfg)
+{
+    size_t idx;
+
+    if (!tziBatchUtc2LocalByZone(b->offs, b->flags, b->tsUtc, b->zoneId, b->count,
+                                 cfg->ctxTab, cfg->nzones, b->scratch)) {
+        // some zone id is out of range; sort that out record by record
+        for (idx = 0; idx < b->count; ++idx) {
+            if ((b->zoneId[idx] >= cfg->nzones)
+                || !tziBatchUtc2Local(b->offs + idx, b->flags + idx,
+                                      cfg->ctxTab + b->zoneId[idx], b->tsUtc + idx, 1))
+            {
+                b->offs[idx]  = 0;
+                b->flags[idx] = 0;
+                if (!b->status[idx]) {
+                    b->status[idx] = EINVAL;
+                }
+            }
+        }
+    }
+}
+
+static void
+pipe_Split(ucal_PipeBatchT *b, ucal_PipeCfgT const *cfg)
+{
+    ucal_TimeDivT qr;
+    int64_t       rdn;
+    size_t        idx;
+
+    (void)cfg;
+    for (idx = 0; idx < b->count; ++idx) {
+        qr  = ucal_TimeToRdn((time_t)b->tsUtc[idx]);
+        rdn = (int64_t)qr.q + ucal_DayTimeSplit(b->time + idx, (int32_t)qr.r, b->offs[idx]);
+        if ((rdn < INT32_MIN) || (rdn > INT32_MAX)
+            || !ucal_RdnToDateGD(b->date + idx, (int32_t)rdn)) {
+            memset(b->date + idx, 0, sizeof(*b->date));
+            if (!b->status[idx]) {
+                b->status[idx] = ERANGE;
+            }
+        }
+    }
+}
+
+// put 'n' decimal digits of 'v', right to left
+static void
+pipe_Digits(char *cp, unsigned v, unsigned n)
+{
+    cp += n;
+    while (n--) {
+        *--cp = (char)('0' + v % 10u);
+        v /= 10u;
+    }
+}
+
+static void
+pipe_Format(ucal_PipeBatchT *b, ucal_PipeCfgT const *cfg)
+{
+    size_t idx;
+
+    (void)cfg;
+    for (idx = 0; idx < b->count; ++idx) {
+        char                  *cp  = b->out + idx * UCAL_PIPE_TXTLEN;
+        ucal_CivilDateT const *d   = b->date + idx;
+        ucal_CivilTimeT const *t   = b->time + idx;
+        int32_t                ofs = b->offs[idx] / 60;
+
+        if (b->status[idx] || (d->dYear < 0) || (d->dYear > 9999)) {
+            *cp = '\0';
+            continue;
+        }
+        pipe_Digits(cp, (unsigned)d->dYear, 4);  cp[4]  = '-';
+        pipe_Digits(cp + 5, d->dMonth, 2);       cp[7]  = '-';
+        pipe_Digits(cp + 8, d->dMDay, 2);        cp[10] = 'T';
+        pipe_Digits(cp + 11, t->tHour, 2);       cp[13] = ':';
+        pipe_Digits(cp + 14, t->tMin, 2);        cp[16] = ':';
+        pipe_Digits(cp + 17, t->tSec, 2);
+        cp += 19;
+        if (b->nsec[idx]) {
+            *cp = '.';
+            pipe_Digits(cp + 1, (unsigned)b->nsec[idx], 9);
+            cp += 10;
+        }
+        if (ofs < 0) {
+            *cp++ = '-';
+            ofs   = -ofs;
+        } else {
+            *cp++ = '+';
+        }
+        pipe_Digits(cp, (unsigned)ofs / 60u, 2);  cp[2] = ':';
+        pipe_Digits(cp + 3, (unsigned)ofs % 60u, 2);
+        cp[5] = '\0';
+    }
+}
+
+typedef void (*pipe_StageT)(ucal_PipeBatchT*, ucal_PipeCfgT const*);
+
+static const pipe_StageT s_stages[UCAL_PIPE_STAGES] = {
+    pipe_Decode, pipe_Convert, pipe_Split, pipe_Format
+};
+
+void
+ucal_PipeProcess(
+    ucal_PipeBatchT     *batch,
+    ucal_PipeCfgT const *cfg  )
+{
+    unsigned idx;
+    for (idx = 0; idx < UCAL_PIPE_STAGES; ++idx) {
+        s_stages[idx](batch, cfg);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// rings
+// ----------------------------------------------------------------------------------------------
+
+// end-of-input marker travelling down the pipe
+static ucal_PipeBatchT s_eof;
+
+static void
+pipe_Wait(unsigned *spins)
+{
+    if (++*spins < 64) {
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    } else {
+        sched_yield();
+    }
+}
+
+static bool
+pipe_TryPush(ucal_PipeRingT *r, unsigned depth, ucal_PipeBatchT *b)
+{
+    unsigned const h = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+    unsigned const t = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    if (h - t >= depth) {
+        return false;
+    }
+    r->slot[h % UCAL_PIPE_RING] = b;
+    __atomic_store_n(&r->head, h + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool
+pipe_TryPop(ucal_PipeRingT *r, ucal_PipeBatchT **pb)
+{
+    unsigned const t = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+    unsigned const h = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    if (h == t) {
+        return false;
+    }
+    *pb = r->slot[t % UCAL_PIPE_RING];
+    __atomic_store_n(&r->tail, t + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void
+pipe_Push(ucal_PipeRingT *r, unsigned depth, ucal_PipeBatchT *b)
+{
+    unsigned spins = 0;
+    while (!pipe_TryPush(r, depth, b)) {
+        pipe_Wait(&spins);
+    }
+}
+
+static ucal_PipeBatchT*
+pipe_Pop(ucal_PipeRingT *r)
+{
+    ucal_PipeBatchT *b;
+    unsigned         spins = 0;
+    while (!pipe_TryPop(r, &b)) {
+        pipe_Wait(&spins);
+    }
+    return b;
+}
+
+// ----------------------------------------------------------------------------------------------
+// threads
+// ----------------------------------------------------------------------------------------------
+
+static void*
+pipe_Worker(void *arg)
+{
+    ucal_PipeWorkerT * const w    = (ucal_PipeWorkerT*)arg;
+    ucal_PipeT       * const pipe = w->pipe;
+    ucal_PipeBatchT         *b;
+    unsigned                 st;
+
+    do {
+        b = pipe_Pop(&pipe->ring[w->index]);
+        if (b != &s_eof) {
+            for (st = w->sbeg; st < w->send; ++st) {
+                s_stages[st](b, &pipe->cfg);
+            }
+        }
+        pipe_Push(&pipe->ring[w->index + 1], pipe->cfg.depth, b);
+    } while (b != &s_eof);
+    return NULL;
+}
+
+bool
+ucal_PipeStart(
+    ucal_PipeT          *pipe,
+    ucal_PipeCfgT const *cfg )
+{
+    unsigned idx;
+    int      rc;
+
+    if ((NULL == pipe) || (NULL == cfg)
+        || (cfg->nthreads < 1) || (cfg->nthreads > UCAL_PIPE_STAGES)
+        || (cfg->depth < 1) || (cfg->depth > UCAL_PIPE_RING)
+        || (cfg->nzones && (NULL == cfg->ctxTab)))
+    {
+        errno = EINVAL;
+        return false;
+    }
+    memset(pipe, 0, sizeof(*pipe));
+    pipe->cfg = *cfg;
+
+    for (idx = 0; idx < cfg->nthreads; ++idx) {
+        ucal_PipeWorkerT * const w = &pipe->worker[idx];
+        w->pipe  = pipe;
+        w->index = idx;
+        w->sbeg  = idx * UCAL_PIPE_STAGES / cfg->nthreads;
+        w->send  = (idx + 1) * UCAL_PIPE_STAGES / cfg->nthreads;
+        rc = pthread_create(&w->thread, NULL, pipe_Worker, w);
+        if (rc) {
+            // shut down what we have started so far
+            pipe->cfg.nthreads = idx;
+            if (idx) {
+                ucal_PipeClose(pipe);
+                while (ucal_PipeReceive(pipe)) {
+                    // drain
+                }
+                ucal_PipeJoin(pipe);
+            }
+            errno = rc;
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+ucal_PipeSubmit(
+    ucal_PipeT      *pipe ,
+    ucal_PipeBatchT *batch)
+{
+    pipe_Push(&pipe->ring[0], pipe->cfg.depth, batch);
+}
+
+bool
+ucal_PipeTryReceive(
+    ucal_PipeT       *pipe  ,
+    ucal_PipeBatchT **pbatch)
+{
+    ucal_PipeBatchT *b;
+    if (!pipe_TryPop(&pipe->ring[pipe->cfg.nthreads], &b)) {
+        return false;
+    }
+    *pbatch = (b == &s_eof) ? NULL : b;
+    return true;
+}
+
+ucal_PipeBatchT*
+ucal_PipeReceive(
+    ucal_PipeT *pipe)
+{
+    ucal_PipeBatchT *b = pipe_Pop(&pipe->ring[pipe->cfg.nthreads]);
+    return (b == &s_eof) ? NULL : b;
+}
+
+void
+ucal_PipeClose(
+    ucal_PipeT *pipe)
+{
+    pipe_Push(&pipe->ring[0], pipe->cfg.depth, &s_eof);
+}
+
+void
+ucal_PipeJoin(
+    ucal_PipeT *pipe)
+{
+    unsigned idx;
+    for (idx = 0; idx < pipe->cfg.nthreads; ++idx) {
+        pthread_join(pipe->worker[idx].thread, NULL);
+    }
+}
+
+// -*- that's all folks -*-
@@ -0,0 +1,47 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains internal definitions for static trace points (USDT probes).
+// ----------------------------------------------------------------------------------------------
+#ifndef PROBES_H_D2078C60_0B6B_439F_B110_087913F54042
+#define PROBES_H_D2078C60_0B6B_439F_B110_087913F54042
+
+// Static probes are compiled in only if 'UCAL_WITH_SDT' is defined (see the 'UCAL_USDT' build
+// option) and <sys/sdt.h> is available.  An unattached probe is a single NOP instruction, and the
+// arguments are only materialised where they are in registers or memory anyway; an attached
+// tracer (bpftrace, perf, systemtap) picks them up from there.  Otherwise the macros expand to
+// nothing and the arguments are not evaluated at all.
+//
+// All probes use the provider name 'ucal':
+//
+//  tz_ctx_update(tsfrom, year, ttDST, ttSTD)        transition frame recomputed
+//  tz_local2utc_reject(tsfrom, hint, kind, ttLo, ttHi)
+//                                                   local time in gap (kind 1) or overlap (kind 2)
+//  tsd_mktime_retry(tzmode, year, mon, mday, tod)   'mktime()' retried with 'tm_isdst = tzmode'
+//  tsd_mktime_fail(year, mon, mday, tod)            all 'mktime()' attempts failed
+//  gps_era_time(tbase)                              GPS era expansion called 'time()'
+//  ntp_era_time(tbase)                              NTP era expansion called 'time()'
+
+#if defined(UCAL_WITH_SDT)
+# include <sys/sdt.h>
+# define UCAL_PROBE1(name, a1)                  DTRACE_PROBE1(ucal, name, a1)
+# define UCAL_PROBE4(name, a1, a2, a3, a4)      DTRACE_PROBE4(ucal, name, a1, a2, a3, a4)
+# define UCAL_PROBE5(name, a1, a2, a3, a4, a5)  DTRACE_PROBE5(ucal, name, a1, a2, a3, a4, a5)
+#else
+# define UCAL_PROBE1(name, a1)                  do {} while (0)
+# define UCAL_PROBE4(name, a1, a2, a3, a4)      do {} while (0)
+# define UCAL_PROBE5(name, a1, a2, a3, a4, a5)  do {} while (0)
+#endif
+
+#endif /*PROBES_H_D2078C60_0B6B_439F_B110_087913F54042*/
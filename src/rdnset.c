@@ -0,0 +1,653 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains compressed sets of days.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// compressed sets of days
+///
+/// The set is cut into calendar years, in the manner of roaring bitmaps: each year with days
+/// in the set has a container, either a bitmap of 366 days or a short list of runs.  The set
+/// operations expand both operands of a year to bitmaps and combine six words; these loops
+/// have a fixed length and no branches, so the compiler can keep them in vector registers.
+/// The result is packed again into the smaller form.
+///
+/// Every container knows how many days come before it, so rank and select only need a binary
+/// search on the containers and some counting in one of them.
+
+#include <errno.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/rdnset.h"
+
+#define RDS_NWORD 6
+
+typedef uint64_t rds_BitsT[RDS_NWORD];
+
+// A container must stay one cache line: 16 bytes of header and the 48-byte union.  C99 has no
+// static assertion, so a negative array size makes the build fail instead.
+typedef char rds_ContSizeCheck[(sizeof(ucal_RdnSetContT) == 64) ? 1 : -1];
+
+// ----------------------------------------------------------------------------------------------
+// bit fiddling
+// ----------------------------------------------------------------------------------------------
+
+static inline unsigned
+rds_Pop64(
+    uint64_t v)
+{
+#ifdef __GNUC__
+    return (unsigned)__builtin_popcountll(v);
+#else
+    v = v - ((v >> 1) & UINT64_C(0x5555555555555555));
+    v = (v & UINT64_C(0x3333333333333333)) + ((v >> 2) & UINT64_C(0x3333333333333333));
+    v = (v + (v >> 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+    return (unsigned)((v * UINT64_C(0x0101010101010101)) >> 56);
+#endif
+}
+
+// index of the lowest bit; v must not be zero
+static inline unsigned
+rds_Ctz64(
+    uint64_t v)
+{
+#ifdef __GNUC__
+    return (unsigned)__builtin_ctzll(v);
+#else
+    return rds_Pop64((v & -v) - 1);
+#endif
+}
+
+// set the bits [lo,hi[
+static void
+rds_SetRange(
+    rds_BitsT bits,
+    unsigned  lo  ,
+    unsigned  hi  )
+{
+    unsigned w;
+
+    for (w = lo >> 6; (w < RDS_NWORD) && (w * 64 < hi); ++w) {
+        uint64_t m = ~UINT64_C(0);
+        if (lo > w * 64) {
+            m <<= (lo - w * 64);
+        }
+        if (hi < w * 64 + 64) {
+            m &= ~(~UINT64_C(0) << (hi - w * 64));
+        }
+        bits[w] |= m;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// containers
+// ----------------------------------------------------------------------------------------------
+
+static void
+rds_ToBits(
+    rds_BitsT               bits,
+    ucal_RdnSetContT const *c   )
+{
+    unsigned i;
+
+    if (ucal_RdnSetBits == c->kind) {
+        memcpy(bits, c->u.bits, sizeof(rds_BitsT));
+    } else {
+        memset(bits, 0, sizeof(rds_BitsT));
+        for (i = 0; i < c->nrun; ++i) {
+            rds_SetRange(bits, c->u.run[i][0], c->u.run[i][1]);
+        }
+    }
+}
+
+// pack a bitmap into a container, choosing the form; returns the number of days
+static unsigned
+rds_Pack(
+    ucal_RdnSetContT *c   ,
+    rds_BitsT const   bits)
+{
+    uint64_t cin = 0;
+    unsigned w, card = 0, nrun = 0;
+
+    for (w = 0; w < RDS_NWORD; ++w) {
+        card += rds_Pop64(bits[w]);
+        nrun += rds_Pop64(bits[w] & ~((bits[w] << 1) | cin));
+        cin   = bits[w] >> 63;
+    }
+    c->card = (uint16_t)card;
+    if (nrun > UCAL_RDNSET_NRUN) {
+        c->kind = ucal_RdnSetBits;
+        c->nrun = 0;
+        memcpy(c->u.bits, bits, sizeof(rds_BitsT));
+        return card;
+    }
+
+    // Starts are set bits with a clear bit below, ends are clear bits with a set bit below.
+    c->kind = ucal_RdnSetRuns;
+    c->nrun = (uint8_t)nrun;
+    nrun    = 0;
+    cin     = 0;
+    for (w = 0; w < RDS_NWORD; ++w) {
+        uint64_t prev = (bits[w] << 1) | cin;
+        uint64_t beg  = bits[w] & ~prev;
+        uint64_t end  = ~bits[w] & prev;
+        cin = bits[w] >> 63;
+        while (beg | end) {
+            unsigned pb = beg ? rds_Ctz64(beg) : 64;
+            unsigned pe = end ? rds_Ctz64(end) : 64;
+            if (pb < pe) {
+                c->u.run[nrun][0] = (uint16_t)(w * 64 + pb);
+                beg &= beg - 1;
+            } else {
+                c->u.run[nrun++][1] = (uint16_t)(w * 64 + pe);
+                end &= end - 1;
+            }
+        }
+    }
+    return card;
+}
+
+// number of days less than day d of the year
+static unsigned
+rds_ContRank(
+    ucal_RdnSetContT const *c,
+    unsigned                d)
+{
+    unsigned i, n = 0;
+
+    if (ucal_RdnSetBits == c->kind) {
+        for (i = 0; i < (d >> 6); ++i) {
+            n += rds_Pop64(c->u.bits[i]);
+        }
+        if (d & 63) {
+            n += rds_Pop64(c->u.bits[d >> 6] & ~(~UINT64_C(0) << (d & 63)));
+        }
+    } else {
+        for (i = 0; (i < c->nrun) && (c->u.run[i][0] < d); ++i) {
+            n += ((d < c->u.run[i][1]) ? d : c->u.run[i][1]) - c->u.run[i][0];
+        }
+    }
+    return n;
+}
+
+// check for day d of the year
+static bool
+rds_ContHas(
+    ucal_RdnSetContT const *c,
+    unsigned                d)
+{
+    unsigned i;
+
+    if (ucal_RdnSetBits == c->kind) {
+        return (c->u.bits[d >> 6] >> (d & 63)) & 1u;
+    }
+    for (i = 0; (i < c->nrun) && (c->u.run[i][0] <= d); ++i) {
+        if (d < c->u.run[i][1]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// day of the year that has k days before it; k < card
+static unsigned
+rds_ContSelect(
+    ucal_RdnSetContT const *c,
+    unsigned                k)
+{
+    unsigned i, n;
+
+    if (ucal_RdnSetBits == c->kind) {
+        uint64_t v;
+        for (i = 0; k >= (n = rds_Pop64(c->u.bits[i])); ++i) {
+            k -= n;
+        }
+        for (v = c->u.bits[i]; k; --k) {
+            v &= v - 1;
+        }
+        return i * 64 + rds_Ctz64(v);
+    }
+    for (i = 0; k >= (n = c->u.run[i][1] - c->u.run[i][0]); ++i) {
+        k -= n;
+    }
+    return c->u.run[i][0] + k;
+}
+
+// ----------------------------------------------------------------------------------------------
+// set helpers
+// ----------------------------------------------------------------------------------------------
+
+// index of the first container with a year not less than y
+static size_t
+rds_Find(
+    ucal_RdnSetT const *set,
+    int32_t             y  )
+{
+    size_t lo = 0, hi = set->ncont;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (set->cont[mid].year < y) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// recalculate the running counts from container idx on
+static void
+rds_Fixup(
+    ucal_RdnSetT *set,
+    size_t        idx)
+{
+    uint32_t n = idx ? set->cont[idx - 1].before + set->cont[idx - 1].card : 0;
+
+    for (; idx < set->ncont; ++idx) {
+        set->cont[idx].before = n;
+        n += set->cont[idx].card;
+    }
+}
+
+// check a day range and get the years it covers
+static bool
+rds_Years(
+    int32_t *ylo,
+    int32_t *yhi,
+    int32_t  lo ,
+    int32_t  hi )
+{
+    if ((lo < ucal_YearStartGD(INT16_MIN)) || (hi > ucal_YearStartGD(INT16_MAX) + 365)) {
+        errno = ERANGE;
+        return false;
+    }
+    if (lo >= hi) {
+        *ylo = 1;
+        *yhi = 0;
+    } else {
+        *ylo = ucal_DaysToYearsGD(lo, NULL).q + 1;
+        *yhi = ucal_DaysToYearsGD(hi - 1, NULL).q + 1;
+    }
+    return true;
+}
+
+// days [dlo,dhi[ of year y that are in [lo,hi[; returns the length of the year
+static unsigned
+rds_Clip(
+    unsigned *dlo,
+    unsigned *dhi,
+    int32_t   y  ,
+    int32_t   lo ,
+    int32_t   hi )
+{
+    int32_t  ys   = ucal_YearStartGD((int16_t)y);
+    unsigned ylen = 365u + ucal_IsLeapYearGD(y);
+
+    *dlo = (lo > ys) ? (unsigned)(lo - ys) : 0u;
+    *dhi = (hi - ys < (int32_t)ylen) ? (unsigned)(hi - ys) : ylen;
+    return ylen;
+}
+
+// weekday pattern of the 64 days from a day with weekday wd; mask bit n is weekday n
+static inline uint64_t
+rds_WdWord(
+    unsigned mask,
+    unsigned wd  )
+{
+    uint64_t r = ((mask >> wd) | (mask << (7 - wd))) & 0x7Fu;
+    // copies at every 7th bit; they cannot overlap, so the product has no carries
+    return r * UINT64_C(0x8102040810204081);
+}
+
+// add the days [lo,hi[ on the weekdays in mask
+static bool
+rds_Add(
+    ucal_RdnSetT *set ,
+    int32_t       lo  ,
+    int32_t       hi  ,
+    unsigned      mask)
+{
+    int32_t ylo, yhi, y;
+    size_t  idx, need = 0;
+
+    if (!rds_Years(&ylo, &yhi, lo, hi)) {
+        return false;
+    }
+
+    // count the missing containers first, so a failure leaves the set alone
+    for (y = ylo, idx = rds_Find(set, ylo); y <= yhi; ++y) {
+        if ((idx < set->ncont) && (set->cont[idx].year == y)) {
+            ++idx;
+        } else {
+            ++need;
+        }
+    }
+    if (need > set->capacity - set->ncont) {
+        errno = ERANGE;
+        return false;
+    }
+
+    idx = rds_Find(set, ylo);
+    for (y = ylo; y <= yhi; ++y, ++idx) {
+        ucal_RdnSetContT *c     = &set->cont[idx];
+        bool              fresh = (idx >= set->ncont) || (c->year != y);
+        rds_BitsT         bits;
+        unsigned          dlo, dhi, w;
+
+        if (fresh) {
+            memmove(c + 1, c, (set->ncont - idx) * sizeof(*c));
+            ++set->ncont;
+            memset(c, 0, sizeof(*c));
+            c->year = (int16_t)y;
+            c->kind = ucal_RdnSetRuns;
+        }
+        rds_ToBits(bits, c);
+        (void)rds_Clip(&dlo, &dhi, y, lo, hi);
+        if (0x7Fu == mask) {
+            rds_SetRange(bits, dlo, dhi);
+        } else {
+            rds_BitsT sel = { 0 };
+            unsigned  wd  = (unsigned)ucal_i32Mod7(ucal_YearStartGD((int16_t)y));
+            rds_SetRange(sel, dlo, dhi);
+            // 64 = 1 (mod 7), so each word starts one weekday later
+            for (w = 0; w < RDS_NWORD; ++w) {
+                bits[w] |= sel[w] & rds_WdWord(mask, (wd + w) % 7u);
+            }
+        }
+        if (!rds_Pack(c, bits) && fresh) {
+            // no weekday of the mask in this part of the range
+            --set->ncont;
+            memmove(c, c + 1, (set->ncont - idx) * sizeof(*c));
+            --idx;
+        }
+    }
+    rds_Fixup(set, rds_Find(set, ylo));
+    return true;
+}
+
+// merge two sets container by container; op is 0 for union, 1 for intersection, 2 for
+// difference
+static bool
+rds_Merge(
+    ucal_RdnSetT       *dst,
+    ucal_RdnSetT const *a  ,
+    ucal_RdnSetT const *b  ,
+    int                 op )
+{
+    size_t ia = 0, ib = 0;
+
+    if ((dst == a) || (dst == b)) {
+        errno = EINVAL;
+        return false;
+    }
+    dst->ncont = 0;
+    while ((ia < a->ncont) || (ib < b->ncont)) {
+        ucal_RdnSetContT const *ca = (ia < a->ncont) ? &a->cont[ia] : NULL;
+        ucal_RdnSetContT const *cb = (ib < b->ncont) ? &b->cont[ib] : NULL;
+        ucal_RdnSetContT const *cp = NULL;
+        ucal_RdnSetContT        cr;
+        rds_BitsT               ba, bb;
+        unsigned                w;
+
+        if (ca && (!cb || (ca->year < cb->year))) {
+            // only in a
+            ++ia;
+            if (1 == op) {
+                continue;
+            }
+            cp = ca;
+        } else if (!ca || (cb->year < ca->year)) {
+            // only in b
+            ++ib;
+            if (0 != op) {
+                continue;
+            }
+            cp = cb;
+        }
+        if (cp) {
+            if (dst->ncont >= dst->capacity) {
+                errno = ERANGE;
+                return false;
+            }
+            dst->cont[dst->ncont++] = *cp;
+            continue;
+        }
+
+        // in both
+        ++ia;
+        ++ib;
+        rds_ToBits(ba, ca);
+        rds_ToBits(bb, cb);
+        switch (op) {
+        case 0:
+            for (w = 0; w < RDS_NWORD; ++w) {
+                ba[w] |= bb[w];
+            }
+            break;
+        case 1:
+            for (w = 0; w < RDS_NWORD; ++w) {
+                ba[w] &= bb[w];
+            }
+            break;
+        default:
+            for (w = 0; w < RDS_NWORD; ++w) {
+                ba[w] &= ~bb[w];
+            }
+            break;
+        }
+        cr.year = ca->year;
+        if (rds_Pack(&cr, ba)) {
+            if (dst->ncont >= dst->capacity) {
+                errno = ERANGE;
+                return false;
+            }
+            dst->cont[dst->ncont++] = cr;
+        }
+    }
+    rds_Fixup(dst, 0);
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// API
+// ----------------------------------------------------------------------------------------------
+
+void
+ucal_RdnSetInit(
+    ucal_RdnSetT     *set     ,
+    ucal_RdnSetContT *mem     ,
+    size_t            capacity)
+{
+    set->cont     = mem;
+    set->ncont    = 0;
+    set->capacity = capacity;
+}
+
+void
+ucal_RdnSetClear(
+    ucal_RdnSetT *set)
+{
+    set->ncont = 0;
+}
+
+bool
+ucal_RdnSetAddRange(
+    ucal_RdnSetT *set,
+    int32_t       lo ,
+    int32_t       hi )
+{
+    return rds_Add(set, lo, hi, 0x7Fu);
+}
+
+bool
+ucal_RdnSetAddWeekdays(
+    ucal_RdnSetT *set   ,
+    int32_t       lo    ,
+    int32_t       hi    ,
+    unsigned      wdmask)
+{
+    wdmask = (wdmask | (wdmask >> 7)) & 0x7Fu;
+    if (0 == wdmask) {
+        int32_t ylo, yhi;
+        return rds_Years(&ylo, &yhi, lo, hi);
+    }
+    return rds_Add(set, lo, hi, wdmask);
+}
+
+bool
+ucal_RdnSetRemoveRange(
+    ucal_RdnSetT *set,
+    int32_t       lo ,
+    int32_t       hi )
+{
+    int32_t ylo, yhi;
+    size_t  idx, first;
+
+    if (!rds_Years(&ylo, &yhi, lo, hi)) {
+        return false;
+    }
+    first = idx = rds_Find(set, ylo);
+    while ((idx < set->ncont) && (set->cont[idx].year <= yhi)) {
+        ucal_RdnSetContT *c = &set->cont[idx];
+        rds_BitsT         bits, cut = { 0 };
+        unsigned          dlo, dhi, w;
+
+        (void)rds_Clip(&dlo, &dhi, c->year, lo, hi);
+        rds_ToBits(bits, c);
+        rds_SetRange(cut, dlo, dhi);
+        for (w = 0; w < RDS_NWORD; ++w) {
+            bits[w] &= ~cut[w];
+        }
+        if (rds_Pack(c, bits)) {
+            ++idx;
+        } else {
+            --set->ncont;
+            memmove(c, c + 1, (set->ncont - idx) * sizeof(*c));
+        }
+    }
+    rds_Fixup(set, first);
+    return true;
+}
+
+bool
+ucal_RdnSetContains(
+    ucal_RdnSetT const *set,
+    int32_t             rdn)
+{
+    ucal_iu32DivT yd  = ucal_DaysToYearsGD(rdn, NULL);
+    size_t        idx = rds_Find(set, yd.q + 1);
+
+    if ((idx >= set->ncont) || (set->cont[idx].year != yd.q + 1)) {
+        return false;
+    }
+    return rds_ContHas(&set->cont[idx], yd.r);
+}
+
+size_t
+ucal_RdnSetCount(
+    ucal_RdnSetT const *set)
+{
+    if (0 == set->ncont) {
+        return 0;
+    }
+    return (size_t)set->cont[set->ncont - 1].before + set->cont[set->ncont - 1].card;
+}
+
+size_t
+ucal_RdnSetRank(
+    ucal_RdnSetT const *set,
+    int32_t             rdn)
+{
+    ucal_iu32DivT yd  = ucal_DaysToYearsGD(rdn, NULL);
+    size_t        idx = rds_Find(set, yd.q + 1);
+
+    if (idx >= set->ncont) {
+        return ucal_RdnSetCount(set);
+    }
+    if (set->cont[idx].year != yd.q + 1) {
+        return set->cont[idx].before;
+    }
+    return (size_t)set->cont[idx].before + rds_ContRank(&set->cont[idx], yd.r);
+}
+
+bool
+ucal_RdnSetSelect(
+    int32_t            *into,
+    ucal_RdnSetT const *set ,
+    size_t              k   )
+{
+    size_t lo = 0, hi = set->ncont;
+
+    if (k >= ucal_RdnSetCount(set)) {
+        return false;
+    }
+    // last container that has at most k days before it
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (set->cont[mid].before <= k) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    *into = ucal_YearStartGD(set->cont[lo].year)
+          + (int32_t)rds_ContSelect(&set->cont[lo], (unsigned)(k - set->cont[lo].before));
+    return true;
+}
+
+bool
+ucal_RdnSetNext(
+    int32_t            *into,
+    ucal_RdnSetT const *set ,
+    int32_t             rdn ,
+    size_t              k   )
+{
+    if ((0 == k) || (INT32_MAX == rdn)) {
+        return false;
+    }
+    return ucal_RdnSetSelect(into, set, ucal_RdnSetRank(set, rdn + 1) + k - 1);
+}
+
+bool
+ucal_RdnSetUnion(
+    ucal_RdnSetT       *dst,
+    ucal_RdnSetT const *a  ,
+    ucal_RdnSetT const *b  )
+{
+    return rds_Merge(dst, a, b, 0);
+}
+
+bool
+ucal_RdnSetIntersect(
+    ucal_RdnSetT       *dst,
+    ucal_RdnSetT const *a  ,
+    ucal_RdnSetT const *b  )
+{
+    return rds_Merge(dst, a, b, 1);
+}
+
+bool
+ucal_RdnSetDifference(
+    ucal_RdnSetT       *dst,
+    ucal_RdnSetT const *a  ,
+    ucal_RdnSetT const *b  )
+{
+    return rds_Merge(dst, a, b, 2);
+}
+
+// -*- that's all folks -*-
@@ -0,0 +1,472 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains decoders for radio / time code frames.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// decoding DCF77, MSF, WWVB and IRIG-B frames
+///
+/// All these time codes transmit BCD digits with a two-digit year, so the real work is not the
+/// bit fiddling but establishing the century.  DCF77 and MSF provide a day-of-week, so we can
+/// use Zeller's congruence backwards (@c ucal_RellezGD) to get a year in a 400 year window.
+/// WWVB and IRIG-B have a day-of-year and no day-of-week; the best we can do is a 100 year
+/// window.
+///
+/// Once a year is resolved, a frame stream rarely leaves it: The decoder state keeps the full
+/// year and the start of the current year and month, so the usual frame is decoded with a few
+/// compares and additions.  The weekday is still checked on that fast path, and a mismatch
+/// falls back to the full resolution.
+
+#include <errno.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/rtcdecode.h"
+
+// ----------------------------------------------------------------------------------------------
+// bit field helpers
+// ----------------------------------------------------------------------------------------------
+
+// extract 'n' bits starting at 'pos'; the first transmitted bit is least significant
+static inline unsigned
+rtc_lsbf(uint64_t f, unsigned pos, unsigned n)
+{
+    return (unsigned)(f >> pos) & ((1u << n) - 1u);
+}
+
+// extract 'n' bits starting at 'pos'; the first transmitted bit is most significant
+static unsigned
+rtc_msbf(uint64_t f, unsigned pos, unsigned n)
+{
+    unsigned v = 0;
+    while (n--) {
+        v = (v << 1) | ((unsigned)(f >> pos++) & 1u);
+    }
+    return v;
+}
+
+// combine two BCD digits, -1 if a digit is out of range
+static inline int
+rtc_bcd(unsigned tens, unsigned units)
+{
+    return ((tens > 9u) || (units > 9u)) ? -1 : (int)(tens * 10u + units);
+}
+
+// parity of a bit vector: 1 if the number of set bits is odd
+static inline unsigned
+rtc_parity(uint64_t v)
+{
+    v ^= v >> 32;
+    v ^= v >> 16;
+    v ^= v >> 8;
+    v ^= v >> 4;
+    v ^= v >> 2;
+    v ^= v >> 1;
+    return (unsigned)v & 1u;
+}
+
+// mask for 'n' bits starting at 'pos'
+static inline uint64_t
+rtc_mask(unsigned pos, unsigned n)
+{
+    return ((UINT64_C(1) << n) - 1u) << pos;
+}
+
+// ----------------------------------------------------------------------------------------------
+// century and base day resolution
+// ----------------------------------------------------------------------------------------------
+
+// set year cache, invalidating the month cache if the year changes
+static void
+rtc_SetYear(ucal_RtcDecoderT *dec, int16_t y, unsigned yy)
+{
+    if (y != dec->yFull) {
+        dec->yFull   = y;
+        dec->mCache  = 0;
+        dec->rdnYear = ucal_YearStartGD(y);
+    }
+    dec->yTrunc = (int8_t)yy;
+}
+
+// get the year following the cached one if 'yy' matches the cached year or the next one
+static int16_t
+rtc_CachedYear(ucal_RtcDecoderT const *dec, unsigned yy)
+{
+    if (dec->yFull != INT16_MIN) {
+        if ((int)yy == dec->yTrunc) {
+            return dec->yFull;
+        }
+        if ((yy == (dec->yTrunc + 1u) % 100u) && (dec->yFull < INT16_MAX)) {
+            return dec->yFull + 1;
+        }
+    }
+    return INT16_MIN;
+}
+
+// Resolve a year/month/day/weekday tuple to a RDN, using and updating the cache.
+static int32_t
+rtc_ResolveYMD(
+    ucal_RtcDecoderT *dec,
+    unsigned          yy ,
+    unsigned          m  ,
+    unsigned          d  ,
+    unsigned          wd )
+{
+    int16_t y;
+    int32_t rdn;
+
+    if ((m < 1) || (m > 12) || (d < 1) || (wd < 1) || (wd > 7)) {
+        goto invalid;
+    }
+
+    // Try to continue with the cached year first. This usually hits the cached month, too.
+    // The cache is only updated if the weekday confirms the date.
+    y = rtc_CachedYear(dec, yy);
+    if ((y != INT16_MIN) && (d <= _ucal_mdtab[ucal_IsLeapYearGD(y)][m - 1])) {
+        if ((y == dec->yFull) && ((int)m == dec->mCache)) {
+            rdn = dec->rdnMonth;
+        } else {
+            rdn = ucal_DateToRdnGD(y, m, 0);
+        }
+        if ((unsigned)ucal_i32SubMod7(rdn + (int32_t)d, 1) + 1u == wd) {
+            rtc_SetYear(dec, y, yy);
+            dec->mCache   = (int8_t)m;
+            dec->rdnMonth = rdn;
+            return rdn + (int32_t)d;
+        }
+    }
+
+    // No luck, do the full inverse Zeller computation.
+    y = ucal_RellezGD(yy, m, d, wd, dec->ybase);
+    if (y == INT16_MIN) {
+        return INT32_MIN;   // errno is already set
+    }
+    rtc_SetYear(dec, y, yy);
+    dec->mCache   = (int8_t)m;
+    dec->rdnMonth = ucal_DateToRdnGD(y, m, 0);
+    return dec->rdnMonth + d;
+
+invalid:
+    errno = EINVAL;
+    return INT32_MIN;
+}
+
+// Resolve a year/day-of-year tuple to a RDN and the full year, using the cache.  The cache is
+// left alone: the caller updates it with rtc_SetYear() once the frame is accepted.
+static int32_t
+rtc_ResolveYD(
+    ucal_RtcDecoderT const *dec,
+    int16_t                *py ,
+    unsigned                yy ,
+    unsigned                yd )
+{
+    int16_t y = rtc_CachedYear(dec, yy);
+    if (y == INT16_MIN) {
+        y = (int16_t)(dec->ybase + ucal_iu32SubDiv(yy, dec->ybase, 100u).r);
+    }
+    if ((yd < 1) || (yd > 365u + ucal_IsLeapYearGD(y))) {
+        errno = EINVAL;
+        return INT32_MIN;
+    }
+    *py = y;
+    return ((y == dec->yFull) ? dec->rdnYear : ucal_YearStartGD(y)) + (int32_t)yd - 1;
+}
+
+// fill in the result record
+static void
+rtc_SetResult(
+    ucal_RtcTimeT *into ,
+    int32_t        rdn  ,
+    int32_t        tod  ,
+    int            offs ,
+    unsigned       flags)
+{
+    into->rdn   = rdn;
+    into->tod   = tod;
+    into->offs  = (int16_t)offs;
+    into->flags = (uint8_t)flags;
+    into->tsUtc = ((time_t)rdn - UCAL_rdnUNIX) * 86400 + tod - (time_t)offs * 60;
+}
+
+// ----------------------------------------------------------------------------------------------
+void
+ucal_RtcDecoderInit(
+    ucal_RtcDecoderT *dec  ,
+    int16_t           ybase)
+{
+    dec->ybase    = ybase;
+    dec->yFull    = INT16_MIN;
+    dec->yTrunc   = 0;
+    dec->mCache   = 0;
+    dec->rdnYear  = 0;
+    dec->rdnMonth = 0;
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+ucal_RtcDecodeDCF77(
+    ucal_RtcTimeT    *into ,
+    ucal_RtcDecoderT *dec  ,
+    uint64_t          frame)
+{
+    int      mm, hh, dd, mo, yy;
+    unsigned flags = 0;
+    int32_t  rdn;
+
+    // Start of minute is always 0, start of time is always 1, and exactly one of the zone bits
+    // Z1/Z2 must be set.  Minute, hour and date blocks have even parity each.
+    if (  (frame & (UINT64_C(1) << 0))
+       || !(frame & (UINT64_C(1) << 20))
+       || (rtc_lsbf(frame, 17, 2) == 0) || (rtc_lsbf(frame, 17, 2) == 3)
+       || rtc_parity(frame & rtc_mask(21,  8))
+       || rtc_parity(frame & rtc_mask(29,  7))
+       || rtc_parity(frame & rtc_mask(36, 23)))
+    {
+        goto invalid;
+    }
+
+    mm = rtc_bcd(rtc_lsbf(frame, 25, 3), rtc_lsbf(frame, 21, 4));
+    hh = rtc_bcd(rtc_lsbf(frame, 33, 2), rtc_lsbf(frame, 29, 4));
+    dd = rtc_bcd(rtc_lsbf(frame, 40, 2), rtc_lsbf(frame, 36, 4));
+    mo = rtc_bcd(rtc_lsbf(frame, 49, 1), rtc_lsbf(frame, 45, 4));
+    yy = rtc_bcd(rtc_lsbf(frame, 54, 4), rtc_lsbf(frame, 50, 4));
+    if ((mm < 0) || (mm > 59) || (hh < 0) || (hh > 23) || (dd < 0) || (mo < 0) || (yy < 0)) {
+        goto invalid;
+    }
+
+    rdn = rtc_ResolveYMD(dec, yy, mo, dd, rtc_lsbf(frame, 42, 3));
+    if (rdn == INT32_MIN) {
+        return false;
+    }
+
+    if (frame & (UINT64_C(1) << 17)) {
+        flags |= ucal_RtcFlag_DST;
+    }
+    if (frame & (UINT64_C(1) << 16)) {
+        flags |= ucal_RtcFlag_DSTAnn;
+    }
+    if (frame & (UINT64_C(1) << 19)) {
+        flags |= ucal_RtcFlag_LeapAnn;
+    }
+    rtc_SetResult(into, rdn, ucal_DayTimeMerge(hh, mm, 0),
+                  (flags & ucal_RtcFlag_DST) ? 120 : 60, flags);
+    return true;
+
+invalid:
+    errno = EINVAL;
+    return false;
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+ucal_RtcDecodeMSF(
+    ucal_RtcTimeT    *into ,
+    ucal_RtcDecoderT *dec  ,
+    uint64_t          abits,
+    uint64_t          bbits)
+{
+    int      mm, hh, dd, mo, yy;
+    unsigned wd, flags = 0;
+    int32_t  rdn;
+
+    // The minute identifier 01111110 sits in 52A..59A, and the parity bits in 54B..57B make
+    // for odd parity over their respective A bit blocks.
+    if (  (rtc_msbf(abits, 52, 8) != 0x7Eu)
+       || !rtc_parity((abits & rtc_mask(17,  8)) | (bbits & (UINT64_C(1) << 54)))
+       || !rtc_parity((abits & rtc_mask(25, 11)) | (bbits & (UINT64_C(1) << 55)))
+       || !rtc_parity((abits & rtc_mask(36,  3)) | (bbits & (UINT64_C(1) << 56)))
+       || !rtc_parity((abits & rtc_mask(39, 13)) | (bbits & (UINT64_C(1) << 57))))
+    {
+        goto invalid;
+    }
+
+    yy = rtc_bcd(rtc_msbf(abits, 17, 4), rtc_msbf(abits, 21, 4));
+    mo = rtc_bcd(rtc_msbf(abits, 25, 1), rtc_msbf(abits, 26, 4));
+    dd = rtc_bcd(rtc_msbf(abits, 30, 2), rtc_msbf(abits, 32, 4));
+    wd = rtc_msbf(abits, 36, 3);
+    hh = rtc_bcd(rtc_msbf(abits, 39, 2), rtc_msbf(abits, 41, 4));
+    mm = rtc_bcd(rtc_msbf(abits, 45, 3), rtc_msbf(abits, 48, 4));
+    if ((mm < 0) || (mm > 59) || (hh < 0) || (hh > 23) || (dd < 0) || (mo < 0) || (yy < 0)
+       || (wd > 6)) {
+        goto invalid;
+    }
+
+    // MSF counts weekdays from Sunday == 0
+    rdn = rtc_ResolveYMD(dec, yy, mo, dd, (wd ? wd : 7u));
+    if (rdn == INT32_MIN) {
+        return false;
+    }
+
+    if (bbits & (UINT64_C(1) << 58)) {
+        flags |= ucal_RtcFlag_DST;
+    }
+    if (bbits & (UINT64_C(1) << 53)) {
+        flags |= ucal_RtcFlag_DSTAnn;
+    }
+    rtc_SetResult(into, rdn, ucal_DayTimeMerge(hh, mm, 0),
+                  (flags & ucal_RtcFlag_DST) ? 60 : 0, flags);
+    return true;
+
+invalid:
+    errno = EINVAL;
+    return false;
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+ucal_RtcDecodeWWVB(
+    ucal_RtcTimeT    *into ,
+    ucal_RtcDecoderT *dec  ,
+    uint64_t          frame)
+{
+    // markers and unused bits, which must all be zero
+    static const uint64_t zmask =
+        (UINT64_C(1) <<  0) | (UINT64_C(1) <<  4) | (UINT64_C(1) <<  9) | (UINT64_C(1) << 10) |
+        (UINT64_C(1) << 11) | (UINT64_C(1) << 14) | (UINT64_C(1) << 19) | (UINT64_C(1) << 20) |
+        (UINT64_C(1) << 21) | (UINT64_C(1) << 24) | (UINT64_C(1) << 29) | (UINT64_C(1) << 34) |
+        (UINT64_C(1) << 35) | (UINT64_C(1) << 39) | (UINT64_C(1) << 44) | (UINT64_C(1) << 49) |
+        (UINT64_C(1) << 54) | (UINT64_C(1) << 59);
+
+    int      mm, hh, yy, yd;
+    unsigned dst, flags = 0;
+    int16_t  y;
+    int32_t  rdn;
+
+    if (frame & zmask) {
+        goto invalid;
+    }
+
+    mm = rtc_bcd(rtc_msbf(frame,  1, 3), rtc_msbf(frame,  5, 4));
+    hh = rtc_bcd(rtc_msbf(frame, 12, 2), rtc_msbf(frame, 15, 4));
+    yd = rtc_bcd(rtc_msbf(frame, 25, 4), rtc_msbf(frame, 30, 4));
+    yy = rtc_bcd(rtc_msbf(frame, 45, 4), rtc_msbf(frame, 50, 4));
+    if ((mm < 0) || (mm > 59) || (hh < 0) || (hh > 23) || (yd < 0) || (yy < 0)) {
+        goto invalid;
+    }
+    yd += 100 * (int)rtc_msbf(frame, 22, 2);
+
+    rdn = rtc_ResolveYD(dec, &y, yy, yd);
+    if (rdn == INT32_MIN) {
+        return false;
+    }
+    // cross-check the leap year indicator
+    if (!(frame & (UINT64_C(1) << 55)) != !ucal_IsLeapYearGD(y)) {
+        goto invalid;
+    }
+    rtc_SetYear(dec, y, yy);
+
+    // DST status at 00:00Z today (bit 57) and at 24:00Z today (bit 58)
+    dst = rtc_lsbf(frame, 57, 2);
+    if (dst == 3u) {
+        flags |= ucal_RtcFlag_DST;
+    } else if (dst != 0u) {
+        flags |= ucal_RtcFlag_DSTAnn;
+    }
+    if (frame & (UINT64_C(1) << 56)) {
+        flags |= ucal_RtcFlag_LeapAnn;
+    }
+    rtc_SetResult(into, rdn, ucal_DayTimeMerge(hh, mm, 0), 0, flags);
+    return true;
+
+invalid:
+    errno = EINVAL;
+    return false;
+}
+
+// ----------------------------------------------------------------------------------------------
+// extract up to 16 bits from a 128 bit frame, least significant first
+static unsigned
+irig_bits(const uint64_t frame[2], unsigned pos, unsigned n)
+{
+    uint64_t v = frame[pos >> 6] >> (pos & 63);
+    if ((pos & 63) + n > 64) {
+        v |= frame[1] << (64 - (pos & 63));
+    }
+    return (unsigned)v & ((1u << n) - 1u);
+}
+
+bool
+ucal_RtcDecodeIRIGB(
+    ucal_RtcTimeT    *into    ,
+    ucal_RtcDecoderT *dec     ,
+    const uint64_t    frame[2],
+    bool              ieee1344)
+{
+    // position identifiers and index markers in the time/date section, which must be zero
+    static const uint64_t zmask =
+        (UINT64_C(1) <<  0) | (UINT64_C(1) <<  5) | (UINT64_C(1) <<  9) | (UINT64_C(1) << 14) |
+        (UINT64_C(1) << 18) | (UINT64_C(1) << 19) | (UINT64_C(1) << 24) | (UINT64_C(1) << 27) |
+        (UINT64_C(1) << 28) | (UINT64_C(1) << 29) | (UINT64_C(1) << 34) | (UINT64_C(1) << 39) |
+        (UINT64_C(1) << 49) | (UINT64_C(1) << 54) | (UINT64_C(1) << 59);
+
+    int      ss, mm, hh, yy, yd, offs = 0;
+    unsigned flags = 0;
+    int16_t  y;
+    int32_t  rdn;
+
+    if ((frame[0] & zmask) || irig_bits(frame, 69, 1)) {
+        goto invalid;
+    }
+
+    ss = rtc_bcd(irig_bits(frame,  6, 3), irig_bits(frame,  1, 4));
+    mm = rtc_bcd(irig_bits(frame, 15, 3), irig_bits(frame, 10, 4));
+    hh = rtc_bcd(irig_bits(frame, 25, 2), irig_bits(frame, 20, 4));
+    yd = rtc_bcd(irig_bits(frame, 35, 4), irig_bits(frame, 30, 4));
+    yy = rtc_bcd(irig_bits(frame, 55, 4), irig_bits(frame, 50, 4));
+    // The two bits of the hundreds cannot be out of range, but with a hundreds digit of 3 the
+    // tens are limited to 0..6; check the full day before it touches the year cache.
+    if (yd >= 0) {
+        yd += 100 * (int)irig_bits(frame, 40, 2);
+    }
+    if (  (ss < 0) || (ss > 60) || (mm < 0) || (mm > 59) || (hh < 0) || (hh > 23)
+       || (yd < 1) || (yd > 366) || (yy < 0)) {
+        goto invalid;
+    }
+
+    if (ieee1344) {
+        // IRIG time plus offset is UTC, so the offset of the local time is the negation.
+        offs = (int)irig_bits(frame, 65, 4) * 60 + (int)irig_bits(frame, 70, 1) * 30;
+        if (!irig_bits(frame, 64, 1)) {
+            offs = -offs;
+        }
+        if (irig_bits(frame, 60, 1)) {
+            flags |= ucal_RtcFlag_LeapAnn;
+        }
+        if (irig_bits(frame, 61, 1)) {
+            flags |= ucal_RtcFlag_LeapNeg;
+        }
+        if (irig_bits(frame, 62, 1)) {
+            flags |= ucal_RtcFlag_DSTAnn;
+        }
+        if (irig_bits(frame, 63, 1)) {
+            flags |= ucal_RtcFlag_DST;
+        }
+    }
+
+    rdn = rtc_ResolveYD(dec, &y, yy, yd);
+    if (rdn == INT32_MIN) {
+        return false;
+    }
+    rtc_SetYear(dec, y, yy);
+    rtc_SetResult(into, rdn, ucal_DayTimeMerge(hh, mm, ss), offs, flags);
+    return true;
+
+invalid:
+    errno = EINVAL;
+    return false;
+}
+
+// -*- that's all folks -*-
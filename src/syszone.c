@@ -0,0 +1,516 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module tracks the system time zone.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// system time zone tracker
+///
+/// The snapshots form a ring.  A writer fills the slot after the published one and then
+/// publishes it by storing the slot pointer and the generation, in that order, with release
+/// semantics.  A reader loads the generation and the pointer with acquire semantics, copies
+/// the slot, and loads the generation again.  The slot it copied is only written again when
+/// the generation has advanced by @c UCAL_SYSZONE_SLOTS-1, so if it has advanced by less the
+/// copy is good; otherwise the reader tries again.  This is a sequence lock with the sequence
+/// spread over the slots, and readers never wait for a writer.
+///
+/// C99 has no atomics, so like the pipeline this uses the GCC/Clang @c __atomic builtins.
+///
+/// inotify watches inodes, not names.  Tools that change the system zone replace the symlink
+/// @c /etc/localtime by a rename, and packages update zone files the same way, so there are
+/// two watches: one on the directory for changes of the name, one on the file (following the
+/// link) for changes in place.  The file watch moves to the new inode on each reload.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ucal/common.h"
+#include "ucal/tzposix.h"
+#include "ucal/syszone.h"
+
+#if !defined(__GNUC__)
+# error "the system zone tracker needs the GCC/Clang __atomic builtins"
+#endif
+
+#define SYZ_DIRMASK  (IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CLOSE_WRITE \
+                      | IN_ONLYDIR)
+#define SYZ_FILEMASK (IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF)
+
+// ----------------------------------------------------------------------------------------------
+// resolving the zone
+// ----------------------------------------------------------------------------------------------
+
+// Get the POSIX TZ footer of a TZif file.  The footer is the last line of the file, enclosed
+// by newlines; version 1 files have none.
+static bool
+syz_ReadFooter(
+    char       *spec,
+    const char *path)
+{
+    char        buf[2 * UCAL_SYSZONE_SPECLEN];
+    struct stat st;
+    ssize_t     n;
+    off_t       pos;
+    char       *head, *tail;
+    int         fd, err = EINVAL;
+
+    if (0 > (fd = open(path, O_RDONLY | O_CLOEXEC))) {
+        return false;
+    }
+    if ((5 != read(fd, buf, 5)) || memcmp(buf, "TZif", 4) || (buf[4] < '2')
+        || fstat(fd, &st))
+    {
+        goto done;
+    }
+    pos = (st.st_size > (off_t)sizeof(buf)) ? st.st_size - (off_t)sizeof(buf) : 0;
+    if (0 >= (n = pread(fd, buf, sizeof(buf), pos)) || ('\n' != buf[n - 1])) {
+        goto done;
+    }
+    tail = buf + n - 1;
+    for (head = tail; (head != buf) && ('\n' != head[-1]); --head) {
+        // scan back to the line start
+    }
+    if ((head != buf) && (head != tail) && (tail - head < UCAL_SYSZONE_SPECLEN)) {
+        memcpy(spec, head, (size_t)(tail - head));
+        spec[tail - head] = '\0';
+        err = 0;
+    }
+  done:
+    close(fd);
+    if (err) {
+        errno = err;
+    }
+    return !err;
+}
+
+// check that a TZ string parses completely
+static bool
+syz_ParseSpec(
+    tziPosixZoneT *zone,
+    const char    *spec)
+{
+    const char *tail = spec + strlen(spec);
+    return (tail != spec) && (tziFromPosixSpec(zone, spec, tail) == tail);
+}
+
+// Find the zone file or the TZ string of the system zone, following the C library: no TZ
+// means the local time file, an empty TZ is UTC, a leading colon or a string that does not
+// parse names a file, relative to the zone directory unless absolute.
+static bool
+syz_ResolveEnv(
+    ucal_SysZoneT *sz  ,
+    char          *spec,
+    char          *path)
+{
+    tziPosixZoneT tmp;
+    const char   *tz = getenv("TZ");
+    int           n;
+
+    *spec = *path = '\0';
+    if (NULL == tz) {
+        strcpy(path, UCAL_SYSZONE_LOCALTIME);
+        return true;
+    }
+    if ('\0' == *tz) {
+        strcpy(spec, "UTC0");
+        return true;
+    }
+    if (':' == *tz) {
+        ++tz;
+    } else if (syz_ParseSpec(&tmp, tz)) {
+        if (strlen(tz) >= UCAL_SYSZONE_SPECLEN) {
+            errno = EINVAL;
+            return false;
+        }
+        strcpy(spec, tz);
+        return true;
+    }
+    if ('/' == *tz) {
+        n = snprintf(path, UCAL_SYSZONE_PATHLEN, "%s", tz);
+    } else {
+        n = snprintf(path, UCAL_SYSZONE_PATHLEN, "%s/%s", sz->zdir, tz);
+    }
+    if ((n < 0) || (n >= UCAL_SYSZONE_PATHLEN) || ('\0' == *tz)) {
+        *path = '\0';
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// watches
+// ----------------------------------------------------------------------------------------------
+
+// put the watches on the directory and the file of 'path'; called with the lock held
+static void
+syz_Watch(
+    ucal_SysZoneT *sz  ,
+    const char    *path)
+{
+    char        dir[UCAL_SYSZONE_PATHLEN];
+    const char *base;
+    struct stat st;
+
+    if (strcmp(path, sz->path)) {
+        if (sz->wdDir >= 0) {
+            inotify_rm_watch(sz->ifd, sz->wdDir);
+            sz->wdDir = -1;
+        }
+        strcpy(sz->path, path);
+        if (*path) {
+            base = strrchr(path, '/');
+            if (NULL == base) {
+                strcpy(dir, ".");
+            } else if (base == path) {
+                strcpy(dir, "/");
+            } else {
+                memcpy(dir, path, (size_t)(base - path));
+                dir[base - path] = '\0';
+            }
+            sz->wdDir = inotify_add_watch(sz->ifd, dir, SYZ_DIRMASK);
+        }
+    }
+
+    // Move the file watch only if the file changed: removing a watch queues an event for it,
+    // which would cause another reload.
+    if (*path && !stat(path, &st)
+        && (sz->wdFile >= 0) && (sz->fileId[0] == (uint64_t)st.st_dev)
+        && (sz->fileId[1] == (uint64_t)st.st_ino))
+    {
+        return;
+    }
+    if (sz->wdFile >= 0) {
+        inotify_rm_watch(sz->ifd, sz->wdFile);
+        sz->wdFile = -1;
+    }
+    if (*path && !stat(path, &st)) {
+        sz->fileId[0] = (uint64_t)st.st_dev;
+        sz->fileId[1] = (uint64_t)st.st_ino;
+        sz->wdFile    = inotify_add_watch(sz->ifd, path, SYZ_FILEMASK);
+    }
+}
+
+// check if an event concerns the tracked file
+static bool
+syz_Relevant(
+    ucal_SysZoneT const        *sz,
+    struct inotify_event const *ev)
+{
+    const char *base;
+
+    if (ev->mask & IN_Q_OVERFLOW) {
+        return true;
+    }
+    if ((ev->wd == sz->wdFile) && (ev->mask & SYZ_FILEMASK)) {
+        return true;
+    }
+    if ((ev->wd == sz->wdDir) && ev->len) {
+        base = strrchr(sz->path, '/');
+        base = base ? base + 1 : sz->path;
+        return !strcmp(ev->name, base);
+    }
+    return false;
+}
+
+// ----------------------------------------------------------------------------------------------
+// publishing
+// ----------------------------------------------------------------------------------------------
+
+// publish a zone if it differs from the current one; called with the lock held
+static bool
+syz_Publish(
+    ucal_SysZoneT *sz  ,
+    const char    *spec)
+{
+    ucal_SysZoneSnapT *snap;
+    tziPosixZoneT      zone;
+    uint32_t           gen = sz->gen + 1;
+
+    if (strlen(spec) >= UCAL_SYSZONE_SPECLEN || !syz_ParseSpec(&zone, spec)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (sz->cur && !strcmp(spec, sz->cur->spec)) {
+        return true;
+    }
+    snap = &sz->slot[gen % UCAL_SYSZONE_SLOTS];
+    snap->zone = zone;
+    snap->gen  = gen;
+    strcpy(snap->spec, spec);
+    __atomic_store_n(&sz->cur, snap, __ATOMIC_RELEASE);
+    __atomic_store_n(&sz->gen, gen, __ATOMIC_RELEASE);
+    return true;
+}
+
+// resolve and publish; called with the lock held
+static bool
+syz_Reload(
+    ucal_SysZoneT *sz)
+{
+    char spec[UCAL_SYSZONE_SPECLEN];
+    char path[UCAL_SYSZONE_PATHLEN];
+    bool retv;
+
+    if (sz->fromEnv) {
+        retv = syz_ResolveEnv(sz, spec, path);
+    } else {
+        strcpy(path, sz->path);
+        retv = true;
+    }
+    if (retv) {
+        // watch first, so a change right after reading the file is not lost
+        syz_Watch(sz, path);
+        if (*path) {
+            retv = syz_ReadFooter(spec, path);
+        }
+    }
+    return retv && syz_Publish(sz, spec);
+}
+
+// drain the inotify queue and reload if needed; called with the lock held
+static bool
+syz_Update(
+    ucal_SysZoneT *sz)
+{
+    union {
+        struct inotify_event ev;
+        char                 raw[4096];
+    }       buf;
+    ssize_t n, pos;
+    bool    reload = false;
+
+    while (0 < (n = read(sz->ifd, buf.raw, sizeof(buf)))) {
+        for (pos = 0; pos < n; ) {
+            struct inotify_event const *ev = (struct inotify_event const *)(buf.raw + pos);
+            reload = reload || syz_Relevant(sz, ev);
+            pos += (ssize_t)(sizeof(*ev) + ev->len);
+        }
+    }
+    return !reload || syz_Reload(sz);
+}
+
+// ----------------------------------------------------------------------------------------------
+// API
+// ----------------------------------------------------------------------------------------------
+
+bool
+ucal_SysZoneOpen(
+    ucal_SysZoneT *sz     ,
+    const char    *path   ,
+    const char    *zonedir)
+{
+    if ((NULL == sz) || (path && (strlen(path) >= UCAL_SYSZONE_PATHLEN))
+        || (zonedir && (strlen(zonedir) >= UCAL_SYSZONE_PATHLEN)))
+    {
+        errno = EINVAL;
+        return false;
+    }
+    memset(sz, 0, sizeof(*sz));
+    sz->wdDir = sz->wdFile = sz->stop[0] = sz->stop[1] = -1;
+    strcpy(sz->zdir, zonedir ? zonedir : UCAL_SYSZONE_ZONEINFO);
+    if (0 > (sz->ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC))) {
+        return false;
+    }
+    pthread_mutex_init(&sz->lock, NULL);
+
+    // a fixed path is set up once here; the reloads keep it
+    sz->fromEnv = (NULL == path);
+    if (path) {
+        syz_Watch(sz, path);
+    }
+    if (!syz_Reload(sz)) {
+        (void)syz_Publish(sz, "UTC0");
+    }
+    return true;
+}
+
+void
+ucal_SysZoneClose(
+    ucal_SysZoneT *sz)
+{
+    ucal_SysZoneStop(sz);
+    close(sz->ifd);
+    sz->ifd = sz->wdDir = sz->wdFile = -1;
+    pthread_mutex_destroy(&sz->lock);
+}
+
+int
+ucal_SysZoneFd(
+    ucal_SysZoneT const *sz)
+{
+    return sz->ifd;
+}
+
+bool
+ucal_SysZoneUpdate(
+    ucal_SysZoneT *sz)
+{
+    bool retv;
+
+    pthread_mutex_lock(&sz->lock);
+    retv = syz_Update(sz);
+    pthread_mutex_unlock(&sz->lock);
+    return retv;
+}
+
+bool
+ucal_SysZoneReload(
+    ucal_SysZoneT *sz)
+{
+    bool retv;
+
+    pthread_mutex_lock(&sz->lock);
+    retv = syz_Reload(sz);
+    pthread_mutex_unlock(&sz->lock);
+    return retv;
+}
+
+bool
+ucal_SysZonePublish(
+    ucal_SysZoneT *sz  ,
+    const char    *spec)
+{
+    bool retv;
+
+    pthread_mutex_lock(&sz->lock);
+    retv = syz_Publish(sz, spec);
+    pthread_mutex_unlock(&sz->lock);
+    return retv;
+}
+
+static void*
+syz_Watcher(
+    void *arg)
+{
+    ucal_SysZoneT * const sz = (ucal_SysZoneT*)arg;
+    struct pollfd         pfd[2];
+
+    pfd[0].fd     = sz->ifd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd     = sz->stop[0];
+    pfd[1].events = POLLIN;
+    for (;;) {
+        if (0 > poll(pfd, 2, -1)) {
+            if (EINTR == errno) {
+                continue;
+            }
+            break;
+        }
+        if (pfd[1].revents) {
+            break;
+        }
+        if (pfd[0].revents) {
+            (void)ucal_SysZoneUpdate(sz);
+        }
+    }
+    return NULL;
+}
+
+bool
+ucal_SysZoneStart(
+    ucal_SysZoneT *sz)
+{
+    int rc;
+
+    if (sz->running) {
+        errno = EINVAL;
+        return false;
+    }
+    if (pipe(sz->stop)) {
+        return false;
+    }
+    rc = pthread_create(&sz->thread, NULL, syz_Watcher, sz);
+    if (rc) {
+        close(sz->stop[0]);
+        close(sz->stop[1]);
+        sz->stop[0] = sz->stop[1] = -1;
+        errno = rc;
+        return false;
+    }
+    sz->running = true;
+    return true;
+}
+
+void
+ucal_SysZoneStop(
+    ucal_SysZoneT *sz)
+{
+    if (sz->running) {
+        while ((1 != write(sz->stop[1], "", 1)) && (EINTR == errno)) {
+            // retry
+        }
+        pthread_join(sz->thread, NULL);
+        close(sz->stop[0]);
+        close(sz->stop[1]);
+        sz->stop[0] = sz->stop[1] = -1;
+        sz->running = false;
+    }
+}
+
+void
+ucal_SysZoneSnapshot(
+    ucal_SysZoneSnapT   *into,
+    ucal_SysZoneT const *sz  )
+{
+    ucal_SysZoneSnapT const *snap;
+    uint32_t                 gen;
+
+    do {
+        gen  = __atomic_load_n(&sz->gen, __ATOMIC_ACQUIRE);
+        snap = __atomic_load_n(&sz->cur, __ATOMIC_ACQUIRE);
+        memcpy(into, snap, sizeof(*into));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&sz->gen, __ATOMIC_RELAXED) - gen > UCAL_SYSZONE_SLOTS - 2);
+}
+
+uint32_t
+ucal_SysZoneGeneration(
+    ucal_SysZoneT const *sz)
+{
+    return __atomic_load_n(&sz->gen, __ATOMIC_ACQUIRE);
+}
+
+tziConvCtxT*
+ucal_SysZoneRefresh(
+    ucal_SysZoneCtxT    *lc,
+    ucal_SysZoneT const *sz)
+{
+    ucal_SysZoneSnapT snap;
+
+    ucal_SysZoneSnapshot(&snap, sz);
+    lc->zone = snap.zone;
+    lc->gen  = snap.gen;
+    memset(&lc->ctx, 0, sizeof(lc->ctx));
+    lc->ctx.pTZI = &lc->zone;
+    return &lc->ctx;
+}
+
+tziConvCtxT*
+ucal_SysZoneSync(
+    ucal_SysZoneCtxT    *lc,
+    ucal_SysZoneT const *sz)
+{
+    return (ucal_SysZoneGeneration(sz) == lc->gen) ? &lc->ctx : ucal_SysZoneRefresh(lc, sz);
+}
+
+// -*- that's all folks -*-
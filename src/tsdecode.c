@@ -23,6 +23,10 @@
 /// and (to a lesser degree) parsing nanoseconds from a fractional string.
 ///
 /// As this is a frequent topic in some domains, here are some helpers and building blocks.
+///
+/// For columns of time stamps in an unknown format, the layout of a sample is detected once.
+/// The rest of the column is then decoded by checking separators at fixed offsets, and only
+/// the values that don't fit are classified on their own.
 
 #include <stddef.h>
 #include <ctype.h>
@@ -35,6 +39,8 @@
 #include "ucal/common.h"
 #include "ucal/gregorian.h"
 #include "ucal/calconst.h"
+#include "ucal/tzposix.h"
+#include "probes.h"
 
 // EOF is defined in stdio.h, but we don't want that one here...
 #ifndef EOF
@@ -329,12 +335,10 @@ _ucal_mktime(
         into->tv_sec  = ((h * 60) + m) * 60 + s;
         into->tv_sec += ((time_t)ucal_DateToRdnGD(year, adg[0], adg[1]) - UCAL_rdnUNIX) * 86400;
 
-        while (nsec >= pow10_9) {
-            ++into->tv_sec;
-            nsec -= pow10_9;
-        }
-        into->tv_nsec = nsec;
+        // the rounded fraction is 10⁹ at most
+        into->tv_sec += (nsec >= pow10_9);
         into->tv_sec -= tzo * 60;
+        into->tv_nsec = nsec - ((nsec >= pow10_9) ? pow10_9 : 0);
         return true;
     }
     return false;
@@ -362,6 +366,10 @@ _ucal_mklocal(
 
         // try AUTO, STD, DST in that order when converting to time stamp
         for (tzmode = -1; tzmode < 2; ++tzmode) {
+            if (tzmode >= 0) {
+                UCAL_PROBE5(tsd_mktime_retry, tzmode, year, adg[0], adg[1],
+                            ucal_DayTimeMerge(adg[2], adg[3], adg[4]));
+            }
             itm.tm_isdst = tzmode;
             errno        = 0;
             into->tv_sec = mktime(&itm);
@@ -370,15 +378,14 @@ _ucal_mklocal(
             }
         }
         if (tzmode > 1) {
+            UCAL_PROBE4(tsd_mktime_fail, year, adg[0], adg[1],
+                        ucal_DayTimeMerge(adg[2], adg[3], adg[4]));
             return false;   // Bummer. All 3 attempts failed.
         }
 
         // merge with normalised nano-secs, and that's it!
-        while (nsec >= pow10_9) {
-            ++into->tv_sec;
-            nsec -= pow10_9;
-        }
-        into->tv_nsec = nsec;
+        into->tv_sec += (nsec >= pow10_9);
+        into->tv_nsec = nsec - ((nsec >= pow10_9) ? pow10_9 : 0);
         return true;
     }
     return false;
@@ -457,4 +464,857 @@ ucal_decASN1GenTime24(
     return false;
 }
 
+// ----------------------------------------------------------------------------------------------
+// decode RFC 5322 mail dates
+// ----------------------------------------------------------------------------------------------
+
+// Month names, day names and zone names are found with a perfect hash over their first three
+// letters, folded to lower case and packed little endian.  The multiplier was searched to map
+// the 29 names into 32 slots without collisions.  A word must then be the short name itself or,
+// for months and days, the full English name; "Junk" is not June.
+#define MDN_KEY(a, b, c) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16))
+#define MDN_HASH(k)      ((uint32_t)((k) * UINT32_C(0x17f74bb1)) >> 27)
+
+enum { mdn_None, mdn_Month, mdn_WDay, mdn_Zone };
+
+typedef struct {
+    uint32_t    key;   // packed name
+    uint8_t     kind;  // what the name stands for
+    uint8_t     len;   // length of the short name
+    int16_t     value; // month, day of week or zone offset in minutes
+    const char *tail;  // rest of the full English name; NULL if there is none
+} mdn_EntryT;
+
+static const mdn_EntryT mdn_tab[32] = {
+    [ 0] = { MDN_KEY('u','t', 0 ), mdn_Zone ,  2,    0, NULL },
+    [ 2] = { MDN_KEY('f','e','b'), mdn_Month,  3,    2, "ruary" },
+    [ 3] = { MDN_KEY('m','d','t'), mdn_Zone ,  3, -360, NULL },
+    [ 4] = { MDN_KEY('j','a','n'), mdn_Month,  3,    1, "uary" },
+    [ 5] = { MDN_KEY('c','d','t'), mdn_Zone ,  3, -300, NULL },
+    [ 6] = { MDN_KEY('d','e','c'), mdn_Month,  3,   12, "ember" },
+    [ 7] = { MDN_KEY('g','m','t'), mdn_Zone ,  3,    0, NULL },
+    [ 8] = { MDN_KEY('w','e','d'), mdn_WDay ,  3,    3, "nesday" },
+    [ 9] = { MDN_KEY('s','u','n'), mdn_WDay ,  3,    7, "day" },
+    [10] = { MDN_KEY('o','c','t'), mdn_Month,  3,   10, "ober" },
+    [11] = { MDN_KEY('e','d','t'), mdn_Zone ,  3, -240, NULL },
+    [12] = { MDN_KEY('p','d','t'), mdn_Zone ,  3, -420, NULL },
+    [13] = { MDN_KEY('n','o','v'), mdn_Month,  3,   11, "ember" },
+    [14] = { MDN_KEY('s','e','p'), mdn_Month,  3,    9, "tember" },
+    [15] = { MDN_KEY('j','u','n'), mdn_Month,  3,    6, "e" },
+    [17] = { MDN_KEY('a','u','g'), mdn_Month,  3,    8, "ust" },
+    [18] = { MDN_KEY('m','s','t'), mdn_Zone ,  3, -420, NULL },
+    [19] = { MDN_KEY('m','a','r'), mdn_Month,  3,    3, "ch" },
+    [20] = { MDN_KEY('c','s','t'), mdn_Zone ,  3, -360, NULL },
+    [21] = { MDN_KEY('m','a','y'), mdn_Month,  3,    5, "" },
+    [22] = { MDN_KEY('f','r','i'), mdn_WDay ,  3,    5, "day" },
+    [23] = { MDN_KEY('t','u','e'), mdn_WDay ,  3,    2, "sday" },
+    [24] = { MDN_KEY('s','a','t'), mdn_WDay ,  3,    6, "urday" },
+    [26] = { MDN_KEY('e','s','t'), mdn_Zone ,  3, -300, NULL },
+    [27] = { MDN_KEY('p','s','t'), mdn_Zone ,  3, -480, NULL },
+    [28] = { MDN_KEY('j','u','l'), mdn_Month,  3,    7, "y" },
+    [29] = { MDN_KEY('t','h','u'), mdn_WDay ,  3,    4, "rsday" },
+    [30] = { MDN_KEY('m','o','n'), mdn_WDay ,  3,    1, "day" },
+    [31] = { MDN_KEY('a','p','r'), mdn_Month,  3,    4, "il" },
+};
+
+// ASCII letter test, independent of the locale
+static inline bool
+mdn_IsAlpha(int ch)
+{
+    return ((unsigned)(ch | 0x20) - 'a') < 26u;
+}
+
+// skip white space, line folding and (nested) comments
+static bool
+mdn_SkipCFWS(
+    const char **pstr,
+    const char  *end )
+{
+    const char *str   = *pstr, *open = NULL;
+    unsigned    depth = 0;
+    int         xch;
+
+    while (EOF != (xch = str_peek(&str, end))) {
+        if (depth) {
+            ++str;
+            if ('\\' == xch) {
+                str += (str != end);
+            } else {
+                depth += ('(' == xch);
+                depth -= (')' == xch);
+            }
+        } else if ((' ' == xch) || ('\t' == xch) || ('\r' == xch) || ('\n' == xch)) {
+            ++str;
+        } else if ('(' == xch) {
+            open = str++;
+            depth = 1;
+        } else {
+            break;
+        }
+    }
+    if (depth) {
+        str = open;         // an open comment is an error; stop in front of it
+    }
+    *pstr = str;
+    return (0 == depth);
+}
+
+// check a word of letters against the short and the full name of a table entry
+static bool
+mdn_Match(
+    mdn_EntryT const *ent ,
+    const char       *word,
+    unsigned          len )
+{
+    unsigned idx;
+
+    if (len == ent->len) {
+        return true;
+    }
+    if ((NULL == ent->tail) || (len != 3u + strlen(ent->tail))) {
+        return false;
+    }
+    for (idx = 3; idx < len; ++idx) {
+        if ((word[idx] | 0x20) != ent->tail[idx - 3]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// scan a word of letters; return its length and the table entry for it, if the word is the
+// short or the full name of one
+static unsigned
+mdn_Scan(
+    mdn_EntryT const **pent,
+    const char       **pstr,
+    const char        *end )
+{
+    const char *str = *pstr;
+    uint32_t    key = 0;
+    unsigned    len = 0;
+    int         xch;
+
+    while (mdn_IsAlpha(xch = str_peek(&str, end))) {
+        ++str;
+        if (len < 3) {
+            key |= (uint32_t)(xch | 0x20) << (8 * len);
+        }
+        ++len;
+    }
+    *pent = NULL;
+    if (len) {
+        mdn_EntryT const *ent = &mdn_tab[MDN_HASH(key)];
+        if ((ent->key == key) && (mdn_None != ent->kind) && mdn_Match(ent, *pstr, len)) {
+            *pent = ent;
+        }
+    }
+    *pstr = str;
+    return len;
+}
+
+// check a word against a zone name of the local zone
+static bool
+mdn_IsName(
+    const char *name,
+    const char *word,
+    unsigned    len )
+{
+    return (len < 12) && (0 == memcmp(name, word, len)) && ('\0' == name[len]);
+}
+
+bool
+ucal_decRFC5322Date(
+    struct timespec *into,
+    const char     **pstr,
+    const char      *end ,
+    tziConvCtxT     *ctx )
+{
+    mdn_EntryT const *ent;
+    const char       *str = *pstr, *word;
+    uint8_t           adg[5], dig[2];
+    unsigned          len;
+    int               tzo, y;
+    bool              local = false;
+
+    if (NULL == end) {
+        end = str + strnlen(str, 128);
+    }
+
+    // optional day name, followed by a comma
+    mdn_SkipCFWS(&str, end);
+    if (mdn_Scan(&ent, &str, end)) {
+        if ((NULL == ent) || (mdn_WDay != ent->kind)) {
+            return false;
+        }
+        mdn_SkipCFWS(&str, end);
+        if (',' != str_get(&str, end)) {
+            return false;
+        }
+        mdn_SkipCFWS(&str, end);
+    }
+
+    // day, month, year
+    if (!_ucal_pdgroups(adg + 1, 2, &str, end)) {
+        return false;
+    }
+    mdn_SkipCFWS(&str, end);
+    if (!mdn_Scan(&ent, &str, end) || (NULL == ent) || (mdn_Month != ent->kind)) {
+        return false;
+    }
+    adg[0] = (uint8_t)ent->value;
+    mdn_SkipCFWS(&str, end);
+    switch (_ucal_pdgroups(dig, 4, &str, end)) {
+    case 2:     y = dig[0] + ((dig[0] < 50) ? 2000 : 1900);
+                break;
+    case 3:     y = dig[0] * 10 + dig[1] + 1900;
+                break;
+    case 4:     y = dig[0] * 100 + dig[1];
+                break;
+    default:    return false;
+    }
+
+    // time of day, seconds optional
+    mdn_SkipCFWS(&str, end);
+    if (!_ucal_pdgroups(adg + 2, 2, &str, end)) {
+        return false;
+    }
+    mdn_SkipCFWS(&str, end);
+    if ((':' != str_get(&str, end)) || !mdn_SkipCFWS(&str, end)
+        || (2 != _ucal_pdgroups(adg + 3, 2, &str, end)))
+    {
+        return false;
+    }
+    mdn_SkipCFWS(&str, end);
+    adg[4] = 0;
+    if (':' == str_peek(&str, end)) {
+        ++str;
+        mdn_SkipCFWS(&str, end);
+        if (2 != _ucal_pdgroups(adg + 4, 2, &str, end)) {
+            return false;
+        }
+        mdn_SkipCFWS(&str, end);
+    }
+
+    // zone: numeric, a name of the local zone, a well-known name, or nothing
+    tzo  = 0;
+    word = str;
+    switch (str_peek(&str, end)) {
+    case '+':
+    case '-':   if (!_ucal_ptzo(&tzo, &str, end)) {
+                    return false;
+                }
+                break;
+
+    default:    if (0 != (len = mdn_Scan(&ent, &str, end))) {
+                    if (ctx && ctx->pTZI && mdn_IsName(ctx->pTZI->stdName, word, len)) {
+                        tzo = -ctx->pTZI->stdOffs;
+                    } else if (ctx && ctx->pTZI && mdn_IsName(ctx->pTZI->dstName, word, len)) {
+                        tzo = -ctx->pTZI->dstOffs;
+                    } else if (ent && (mdn_Zone == ent->kind)) {
+                        tzo = ent->value;
+                    }
+                } else {
+                    local = (NULL != ctx) && (NULL != ctx->pTZI);
+                }
+                break;
+    }
+    if (!mdn_SkipCFWS(&str, end) || !_ucal_mktime(into, y, adg, 0, tzo)) {
+        return false;
+    }
+    if (local) {
+        tziConvInfoT info;
+        if (!tziGetInfoLocal2Utc(&info, ctx, into->tv_sec, tziCvtHint_HrA)) {
+            return false;
+        }
+        into->tv_sec += info.offs;
+    }
+    *pstr = str;
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// detect the layout of a column and decode it with a bound decoder
+// ----------------------------------------------------------------------------------------------
+
+// characters of the zone styles
+static const uint8_t s_zlen[4] = { 0, 1, 5, 6 };
+
+// epoch units: divider to seconds, scale to nanoseconds, and digits at most
+static const uint32_t s_udiv[4] = { 1ul, 1000ul, 1000000ul, 1000000000ul };
+static const uint32_t s_uscl[4] = { 1000000000ul, 1000000ul, 1000ul, 1ul };
+static const uint8_t  s_udig[4] = { 11, 14, 17, 19 };
+
+// ASCII digit test, independent of the locale
+static inline bool
+dtc_IsDigit(int ch)
+{
+    return ((unsigned)ch - '0') < 10u;
+}
+
+// parse a fixed number of digits; fails on anything else
+static inline bool
+dtc_Fix(
+    uint32_t   *into,
+    const char *str ,
+    unsigned    nch )
+{
+    uint32_t accu = 0u, dch;
+
+    while (nch--) {
+        if ((dch = (uint8_t)*str++ - (uint32_t)'0') > 9u) {
+            return false;
+        }
+        accu = accu * 10u + dch;
+    }
+    *into = accu;
+    return true;
+}
+
+// count digits
+static inline size_t
+dtc_Span(
+    const char *str,
+    const char *end)
+{
+    const char *beg = str;
+
+    while ((str != end) && dtc_IsDigit((uint8_t)*str)) {
+        ++str;
+    }
+    return (size_t)(str - beg);
+}
+
+// parse a fixed-width fraction behind a dot
+static inline bool
+dtc_Frac(
+    uint32_t   *into,
+    const char *str ,
+    unsigned    nch )
+{
+    const char *end = str + nch + 1;
+
+    if (0 == nch) {
+        *into = 0;
+        return true;
+    }
+    if ('.' != *str++) {
+        return false;
+    }
+    *into = ucal_decNano_raw(&str, end);
+    return (str == end);
+}
+
+// parse a zone of a fixed style
+static bool
+dtc_Zone(
+    int        *into ,
+    const char *str  ,
+    unsigned    style)
+{
+    uint32_t hh, mm;
+
+    switch (style) {
+    case ucal_DecZone_Z:
+        *into = 0;
+        return ('Z' == (*str & ~0x20));
+
+    case ucal_DecZone_Offs:
+    case ucal_DecZone_OffsColon:
+        if ((('+' != *str) && ('-' != *str)) || !dtc_Fix(&hh, str + 1, 2)
+            || ((ucal_DecZone_OffsColon == style) && (':' != str[3]))
+            || !dtc_Fix(&mm, str + 3 + (ucal_DecZone_OffsColon == style), 2)
+            || (hh > 23) || (mm > 59)) {
+            return false;
+        }
+        *into = (int)(hh * 60 + mm);
+        if ('-' == *str) {
+            *into = -*into;
+        }
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// classify the zone behind the date/time fields; the rest of the text must be the zone
+static bool
+dtc_ZoneStyle(
+    uint8_t    *into,
+    const char *str ,
+    const char *end )
+{
+    size_t n = (size_t)(end - str);
+    int    tzo;
+
+    for (*into = ucal_DecZone_None; *into <= ucal_DecZone_OffsColon; ++*into) {
+        if ((n == s_zlen[*into]) && ((0 == n) || dtc_Zone(&tzo, str, *into))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// merge fields to a time stamp, in UTC or as local time
+static bool
+dtc_Make(
+    struct timespec *into,
+    int              year,
+    const uint8_t  adg[5],
+    uint32_t         nsec,
+    unsigned         zone,
+    int              tzo ,
+    tziConvCtxT     *ctx )
+{
+    tziConvInfoT info;
+
+    if (ucal_DecZone_None != zone) {
+        return _ucal_mktime(into, year, adg, nsec, tzo);
+    }
+    if ((NULL == ctx) || (NULL == ctx->pTZI)) {
+        return _ucal_mklocal(into, year, adg, nsec);
+    }
+    if (!_ucal_mktime(into, year, adg, nsec, 0)
+        || !tziGetInfoLocal2Utc(&info, ctx, into->tv_sec, tziCvtHint_HrA)) {
+        return false;
+    }
+    into->tv_sec += info.offs;
+    return true;
+}
+
+// ASN.1 UTCTime and GeneralizedTime
+static bool
+dtc_DecASN1(
+    struct timespec       *into,
+    ucal_DecLayoutT const *lay ,
+    const char            *str ,
+    size_t                 n   ,
+    ucal_DecDetectT const *det )
+{
+    unsigned ny = (ucal_DecFmt_ASN1Gen == lay->format) ? 4 : 2;
+    unsigned nd = lay->length - ny;
+    uint32_t year, v, nsec;
+    uint8_t  adg[5] = { 0, 0, 0, 0, 0 };
+    unsigned idx;
+    int      tzo = 0;
+
+    if ((n != lay->length + (lay->fracWidth ? lay->fracWidth + 1u : 0u) + s_zlen[lay->zone])
+        || !dtc_Fix(&year, str, ny)) {
+        return false;
+    }
+    for (idx = 0; idx < nd / 2; ++idx) {
+        if (!dtc_Fix(&v, str + ny + 2 * idx, 2)) {
+            return false;
+        }
+        adg[idx] = (uint8_t)v;
+    }
+    str += lay->length;
+    if (!dtc_Frac(&nsec, str, lay->fracWidth)) {
+        return false;
+    }
+    str += lay->fracWidth + (lay->fracWidth != 0);
+    if ((ucal_DecZone_None != lay->zone) && !dtc_Zone(&tzo, str, lay->zone)) {
+        return false;
+    }
+    if (2 == ny) {
+        year = det->ybase + ucal_iu32SubDiv(year, det->ybase, 100).r;
+    }
+    return dtc_Make(into, year, adg, nsec, lay->zone, tzo, det->ctx);
+}
+
+// RFC 3339 / ISO 8601 extended format
+static bool
+dtc_DecRFC3339(
+    struct timespec       *into,
+    ucal_DecLayoutT const *lay ,
+    const char            *str ,
+    size_t                 n   ,
+    ucal_DecDetectT const *det )
+{
+    uint32_t year, mon, day, h, m, s, nsec;
+    uint8_t  adg[5];
+    int      tzo = 0;
+
+    if ((n != 19u + (lay->fracWidth ? lay->fracWidth + 1u : 0u) + s_zlen[lay->zone])
+        || ('-' != str[4]) || ('-' != str[7]) || (lay->tsep != (uint8_t)str[10])
+        || (':' != str[13]) || (':' != str[16])
+        || !dtc_Fix(&year, str, 4) || !dtc_Fix(&mon, str + 5, 2) || !dtc_Fix(&day, str + 8, 2)
+        || !dtc_Fix(&h, str + 11, 2) || !dtc_Fix(&m, str + 14, 2) || !dtc_Fix(&s, str + 17, 2)
+        || !dtc_Frac(&nsec, str + 19, lay->fracWidth)) {
+        return false;
+    }
+    str += 19 + lay->fracWidth + (lay->fracWidth != 0);
+    if ((ucal_DecZone_None != lay->zone) && !dtc_Zone(&tzo, str, lay->zone)) {
+        return false;
+    }
+    adg[0] = (uint8_t)mon;
+    adg[1] = (uint8_t)day;
+    adg[2] = (uint8_t)h;
+    adg[3] = (uint8_t)m;
+    adg[4] = (uint8_t)s;
+    return dtc_Make(into, year, adg, nsec, lay->zone, tzo, det->ctx);
+}
+
+// look up a name of the mail date table
+static int
+dtc_Name(
+    const char *str ,
+    unsigned    kind)
+{
+    uint32_t          key = MDN_KEY(str[0] | 0x20, str[1] | 0x20, str[2] | 0x20);
+    mdn_EntryT const *ent = &mdn_tab[MDN_HASH(key)];
+
+    return ((ent->key == key) && (kind == ent->kind)) ? ent->value : -1;
+}
+
+// IMF-fixdate, "Sun, 06 Nov 1994 08:49:37 GMT"
+static bool
+dtc_DecHTTP(
+    struct timespec *into,
+    const char      *str ,
+    size_t           n   )
+{
+    uint32_t year, day, h, m, s;
+    uint8_t  adg[5];
+    int      mon;
+
+    if ((29 != n) || (',' != str[3]) || (' ' != str[4]) || (' ' != str[7]) || (' ' != str[11])
+        || (' ' != str[16]) || (':' != str[19]) || (':' != str[22]) || (' ' != str[25])
+        || (0 != memcmp(str + 26, "GMT", 3)) || (dtc_Name(str, mdn_WDay) < 0)
+        || ((mon = dtc_Name(str + 8, mdn_Month)) < 0)
+        || !dtc_Fix(&day, str + 5, 2) || !dtc_Fix(&year, str + 12, 4)
+        || !dtc_Fix(&h, str + 17, 2) || !dtc_Fix(&m, str + 20, 2) || !dtc_Fix(&s, str + 23, 2)) {
+        return false;
+    }
+    adg[0] = (uint8_t)mon;
+    adg[1] = (uint8_t)day;
+    adg[2] = (uint8_t)h;
+    adg[3] = (uint8_t)m;
+    adg[4] = (uint8_t)s;
+    return _ucal_mktime(into, year, adg, 0, 0);
+}
+
+// general mail date; must consume the text
+static bool
+dtc_DecMail(
+    struct timespec       *into,
+    const char            *str ,
+    size_t                 n   ,
+    ucal_DecDetectT const *det )
+{
+    const char *end = str + n;
+
+    return ucal_decRFC5322Date(into, &str, end, det->ctx) && (str == end);
+}
+
+// epoch value in the unit of the layout
+static bool
+dtc_DecEpoch(
+    struct timespec       *into,
+    ucal_DecLayoutT const *lay ,
+    const char            *str ,
+    size_t                 n   )
+{
+    const char *end = str + n;
+    unsigned    ui  = lay->unit / 3;
+    uint64_t    mag = 0;
+    uint32_t    nsec = 0, dch;
+    size_t      nd;
+    int64_t     sec;
+    bool        neg = false;
+
+    if ((str != end) && (('-' == *str) || ('+' == *str))) {
+        neg = ('-' == *str++);
+    }
+    nd = dtc_Span(str, end);
+    if ((0 == nd) || (nd > s_udig[ui])
+        || ((size_t)(end - str) != nd + (lay->fracWidth ? lay->fracWidth + 1u : 0u))) {
+        return false;
+    }
+    while (nd--) {
+        dch = (uint8_t)*str++ - (uint32_t)'0';
+        mag = mag * 10u + dch;
+    }
+    if (!dtc_Frac(&nsec, str, lay->fracWidth)) {
+        return false;
+    }
+    // constant divisors, so there is no 64bit division on 64bit targets
+    switch (ui) {
+    case 0:  sec = (int64_t)mag;                 break;
+    case 1:  sec = (int64_t)(mag / 1000u);       break;
+    case 2:  sec = (int64_t)(mag / 1000000u);    break;
+    default: sec = (int64_t)(mag / 1000000000u); break;
+    }
+    nsec += (uint32_t)(mag - (uint64_t)sec * s_udiv[ui]) * s_uscl[ui];
+    if (nsec >= pow10_9) {
+        ++sec;
+        nsec -= pow10_9;
+    }
+    if (neg) {
+        sec = -sec;
+        if (nsec) {
+            --sec;
+            nsec = pow10_9 - nsec;
+        }
+    }
+    into->tv_sec  = (time_t)sec;
+    into->tv_nsec = nsec;
+    return true;
+}
+
+// decode with a given layout
+static bool
+dtc_Decode(
+    struct timespec       *into,
+    ucal_DecLayoutT const *lay ,
+    const char            *str ,
+    size_t                 n   ,
+    ucal_DecDetectT const *det )
+{
+    switch (lay->format) {
+    case ucal_DecFmt_ASN1Utc:
+    case ucal_DecFmt_ASN1Gen:
+        return dtc_DecASN1(into, lay, str, n, det);
+    case ucal_DecFmt_RFC3339:
+        return dtc_DecRFC3339(into, lay, str, n, det);
+    case ucal_DecFmt_HTTPDate:
+        return dtc_DecHTTP(into, str, n);
+    case ucal_DecFmt_Mail:
+        return dtc_DecMail(into, str, n, det);
+    case ucal_DecFmt_Epoch:
+        return dtc_DecEpoch(into, lay, str, n);
+    default:
+        return false;
+    }
+}
+
+bool
+ucal_decClassify(
+    ucal_DecLayoutT *into,
+    const char      *str ,
+    const char      *end )
+{
+    ucal_DecLayoutT lay;
+    const char     *beg = str, *sig = str;
+    uint32_t        v;
+    size_t          nd, nf = 0;
+
+    if (NULL == end) {
+        end = str + strnlen(str, 128);
+    }
+    memset(&lay, 0, sizeof(lay));
+    memset(into, 0, sizeof(*into));
+    if (str == end) {
+        return false;
+    }
+
+    // names first: the fixed HTTP date, or any other mail date
+    if (mdn_IsAlpha((uint8_t)*str) || ('(' == *str)) {
+        lay.format = ((29 == end - str) && (',' == str[3]) && (':' == str[19])
+                      && (0 == memcmp(str + 25, " GMT", 4)))
+                   ? ucal_DecFmt_HTTPDate
+                   : ucal_DecFmt_Mail;
+        *into = lay;
+        return true;
+    }
+
+    // optional sign: epoch value
+    if (('-' == *str) || ('+' == *str)) {
+        ++sig;
+    }
+    nd = dtc_Span(sig, end);
+    if (0 == nd) {
+        return false;
+    }
+
+    // RFC 3339
+    if ((sig == str) && (4 == nd) && ((end - str) >= 19) && ('-' == str[4])) {
+        lay.format = ucal_DecFmt_RFC3339;
+        lay.length = 19;
+        lay.tsep   = (uint8_t)str[10];
+        if ((('T' != (lay.tsep & ~0x20)) && (' ' != lay.tsep))) {
+            return false;
+        }
+        str += 19;
+        if ((str != end) && ('.' == *str)) {
+            nf = dtc_Span(str + 1, end);
+            if ((0 == nf) || (nf > UINT8_MAX)) {
+                return false;
+            }
+            str += nf + 1;
+        }
+        lay.fracWidth = (uint8_t)nf;
+        if (!dtc_ZoneStyle(&lay.zone, str, end)) {
+            return false;
+        }
+        *into = lay;
+        return true;
+    }
+
+    // a day of month: other mail date
+    if ((sig == str) && (nd <= 2) && (str + nd != end) && (' ' == str[nd])) {
+        lay.format = ucal_DecFmt_Mail;
+        *into = lay;
+        return true;
+    }
+
+    // fraction, then zone or end
+    str = sig + nd;
+    if ((str != end) && ('.' == *str)) {
+        nf = dtc_Span(str + 1, end);
+        if ((0 == nf) || (nf > UINT8_MAX)) {
+            return false;
+        }
+        str += nf + 1;
+    }
+    lay.fracWidth = (uint8_t)nf;
+
+    // ASN.1 times need a zone
+    if ((str != end) && (('Z' == *str) || ('+' == *str) || ('-' == *str))) {
+        if ((sig != beg) || ((10 != nd) && (12 != nd) && (14 != nd))) {
+            return false;
+        }
+        if (!dtc_ZoneStyle(&lay.zone, str, end) || (ucal_DecZone_OffsColon == lay.zone)) {
+            return false;
+        }
+        lay.length = (uint8_t)nd;
+        lay.format = ((14 == nd) || !dtc_Fix(&v, sig + 2, 2) || (v < 1) || (v > 12))
+                   ? ucal_DecFmt_ASN1Gen
+                   : ucal_DecFmt_ASN1Utc;
+        *into = lay;
+        return true;
+    }
+
+    // plain number
+    if (str != end) {
+        return false;
+    }
+    lay.format = ucal_DecFmt_Epoch;
+    for (lay.unit = 0; (lay.unit < 9) && (nd > s_udig[lay.unit / 3]); lay.unit += 3) {
+        // search the unit
+    }
+    if ((nd > s_udig[lay.unit / 3]) || (nf && lay.unit)) {
+        return false;
+    }
+    *into = lay;
+    return true;
+}
+
+void
+ucal_decDetectInit(
+    ucal_DecDetectT *det  ,
+    tziConvCtxT     *ctx  ,
+    int              ybase)
+{
+    memset(det, 0, sizeof(*det));
+    det->ctx   = ctx;
+    det->ybase = ybase;
+}
+
+bool
+ucal_decDetect(
+    ucal_DecDetectT   *det  ,
+    const char *const *str  ,
+    const size_t      *len  ,
+    size_t             count)
+{
+    ucal_DecLayoutT cand[8], lay;
+    size_t          hits[8];
+    size_t          idx, ncand = 0, best = 0;
+    unsigned        ic;
+
+    for (idx = 0; idx < count; ++idx) {
+        if (!ucal_decClassify(&lay, str[idx], (len ? str[idx] + len[idx] : NULL))) {
+            continue;
+        }
+        for (ic = 0; (ic < ncand) && memcmp(&cand[ic], &lay, sizeof(lay)); ++ic) {
+            // search the candidate
+        }
+        if (ic == ncand) {
+            if (ncand == sizeof(cand) / sizeof(cand[0])) {
+                continue;   // too many layouts; the rest goes the slow way anyway
+            }
+            cand[ncand] = lay;
+            hits[ncand] = 0;
+            ++ncand;
+        }
+        if ((++hits[ic] > hits[best]) || (ic == best)) {
+            best = ic;
+        }
+    }
+    if (0 == ncand) {
+        memset(&det->layout, 0, sizeof(det->layout));
+        errno = EINVAL;
+        return false;
+    }
+    det->layout = cand[best];
+    return true;
+}
+
+// decode one value of a column, in the bound layout or its own
+static inline bool
+dtc_DecodeAny(
+    struct timespec *into,
+    ucal_DecDetectT *det ,
+    const char      *str ,
+    size_t           n   )
+{
+    ucal_DecLayoutT lay;
+
+    if (dtc_Decode(into, &det->layout, str, n, det)) {
+        return true;
+    }
+    ++det->nslow;
+    if (!ucal_decClassify(&lay, str, str + n) || !dtc_Decode(into, &lay, str, n, det)) {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+size_t
+ucal_decColumn(
+    struct timespec   *into ,
+    ucal_DecDetectT   *det  ,
+    const char *const *str  ,
+    const size_t      *len  ,
+    size_t             count)
+{
+    size_t idx, n;
+
+    for (idx = 0; idx < count; ++idx) {
+        n = len ? len[idx] : strnlen(str[idx], 128);
+        if (!dtc_DecodeAny(&into[idx], det, str[idx], n)) {
+            break;
+        }
+    }
+    return idx;
+}
+
+size_t
+ucal_decColumnNs(
+    ucal_ns_t         *into ,
+    ucal_DecDetectT   *det  ,
+    const char *const *str  ,
+    const size_t      *len  ,
+    size_t             count)
+{
+    struct timespec ts;
+    size_t          idx, n;
+
+    for (idx = 0; idx < count; ++idx) {
+        n = len ? len[idx] : strnlen(str[idx], 128);
+        if (!dtc_DecodeAny(&ts, det, str[idx], n)) {
+            break;
+        }
+        if ((ts.tv_sec < INT64_MIN / pow10_9) || (ts.tv_sec >= INT64_MAX / pow10_9)) {
+            errno = ERANGE;
+            break;
+        }
+        into[idx] = ucal_TimespecToNs(&ts);
+    }
+    return idx;
+}
+
 // -*- that's all folks -*-
@@ -0,0 +1,722 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains bulk conversions with POSIX time zones.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// bulk time zone conversions
+///
+/// Converting one instant into many zones repeats the same calendar work for every zone in
+/// @c tziGetInfoUtc2Local(): finding the year and evaluating the rules for that year.  The
+/// year does not depend on the zone, and after some pre-digestion neither does most of the
+/// rule evaluation: A POSIX rule always resolves to
+///
+///     day = base + leap + [(wd - weekday(base + leap)) mod 7]
+///
+/// where @e base is the day-in-year for a regular year, @e leap is one for days after
+/// February in leap years, and the weekday is that of Jan,1 plus the day-in-year.  Everything
+/// but the leap year flag and the weekday of Jan,1 can be calculated when packing the zone.
+/// The zones are stored in blocks of @c TZI_LANES, field by field, and the per-lane evaluation
+/// is written without branches so the compiler can vectorise it.
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzbatch.h"
+
+// cumulated month lengths in a regular year, with the year length at index 12
+static const int16_t s_mstart[13] = {
+    0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365
+};
+
+// Digest a rule into base day, leap year shift and weekday constant & mask.  See
+// 'tzi_EvalRule()' in tzposix.c for the straight implementation.
+static void
+tzb_PackRule(
+    int32_t       *day ,
+    int32_t       *lpi ,
+    int32_t       *wdc ,
+    int32_t       *wdm ,
+    tziPosixRuleT  rule)
+{
+    int mon;    // base month, zero-based; 12 is the start of the next year
+
+    if (0 == rule.rt_month) {
+        mon  = 0;
+        *day = 0;
+    } else if (0 == rule.rt_wday) {
+        mon  = rule.rt_month - 1;
+        *day = rule.rt_mdmw - 1;
+    } else if (5 == rule.rt_mdmw) {
+        // last weekday on or before the last day of the month, which is the first weekday
+        // on or after the 7th-last day
+        mon  = rule.rt_month;
+        *day = -7;
+    } else {
+        mon  = rule.rt_month - 1;
+        *day = (rule.rt_mdmw - 1) * 7;
+    }
+    *day += s_mstart[mon];
+    *lpi  = (mon >= 2) ? -1 : 0;
+    *wdm  = rule.rt_wday ? -1 : 0;
+    *wdc  = ucal_i32SubMod7(rule.rt_wday, *day);
+}
+
+// ----------------------------------------------------------------------------------------------
+void
+tziPackZone(
+    tziZoneBlockT       *blocks,
+    size_t               idx   ,
+    tziPosixZoneT const *zone  )
+{
+    tziZoneBlockT * const blk = blocks + idx / TZI_LANES;
+    unsigned        const ln  = idx % TZI_LANES;
+
+    blk->offsSTD[ln] = -zone->stdOffs * 60;
+    blk->offsDST[ln] = -zone->dstOffs * 60;
+    blk->locDST[ln]  = zone->dstRule.rt_ttloc + zone->stdOffs;
+    blk->locSTD[ln]  = zone->stdRule.rt_ttloc + zone->dstOffs;
+    blk->ovlSTD[ln]  = (zone->stdOffs >= zone->dstOffs) ? -1 : 0;
+
+    tzb_PackRule(&blk->dayDST[ln], &blk->lpiDST[ln], &blk->wdcDST[ln], &blk->wdmDST[ln],
+                 zone->dstRule);
+    tzb_PackRule(&blk->daySTD[ln], &blk->lpiSTD[ln], &blk->wdcSTD[ln], &blk->wdmSTD[ln],
+                 zone->stdRule);
+
+    if (0 == zone->dstRule.rt_month) {
+        blk->fixMode[ln] = 1;
+        blk->ovlSecs[ln] = 0;
+    } else if (0 == zone->stdRule.rt_month) {
+        blk->fixMode[ln] = 2;
+        blk->ovlSecs[ln] = 0;
+    } else {
+        blk->fixMode[ln] = 0;
+        blk->ovlSecs[ln] = abs(zone->stdOffs - zone->dstOffs) * 60;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+void
+tziPackZones(
+    tziZoneBlockT       *blocks,
+    tziPosixZoneT const *zones ,
+    size_t               count )
+{
+    static const tziPosixZoneT utc = { .stdName = "UTC" };
+
+    size_t idx;
+    for (idx = 0; idx < count; ++idx) {
+        tziPackZone(blocks, idx, zones + idx);
+    }
+    for ( ; idx % TZI_LANES; ++idx) {
+        tziPackZone(blocks, idx, &utc);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// The common calendar data for one time stamp.  Inside a year, all times are seconds since the
+// start of the year and fit into 32 bits.
+typedef struct {
+    int32_t tsrel;  // the time stamp, relative to year start
+    int32_t isLY;   // leap year mask (-1 or 0)
+    int32_t wdY;    // day-of-week of Jan,1, 0..6
+} tzb_YearT;
+
+// x mod 7, given x in [-7,6]
+static inline int32_t
+tzb_mod7(int32_t x) {
+    return x + (7 & ucal_i32Asr(x, 31));
+}
+
+// Evaluate one block; all lanes are computed, the results go to lane-sized buffers.  The
+// pointers are marked 'restrict' so the compiler may vectorise the lane loop.
+static void
+tzb_EvalBlock(
+    int32_t             * restrict offs ,
+    int32_t             * restrict flags,
+    tziZoneBlockT const * restrict blk  ,
+    tzb_YearT const     * restrict yr   )
+{
+    int32_t const ts   = yr->tsrel;
+    int32_t const isLY = yr->isLY;
+    int32_t const wdY  = yr->wdY;
+    unsigned      ln;
+
+    for (ln = 0; ln < TZI_LANES; ++ln) {
+        int32_t lpi, dDST, dSTD, ttDST, ttSTD, ttCrit;
+        int32_t north, inA, inB, isDst, fix;
+
+        // Day-in-year of the transitions.  After March, the base day and its weekday move
+        // by one in leap years; the weekday adjustment is masked out for fixed days.
+        lpi   = blk->lpiDST[ln] & isLY;
+        dDST  = blk->dayDST[ln] - lpi;
+        dDST += tzb_mod7(blk->wdcDST[ln] + lpi - wdY) & blk->wdmDST[ln];
+        lpi   = blk->lpiSTD[ln] & isLY;
+        dSTD  = blk->daySTD[ln] - lpi;
+        dSTD += tzb_mod7(blk->wdcSTD[ln] + lpi - wdY) & blk->wdmSTD[ln];
+
+        ttDST = (dDST * 1440 + blk->locDST[ln]) * 60;
+        ttSTD = (dSTD * 1440 + blk->locSTD[ln]) * 60;
+
+        // seasons flip around when crossing the equator
+        north = (ttDST < ttSTD);
+        inA   = (ts >= ttDST);
+        inB   = (ts <  ttSTD);
+        isDst = (inA & inB) | ((north ^ 1) & (inA | inB));
+
+        // override for zones without transitions
+        fix   = blk->fixMode[ln];
+        isDst = (isDst & (0 == fix)) | (2 == fix);
+
+        offs[ln] = (blk->offsDST[ln] & -isDst) | (blk->offsSTD[ln] & (isDst - 1));
+
+        // overlap indicators; 'ovlSecs' is zero for fixed zones, giving empty ranges
+        ttCrit    = (ttSTD & blk->ovlSTD[ln]) | (ttDST & ~blk->ovlSTD[ln]);
+        flags[ln] = isDst
+                  | (((ttCrit - blk->ovlSecs[ln] <= ts) & (ts < ttCrit)) << 1)
+                  | (((ttCrit <= ts) & (ts < ttCrit + blk->ovlSecs[ln])) << 2);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+tziFanOutUtc2Local(
+    int32_t             *offs  ,
+    uint8_t             *flags ,
+    tziZoneBlockT const *blocks,
+    size_t               count ,
+    int64_t              tsfrom)
+{
+    tzb_YearT     yr;
+    ucal_iu32DivT yd;
+    int64_t       days;
+    int32_t       rdn;
+    bool          isLY;
+
+    if ((NULL == offs) || (count && (NULL == blocks))) {
+        errno = EINVAL;
+        return false;
+    }
+
+    // Get the year and its properties.  This is the only calendar work we do.
+    days = tsfrom / 86400;
+    days -= (tsfrom % 86400 < 0);
+    if ((days < INT32_MIN + UCAL_rdnUNIX) || (days > INT32_MAX - UCAL_rdnUNIX)) {
+        errno = ERANGE;
+        return false;
+    }
+    rdn = (int32_t)days + UCAL_rdnUNIX;
+    yd  = ucal_DaysToYearsGD(rdn, &isLY);
+    if (yd.q < INT16_MIN || yd.q >= INT16_MAX) {
+        errno = ERANGE;
+        return false;
+    }
+    yr.tsrel = (int32_t)(tsfrom - (days - (int64_t)yd.r) * 86400);
+    yr.isLY  = isLY ? -1 : 0;
+    yr.wdY   = ucal_i32SubMod7(rdn - (int32_t)yd.r, 0);
+
+    // Evaluate block by block.  The lane buffers are all 32 bit, for the same reason the block
+    // fields are; narrowing the flags is done here.
+    while (count) {
+        int32_t bOffs[TZI_LANES];
+        int32_t bFlags[TZI_LANES];
+        size_t  n = (count < TZI_LANES) ? count : TZI_LANES;
+        size_t  i;
+
+        tzb_EvalBlock(bOffs, bFlags, blocks, &yr);
+        memcpy(offs, bOffs, n * sizeof(*offs));
+        offs += n;
+        if (flags) {
+            for (i = 0; i < n; ++i) {
+                *flags++ = (uint8_t)bFlags[i];
+            }
+        }
+        count -= n;
+        ++blocks;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// runs of time stamps in one zone
+// ----------------------------------------------------------------------------------------------
+
+static inline int64_t i64_min(int64_t a, int64_t b) {
+    return (a <= b) ? a : b;
+}
+static inline int64_t i64_max(int64_t a, int64_t b) {
+    return (a <= b) ? b : a;
+}
+
+// Get the interval [*plo,*phi[ around 'tsfrom' where the conversion info does not change.  The
+// context must have been updated for 'tsfrom'.  The info changes only at the transitions and
+// at the edges of the overlap, and the interval is clipped to the range where the context is
+// not recalculated.
+static void
+tzb_Segment(int64_t *plo, int64_t *phi, tziConvCtxT const *ctx, int64_t tsfrom)
+{
+    tziPosixZoneT const * const tzi = ctx->pTZI;
+
+    int64_t lo = INT64_MIN;
+    int64_t hi = INT64_MAX;
+    if (tzi->dstRule.rt_month && tzi->stdRule.rt_month) {
+        int64_t edge[4];
+        int64_t ttCrit;
+        int32_t ttDiff;
+        int     i;
+
+        if (tzi->stdOffs >= tzi->dstOffs) {
+            ttCrit = ctx->ttSTD;
+            ttDiff = (tzi->stdOffs - tzi->dstOffs) * 60;
+        } else {
+            ttCrit = ctx->ttDST;
+            ttDiff = (tzi->dstOffs - tzi->stdOffs) * 60;
+        }
+        edge[0] = ctx->ttDST;
+        edge[1] = ctx->ttSTD;
+        edge[2] = ttCrit - ttDiff;
+        edge[3] = ttCrit + ttDiff;
+
+        lo = ctx->trLoBound - 86400;
+        hi = ctx->trHiBound + 86400;
+        for (i = 0; i < 4; ++i) {
+            if (edge[i] <= tsfrom) {
+                lo = i64_max(lo, edge[i]);
+            } else {
+                hi = i64_min(hi, edge[i]);
+            }
+        }
+    }
+    *plo = lo;
+    *phi = hi;
+}
+
+// the interval where the conversion info does not change, and that info
+typedef struct {
+    int64_t lo, hi;
+    int32_t offs;
+    uint8_t flags;
+} tzb_SegT;
+
+static void
+tzb_SegInit(tzb_SegT *seg)
+{
+    seg->lo = 1;    // empty
+    seg->hi = 0;
+}
+
+// convert a run in one zone, using and updating a segment cache
+static bool
+tzb_Run(
+    int32_t       *offs  ,
+    uint8_t       *flags ,
+    tziConvCtxT   *ctx   ,
+    tzb_SegT      *seg   ,
+    int64_t const *tsfrom,
+    size_t         count )
+{
+    tziConvInfoT info;
+    tzb_SegT     sc = *seg;
+    size_t       idx;
+
+    for (idx = 0; idx < count; ++idx) {
+        int64_t const ts = tsfrom[idx];
+        if ((ts < sc.lo) || (ts >= sc.hi)) {
+            if (!tziGetInfoUtc2Local(&info, ctx, ts)) {
+                return false;
+            }
+            tzb_Segment(&sc.lo, &sc.hi, ctx, ts);
+            sc.offs  = info.offs;
+            sc.flags = (uint8_t)((info.isDst ? tziFlag_DST : 0)
+                               | (info.isHrA ? tziFlag_HrA : 0)
+                               | (info.isHrB ? tziFlag_HrB : 0));
+        }
+        offs[idx] = sc.offs;
+        if (flags) {
+            flags[idx] = sc.flags;
+        }
+    }
+    *seg = sc;
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+tziBatchUtc2Local(
+    int32_t       *offs  ,
+    uint8_t       *flags ,
+    tziConvCtxT   *ctx   ,
+    int64_t const *tsfrom,
+    size_t         count )
+{
+    tzb_SegT seg;
+
+    if ((NULL == offs) || (NULL == ctx) || (NULL == ctx->pTZI) || (count && (NULL == tsfrom))) {
+        errno = EINVAL;
+        return false;
+    }
+    tzb_SegInit(&seg);
+    return tzb_Run(offs, flags, ctx, &seg, tsfrom, count);
+}
+
+// ----------------------------------------------------------------------------------------------
+// mixed-zone records
+// ----------------------------------------------------------------------------------------------
+
+// Records are processed in chunks, so the partitioned data stays in the cache. Each zone keeps
+// its segment from one chunk to the next.
+#define TZB_CHUNK 4096
+
+// The scratch buffer holds (in this order, to keep the alignment right):
+//  - the segment caches, per zone              : nzones * tzb_SegT
+//  - the time stamps, gathered by zone         : chunk  * int64_t
+//  - the offsets, in partitioned order         : chunk  * int32_t
+//  - the partition start indices               : nzones * uint32_t (+1)
+//  - the permutation (partition -> record)     : chunk  * uint16_t
+//  - the flags, in partitioned order           : chunk  * uint8_t
+
+size_t
+tziBatchScratchSize(
+    size_t count ,
+    size_t nzones)
+{
+    size_t const chunk = (count < TZB_CHUNK) ? count : TZB_CHUNK;
+    return nzones * sizeof(tzb_SegT) + (nzones + 1) * sizeof(uint32_t)
+         + chunk * (sizeof(int64_t) + sizeof(int32_t) + sizeof(uint16_t) + sizeof(uint8_t));
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+tziBatchUtc2LocalByZone(
+    int32_t        *offs   ,
+    uint8_t        *flags  ,
+    int64_t const  *tsfrom ,
+    uint16_t const *zoneId ,
+    size_t          count  ,
+    tziConvCtxT    *ctxTab ,
+    size_t          nzones ,
+    void           *scratch)
+{
+    size_t const chunk = (count < TZB_CHUNK) ? count : TZB_CHUNK;
+
+    tzb_SegT *sSeg;
+    int64_t  *sTs;
+    int32_t  *sOffs;
+    uint32_t *sPos;
+    uint16_t *sPerm;
+    uint8_t  *sFlags;
+    size_t    idx, zi;
+
+    if ((NULL == offs) || (count && ((NULL == tsfrom) || (NULL == zoneId)
+                                     || (NULL == ctxTab) || (NULL == scratch)))) {
+        errno = EINVAL;
+        return false;
+    }
+    for (idx = 0; idx < count; ++idx) {
+        if (zoneId[idx] >= nzones) {
+            errno = EINVAL;
+            return false;
+        }
+    }
+    sSeg   = (tzb_SegT*)scratch;
+    sTs    = (int64_t*)(sSeg + nzones);
+    sOffs  = (int32_t*)(sTs + chunk);
+    sPos   = (uint32_t*)(sOffs + chunk);
+    sPerm  = (uint16_t*)(sPos + nzones + 1);
+    sFlags = (uint8_t*)(sPerm + chunk);
+
+    for (zi = 0; zi < nzones; ++zi) {
+        tzb_SegInit(&sSeg[zi]);
+    }
+
+    while (count) {
+        size_t const n   = (count < chunk) ? count : chunk;
+        uint32_t     beg = 0;
+
+        // counting pass; sPos[z+1] counts zone z
+        memset(sPos, 0, (nzones + 1) * sizeof(*sPos));
+        for (idx = 0; idx < n; ++idx) {
+            ++sPos[zoneId[idx] + 1];
+        }
+        // prefix sum; sPos[z] is the start of zone z now
+        for (zi = 1; zi < nzones; ++zi) {
+            sPos[zi + 1] += sPos[zi];
+        }
+        // distribution pass; afterwards sPos[z] is the end of zone z
+        for (idx = 0; idx < n; ++idx) {
+            uint32_t const dst = sPos[zoneId[idx]]++;
+            sTs[dst]   = tsfrom[idx];
+            sPerm[dst] = (uint16_t)idx;
+        }
+
+        // convert the partitions
+        for (zi = 0; zi < nzones; beg = sPos[zi++]) {
+            size_t const pn = sPos[zi] - beg;
+            if (pn && !tzb_Run(sOffs + beg, sFlags + beg, &ctxTab[zi], &sSeg[zi],
+                               sTs + beg, pn)) {
+                return false;
+            }
+        }
+
+        // scatter back to record order
+        for (idx = 0; idx < n; ++idx) {
+            offs[sPerm[idx]] = sOffs[idx];
+        }
+        if (flags) {
+            for (idx = 0; idx < n; ++idx) {
+                flags[sPerm[idx]] = sFlags[idx];
+            }
+            flags += n;
+        }
+        offs   += n;
+        tsfrom += n;
+        zoneId += n;
+        count  -= n;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// streams of local time stamps
+// ----------------------------------------------------------------------------------------------
+
+void
+tziStreamInit(
+    tziStreamT  *strm ,
+    tziConvCtxT *ctx  ,
+    int64_t      pivot)
+{
+    strm->ctx      = ctx;
+    strm->pivot    = pivot;
+    strm->segLo    = 1;     // empty
+    strm->segHi    = 0;
+    strm->segOffs  = 0;
+    strm->segFlags = 0;
+}
+
+// Resolve a local time stamp the hard way: get both candidates, pick one, and establish the
+// interval of the result for the following time stamps.
+static bool
+tzb_StreamResolve(
+    int64_t    *putc ,
+    uint8_t    *pflag,
+    tziStreamT *strm ,
+    int64_t     tsloc)
+{
+    tziConvInfoT info;
+    int64_t      uA, uB, u;
+    uint8_t      fl = 0;
+
+    if (!tziGetInfoLocal2Utc(&info, strm->ctx, tsloc, tziCvtHint_HrA)) {
+        return false;
+    }
+    uA = tsloc + info.offs;
+    if (!tziGetInfoLocal2Utc(&info, strm->ctx, tsloc, tziCvtHint_HrB)) {
+        return false;
+    }
+    uB = tsloc + info.offs;
+
+    if (uA > uB) {
+        // in the gap: the offset before the transition moves it forward
+        u  = uA;
+        fl = tziFlag_Gap;
+    } else {
+        // the first candidate after the pivot; if there is none, the later is closer
+        u  = (uA > strm->pivot) ? uA : uB;
+    }
+
+    if (!tziGetInfoUtc2Local(&info, strm->ctx, u)) {
+        return false;
+    }
+    tzb_Segment(&strm->segLo, &strm->segHi, strm->ctx, u);
+    strm->segOffs  = info.offs;
+    strm->segFlags = (uint8_t)((info.isDst ? tziFlag_DST : 0)
+                             | (info.isHrA ? tziFlag_HrA : 0)
+                             | (info.isHrB ? tziFlag_HrB : 0));
+    *putc  = u;
+    *pflag = (uint8_t)(strm->segFlags | fl);
+    return true;
+}
+
+size_t
+tziStreamLocal2Utc(
+    int64_t       *utc  ,
+    uint8_t       *flags,
+    tziStreamT    *strm ,
+    int64_t const *tsloc,
+    size_t         count)
+{
+    size_t idx;
+
+    if ((NULL == utc) || (NULL == strm) || (NULL == strm->ctx) || (NULL == strm->ctx->pTZI)
+        || (count && (NULL == tsloc)))
+    {
+        errno = EINVAL;
+        return 0;
+    }
+
+    for (idx = 0; idx < count; ++idx) {
+        int64_t u  = tsloc[idx] - strm->segOffs;
+        uint8_t fl = strm->segFlags;
+
+        // The cached interval has a single offset, and outside the overlap every local time
+        // shows up once; if the candidate lands in it, it is the answer.
+        if ((u < strm->segLo) || (u >= strm->segHi) || (fl & (tziFlag_HrA | tziFlag_HrB))) {
+            if (!tzb_StreamResolve(&u, &fl, strm, tsloc[idx])) {
+                break;
+            }
+        }
+        if (u < strm->pivot) {
+            fl |= tziFlag_Bck;
+        }
+        strm->pivot = u;
+        utc[idx] = u;
+        if (flags) {
+            flags[idx] = fl;
+        }
+    }
+    return idx;
+}
+
+// ----------------------------------------------------------------------------------------------
+// aligned windows in many resolutions
+// ----------------------------------------------------------------------------------------------
+
+// one resolution: the last window and the part of it where it can be reused
+typedef struct {
+    int64_t lo, hi;     // window, clamped
+    int64_t vlo, vhi;   // reuse interval; empty if a transition is in the window
+    int64_t idx;        // window number in local time
+} tzb_WinT;
+
+// The window of one resolution, done like 'tziAlignedLocalRange()' with the offset and
+// transitions shared by all resolutions.
+static void
+tzb_Window(
+    tzb_WinT         *wc   ,
+    tziWindowT const *win  ,
+    int64_t           ts   ,
+    int32_t           offs ,
+    int64_t const     tt[2])
+{
+    int64_t loc = ts + offs + win->phi;
+    int64_t q   = loc / win->period;
+    int32_t r   = (int32_t)(loc - q * win->period);
+    int     i;
+
+    if (r < 0) {
+        r += win->period;
+        --q;
+    }
+    wc->idx = q;
+    wc->lo  = ts - r;
+    wc->hi  = wc->lo + win->period;
+    if (tt) {
+        // clamp the window so 'ts' is in it; the lower bound is only moved for time stamps
+        // strictly after the transition!
+        for (i = 0; i < 2; ++i) {
+            if ((wc->lo < tt[i]) && (ts > tt[i])) {
+                wc->lo = tt[i];
+            }
+        }
+        for (i = 0; i < 2; ++i) {
+            if ((wc->hi > tt[i]) && (ts < tt[i])) {
+                wc->hi = tt[i];
+            }
+        }
+    }
+    wc->vlo = wc->lo;
+    wc->vhi = wc->hi;
+    if (tt) {
+        // ...which makes the result depend on the side of a transition in the window
+        for (i = 0; i < 2; ++i) {
+            if ((wc->lo <= tt[i]) && (tt[i] < wc->hi)) {
+                wc->vlo = 1;
+                wc->vhi = 0;
+            }
+        }
+    }
+}
+
+bool
+tziAlignedLocalRanges(
+    int64_t          *tlohi ,
+    int64_t          *widx  ,
+    tziConvCtxT      *ctx   ,
+    tziWindowT const *win   ,
+    size_t            nwin  ,
+    int64_t const    *tsfrom,
+    size_t            count )
+{
+    tzb_WinT     wc[TZI_MAX_WINDOWS];
+    tziConvInfoT info;
+    tzb_SegT     seg;
+    int64_t      tt[2];
+    bool         hasTr;
+    size_t       idx, k;
+
+    if ((NULL == ctx) || (NULL == ctx->pTZI) || (nwin > TZI_MAX_WINDOWS)
+        || (nwin && (NULL == win)) || (count && (NULL == tsfrom)))
+    {
+        errno = EINVAL;
+        return false;
+    }
+    for (k = 0; k < nwin; ++k) {
+        if ((win[k].period <= 0) || (win[k].period > 7 * 86400)) {
+            errno = EINVAL;
+            return false;
+        }
+    }
+    hasTr = ctx->pTZI->dstRule.rt_month && ctx->pTZI->stdRule.rt_month;
+    tt[0] = tt[1] = 0;
+
+    tzb_SegInit(&seg);
+    for (idx = 0; idx < count; ++idx) {
+        int64_t const ts = tsfrom[idx];
+        if ((ts < seg.lo) || (ts >= seg.hi)) {
+            // the offset and the transitions the clamping uses change only here
+            if (!tziGetInfoUtc2Local(&info, ctx, ts)) {
+                return false;
+            }
+            tzb_Segment(&seg.lo, &seg.hi, ctx, ts);
+            seg.offs = info.offs;
+            tt[0] = ctx->ttDST;
+            tt[1] = ctx->ttSTD;
+            for (k = 0; k < nwin; ++k) {
+                wc[k].vlo = 1;
+                wc[k].vhi = 0;
+            }
+        }
+        for (k = 0; k < nwin; ++k) {
+            if ((ts < wc[k].vlo) || (ts >= wc[k].vhi)) {
+                tzb_Window(&wc[k], &win[k], ts, seg.offs, hasTr ? tt : NULL);
+            }
+            if (tlohi) {
+                tlohi[(idx * nwin + k) * 2 + 0] = wc[k].lo;
+                tlohi[(idx * nwin + k) * 2 + 1] = wc[k].hi;
+            }
+            if (widx) {
+                widx[idx * nwin + k] = wc[k].idx;
+            }
+        }
+    }
+    return true;
+}
+
+// -*- that's all folks -*-
@@ -0,0 +1,353 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the local period numbers of time stamps.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// local period numbers
+///
+/// Quotas and reports are often keyed by the local day, week or month of an event.  Getting
+/// there through a full civil date is a waste: the local day number is the floor of the local
+/// time by 86400, the ISO week number follows with another floor division, and only months,
+/// quarters and years need the calendar, and just the year/day-in-year split at that.
+///
+/// The inverse maps a period to the UTC instant of its local midnight; two of these make the
+/// UTC range of a period, which is what billing by local month or quarter needs.  In an array
+/// of time stamps, the UTC bounds of the current period are kept, and a time stamp inside is
+/// done with two compares.
+
+#include <errno.h>
+#include <time.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzperiod.h"
+
+#define EPOCH_YEAR 1970
+
+// day index of the Monday starting ISO week zero, 1969-12-29
+#define TZP_WEEK0 (-3)
+
+// ----------------------------------------------------------------------------------------------
+// split local time by a period
+static bool
+tzp_IndexLocal(
+    int32_t   *into,
+    int64_t    loc ,
+    tziPeriodT unit)
+{
+    ucal_TimeDivT ds = ucal_TimeToDays((time_t)loc);
+    ucal_iu32DivT yd;
+    bool          isLY;
+
+    if ((ds.q <= INT32_MIN - TZP_WEEK0) || (ds.q > INT32_MAX - UCAL_rdnUNIX)) {
+        errno = ERANGE;
+        return false;
+    }
+    switch (unit) {
+    case tziPeriod_Day:
+        *into = (int32_t)ds.q;
+        break;
+
+    case tziPeriod_Week:
+        *into = ucal_iu32SubDiv((int32_t)ds.q, TZP_WEEK0, 7).q;
+        break;
+
+    case tziPeriod_Month:
+        yd    = ucal_DaysToYearsGD((int32_t)ds.q + UCAL_rdnUNIX, &isLY);
+        *into = (yd.q - (EPOCH_YEAR - 1)) * 12 + ucal_DaysToMonth(yd.r, isLY).q;
+        break;
+
+    case tziPeriod_Year:
+        yd    = ucal_DaysToYearsGD((int32_t)ds.q + UCAL_rdnUNIX, &isLY);
+        *into = yd.q - (EPOCH_YEAR - 1);
+        break;
+
+    case tziPeriod_Quarter:
+        yd    = ucal_DaysToYearsGD((int32_t)ds.q + UCAL_rdnUNIX, &isLY);
+        *into = (yd.q - (EPOCH_YEAR - 1)) * 4 + ucal_DaysToMonth(yd.r, isLY).q / 3;
+        break;
+
+    default:
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+// get the local midnight starting a period, as days since 1970
+static bool
+tzp_StartLocal(
+    int32_t   *into ,
+    int32_t    index,
+    tziPeriodT unit )
+{
+    ucal_iu32DivT ym;
+    int64_t       y;
+
+    switch (unit) {
+    case tziPeriod_Day:
+        if (index > INT32_MAX - UCAL_rdnUNIX) {
+            break;
+        }
+        *into = index;
+        return true;
+
+    case tziPeriod_Week:
+        if ((index < (INT32_MIN - TZP_WEEK0) / 7) || (index > (INT32_MAX - UCAL_rdnUNIX) / 7)) {
+            break;
+        }
+        *into = index * 7 + TZP_WEEK0;
+        return true;
+
+    case tziPeriod_Month:
+        ym = ucal_iu32Div(index, 12);
+        y  = (int64_t)ym.q + EPOCH_YEAR;
+        if ((y < INT16_MIN) || (y > INT16_MAX)) {
+            break;
+        }
+        *into = ucal_DateToRdnGD((int16_t)y, (int16_t)(ym.r + 1), 1) - UCAL_rdnUNIX;
+        return true;
+
+    case tziPeriod_Year:
+        y = (int64_t)index + EPOCH_YEAR;
+        if ((y < INT16_MIN) || (y > INT16_MAX)) {
+            break;
+        }
+        *into = ucal_YearStartGD((int16_t)y) - UCAL_rdnUNIX;
+        return true;
+
+    case tziPeriod_Quarter:
+        ym = ucal_iu32Div(index, 4);
+        y  = (int64_t)ym.q + EPOCH_YEAR;
+        if ((y < INT16_MIN) || (y > INT16_MAX)) {
+            break;
+        }
+        *into = ucal_DateToRdnGD((int16_t)y, (int16_t)(ym.r * 3 + 1), 1) - UCAL_rdnUNIX;
+        return true;
+
+    default:
+        errno = EINVAL;
+        return false;
+    }
+    errno = ERANGE;
+    return false;
+}
+
+// ----------------------------------------------------------------------------------------------
+bool
+tziPeriodIndex(
+    int32_t     *into  ,
+    tziConvCtxT *ctx   ,
+    int64_t      tsfrom,
+    tziPeriodT   unit  )
+{
+    tziConvInfoT info;
+
+    if ((NULL == into) || (NULL == ctx) || (NULL == ctx->pTZI)) {
+        errno = EINVAL;
+        return false;
+    }
+    return tziGetInfoUtc2Local(&info, ctx, tsfrom)
+        && tzp_IndexLocal(into, tsfrom + info.offs, unit);
+}
+
+bool
+tziPeriodStart(
+    int64_t     *into ,
+    tziConvCtxT *ctx  ,
+    int32_t      index,
+    tziPeriodT   unit )
+{
+    tziConvInfoT info;
+    int64_t      loc, uA, uB;
+    int32_t      days;
+
+    if ((NULL == into) || (NULL == ctx) || (NULL == ctx->pTZI)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!tzp_StartLocal(&days, index, unit)) {
+        return false;
+    }
+    loc = (int64_t)days * 86400;
+
+    // the zone before the transition gives the first occurrence in an overlap...
+    if (!tziGetInfoLocal2Utc(&info, ctx, loc, tziCvtHint_HrA)) {
+        return false;
+    }
+    uA = loc + info.offs;
+    if (!tziGetInfoLocal2Utc(&info, ctx, loc, tziCvtHint_HrB)) {
+        return false;
+    }
+    uB = loc + info.offs;
+    *into = uA;
+
+    // ...but in a gap, the period starts with the transition, which is in ]uB,uA]
+    if (uA > uB) {
+        bool    isLY;
+        int64_t tt[2];
+        int16_t y = (int16_t)(ucal_DaysToYearsGD(days + UCAL_rdnUNIX, &isLY).q + 1);
+        if (tziGetTransitions(tt, ctx->pTZI, y)) {
+            if ((tt[0] > uB) && (tt[0] <= uA)) {
+                *into = tt[0];
+            } else if ((tt[1] > uB) && (tt[1] <= uA)) {
+                *into = tt[1];
+            }
+        }
+    }
+    return true;
+}
+
+size_t
+tziPeriodIndexArray(
+    int32_t       *into  ,
+    tziConvCtxT   *ctx   ,
+    int64_t const *tsfrom,
+    size_t         count ,
+    tziPeriodT     unit  )
+{
+    int64_t lo = 1, hi = 0;     // UTC bounds of the current period
+    int32_t cur = 0;
+    size_t  idx;
+
+    if ((NULL == into) || (count && (NULL == tsfrom))) {
+        errno = EINVAL;
+        return 0;
+    }
+    for (idx = 0; idx < count; ++idx) {
+        int64_t const ts = tsfrom[idx];
+        if ((ts < lo) || (ts >= hi)) {
+            int eSave = errno;
+            if (!tziPeriodIndex(&cur, ctx, ts, unit)) {
+                break;
+            }
+            // Failing to get the bounds (at the end of the range) just means no caching.
+            if ((cur == INT32_MAX) || !tziPeriodStart(&lo, ctx, cur, unit)
+                || !tziPeriodStart(&hi, ctx, cur + 1, unit) || (ts < lo) || (ts >= hi))
+            {
+                lo = ts;
+                hi = ts + 1;
+                errno = eSave;
+            }
+        }
+        into[idx] = cur;
+    }
+    return idx;
+}
+
+// ----------------------------------------------------------------------------------------------
+// period ranges
+// ----------------------------------------------------------------------------------------------
+
+void
+tziPeriodCacheInit(
+    tziPeriodCacheT *cache,
+    tziConvCtxT     *ctx  ,
+    tziPeriodT       unit )
+{
+    cache->ctx   = ctx;
+    cache->unit  = unit;
+    cache->index = 0;
+    cache->lo    = 1;   // empty
+    cache->hi    = 0;
+}
+
+// Look up the period of a time stamp, unless it is the cached one.
+static bool
+tzp_Range(
+    int64_t         *tlohi,
+    int32_t         *index,
+    tziPeriodCacheT *pc   ,
+    int64_t          ts   )
+{
+    int32_t cur;
+    int64_t lo, hi;
+
+    if ((ts < pc->lo) || (ts >= pc->hi)) {
+        if (!tziPeriodIndex(&cur, pc->ctx, ts, pc->unit)) {
+            return false;
+        }
+        if (cur == INT32_MAX) {
+            errno = ERANGE;
+            return false;
+        }
+        if (!tziPeriodStart(&lo, pc->ctx, cur, pc->unit)
+            || !tziPeriodStart(&hi, pc->ctx, cur + 1, pc->unit))
+        {
+            return false;
+        }
+        if ((ts < lo) || (ts >= hi)) {
+            // in a repeated part: don't let it shadow the real period
+            tlohi[0] = lo;
+            tlohi[1] = hi;
+            if (index) {
+                *index = cur;
+            }
+            return true;
+        }
+        pc->index = cur;
+        pc->lo    = lo;
+        pc->hi    = hi;
+    }
+    tlohi[0] = pc->lo;
+    tlohi[1] = pc->hi;
+    if (index) {
+        *index = pc->index;
+    }
+    return true;
+}
+
+bool
+tziPeriodRange(
+    int64_t          tlohi[2],
+    int32_t         *index   ,
+    tziPeriodCacheT *cache   ,
+    int64_t          tsfrom  )
+{
+    if ((NULL == tlohi) || (NULL == cache) || (NULL == cache->ctx)) {
+        errno = EINVAL;
+        return false;
+    }
+    return tzp_Range(tlohi, index, cache, tsfrom);
+}
+
+size_t
+tziPeriodRangeArray(
+    int64_t         *tlohi ,
+    int32_t         *index ,
+    tziPeriodCacheT *cache ,
+    int64_t const   *tsfrom,
+    size_t           count )
+{
+    size_t idx;
+
+    if ((NULL == tlohi) || (NULL == cache) || (NULL == cache->ctx)
+        || (count && (NULL == tsfrom)))
+    {
+        errno = EINVAL;
+        return 0;
+    }
+    for (idx = 0; idx < count; ++idx) {
+        if (!tzp_Range(&tlohi[2 * idx], index ? &index[idx] : NULL, cache, tsfrom[idx])) {
+            break;
+        }
+    }
+    return idx;
+}
+
+// -*- that's all folks -*-
@@ -33,6 +33,7 @@
 #include "ucal/calconst.h"
 #include "ucal/gregorian.h"
 #include "ucal/tzposix.h"
+#include "probes.h"
 
 // EOF is defined in stdio.h, but we don't want that one here...
 #ifndef EOF
@@ -341,13 +342,16 @@ tzi_EvalRule(tziPosixRuleT rule, int16_t year)
 
 // For a given time stamp in seconds since UNIX epoch, establish the frame for
 // the corresponding year.  Assumes that two valid transition rules are present,
-// or "Evil Things"(tm) might happen.
+// or "Evil Things"(tm) might happen.  A zeroed context has an empty frame and is
+// always updated, even for time stamps close to the epoch.
 static bool
 tzi_CtxUpdate(tziConvCtxT* ctx, int64_t tsfrom)
 {
     tziPosixZoneT const * const tzi = ctx->pTZI;
 
-    if ((tsfrom < ctx->trLoBound - 86400) || (tsfrom >= ctx->trHiBound + 86400)) {
+    if (  (ctx->trLoBound >= ctx->trHiBound)
+       || (tsfrom < ctx->trLoBound - 86400) || (tsfrom >= ctx->trHiBound + 86400))
+    {
         int year = tsfrom / 31556952;
         year += EPOCH_YEAR - (tsfrom < year * INT64_C(31556952));
 
@@ -360,10 +364,27 @@ tzi_CtxUpdate(tziConvCtxT* ctx, int64_t tsfrom)
         ctx->trHiBound = tzi_dm2s(ysnext, int_max(tzi->stdOffs, tzi->dstOffs));
         ctx->ttDST     = tzi_dm2s(dayDST, tzi->dstRule.rt_ttloc + tzi->stdOffs);
         ctx->ttSTD     = tzi_dm2s(daySTD, tzi->stdRule.rt_ttloc + tzi->dstOffs);
+        UCAL_PROBE4(tz_ctx_update, tsfrom, year, ctx->ttDST, ctx->ttSTD);
     }
     return true;
 }
 
+bool
+tziGetTransitions(
+    int64_t              tt[2],
+    tziPosixZoneT const *zone ,
+    int16_t              year )
+{
+    if ((0 == zone->dstRule.rt_month) || (0 == zone->stdRule.rt_month)) {
+        return false;
+    }
+    tt[0] = tzi_dm2s(tzi_EvalRule(zone->dstRule, year) - UCAL_rdnUNIX,
+                     zone->dstRule.rt_ttloc + zone->stdOffs);
+    tt[1] = tzi_dm2s(tzi_EvalRule(zone->stdRule, year) - UCAL_rdnUNIX,
+                     zone->stdRule.rt_ttloc + zone->dstOffs);
+    return true;
+}
+
 bool
 tziGetInfoUtc2Local(
     tziConvInfoT *into  ,
@@ -481,6 +502,8 @@ tziGetInfoLocal2Utc(
                 into->isHrB = (tzi->dstOffs > tzi->stdOffs);
                 break;
             default:
+                UCAL_PROBE5(tz_local2utc_reject, tsfrom, (int)hint,
+                            ((tzi->dstOffs < tzi->stdOffs) ? 1 : 2), ttDstA, ttDstB);
                 return false;
             }
         } else if ((tsfrom >= ttStdA) && (tsfrom < ttStdB)) {
@@ -497,6 +520,8 @@ tziGetInfoLocal2Utc(
                 into->isHrA = (tzi->dstOffs < tzi->stdOffs);
                 break;
             default:
+                UCAL_PROBE5(tz_local2utc_reject, tsfrom, (int)hint,
+                            ((tzi->dstOffs < tzi->stdOffs) ? 2 : 1), ttStdA, ttStdB);
                 return false;
             }
         } else if (ctx->ttDST < ctx->ttSTD) {
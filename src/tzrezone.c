@@ -0,0 +1,246 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// This module contains the re-zoning of stored local time stamps.
+// ----------------------------------------------------------------------------------------------
+
+/// @file
+/// re-zoning stored local time stamps
+///
+/// When the DST rules of a zone change, local time stamps stored under the old rules are wrong
+/// where the old and the new offsets differ -- and only there.  These intervals follow from the
+/// transitions of both zones, year by year; a sweep over the merged transitions finds them
+/// without looking at a single row.  A sorted column of local time stamps is then fixed by
+/// searching each interval from where the previous one ended.  Exponential (galloping) search
+/// makes the cost of a search logarithmic in the distance covered, so a table is fixed in time
+/// proportional to the rows that change.
+
+#include <errno.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzrezone.h"
+
+static inline int64_t i64_min(int64_t a, int64_t b) {
+    return (a <= b) ? a : b;
+}
+static inline int64_t i64_max(int64_t a, int64_t b) {
+    return (a <= b) ? b : a;
+}
+
+// ----------------------------------------------------------------------------------------------
+// the transitions of one zone, served in time order
+// ----------------------------------------------------------------------------------------------
+
+typedef struct {
+    tziPosixZoneT const *zone;
+    int64_t              tt[2]; // transitions of the current year, ascending
+    int32_t              to[2]; // offset (local - UTC) after each transition
+    int16_t              year;  // current year
+    uint8_t              idx;   // next transition
+    bool                 fixed; // zone without transitions
+} rz_ZoneT;
+
+static void
+rz_Load(
+    rz_ZoneT *rz  ,
+    int16_t   year)
+{
+    tziPosixZoneT const * const tzi = rz->zone;
+    int64_t                     tt[2];
+
+    rz->year = year;
+    rz->idx  = 0;
+    if (tziGetTransitions(tt, tzi, year)) {
+        // DST first on the northern hemisphere, STD first on the southern one
+        unsigned i = (tt[0] > tt[1]);
+        rz->tt[i]     = tt[0];
+        rz->to[i]     = -tzi->dstOffs * 60;
+        rz->tt[i ^ 1] = tt[1];
+        rz->to[i ^ 1] = -tzi->stdOffs * 60;
+    } else {
+        // no rule for DST is all-year STD, and vice versa
+        rz->fixed = true;
+        rz->to[1] = -(tzi->dstRule.rt_month ? tzi->dstOffs : tzi->stdOffs) * 60;
+    }
+}
+
+static inline int64_t
+rz_Next(rz_ZoneT const *rz)
+{
+    return rz->fixed ? INT64_MAX : rz->tt[rz->idx];
+}
+
+// consume the next transition, return the offset after it
+static int32_t
+rz_Pop(rz_ZoneT *rz)
+{
+    int32_t offs = rz->to[rz->idx];
+    if (++rz->idx == 2) {
+        rz_Load(rz, rz->year + 1);
+    }
+    return offs;
+}
+
+// ----------------------------------------------------------------------------------------------
+size_t
+tziRezoneIntervals(
+    tziRezoneT          *into,
+    size_t               cap ,
+    tziPosixZoneT const *zold,
+    tziPosixZoneT const *znew,
+    int16_t              ylo ,
+    int16_t              yhi )
+{
+    rz_ZoneT   zo, zn;
+    tziRezoneT pend;    // last interval found, not yet stored
+    bool       havePend = false;
+    int64_t    t0, t1, t;
+    int32_t    oOld, oNew, oPrev;
+    size_t     n = 0;
+
+    if ((NULL == zold) || (NULL == znew) || (cap && (NULL == into))
+        || (ylo > yhi) || (ylo == INT16_MIN) || (yhi >= INT16_MAX - 1))
+    {
+        errno = EINVAL;
+        return 0;
+    }
+
+    t0 = ((int64_t)ucal_YearStartGD(ylo) - UCAL_rdnUNIX) * 86400;
+    t1 = ((int64_t)ucal_YearStartGD(yhi + 1) - UCAL_rdnUNIX) * 86400;
+
+    // Start a year early.  The rules repeat, so the offset after the last transition of that
+    // year is also the offset before its first one.
+    memset(&zo, 0, sizeof(zo));
+    memset(&zn, 0, sizeof(zn));
+    zo.zone = zold;
+    zn.zone = znew;
+    rz_Load(&zo, ylo - 1);
+    rz_Load(&zn, ylo - 1);
+    oOld  = zo.to[1];
+    oNew  = zn.to[1];
+    oPrev = oOld;
+
+    for (t = INT64_MIN; ; ) {
+        int64_t nOld = rz_Next(&zo);
+        int64_t nNew = rz_Next(&zn);
+        int64_t next = i64_min(nOld, nNew);
+        int64_t lo   = i64_max(t, t0);
+        int64_t hi   = i64_min(next, t1);
+
+        if ((oOld != oNew) && (lo < hi)) {
+            if (havePend && (pend.utcHi == lo) && (pend.offsOld == oOld) && (pend.offsNew == oNew)) {
+                pend.utcHi = hi;
+                pend.locHi = hi + oOld;
+            } else {
+                if (havePend && (n++ < cap)) {
+                    into[n - 1] = pend;
+                }
+                // where the old rules step back here, the local times shown twice belong to
+                // the interval before
+                pend.utcLo   = lo;
+                pend.utcHi   = hi;
+                pend.locLo   = lo + ((t == lo) ? i64_max(oOld, oPrev) : oOld);
+                pend.locHi   = hi + oOld;
+                pend.offsOld = oOld;
+                pend.offsNew = oNew;
+                havePend = true;
+            }
+        }
+        if (next >= t1) {
+            break;
+        }
+        t     = next;
+        oPrev = oOld;
+        if (nOld == next) {
+            oOld = rz_Pop(&zo);
+        }
+        if (nNew == next) {
+            oNew = rz_Pop(&zn);
+        }
+    }
+    if (havePend && (n++ < cap)) {
+        into[n - 1] = pend;
+    }
+    return n;
+}
+
+// ----------------------------------------------------------------------------------------------
+// galloping search: the first index in [lo,count) with tsloc[idx] >= key
+static size_t
+rz_Gallop(
+    int64_t const *tsloc,
+    size_t         count,
+    size_t         lo   ,
+    int64_t        key  )
+{
+    size_t step = 1, hi;
+
+    if ((lo >= count) || (tsloc[lo] >= key)) {
+        return lo;
+    }
+    // tsloc[lo] < key; double the step until we pass the key
+    while (((hi = lo + step) < count) && (tsloc[hi] < key)) {
+        lo     = hi;
+        step <<= 1;
+    }
+    if (hi > count) {
+        hi = count;
+    }
+    // tsloc[lo] < key, and tsloc[hi] >= key unless hi is the end
+    while (hi - lo > 1) {
+        size_t mid = lo + ((hi - lo) >> 1);
+        if (tsloc[mid] < key) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return hi;
+}
+
+size_t
+tziRezoneColumn(
+    int64_t          *tsloc,
+    size_t            count,
+    tziRezoneT const *iv   ,
+    size_t            niv  )
+{
+    size_t pos = 0, nchg = 0, k;
+
+    if ((count && (NULL == tsloc)) || (niv && (NULL == iv))) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    // Rows before 'pos' have been dealt with; they are never looked at again, so a row in an
+    // overlap of intervals changes only once.
+    for (k = 0; k < niv; ++k) {
+        int64_t const delta = (int64_t)iv[k].offsNew - iv[k].offsOld;
+        size_t        idx   = rz_Gallop(tsloc, count, pos, iv[k].locLo);
+
+        pos = idx;
+        while ((idx < count) && (tsloc[idx] < iv[k].locHi)) {
+            tsloc[idx++] += delta;
+        }
+        nchg += idx - pos;
+        pos   = idx;
+    }
+    return nchg;
+}
+
+// -*- that's all folks -*-
@@ -15,12 +15,16 @@
 // This module contains unit / regression test code for the 'unity' UT framework.
 // ----------------------------------------------------------------------------------------------
 
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "ucal/common.h"
 #include "ucal/tsdecode.h"
+#include "ucal/tzposix.h"
 
 #include <unity.h>
 
@@ -81,6 +85,239 @@ static void test_GenTm(void) {
     TEST_ASSERT_TRUE(ucal_decASN1GenTime24(&ts, &str, NULL));
 }
 
+// -------------------------------------------------------------------------------------
+// RFC 5322 mail dates, including the obsolete forms
+static void test_MailDate(void) {
+    static const struct {
+        const char *text;
+        int64_t     secs;
+    } good[] = {
+        { "Fri, 21 Nov 1997 09:55:06 -0600", 880127706 },
+        { "Tue, 1 Jul 2003 10:52:37 +0200", 1057049557 },
+        { "21 Nov 97 09:55:06 GMT", 880106106 },
+        { "fri, 21 nov 97 09:55:06 ut", 880106106 },
+        { "Friday, 21 November 1997 09:55:06 Z", 880106106 },
+        { "SATURDAY, 1 MAY 2004 00:00 UT", 1083369600 },
+        { "wednesday, 1 september 2004 00:00 gmt", 1093996800 },
+        { "Thu,\r\n      13\r\n        Feb\r\n          1969\r\n      23:32\r\n"
+          "               -0330 (Newfoundland Time)", -27723480 },
+        { "(x) Thu (\\(y\\)), 13 Feb (1969) 1969 23 : 32 -0330", -27723480 },
+        { "1 Jan 05 00:00 EST", 1104555600 },
+        { "1 Jan 049 00:00:00 UTC", -662688000 },
+        { "1 Jan 1949 00:00:00 A", -662688000 }
+    };
+    static const char * const bad[] = {
+        "Fri 21 Nov 1997 09:55:06 -0600", "Fry, 21 Nov 1997 09:55:06 -0600",
+        "21 Now 1997 09:55:06 -0600", "31 Nov 1997 09:55:06 -0600", "21 Nov 1997 24:55:06 -0600",
+        "21 Nov 1997 09:5:06 -0600", "21 Nov 1997 09:55:06 +06", "21 Nov 1997 09:55:06 (open",
+        "21 Nov 1 09:55:06 GMT", "Junk 2024 09:55:06 GMT", "21 Junk 2024 09:55:06 GMT",
+        "Monstrous, 21 Nov 1997 09:55:06 GMT", "Fri, 21 Novem 1997 09:55:06 GMT",
+        "Frid, 21 Nov 1997 09:55:06 GMT", "Mondays, 21 Nov 1997 09:55:06 GMT", ""
+    };
+    struct timespec ts;
+    const char     *str;
+    size_t          idx;
+
+    for (idx = 0; idx < sizeof(good) / sizeof(good[0]); ++idx) {
+        str = good[idx].text;
+        TEST_ASSERT_TRUE_MESSAGE(ucal_decRFC5322Date(&ts, &str, NULL, NULL), good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].secs, (int64_t)ts.tv_sec, good[idx].text);
+        TEST_ASSERT_EQUAL(0, ts.tv_nsec);
+        TEST_ASSERT_EQUAL('\0', *str);
+    }
+    for (idx = 0; idx < sizeof(bad) / sizeof(bad[0]); ++idx) {
+        str = bad[idx];
+        TEST_ASSERT_FALSE_MESSAGE(ucal_decRFC5322Date(&ts, &str, NULL, NULL), bad[idx]);
+        TEST_ASSERT_TRUE(str == bad[idx]);
+    }
+
+    // the parse stops behind the date
+    str = "1 Jan 1970 00:00 +0000\r\nSubject: x";
+    TEST_ASSERT_TRUE(ucal_decRFC5322Date(&ts, &str, NULL, NULL));
+    TEST_ASSERT_EQUAL_STRING("Subject: x", str);
+}
+
+// names of a configured zone and local time without a zone
+static void test_MailZone(void) {
+    tziPosixZoneT   zone;
+    tziConvCtxT     ctx;
+    struct timespec ts;
+    const char     *str;
+
+    memset(&ctx, 0, sizeof(ctx));
+    TEST_ASSERT_NOT_NULL(tziFromPosixSpec(&zone, "CET-1CEST,M3.5.0,M10.5.0/3", NULL));
+    ctx.pTZI = &zone;
+
+    str = "Tue, 1 Jul 2025 12:00:00 CEST";
+    TEST_ASSERT_TRUE(ucal_decRFC5322Date(&ts, &str, NULL, &ctx));
+    TEST_ASSERT_EQUAL(1751364000, (int64_t)ts.tv_sec);
+    str = "15 Jan 2025 12:00:00 CET";
+    TEST_ASSERT_TRUE(ucal_decRFC5322Date(&ts, &str, NULL, &ctx));
+    TEST_ASSERT_EQUAL(1736938800, (int64_t)ts.tv_sec);
+
+    // no zone: local time, and a gap time resolves to the zone before the transition
+    str = "1 Jul 2025 12:00:00";
+    TEST_ASSERT_TRUE(ucal_decRFC5322Date(&ts, &str, NULL, &ctx));
+    TEST_ASSERT_EQUAL(1751364000, (int64_t)ts.tv_sec);
+    str = "30 Mar 2025 02:30:00 (gap)";
+    TEST_ASSERT_TRUE(ucal_decRFC5322Date(&ts, &str, NULL, &ctx));
+    TEST_ASSERT_EQUAL(1743298200, (int64_t)ts.tv_sec);
+
+    // the zone names are not known without the context, and other names are UTC
+    str = "1 Jul 2025 12:00:00 CEST";
+    TEST_ASSERT_TRUE(ucal_decRFC5322Date(&ts, &str, NULL, NULL));
+    TEST_ASSERT_EQUAL(1751371200, (int64_t)ts.tv_sec);
+    str = "1 Jul 2025 12:00:00";
+    TEST_ASSERT_TRUE(ucal_decRFC5322Date(&ts, &str, NULL, NULL));
+    TEST_ASSERT_EQUAL(1751371200, (int64_t)ts.tv_sec);
+}
+
+// -------------------------------------------------------------------------------------
+// layout detection and column decoding
+static void test_Classify(void) {
+    static const struct {
+        const char *text;
+        uint8_t     format, length, frac, zone, unit;
+    } good[] = {
+        { "2025-07-01T12:00:00Z", ucal_DecFmt_RFC3339, 19, 0, ucal_DecZone_Z, 0 },
+        { "2025-07-01 12:00:00.125+02:00",
+          ucal_DecFmt_RFC3339, 19, 3, ucal_DecZone_OffsColon, 0 },
+        { "2025-07-01t12:00:00", ucal_DecFmt_RFC3339, 19, 0, ucal_DecZone_None, 0 },
+        { "250701120000Z", ucal_DecFmt_ASN1Utc, 12, 0, ucal_DecZone_Z, 0 },
+        { "2507011200-0130", ucal_DecFmt_ASN1Utc, 10, 0, ucal_DecZone_Offs, 0 },
+        { "202507011200Z", ucal_DecFmt_ASN1Gen, 12, 0, ucal_DecZone_Z, 0 },
+        { "20250701120000.5+0200", ucal_DecFmt_ASN1Gen, 14, 1, ucal_DecZone_Offs, 0 },
+        { "Tue, 01 Jul 2025 12:00:00 GMT", ucal_DecFmt_HTTPDate, 0, 0, 0, 0 },
+        { "Tue, 1 Jul 2025 12:00:00 +0000", ucal_DecFmt_Mail, 0, 0, 0, 0 },
+        { "1 Jul 2025 12:00 GMT", ucal_DecFmt_Mail, 0, 0, 0, 0 },
+        { "1751371200", ucal_DecFmt_Epoch, 0, 0, 0, 0 },
+        { "-1.5", ucal_DecFmt_Epoch, 0, 1, 0, 0 },
+        { "1751371200123", ucal_DecFmt_Epoch, 0, 0, 0, 3 },
+        { "1751371200123456", ucal_DecFmt_Epoch, 0, 0, 0, 6 },
+        { "1751371200123456789", ucal_DecFmt_Epoch, 0, 0, 0, 9 }
+    };
+    static const char * const bad[] = {
+        "", "2025-07-01X12:00:00Z", "2025-07-01T12:00:00.Z", "2025-07-01T12:00:00+2",
+        "12345Z", "-250701120000Z", "20250701120000+02:00", "1751371200123.5",
+        "17513712001234567890", "17513712 00"
+    };
+    ucal_DecLayoutT lay;
+    size_t          idx;
+
+    for (idx = 0; idx < sizeof(good) / sizeof(good[0]); ++idx) {
+        TEST_ASSERT_TRUE_MESSAGE(ucal_decClassify(&lay, good[idx].text, NULL), good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].format, lay.format, good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].length, lay.length, good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].frac, lay.fracWidth, good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].zone, lay.zone, good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].unit, lay.unit, good[idx].text);
+    }
+    for (idx = 0; idx < sizeof(bad) / sizeof(bad[0]); ++idx) {
+        TEST_ASSERT_FALSE_MESSAGE(ucal_decClassify(&lay, bad[idx], NULL), bad[idx]);
+    }
+}
+
+static void test_Column(void) {
+    static const char * const col[] = {
+        "2025-07-01T12:00:00Z", "2025-07-01T12:00:00Z", "2025-07-01T14:00:00.250+02:00",
+        "2025-07-01T12:00:00Z", "1751371200", "250701120000Z", "20250701120000Z",
+        "Tue, 01 Jul 2025 12:00:00 GMT", "Tue, 1 Jul 2025 14:00:00 +0200 (CEST)",
+        "1751371200000", "2025-07-01T12:00:00Z"
+    };
+    static const char * const epoch[] = {
+        "1751371200123", "1751371200000", "-1500", "0", "1751371200"
+    };
+    static const char * const asn1[] = {
+        "500101000000Z", "491231235959Z", "250701120000Z", "nonsense", "250701120000Z"
+    };
+    static const char * const junk[1] = { "#1" };
+    ucal_DecDetectT det;
+    struct timespec ts[16];
+    ucal_ns_t       ns[16];
+    size_t          idx, n;
+
+    // mixed column: the odd values go the slow way, but still decode
+    n = sizeof(col) / sizeof(col[0]);
+    ucal_decDetectInit(&det, NULL, 1950);
+    TEST_ASSERT_TRUE(ucal_decDetect(&det, col, NULL, 4));
+    TEST_ASSERT_EQUAL(ucal_DecFmt_RFC3339, det.layout.format);
+    TEST_ASSERT_EQUAL(ucal_DecZone_Z, det.layout.zone);
+    TEST_ASSERT_EQUAL(n, ucal_decColumn(ts, &det, col, NULL, n));
+    TEST_ASSERT_EQUAL(7, det.nslow);
+    for (idx = 0; idx < n; ++idx) {
+        TEST_ASSERT_EQUAL_MESSAGE(1751371200, (int64_t)ts[idx].tv_sec, col[idx]);
+        TEST_ASSERT_EQUAL_MESSAGE((2 == idx) ? 250000000 : 0, ts[idx].tv_nsec, col[idx]);
+    }
+
+    // epoch milliseconds; shorter numbers in the column are milliseconds, too
+    n = sizeof(epoch) / sizeof(epoch[0]);
+    ucal_decDetectInit(&det, NULL, 1950);
+    TEST_ASSERT_TRUE(ucal_decDetect(&det, epoch, NULL, 2));
+    TEST_ASSERT_EQUAL(ucal_DecFmt_Epoch, det.layout.format);
+    TEST_ASSERT_EQUAL(3, det.layout.unit);
+    TEST_ASSERT_EQUAL(n, ucal_decColumn(ts, &det, epoch, NULL, n));
+    TEST_ASSERT_EQUAL(1751371200, (int64_t)ts[0].tv_sec);
+    TEST_ASSERT_EQUAL(123000000, ts[0].tv_nsec);
+    TEST_ASSERT_EQUAL(1751371200, (int64_t)ts[1].tv_sec);
+    TEST_ASSERT_EQUAL(-2, (int64_t)ts[2].tv_sec);
+    TEST_ASSERT_EQUAL(500000000, ts[2].tv_nsec);
+    TEST_ASSERT_EQUAL(0, (int64_t)ts[3].tv_sec);
+    TEST_ASSERT_EQUAL(1751371, (int64_t)ts[4].tv_sec);
+    TEST_ASSERT_EQUAL(200000000, ts[4].tv_nsec);
+    TEST_ASSERT_EQUAL(0, det.nslow);
+    TEST_ASSERT_EQUAL(n, ucal_decColumnNs(ns, &det, epoch, NULL, n));
+    for (idx = 0; idx < n; ++idx) {
+        TEST_ASSERT_EQUAL_INT64(ucal_TimespecToNs(&ts[idx]), ns[idx]);
+    }
+    TEST_ASSERT_EQUAL_INT64(-1500000000, ns[2]);
+
+    // UTCTime with century expansion, stopping at a bad value
+    n = sizeof(asn1) / sizeof(asn1[0]);
+    ucal_decDetectInit(&det, NULL, 1950);
+    TEST_ASSERT_TRUE(ucal_decDetect(&det, asn1, NULL, n));
+    TEST_ASSERT_EQUAL(ucal_DecFmt_ASN1Utc, det.layout.format);
+    errno = 0;
+    TEST_ASSERT_EQUAL(3, ucal_decColumn(ts, &det, asn1, NULL, n));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_EQUAL(-631152000, (int64_t)ts[0].tv_sec);
+    TEST_ASSERT_EQUAL(2524607999, (int64_t)ts[1].tv_sec);
+    TEST_ASSERT_EQUAL(1751371200, (int64_t)ts[2].tv_sec);
+    errno = 0;
+    TEST_ASSERT_EQUAL(3, ucal_decColumnNs(ns, &det, asn1, NULL, n));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_EQUAL_INT64(INT64_C(2524607999000000000), ns[1]);
+
+    // nothing to detect
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_decDetect(&det, junk, NULL, 1));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// values without zone are local time in the zone of the context; lengths are honoured
+static void test_ColumnLocal(void) {
+    static const char text[] = "2025-07-01T14:00:002025-03-30T02:30:002025-12-31 23:59:59";
+    static const char * const col[3] = { text, text + 19, text + 38 };
+    static const size_t len[3] = { 19, 19, 19 };
+    tziPosixZoneT   zone;
+    tziConvCtxT     ctx;
+    ucal_DecDetectT det;
+    struct timespec ts[3];
+
+    memset(&ctx, 0, sizeof(ctx));
+    TEST_ASSERT_NOT_NULL(tziFromPosixSpec(&zone, "CET-1CEST,M3.5.0,M10.5.0/3", NULL));
+    ctx.pTZI = &zone;
+
+    ucal_decDetectInit(&det, &ctx, 1950);
+    TEST_ASSERT_TRUE(ucal_decDetect(&det, col, len, 3));
+    TEST_ASSERT_EQUAL(ucal_DecFmt_RFC3339, det.layout.format);
+    TEST_ASSERT_EQUAL(ucal_DecZone_None, det.layout.zone);
+    TEST_ASSERT_EQUAL(3, ucal_decColumn(ts, &det, col, len, 3));
+    TEST_ASSERT_EQUAL(1751371200, (int64_t)ts[0].tv_sec);
+    TEST_ASSERT_EQUAL(1743298200, (int64_t)ts[1].tv_sec);
+    TEST_ASSERT_EQUAL(1767221999, (int64_t)ts[2].tv_sec);
+    TEST_ASSERT_EQUAL(1, det.nslow);
+}
+
 static unsigned
 double_up(
     uint8_t *dbuf,
@@ -171,5 +408,10 @@ int main(int argc, char **argv)
     RUN_TEST(test_pfrac);
     RUN_TEST(test_UtcTm);
     RUN_TEST(test_GenTm);
+    RUN_TEST(test_MailDate);
+    RUN_TEST(test_MailZone);
+    RUN_TEST(test_Classify);
+    RUN_TEST(test_Column);
+    RUN_TEST(test_ColumnLocal);
     return UNITY_END();
 }
@@ -0,0 +1,540 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for the conversions on Arrow arrays
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/clockmap.h"
+#include "ucal/tzposix.h"
+#include "ucal/arrow.h"
+
+#include <unity.h>
+
+#define NELEM 3000
+
+static int64_t s_ts[NELEM];
+static uint8_t s_bits[(NELEM + 7) / 8];
+static int64_t s_nulls;
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+// a cheap generator
+static uint32_t s_rng = 4711;
+
+static uint32_t
+rnd(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// release callback of the input arrays, which live in static storage
+static void
+releaseIn(
+    struct ArrowArray *arr)
+{
+    arr->release = NULL;
+}
+
+static void
+onRelease(
+    void *arg)
+{
+    *(int*)arg += 1;
+}
+
+// Time stamps in 'unit' per second over the autumn of 2025, with every 7th one null; the
+// nulls hold garbage.
+static void
+mkInput(
+    struct ArrowArray *arr,
+    const void       **bufs,
+    int64_t            perSec)
+{
+    int64_t t = ((int64_t)ucal_DateToRdnGD(2025, 10, 20) - UCAL_rdnUNIX) * 86400;
+    size_t  idx;
+
+    memset(s_bits, 0, sizeof(s_bits));
+    s_nulls = 0;
+    for (idx = 0; idx < NELEM; ++idx) {
+        t += rnd() % 900;
+        if (idx % 7 == 3) {
+            s_ts[idx] = INT64_MIN + (int64_t)rnd();
+            s_nulls  += 1;
+        } else {
+            s_ts[idx] = t * perSec + (int64_t)(rnd() % (uint32_t)perSec);
+            s_bits[idx >> 3] |= (uint8_t)(1 << (idx & 7));
+        }
+    }
+    bufs[0] = s_bits;
+    bufs[1] = s_ts;
+    memset(arr, 0, sizeof(*arr));
+    arr->length     = NELEM;
+    arr->null_count = s_nulls;
+    arr->n_buffers  = 2;
+    arr->buffers    = bufs;
+    arr->release    = releaseIn;
+}
+
+static bool
+isValid(
+    const void *bits,
+    int64_t     idx)
+{
+    return !bits || ((((const uint8_t*)bits)[idx >> 3] >> (idx & 7)) & 1);
+}
+
+static ucal_ArrowTimeT
+getType(
+    const char *format)
+{
+    struct ArrowSchema sch;
+    ucal_ArrowTimeT    type;
+
+    memset(&sch, 0, sizeof(sch));
+    sch.format = format;
+    TEST_ASSERT_TRUE_MESSAGE(ucal_ArrowGetType(&type, &sch), format);
+    return type;
+}
+
+// local seconds of a time stamp in seconds, the slow way
+static int64_t
+toLocal(
+    tziPosixZoneT const *zone,
+    int64_t              secs)
+{
+    tziConvCtxT  ctx;
+    tziConvInfoT ci;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = zone;
+    TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&ci, &ctx, secs));
+    return secs + ci.offs;
+}
+
+static int64_t
+floorDiv(int64_t v, int64_t d)
+{
+    return v / d - ((v % d) < 0);
+}
+
+// -------------------------------------------------------------------------------------
+
+static void
+test_Types(void)
+{
+    static const struct {
+        const char     *format;
+        ucal_ArrowTypeT type;
+        int32_t         perSec;
+        const char     *tzname;
+    } good[] = {
+        { "tss:", ucal_ArrowType_Timestamp, 1, NULL },
+        { "tsm:UTC", ucal_ArrowType_Timestamp, 1000, "UTC" },
+        { "tsu:+05:30", ucal_ArrowType_Timestamp, 1000000, "+05:30" },
+        { "tsn:Europe/Berlin", ucal_ArrowType_Timestamp, 1000000000, "Europe/Berlin" },
+        { "tdD", ucal_ArrowType_Date32, 0, NULL },
+        { "tdm", ucal_ArrowType_Date64, 1000, NULL }
+    };
+    static const char * const bad[] = { "l", "tsx:", "tsn", "tdDx", "tts", "" };
+
+    struct ArrowSchema sch;
+    ucal_ArrowTimeT    type;
+    size_t             idx;
+
+    memset(&sch, 0, sizeof(sch));
+    for (idx = 0; idx < sizeof(good) / sizeof(good[0]); ++idx) {
+        sch.format = good[idx].format;
+        TEST_ASSERT_TRUE(ucal_ArrowGetType(&type, &sch));
+        TEST_ASSERT_EQUAL(good[idx].type, type.type);
+        TEST_ASSERT_EQUAL(good[idx].perSec, type.perSec);
+        if (good[idx].tzname) {
+            TEST_ASSERT_EQUAL_STRING(good[idx].tzname, type.tzname);
+        } else {
+            TEST_ASSERT_NULL(type.tzname);
+        }
+    }
+    for (idx = 0; idx < sizeof(bad) / sizeof(bad[0]); ++idx) {
+        sch.format = bad[idx];
+        errno = 0;
+        TEST_ASSERT_FALSE_MESSAGE(ucal_ArrowGetType(&type, &sch), bad[idx]);
+        TEST_ASSERT_EQUAL(EINVAL, errno);
+    }
+}
+
+static void
+test_Zones(void)
+{
+    tziPosixZoneT zone;
+
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "UTC"));
+    TEST_ASSERT_EQUAL(0, zone.stdOffs);
+    TEST_ASSERT_EQUAL(0, zone.dstRule.rt_month);
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "Etc/UTC"));
+    TEST_ASSERT_EQUAL(0, zone.stdOffs);
+
+    // Arrow offsets count east, POSIX offsets west
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "+05:30"));
+    TEST_ASSERT_EQUAL(-330, zone.stdOffs);
+    TEST_ASSERT_EQUAL_INT64(19800, toLocal(&zone, 0));
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "-03:00"));
+    TEST_ASSERT_EQUAL(180, zone.stdOffs);
+
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "CET-1CEST,M3.5.0,M10.5.0/3"));
+    TEST_ASSERT_EQUAL(-60, zone.stdOffs);
+    TEST_ASSERT_EQUAL(10, zone.stdRule.rt_month);
+
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ArrowZone(&zone, "Europe/Berlin"));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ArrowZone(&zone, "+5:30x"));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// timestamp[ns, zone] -> date32, against the element-wise conversion
+static void
+test_Date32(void)
+{
+    static const char * const formats[] = {
+        "tss:CET-1CEST,M3.5.0,M10.5.0/3", "tsm:CET-1CEST,M3.5.0,M10.5.0/3",
+        "tsu:CET-1CEST,M3.5.0,M10.5.0/3", "tsn:CET-1CEST,M3.5.0,M10.5.0/3"
+    };
+
+    struct ArrowArray in;
+    const void       *bufs[2];
+    ucal_ArrowOutT    out;
+    ucal_ArrowTimeT   type;
+    tziPosixZoneT     zone;
+    int32_t           days[NELEM];
+    int               released = 0;
+    size_t            fi;
+    int64_t           idx;
+
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "CET-1CEST,M3.5.0,M10.5.0/3"));
+    for (fi = 0; fi < sizeof(formats) / sizeof(formats[0]); ++fi) {
+        type = getType(formats[fi]);
+        mkInput(&in, bufs, type.perSec);
+
+        memset(&out, 0, sizeof(out));
+        out.onRelease = onRelease;
+        out.arg       = &released;
+        TEST_ASSERT_TRUE(ucal_ArrowToDate32(&out, days, NULL, NULL, &in, &type));
+
+        // the validity is passed through
+        TEST_ASSERT_EQUAL_STRING("tdD", out.schema.format);
+        TEST_ASSERT_EQUAL_INT64(NELEM, out.array.length);
+        TEST_ASSERT_EQUAL_INT64(s_nulls, out.array.null_count);
+        TEST_ASSERT_EQUAL_INT64(0, out.array.offset);
+        TEST_ASSERT_EQUAL_INT64(2, out.array.n_buffers);
+        TEST_ASSERT_TRUE(out.array.buffers[0] == s_bits);
+        TEST_ASSERT_TRUE(out.array.buffers[1] == days);
+        for (idx = 0; idx < NELEM; ++idx) {
+            if (isValid(s_bits, idx)) {
+                int64_t const loc = toLocal(&zone, floorDiv(s_ts[idx], type.perSec));
+                TEST_ASSERT_EQUAL_INT32(floorDiv(loc, 86400), days[idx]);
+            } else {
+                TEST_ASSERT_EQUAL_INT32(0, days[idx]);
+            }
+        }
+
+        // release through a moved copy, as a consumer would
+        {
+            struct ArrowArray  moved = out.array;
+            struct ArrowSchema msch  = out.schema;
+            out.array.release  = NULL;
+            out.schema.release = NULL;
+            moved.release(&moved);
+            msch.release(&msch);
+            TEST_ASSERT_NULL(moved.release);
+            TEST_ASSERT_NULL(msch.release);
+        }
+        TEST_ASSERT_EQUAL(fi + 1, released);
+    }
+}
+
+// a slice that does not start on a byte of the bitmap, and values beyond the calendar
+static void
+test_Validity(void)
+{
+    struct ArrowArray in;
+    const void       *bufs[2];
+    ucal_ArrowOutT    out;
+    ucal_ArrowTimeT   type = getType("tss:");
+    int32_t           days[NELEM];
+    uint8_t           valid[(NELEM + 7) / 8];
+    int64_t           idx, nulls;
+
+    mkInput(&in, bufs, 1);
+    in.offset = 5;
+    in.length = NELEM - 5;
+    for (idx = 0, nulls = 0; idx < in.length; ++idx) {
+        nulls += !isValid(s_bits, idx + 5);
+    }
+    in.null_count = nulls;
+
+    memset(&out, 0, sizeof(out));
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ArrowToDate32(&out, days, NULL, NULL, &in, &type));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+
+    TEST_ASSERT_TRUE(ucal_ArrowToDate32(&out, days, valid, NULL, &in, &type));
+    TEST_ASSERT_TRUE(out.array.buffers[0] == valid);
+    TEST_ASSERT_EQUAL_INT64(nulls, out.array.null_count);
+    for (idx = 0; idx < in.length; ++idx) {
+        TEST_ASSERT_EQUAL(isValid(s_bits, idx + 5), isValid(valid, idx));
+        if (isValid(valid, idx)) {
+            TEST_ASSERT_EQUAL_INT32(floorDiv(s_ts[idx + 5], 86400), days[idx]);
+        }
+    }
+    out.array.release(&out.array);
+    out.schema.release(&out.schema);
+
+    // values out of range become nulls
+    in.offset = 0;
+    in.length = NELEM;
+    s_ts[12]  = INT64_C(1) << 50;
+    s_ts[13]  = -(INT64_C(1) << 50);
+    in.null_count = s_nulls;
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ArrowToDate32(&out, days, NULL, NULL, &in, &type));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+    TEST_ASSERT_TRUE(ucal_ArrowToDate32(&out, days, valid, NULL, &in, &type));
+    TEST_ASSERT_TRUE(out.array.buffers[0] == valid);
+    TEST_ASSERT_EQUAL_INT64(s_nulls + 2, out.array.null_count);
+    TEST_ASSERT_FALSE(isValid(valid, 12));
+    TEST_ASSERT_FALSE(isValid(valid, 13));
+    TEST_ASSERT_TRUE(isValid(valid, 14));
+    TEST_ASSERT_EQUAL_INT32(0, days[12]);
+    TEST_ASSERT_EQUAL_INT32(floorDiv(s_ts[14], 86400), days[14]);
+    out.array.release(&out.array);
+    out.schema.release(&out.schema);
+
+    // no bitmap at all: the garbage is taken for values
+    bufs[0]       = NULL;
+    in.null_count = 0;
+    for (idx = 0; idx < NELEM; ++idx) {
+        s_ts[idx] = isValid(valid, idx) ? s_ts[idx] : 0;
+    }
+    TEST_ASSERT_TRUE(ucal_ArrowToDate32(&out, days, NULL, NULL, &in, &type));
+    TEST_ASSERT_NULL(out.array.buffers[0]);
+    TEST_ASSERT_EQUAL_INT64(0, out.array.null_count);
+    out.array.release(&out.array);
+    out.schema.release(&out.schema);
+
+    // released or malformed input
+    in.release = NULL;
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ArrowToDate32(&out, days, valid, NULL, &in, &type));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    in.release   = releaseIn;
+    in.n_buffers = 1;
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ArrowToDate32(&out, days, valid, NULL, &in, &type));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// timestamp[us, zone] -> struct<year, month, day, hour, minute, second>
+static void
+test_Fields(void)
+{
+    static int16_t    year[NELEM];
+    static int8_t     month[NELEM], day[NELEM], hour[NELEM], minute[NELEM], second[NELEM];
+    static const char *names[] = { "year", "month", "day", "hour", "minute", "second" };
+
+    struct ArrowArray in;
+    const void       *bufs[2];
+    ucal_ArrowOutT    out;
+    ucal_ArrowTimeT   type = getType("tsu:+05:30");
+    ucal_ArrowFieldsT fields = { year, month, day, hour, minute, second };
+    tziPosixZoneT     zone;
+    tziConvCtxT       ctx;
+    int               released = 0;
+    int64_t           idx;
+
+    mkInput(&in, bufs, type.perSec);
+    memset(&out, 0, sizeof(out));
+    out.onRelease = onRelease;
+    out.arg       = &released;
+    TEST_ASSERT_TRUE(ucal_ArrowToFields(&out, &fields, NULL, NULL, &in, &type));
+
+    TEST_ASSERT_EQUAL_STRING("+s", out.schema.format);
+    TEST_ASSERT_EQUAL_INT64(1, out.array.n_buffers);
+    TEST_ASSERT_EQUAL_INT64(6, out.array.n_children);
+    TEST_ASSERT_EQUAL_INT64(6, out.schema.n_children);
+    TEST_ASSERT_TRUE(out.array.buffers[0] == s_bits);
+    for (idx = 0; idx < 6; ++idx) {
+        TEST_ASSERT_EQUAL_STRING(names[idx], out.schema.children[idx]->name);
+        TEST_ASSERT_EQUAL_STRING(idx ? "c" : "s", out.schema.children[idx]->format);
+        TEST_ASSERT_EQUAL_INT64(NELEM, out.array.children[idx]->length);
+        TEST_ASSERT_TRUE(out.array.children[idx]->buffers[0] == s_bits);
+    }
+    TEST_ASSERT_TRUE(out.array.children[0]->buffers[1] == year);
+    TEST_ASSERT_TRUE(out.array.children[5]->buffers[1] == second);
+
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "+05:30"));
+    for (idx = 0; idx < NELEM; ++idx) {
+        ucal_CivilDateT cd;
+        ucal_CivilTimeT ct;
+        if (!isValid(s_bits, idx)) {
+            TEST_ASSERT_EQUAL(0, year[idx]);
+            continue;
+        }
+        ucal_NsToCivilGD(&cd, &ct, NULL,
+                         toLocal(&zone, floorDiv(s_ts[idx], type.perSec)) * 1000000000);
+        TEST_ASSERT_EQUAL(cd.dYear, year[idx]);
+        TEST_ASSERT_EQUAL(cd.dMonth, month[idx]);
+        TEST_ASSERT_EQUAL(cd.dMDay, day[idx]);
+        TEST_ASSERT_EQUAL(ct.tHour, hour[idx]);
+        TEST_ASSERT_EQUAL(ct.tMin, minute[idx]);
+        TEST_ASSERT_EQUAL(ct.tSec, second[idx]);
+    }
+
+    // releasing the struct releases the children
+    out.array.release(&out.array);
+    out.schema.release(&out.schema);
+    TEST_ASSERT_NULL(out.child[0].release);
+    TEST_ASSERT_NULL(out.childSchema[5].release);
+    TEST_ASSERT_EQUAL(1, released);
+
+    // a zone from the caller overrides the type; date only
+    memset(&fields, 0, sizeof(fields));
+    fields.month = month;
+    fields.day   = day;
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "NZST-12NZDT,M9.5.0,M4.1.0/3"));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &zone;
+    TEST_ASSERT_TRUE(ucal_ArrowToFields(&out, &fields, NULL, &ctx, &in, &type));
+    TEST_ASSERT_EQUAL_INT64(2, out.array.n_children);
+    TEST_ASSERT_EQUAL_STRING("month", out.schema.children[0]->name);
+    TEST_ASSERT_EQUAL_STRING("day", out.schema.children[1]->name);
+    for (idx = 0; idx < NELEM; ++idx) {
+        ucal_CivilDateT cd;
+        ucal_CivilTimeT ct;
+        if (isValid(s_bits, idx)) {
+            ucal_NsToCivilGD(&cd, &ct, NULL,
+                             toLocal(&zone, floorDiv(s_ts[idx], type.perSec)) * 1000000000);
+            TEST_ASSERT_EQUAL(cd.dMonth, month[idx]);
+            TEST_ASSERT_EQUAL(cd.dMDay, day[idx]);
+        }
+    }
+    out.array.release(&out.array);
+    out.schema.release(&out.schema);
+
+    memset(&fields, 0, sizeof(fields));
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ArrowToFields(&out, &fields, NULL, NULL, &in, &type));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// dates and naive time stamps are local already
+static void
+test_Dates(void)
+{
+    static int32_t    d32[NELEM];
+    static int64_t    d64[NELEM];
+    static int16_t    year[NELEM];
+    static int8_t     month[NELEM], day[NELEM];
+
+    struct ArrowArray in;
+    const void       *bufs[2] = { NULL, d32 };
+    ucal_ArrowOutT    out;
+    ucal_ArrowTimeT   type;
+    ucal_ArrowFieldsT fields = { year, month, day, NULL, NULL, NULL };
+    tziPosixZoneT     zone;
+    tziConvCtxT       ctx;
+    int32_t           days[NELEM];
+    int64_t           idx;
+
+    for (idx = 0; idx < NELEM; ++idx) {
+        d32[idx] = (int32_t)(rnd() % 200000) - 100000;
+        d64[idx] = (int64_t)d32[idx] * 86400000;
+    }
+    memset(&in, 0, sizeof(in));
+    in.length    = NELEM;
+    in.n_buffers = 2;
+    in.buffers   = bufs;
+    in.release   = releaseIn;
+
+    memset(&out, 0, sizeof(out));
+    type = getType("tdD");
+    TEST_ASSERT_TRUE(ucal_ArrowToFields(&out, &fields, NULL, NULL, &in, &type));
+    for (idx = 0; idx < NELEM; ++idx) {
+        ucal_CivilDateT cd;
+        TEST_ASSERT_TRUE(ucal_RdnToDateGD(&cd, d32[idx] + UCAL_rdnUNIX));
+        TEST_ASSERT_EQUAL(cd.dYear, year[idx]);
+        TEST_ASSERT_EQUAL(cd.dMonth, month[idx]);
+        TEST_ASSERT_EQUAL(cd.dMDay, day[idx]);
+    }
+    out.array.release(&out.array);
+    out.schema.release(&out.schema);
+
+    bufs[1] = d64;
+    type    = getType("tdm");
+    TEST_ASSERT_TRUE(ucal_ArrowToDate32(&out, days, NULL, NULL, &in, &type));
+    TEST_ASSERT_EQUAL(0, memcmp(d32, days, sizeof(days)));
+    out.array.release(&out.array);
+    out.schema.release(&out.schema);
+
+    // a naive time stamp ignores the context
+    TEST_ASSERT_TRUE(ucal_ArrowZone(&zone, "+14:00"));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &zone;
+    type     = getType("tsm:");
+    TEST_ASSERT_TRUE(ucal_ArrowToDate32(&out, days, NULL, &ctx, &in, &type));
+    TEST_ASSERT_EQUAL(0, memcmp(d32, days, sizeof(days)));
+    out.array.release(&out.array);
+    out.schema.release(&out.schema);
+
+    // a zone that needs the zone database
+    type = getType("tsm:Europe/Berlin");
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ArrowToDate32(&out, days, NULL, NULL, &in, &type));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_Types);
+    RUN_TEST(test_Zones);
+    RUN_TEST(test_Date32);
+    RUN_TEST(test_Validity);
+    RUN_TEST(test_Fields);
+    RUN_TEST(test_Dates);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -127,6 +127,46 @@ static void test_dsplit(void)
   TEST_ASSERT_EQUAL(UINT32_C(30592), QR.r);
 }
 
+static void test_nsplit(void)
+{
+  static int64_t  table[tabsize];
+  ucal_i64u32DivT QR, GM;
+  ucal_TimeDivT   TD;
+  struct timespec ts;
+  uint32_t        nsec;
+
+  TEST_ASSERT_EQUAL(sizeof(table), getrandom(table, sizeof(table), 0));
+  table[0] = INT64_MAX;
+  table[1] = INT64_MIN;
+  table[2] = -1;
+  table[3] = 0;
+  for (unsigned i = 0; i < tabsize; ++i) {
+    int64_t q = table[i] / 1000000000;
+    int64_t r = table[i] % 1000000000;
+    if (r < 0) {
+      r += 1000000000;
+      --q;
+    }
+    QR = ucal_NsToSecs(table[i]);
+    TEST_ASSERT_EQUAL_INT64(q, QR.q);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)r, QR.r);
+    // the path for targets without 64bit registers
+    GM = ucal_i64u32DivGM(table[i], UINT32_C(0xee6b2800), UINT32_C(0x12e0be82), 2);
+    TEST_ASSERT_EQUAL_INT64(q, GM.q);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)r, GM.r);
+
+    ucal_NsToTimespec(&ts, table[i]);
+    TEST_ASSERT_EQUAL_INT64(q, ts.tv_sec);
+    TEST_ASSERT_EQUAL_INT64(r, ts.tv_nsec);
+    TEST_ASSERT_EQUAL_INT64(table[i], ucal_TimespecToNs(&ts));
+    TEST_ASSERT_EQUAL_INT64(table[i], ucal_TimeToNs((time_t)q, (int32_t)r));
+
+    TD = ucal_NsToRdn(table[i], &nsec);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)r, nsec);
+    TEST_ASSERT_EQUAL_INT64(ucal_TimeToRdn((time_t)q).q, TD.q);
+    TEST_ASSERT_EQUAL_UINT32(ucal_TimeToRdn((time_t)q).r, TD.r);
+  }
+}
 
 static void test_wdshift(void) {
     int32_t base = 5 * 146097 + 1;  // Monday, 2001-01-01
@@ -239,6 +279,26 @@ static void test_ntpDate(void) {
     TEST_ASSERT_EQUAL(0, ntpSec);
 }
 
+static void test_ntpNs(void) {
+    ucal_ns_t base, exp;
+    uint32_t  frac;
+
+    base = DDT((2024,8,18), (1970,1,1)) * INT64_C(1000000000) + 999999999;
+    exp  = (DDT((1900, 1, 1), (1970, 1, 1)) + INT64_C(0x100000000)) * 1000000000 + 500000000;
+    TEST_ASSERT_EQUAL_INT64(exp, ucal_NtpToNs(0, UINT32_C(0x80000000), &base));
+    TEST_ASSERT_EQUAL_INT64(exp - 500000000 + 1, ucal_NtpToNs(0, 4, &base));
+    TEST_ASSERT_EQUAL_UINT32(0, ucal_NsToNtp(&frac, exp));
+    TEST_ASSERT_EQUAL_HEX32(UINT32_C(0x80000000), frac);
+
+    // a round trip is exact to a nanosecond
+    for (frac = 1; frac; frac <<= 1) {
+        uint32_t back;
+        uint32_t secs = ucal_NsToNtp(&back, ucal_NtpToNs(12345, frac, &base));
+        TEST_ASSERT_EQUAL_UINT32(12345, secs);
+        TEST_ASSERT_TRUE(back - frac + 3u <= 6u);
+    }
+}
+
 static void test_gpsDate1(void) {
     int32_t       base;
     ucal_iu32DivT exp, act;
@@ -282,6 +342,54 @@ static void test_gpsDate2(void) {
     TEST_ASSERT_EQUAL(exp, act);
 }
 
+static void test_gpsNs(void) {
+    static const int32_t wcycle = INT32_C(604800);
+
+    ucal_GpsRawTimeT raw, ref;
+    ucal_ns_t        base, exp;
+    time_t           tt;
+    uint32_t         nsec;
+
+    // era one, one week and a bit after the start
+    tt   = DDT((1980, 1, 6), (1970, 1, 1)) + 1024 * wcycle + wcycle + 17;
+    exp  = (ucal_ns_t)tt * 1000000000 + 4711;
+    raw  = ucal_GpsMapNs(exp, 0, &nsec);
+    ref  = ucal_GpsMapTime(tt, 0);
+    TEST_ASSERT_EQUAL(1, raw.w);
+    TEST_ASSERT_EQUAL(17, raw.t);
+    TEST_ASSERT_EQUAL(ref.w, raw.w);
+    TEST_ASSERT_EQUAL(ref.t, raw.t);
+    TEST_ASSERT_EQUAL_UINT32(4711, nsec);
+
+    base = (ucal_ns_t)(tt - 100 * wcycle) * 1000000000;
+    TEST_ASSERT_EQUAL_INT64(exp, ucal_GpsMapRaw2Ns(raw.w, raw.t, nsec, 0, &base));
+    raw = ucal_GpsMapNs(exp, 18, NULL);
+    TEST_ASSERT_EQUAL(35, raw.t);
+    TEST_ASSERT_EQUAL_INT64(exp, ucal_GpsMapRaw2Ns(raw.w, raw.t, nsec, 18, &base));
+}
+
+static void test_nsPast2038(void) {
+    // time stamps beyond the range of a 32-bit 'time_t'
+    int64_t const    days = RDN(2050, 2, 28) - RDN(1970, 1, 1);
+    ucal_ns_t        base, exp;
+    ucal_TimeDivT    TD;
+    ucal_GpsRawTimeT raw;
+    uint32_t         secs, frac, nsec;
+
+    exp = (days * 86400 + 3661) * INT64_C(1000000000) + 4711;
+    TD  = ucal_NsToRdn(exp, &nsec);
+    TEST_ASSERT_EQUAL_INT64(RDN(2050, 2, 28), TD.q);
+    TEST_ASSERT_EQUAL_UINT32(3661, TD.r);
+    TEST_ASSERT_EQUAL_UINT32(4711, nsec);
+
+    base = (days - 1000) * 86400 * INT64_C(1000000000);
+    secs = ucal_NsToNtp(&frac, exp);
+    TEST_ASSERT_EQUAL_INT64(exp, ucal_NtpToNs(secs, frac, &base));
+
+    raw = ucal_GpsMapNs(exp, 18, &nsec);
+    TEST_ASSERT_EQUAL_INT64(exp, ucal_GpsMapRaw2Ns(raw.w, raw.t, nsec, 18, &base));
+}
+
 int main(int argc, char **argv)
 {
     (void)argc,(void)argv;
@@ -291,6 +399,7 @@ int main(int argc, char **argv)
     RUN_TEST(test_BuildDate);
     RUN_TEST(test_mod7);
     RUN_TEST(test_dsplit);
+    RUN_TEST(test_nsplit);
     RUN_TEST(test_wdshift);
     RUN_TEST(test_ysplitGD);
     RUN_TEST(test_Date2Rdn);
@@ -298,7 +407,10 @@ int main(int argc, char **argv)
     RUN_TEST(test_reform2);
     RUN_TEST(test_rellez);
     RUN_TEST(test_ntpDate);
+    RUN_TEST(test_ntpNs);
     RUN_TEST(test_gpsDate1);
     RUN_TEST(test_gpsDate2);
+    RUN_TEST(test_gpsNs);
+    RUN_TEST(test_nsPast2038);
     return UNITY_END();
 }
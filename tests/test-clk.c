@@ -0,0 +1,191 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for the trace clock mapping
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/clockmap.h"
+
+#include <unity.h>
+
+#define NSEC INT64_C(1000000000)
+#define P20  (INT64_C(1) << 20)
+#define P30  (INT64_C(1) << 30)
+
+// 2025-06-01T00:00:00Z, in ns
+static const int64_t s_base = INT64_C(1748736000) * NSEC;
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+// -------------------------------------------------------------------------------------
+static void
+test_Anchors(void)
+{
+    ucal_ClkSegT   buf[4];
+    ucal_ClockMapT map;
+    int64_t        m0 = INT64_C(5000) * NSEC;
+
+    ucal_ClockMapInit(&map, buf, 4);
+    TEST_ASSERT_EQUAL_INT64(12345, ucal_ClockMapToReal(&map, 12345));
+
+    // one anchor: a plain offset
+    TEST_ASSERT_TRUE(ucal_ClockMapAddAnchor(&map, m0, s_base));
+    TEST_ASSERT_EQUAL_INT64(s_base + 77, ucal_ClockMapToReal(&map, m0 + 77));
+    TEST_ASSERT_EQUAL_INT64(s_base - 77, ucal_ClockMapToReal(&map, m0 - 77));
+
+    // second anchor 2^30ns later, with the real time clock 2^-10 fast: exact in fixed point
+    TEST_ASSERT_TRUE(ucal_ClockMapAddAnchor(&map, m0 + P30, s_base + P30 + P20));
+    TEST_ASSERT_EQUAL(INT32_C(1) << 30, map.seg[0].drift);
+    TEST_ASSERT_EQUAL_INT64(s_base + 1024 + 1, ucal_ClockMapToReal(&map, m0 + 1024));
+    TEST_ASSERT_EQUAL_INT64(s_base + P30 / 2 + P20 / 2, ucal_ClockMapToReal(&map, m0 + P30 / 2));
+    // before the first anchor and after the last, with the same rate
+    TEST_ASSERT_EQUAL_INT64(s_base - 1024 - 1, ucal_ClockMapToReal(&map, m0 - 1024));
+    TEST_ASSERT_EQUAL_INT64(s_base + 2 * P30 + 2 * P20, ucal_ClockMapToReal(&map, m0 + 2 * P30));
+
+    // a step of one second: the segment before keeps its rate, the step is at the anchor
+    TEST_ASSERT_TRUE(ucal_ClockMapAddAnchor(&map, m0 + 2 * P30, s_base + 2 * P30 + 2 * P20 + NSEC));
+    TEST_ASSERT_EQUAL(INT32_C(1) << 30, map.seg[1].drift);
+    TEST_ASSERT_EQUAL_INT64(s_base + 2 * P30 + 2 * P20 - 1024 - 1,
+                            ucal_ClockMapToReal(&map, m0 + 2 * P30 - 1024));
+    TEST_ASSERT_EQUAL_INT64(s_base + 2 * P30 + 2 * P20 + NSEC,
+                            ucal_ClockMapToReal(&map, m0 + 2 * P30));
+
+    // ordering and capacity
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_ClockMapAddAnchor(&map, m0, s_base));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_TRUE(ucal_ClockMapAddAnchor(&map, m0 + 3 * P30, s_base + 3 * P30 + NSEC));
+    TEST_ASSERT_FALSE(ucal_ClockMapAddAnchor(&map, m0 + 4 * P30, s_base + 4 * P30));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+}
+
+// -------------------------------------------------------------------------------------
+// a long trace with 50ppm drift and anchors every 10 minutes: the map must stay within a
+// nanosecond of the ideal line, and array conversion must match single conversion
+
+#define NANCH 64
+#define NEV   (1 << 20)
+
+static void
+test_Drift(void)
+{
+    static int64_t mono[NEV], real[NEV];
+    ucal_ClkSegT   buf[NANCH];
+    ucal_ClockMapT map;
+    int64_t        step = INT64_C(600) * NSEC;
+    size_t         idx;
+
+    ucal_ClockMapInit(&map, buf, NANCH);
+    for (idx = 0; idx < NANCH; ++idx) {
+        int64_t m = (int64_t)idx * step;
+        TEST_ASSERT_TRUE(ucal_ClockMapAddAnchor(&map, m, s_base + m + m / 20000));
+    }
+    for (idx = 0; idx < NANCH - 1; ++idx) {
+        TEST_ASSERT_INT_WITHIN(1, (INT64_C(1) << UCAL_CLK_DRIFT_BITS) / 20000, map.seg[idx].drift);
+    }
+    for (idx = 0; idx < NEV; ++idx) {
+        mono[idx] = (int64_t)idx * ((NANCH - 1) * step / NEV) + (int64_t)(idx % 7) * 13;
+    }
+    // shuffle a few, as a trace merged from several CPUs would have
+    for (idx = 64; idx < NEV; idx += 4099) {
+        int64_t tmp = mono[idx];
+        mono[idx] = mono[idx - 64];
+        mono[idx - 64] = tmp;
+    }
+    ucal_ClockMapConvert(&map, real, mono, NEV);
+    for (idx = 0; idx < NEV; ++idx) {
+        int64_t ideal = s_base + mono[idx] + mono[idx] / 20000;
+        TEST_ASSERT_EQUAL_INT64(ucal_ClockMapToReal(&map, mono[idx]), real[idx]);
+        TEST_ASSERT_TRUE(real[idx] - ideal <= 1 && ideal - real[idx] <= 1);
+    }
+}
+
+// -------------------------------------------------------------------------------------
+static void
+test_Civil(void)
+{
+    static const int64_t tab[] = {
+        0, -1, 86400 * NSEC - 1, 86400 * NSEC, -86400 * NSEC, INT64_C(1748781296) * NSEC + 5,
+        INT64_MAX, INT64_MIN, INT64_C(-2208988800) * NSEC + 999999999
+    };
+    static int64_t     ns[4096];
+    static ucal_CivilDateT date[4096];
+    static ucal_CivilTimeT time[4096];
+    static uint32_t    nsec[4096];
+    ucal_CivilDateT    cd, rd;
+    ucal_CivilTimeT    ct, rt;
+    uint32_t           nx;
+    size_t             idx;
+    uint32_t           rnd = 1;
+
+    for (idx = 0; idx < sizeof(ns) / sizeof(ns[0]); ++idx) {
+        if (idx < sizeof(tab) / sizeof(tab[0])) {
+            ns[idx] = tab[idx];
+        } else {
+            rnd = rnd * UINT32_C(1664525) + UINT32_C(1013904223);
+            ns[idx] = ns[idx - 1] + (int64_t)(rnd >> 4) * 1000;
+        }
+    }
+    ucal_NsToCivilArrayGD(date, time, nsec, ns, sizeof(ns) / sizeof(ns[0]));
+    for (idx = 0; idx < sizeof(ns) / sizeof(ns[0]); ++idx) {
+        // reference: split seconds the classic way
+        int64_t       s = ns[idx] / NSEC, f = ns[idx] % NSEC;
+        ucal_TimeDivT td;
+        if (f < 0) {
+            f += NSEC;
+            --s;
+        }
+        td = ucal_TimeToRdn((time_t)s);
+        TEST_ASSERT_TRUE(ucal_RdnToDateGD(&rd, (int32_t)td.q));
+        ucal_DayTimeSplit(&rt, (int32_t)td.r, 0);
+
+        ucal_NsToCivilGD(&cd, &ct, &nx, ns[idx]);
+        TEST_ASSERT_EQUAL_MEMORY(&rd, &cd, sizeof(cd));
+        TEST_ASSERT_EQUAL_MEMORY(&rd, &date[idx], sizeof(cd));
+        TEST_ASSERT_EQUAL_MEMORY(&rt, &ct, sizeof(ct));
+        TEST_ASSERT_EQUAL_MEMORY(&rt, &time[idx], sizeof(ct));
+        TEST_ASSERT_EQUAL(f, nx);
+        TEST_ASSERT_EQUAL(f, nsec[idx]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_Anchors);
+    RUN_TEST(test_Drift);
+    RUN_TEST(test_Civil);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,230 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for day count conventions
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/daycount.h"
+
+#include <unity.h>
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+static int64_t
+yf_Num(
+    int        dc,
+    int16_t    y1,
+    int16_t    m1,
+    int16_t    d1,
+    int16_t    y2,
+    int16_t    m2,
+    int16_t    d2)
+{
+    ucal_YearFracT yf;
+
+    TEST_ASSERT_TRUE(ucal_YearFrac(&yf, dc, ucal_DateToRdnGD(y1, m1, d1),
+                                   ucal_DateToRdnGD(y2, m2, d2)));
+    return yf.num;
+}
+
+// ----------------------------------------------------------------------------------------------
+// reference: full decomposition of both dates, ACT/ACT by walking the years
+
+static bool
+ref_IsEom(
+    ucal_CivilDateT const *cd)
+{
+    return cd->dMDay == _ucal_mdtab[ucal_IsLeapYearGD(cd->dYear)][cd->dMonth - 1];
+}
+
+static int64_t
+ref_Num(
+    int     dc,
+    int32_t r1,
+    int32_t r2)
+{
+    ucal_CivilDateT a, b;
+    int32_t         y, d1, d2, ys;
+    int64_t         num;
+
+    if (r2 < r1) {
+        return -ref_Num(dc, r2, r1);
+    }
+    switch (dc) {
+    case ucal_DcAct360:
+    case ucal_DcAct365F:
+        return (int64_t)r2 - r1;
+    case ucal_DcActActISDA:
+        num = 0;
+        for (y = ucal_DaysToYearsGD(r1, NULL).q + 1; r1 < r2; ++y) {
+            ys = ucal_YearStartGD((int16_t)(y + 1));
+            d1 = (ys < r2) ? ys : r2;
+            num += (int64_t)(d1 - r1) * (ucal_IsLeapYearGD(y) ? 365 : 366);
+            r1 = d1;
+        }
+        return num;
+    default:
+        break;
+    }
+    TEST_ASSERT_TRUE(ucal_RdnToDateGD(&a, r1));
+    TEST_ASSERT_TRUE(ucal_RdnToDateGD(&b, r2));
+    d1 = a.dMDay;
+    d2 = b.dMDay;
+    switch (dc) {
+    case ucal_Dc30_360:
+        if (31 == d1) d1 = 30;
+        if (31 == d2 && 30 == d1) d2 = 30;
+        break;
+    case ucal_Dc30_360US:
+        if (2 == a.dMonth && ref_IsEom(&a) && 2 == b.dMonth && ref_IsEom(&b)) d2 = 30;
+        if (2 == a.dMonth && ref_IsEom(&a)) d1 = 30;
+        if (31 == d2 && d1 >= 30) d2 = 30;
+        if (31 == d1) d1 = 30;
+        break;
+    case ucal_Dc30E_360:
+        if (31 == d1) d1 = 30;
+        if (31 == d2) d2 = 30;
+        break;
+    default:
+        if (ref_IsEom(&a)) d1 = 30;
+        if (ref_IsEom(&b) && (2 != b.dMonth || ucal_Dc30E_360ISDA == dc)) d2 = 30;
+        break;
+    }
+    return (int64_t)(b.dYear - a.dYear) * 360 + (b.dMonth - a.dMonth) * 30 + (d2 - d1);
+}
+
+// ----------------------------------------------------------------------------------------------
+
+static void
+test_Known(void)
+{
+    ucal_YearFracT yf;
+
+    // ISDA 2006 examples
+    TEST_ASSERT_EQUAL_INT64(61 * 366 + 121 * 365,
+                            yf_Num(ucal_DcActActISDA, 2003, 11, 1, 2004, 5, 1));
+    TEST_ASSERT_EQUAL_INT64(181, yf_Num(ucal_DcAct360, 2007, 1, 1, 2007, 7, 1));
+    TEST_ASSERT_EQUAL_INT64(181, yf_Num(ucal_DcAct365F, 2007, 1, 1, 2007, 7, 1));
+
+    TEST_ASSERT_EQUAL_INT64(30, yf_Num(ucal_Dc30_360US,    2007, 2, 28, 2007, 3, 31));
+    TEST_ASSERT_EQUAL_INT64(32, yf_Num(ucal_Dc30E_360,     2007, 2, 28, 2007, 3, 31));
+    TEST_ASSERT_EQUAL_INT64(33, yf_Num(ucal_Dc30_360,      2007, 2, 28, 2007, 3, 31));
+    TEST_ASSERT_EQUAL_INT64(30, yf_Num(ucal_Dc30E_360ISDA, 2007, 2, 28, 2007, 3, 31));
+
+    TEST_ASSERT_EQUAL_INT64(180, yf_Num(ucal_Dc30E_360ISDA,    2007, 8, 31, 2008, 2, 29));
+    TEST_ASSERT_EQUAL_INT64(179, yf_Num(ucal_Dc30E_360ISDAMat, 2007, 8, 31, 2008, 2, 29));
+    TEST_ASSERT_EQUAL_INT64(360, yf_Num(ucal_Dc30_360US,       2007, 2, 28, 2008, 2, 29));
+
+    // whole years and reversed order
+    TEST_ASSERT_TRUE(ucal_YearFrac(&yf, ucal_DcActActISDA, ucal_YearStartGD(2000),
+                                   ucal_YearStartGD(2010)));
+    TEST_ASSERT_EQUAL_INT64(10 * UCAL_DC_ACTACT_DEN, yf.num);
+    TEST_ASSERT_EQUAL_INT64(UCAL_DC_ACTACT_DEN, yf.den);
+    TEST_ASSERT_EQUAL_INT64(INT64_C(10) << 32, ucal_YearFracQ32(&yf));
+    TEST_ASSERT_EQUAL_INT64(-33, yf_Num(ucal_Dc30_360, 2007, 3, 31, 2007, 2, 28));
+
+    // ICMA: semiannual coupon
+    TEST_ASSERT_TRUE(ucal_YearFracICMA(&yf, ucal_DateToRdnGD(2003, 11, 1),
+                                       ucal_DateToRdnGD(2004, 5, 1),
+                                       ucal_DateToRdnGD(2003, 11, 1),
+                                       ucal_DateToRdnGD(2004, 5, 1), 2));
+    TEST_ASSERT_EQUAL_INT64(182, yf.num);
+    TEST_ASSERT_EQUAL_INT64(364, yf.den);
+    TEST_ASSERT_EQUAL_INT64(INT64_C(1) << 31, ucal_YearFracQ32(&yf));
+
+    // fixed point rounding, also below zero
+    yf.num = 1;
+    yf.den = 3;
+    TEST_ASSERT_EQUAL_INT64(INT64_C(0x55555555), ucal_YearFracQ32(&yf));
+    yf.num = -1;
+    TEST_ASSERT_EQUAL_INT64(-INT64_C(0x55555555), ucal_YearFracQ32(&yf));
+
+    // errors
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_YearFrac(&yf, 42, 0, 1));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_YearFracICMA(&yf, 0, 1, 10, 10, 2));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_YearFracICMA(&yf, 0, 1, 0, 10, 0));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// random pairs against the reference, single and batched
+#define NRAND 4096
+
+static void
+test_Random(void)
+{
+    static int32_t        d1[NRAND], d2[NRAND];
+    static ucal_YearFracT yf[NRAND];
+    static int64_t        q32[NRAND];
+    int32_t               base = ucal_DateToRdnGD(1990, 1, 1);
+    ucal_YearFracT        one;
+    int                   dc;
+    size_t                idx;
+
+    srand(119);
+    for (idx = 0; idx < NRAND; ++idx) {
+        d1[idx] = base + rand() % 20000;
+        d2[idx] = (idx & 1) ? d1[idx] + rand() % 4000 : base + rand() % 20000;
+        if (idx & 2) {
+            // push some dates to the end of a month
+            d2[idx] = ucal_DateToRdnGD((int16_t)(1990 + idx % 50), (int16_t)(1 + idx % 12), 1)
+                    - 1;
+        }
+    }
+    for (dc = ucal_DcAct360; dc <= ucal_Dc30E_360ISDAMat; ++dc) {
+        TEST_ASSERT_EQUAL(NRAND, ucal_YearFracArray(yf, dc, d1, d2, NRAND));
+        TEST_ASSERT_EQUAL(NRAND, ucal_YearFracQ32Array(q32, dc, d1, d2, NRAND));
+        for (idx = 0; idx < NRAND; ++idx) {
+            TEST_ASSERT_EQUAL_INT64(ref_Num(dc, d1[idx], d2[idx]), yf[idx].num);
+            TEST_ASSERT_TRUE(ucal_YearFrac(&one, dc, d1[idx], d2[idx]));
+            TEST_ASSERT_EQUAL_INT64(one.num, yf[idx].num);
+            TEST_ASSERT_EQUAL_INT64(one.den, yf[idx].den);
+            TEST_ASSERT_EQUAL_INT64(ucal_YearFracQ32(&one), q32[idx]);
+        }
+    }
+    errno = 0;
+    TEST_ASSERT_EQUAL(0, ucal_YearFracArray(yf, -1, d1, d2, NRAND));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_Known);
+    RUN_TEST(test_Random);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,344 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for ISO 8601 durations
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzposix.h"
+#include "ucal/duration.h"
+
+#include <unity.h>
+
+static tziPosixZoneT s_zone;
+static tziConvCtxT   s_ctx;
+
+void setUp(void)
+{
+    const char *pret = tziFromPosixSpec(&s_zone, "CET-1CEST,M3.5.0,M10.5.0/3", NULL);
+    TEST_ASSERT_TRUE(pret && !*pret);
+    memset(&s_ctx, 0, sizeof(s_ctx));
+    s_ctx.pTZI = &s_zone;
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+static int64_t
+mk_time(int y, int m, int d, int hh, int mm, int ss)
+{
+    return ((int64_t)ucal_DateToRdnGD(y, m, d) - UCAL_rdnUNIX) * 86400
+         + ucal_DayTimeMerge(hh, mm, ss);
+}
+
+static ucal_DurationT
+mk_dur(const char *str)
+{
+    ucal_DurationT dur;
+    const char    *cp = str;
+    TEST_ASSERT_TRUE_MESSAGE(ucal_decDuration(&dur, &cp, NULL), str);
+    TEST_ASSERT_EQUAL_MESSAGE('\0', *cp, str);
+    return dur;
+}
+
+// -------------------------------------------------------------------------------------
+static void
+test_Parse(void)
+{
+    static const struct {
+        const char *text;
+        int32_t     months, days;
+        int64_t     secs;
+        uint32_t    frac;
+    } good[] = {
+        { "P1Y2M10DT2H30M",  14, 10,  9000, 0 },
+        { "P3W",              0, 21,     0, 0 },
+        { "P1Y2W3D",         12, 17,     0, 0 },
+        { "PT36H",            0,  0,129600, 0 },
+        { "PT0.5S",           0,  0,     0, UINT32_C(0x80000000) },
+        { "PT1,5S",           0,  0,     1, UINT32_C(0x80000000) },
+        { "PT1.5H",           0,  0,  5400, 0 },
+        { "PT0.25M",          0,  0,    15, 0 },
+        { "-P1DT0.25S",       0, -1,    -1, UINT32_C(0xC0000000) },
+        { "+P0D",             0,  0,     0, 0 },
+        { "P2147483647D",     0, INT32_MAX, 0, 0 },
+    };
+    static const char * const bad[] = {
+        "", "P", "PT", "P1DT", "1D", "P1", "P1S", "PT1D", "P1D2Y", "P1M1M", "P1.5D",
+        "PT1.5M2S", "P1.D", "PT.5S", "xP1D", "P1Y-2M"
+    };
+    ucal_DurationT dur;
+    const char    *cp;
+    size_t         idx;
+
+    for (idx = 0; idx < sizeof(good) / sizeof(good[0]); ++idx) {
+        dur = mk_dur(good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].months, dur.months, good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].days, dur.days, good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].secs, dur.secs, good[idx].text);
+        TEST_ASSERT_EQUAL_MESSAGE(good[idx].frac, dur.frac, good[idx].text);
+    }
+    for (idx = 0; idx < sizeof(bad) / sizeof(bad[0]); ++idx) {
+        cp = bad[idx];
+        if (ucal_decDuration(&dur, &cp, NULL)) {
+            // may stop early, but must not consume everything
+            TEST_ASSERT_NOT_EQUAL_MESSAGE('\0', *cp, bad[idx]);
+        }
+    }
+
+    // overflow
+    cp = "P2147483648D";
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_decDuration(&dur, &cp, NULL));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+    cp = "P200000000Y";
+    TEST_ASSERT_FALSE(ucal_decDuration(&dur, &cp, NULL));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+
+    // parse region ends before the NUL
+    cp = "P1DT2H";
+    TEST_ASSERT_TRUE(ucal_decDuration(&dur, &cp, cp + 3));
+    TEST_ASSERT_EQUAL(1, dur.days);
+    TEST_ASSERT_EQUAL(0, dur.secs);
+}
+
+// -------------------------------------------------------------------------------------
+static void
+test_AddRdn(void)
+{
+    static const struct {
+        int16_t     y, m, d;
+        const char *dur;
+        int16_t     ry, rm, rd;
+    } tab[] = {
+        { 2025,  1, 31, "P1M",      2025,  2, 28 },
+        { 2024,  1, 31, "P1M",      2024,  2, 29 },
+        { 2024,  2, 29, "P1Y",      2025,  2, 28 },
+        { 2024,  2, 29, "P4Y",      2028,  2, 29 },
+        { 2025,  3, 31, "-P1M",     2025,  2, 28 },
+        { 2025,  1, 31, "P1M1D",    2025,  3,  1 },
+        { 2025, 12, 15, "P1M",      2026,  1, 15 },
+        { 2025,  1, 15, "-P13M",    2023, 12, 15 },
+        { 2025,  5, 31, "P1Y1M2W",  2026,  7, 14 },
+        { 2025,  5, 31, "P0D",      2025,  5, 31 },
+        { 2000,  3,  1, "-P1D",     2000,  2, 29 },
+    };
+    ucal_DurationT dur;
+    int32_t        rdn;
+    size_t         idx;
+
+    for (idx = 0; idx < sizeof(tab) / sizeof(tab[0]); ++idx) {
+        dur = mk_dur(tab[idx].dur);
+        TEST_ASSERT_TRUE(ucal_DurationAddRdn(&rdn, ucal_DateToRdnGD(tab[idx].y, tab[idx].m,
+                                                                    tab[idx].d), &dur));
+        TEST_ASSERT_EQUAL_MESSAGE(ucal_DateToRdnGD(tab[idx].ry, tab[idx].rm, tab[idx].rd), rdn,
+                                  tab[idx].dur);
+    }
+
+    // exact part is not allowed for days, and the year range is limited
+    dur = mk_dur("P1DT1H");
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_DurationAddRdn(&rdn, UCAL_rdnUNIX, &dur));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    dur = mk_dur("P40000Y");
+    TEST_ASSERT_FALSE(ucal_DurationAddRdn(&rdn, UCAL_rdnUNIX, &dur));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+}
+
+// -------------------------------------------------------------------------------------
+static void
+test_AddTime(void)
+{
+    ucal_DurationT dur;
+    time_t         tt;
+
+    dur = mk_dur("P1M");
+    TEST_ASSERT_TRUE(ucal_DurationAddTime(&tt, mk_time(2025, 1, 31, 12, 34, 56), &dur));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 2, 28, 12, 34, 56), tt);
+
+    dur = mk_dur("P1MT12H0.5S");
+    TEST_ASSERT_TRUE(ucal_DurationAddTime(&tt, mk_time(2025, 1, 31, 12, 0, 0), &dur));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 3, 1, 0, 0, 0), tt);
+
+    // negative fractions round toward the past
+    dur = mk_dur("-PT0.5S");
+    TEST_ASSERT_TRUE(ucal_DurationAddTime(&tt, 100, &dur));
+    TEST_ASSERT_EQUAL_INT64(99, tt);
+
+    dur = mk_dur("-P1Y");
+    TEST_ASSERT_TRUE(ucal_DurationAddTime(&tt, -1, &dur));
+    TEST_ASSERT_EQUAL_INT64(mk_time(1968, 12, 31, 23, 59, 59), tt);
+}
+
+// -------------------------------------------------------------------------------------
+static void
+test_AddZoned(void)
+{
+    ucal_DurationT dur;
+    int64_t        ts;
+
+    // a day is a local day: noon stays noon over spring forward (23h) and fall back (25h)
+    dur = mk_dur("P1D");
+    TEST_ASSERT_TRUE(tziDurationAdd(&ts, &s_ctx, mk_time(2025, 3, 29, 11, 0, 0), &dur,
+                                    tziCvtHint_None));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 3, 30, 10, 0, 0), ts);
+    TEST_ASSERT_TRUE(tziDurationAdd(&ts, &s_ctx, mk_time(2025, 10, 25, 10, 0, 0), &dur,
+                                    tziCvtHint_None));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 10, 26, 11, 0, 0), ts);
+
+    // ... but 24 hours are 24 hours
+    dur = mk_dur("PT24H");
+    TEST_ASSERT_TRUE(tziDurationAdd(&ts, &s_ctx, mk_time(2025, 3, 29, 11, 0, 0), &dur,
+                                    tziCvtHint_None));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 3, 30, 11, 0, 0), ts);
+
+    // landing in the gap: 02:30 local does not exist on 2025-03-30
+    dur = mk_dur("P1D");
+    errno = 0;
+    TEST_ASSERT_FALSE(tziDurationAdd(&ts, &s_ctx, mk_time(2025, 3, 29, 1, 30, 0), &dur,
+                                     tziCvtHint_None));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_TRUE(tziDurationAdd(&ts, &s_ctx, mk_time(2025, 3, 29, 1, 30, 0), &dur,
+                                    tziCvtHint_HrA));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 3, 30, 1, 30, 0), ts);   // 03:30 CEST
+
+    // landing in the overlap: 02:30 local happens twice on 2025-10-26; HrA takes the first
+    TEST_ASSERT_TRUE(tziDurationAdd(&ts, &s_ctx, mk_time(2025, 10, 25, 0, 30, 0), &dur,
+                                    tziCvtHint_HrA));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 10, 26, 0, 30, 0), ts);  // 02:30 CEST
+    TEST_ASSERT_TRUE(tziDurationAdd(&ts, &s_ctx, mk_time(2025, 10, 25, 0, 30, 0), &dur,
+                                    tziCvtHint_HrB));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 10, 26, 1, 30, 0), ts);  // 02:30 CET
+
+    // month end clamping happens in local time: Jan,31 00:30 CET is Jan,30 in UTC
+    dur = mk_dur("P1M");
+    TEST_ASSERT_TRUE(tziDurationAdd(&ts, &s_ctx, mk_time(2025, 1, 30, 23, 30, 0), &dur,
+                                    tziCvtHint_HrA));
+    TEST_ASSERT_EQUAL_INT64(mk_time(2025, 2, 27, 23, 30, 0), ts);
+}
+
+// -------------------------------------------------------------------------------------
+// batches must give the same results as single calls
+
+#define NBATCH 20000
+
+static void
+test_Batch(void)
+{
+    static const char * const durs[] = { "P1D", "-P3W", "P1M", "P1Y2M10DT2H30M", "PT90M" };
+    static int32_t rdn[NBATCH], rres[NBATCH];
+    static time_t  tt[NBATCH], tres[NBATCH];
+    static int64_t ts[NBATCH], zres[NBATCH];
+    ucal_DurationT dur;
+    tziConvCtxT    ctx2;
+    size_t         idx, di;
+
+    for (idx = 0; idx < NBATCH; ++idx) {
+        ts[idx]  = mk_time(2024, 1, 1, 0, 0, 0) + (int64_t)idx * 3617;
+        tt[idx]  = (time_t)ts[idx];
+        rdn[idx] = ucal_DateToRdnGD(2024, 1, 1) + (int32_t)(idx / 7);
+    }
+    for (di = 0; di < sizeof(durs) / sizeof(durs[0]); ++di) {
+        dur = mk_dur(durs[di]);
+        if (0 == dur.secs) {
+            TEST_ASSERT_EQUAL(NBATCH, ucal_DurationAddRdnBatch(rres, rdn, NBATCH, &dur));
+            for (idx = 0; idx < NBATCH; ++idx) {
+                int32_t ref;
+                TEST_ASSERT_TRUE(ucal_DurationAddRdn(&ref, rdn[idx], &dur));
+                TEST_ASSERT_EQUAL(ref, rres[idx]);
+            }
+        }
+        TEST_ASSERT_EQUAL(NBATCH, ucal_DurationAddTimeBatch(tres, tt, NBATCH, &dur));
+        TEST_ASSERT_EQUAL(NBATCH, tziDurationAddBatch(zres, &s_ctx, ts, NBATCH, &dur,
+                                                      tziCvtHint_HrA));
+        memset(&ctx2, 0, sizeof(ctx2));
+        ctx2.pTZI = &s_zone;
+        for (idx = 0; idx < NBATCH; ++idx) {
+            time_t  tref;
+            int64_t zref;
+            TEST_ASSERT_TRUE(ucal_DurationAddTime(&tref, tt[idx], &dur));
+            TEST_ASSERT_EQUAL_INT64(tref, tres[idx]);
+            TEST_ASSERT_TRUE(tziDurationAdd(&zref, &ctx2, ts[idx], &dur, tziCvtHint_HrA));
+            TEST_ASSERT_EQUAL_INT64(zref, zres[idx]);
+        }
+    }
+
+    // overflow stops the batch at the culprit
+    rdn[5] = INT32_MAX - 1;
+    dur = mk_dur("P2D");
+    TEST_ASSERT_EQUAL(5, ucal_DurationAddRdnBatch(rres, rdn, NBATCH, &dur));
+}
+
+// nanoseconds keep the fraction the seconds drop
+static void
+test_AddNs(void)
+{
+    static const char * const durs[] = { "PT0.25S", "-P1MT0.5S", "P1Y2M10DT2H30M", "-P3W" };
+    static const uint32_t     fracs[] = { 250000000, 500000000, 0, 0 };
+    static ucal_ns_t ns[NBATCH], nres[NBATCH];
+    ucal_DurationT dur;
+    size_t         idx, di;
+
+    for (idx = 0; idx < NBATCH; ++idx) {
+        ns[idx] = (mk_time(2024, 1, 1, 0, 0, 0) + (int64_t)idx * 3617) * 1000000000
+                + (int64_t)idx * 7919;
+    }
+    for (di = 0; di < sizeof(durs) / sizeof(durs[0]); ++di) {
+        dur = mk_dur(durs[di]);
+        TEST_ASSERT_EQUAL(NBATCH, ucal_DurationAddNsBatch(nres, ns, NBATCH, &dur));
+        for (idx = 0; idx < NBATCH; ++idx) {
+            ucal_ns_t nref;
+            time_t    tref;
+            TEST_ASSERT_TRUE(ucal_DurationAddNs(&nref, ns[idx], &dur));
+            TEST_ASSERT_EQUAL_INT64(nref, nres[idx]);
+            TEST_ASSERT_TRUE(ucal_DurationAddTime(&tref, (time_t)(ns[idx] / 1000000000), &dur));
+            TEST_ASSERT_EQUAL_INT64((int64_t)tref * 1000000000 + ns[idx] % 1000000000
+                                    + fracs[di], nref);
+        }
+    }
+
+    // overflow stops the batch at the culprit
+    ns[5] = INT64_MAX - 1000;
+    dur = mk_dur("PT1S");
+    errno = 0;
+    TEST_ASSERT_EQUAL(5, ucal_DurationAddNsBatch(nres, ns, NBATCH, &dur));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+    dur = mk_dur("P1M");
+    TEST_ASSERT_EQUAL(5, ucal_DurationAddNsBatch(nres, ns, NBATCH, &dur));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_Parse);
+    RUN_TEST(test_AddRdn);
+    RUN_TEST(test_AddTime);
+    RUN_TEST(test_AddZoned);
+    RUN_TEST(test_Batch);
+    RUN_TEST(test_AddNs);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
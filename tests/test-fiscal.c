@@ -0,0 +1,238 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for 52/53-week fiscal calendars
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/isoweek.h"
+#include "ucal/fiscal.h"
+
+#include <unity.h>
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+// NRF retail calendar: ends on the Saturday nearest Jan,31, 4-5-4 quarters, leap week last
+static ucal_FiscalCalT
+make_NRF(void)
+{
+    ucal_FiscalCalT cal = {
+        .aMonth = 2, .aMDay = 1, .aWDay = 7, .rule = ucal_FiscalNearest, .yearOffs = 0,
+        .nPeriods = 12, .leapPeriod = 12,
+        .pWeeks = { 4, 5, 4, 4, 5, 4, 4, 5, 4, 4, 5, 4 }
+    };
+    TEST_ASSERT_TRUE(ucal_FiscalInit(&cal));
+    return cal;
+}
+
+// ISO8601 weeks: starts on the Monday nearest Jan,1; 13 periods of 4 weeks
+static ucal_FiscalCalT
+make_ISO(void)
+{
+    ucal_FiscalCalT cal = {
+        .aMonth = 1, .aMDay = 1, .aWDay = 1, .rule = ucal_FiscalNearest, .yearOffs = 0,
+        .nPeriods = 13, .leapPeriod = 13,
+        .pWeeks = { 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4 }
+    };
+    TEST_ASSERT_TRUE(ucal_FiscalInit(&cal));
+    return cal;
+}
+
+// -------------------------------------------------------------------------------------
+// configuration checks and known year starts
+static void
+test_Config(void)
+{
+    ucal_FiscalCalT  cal = make_NRF(), bad;
+    ucal_FiscalDateT fd;
+
+    // NRF fiscal 2023 has 53 weeks, from 2023-01-29 to 2024-02-03
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2023, 1, 29), ucal_YearStartFC(&cal, 2023));
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2024, 2, 4), ucal_YearStartFC(&cal, 2024));
+    TEST_ASSERT_EQUAL(53, ucal_YearWeeksFC(&cal, 2023));
+    TEST_ASSERT_EQUAL(52, ucal_YearWeeksFC(&cal, 2024));
+
+    TEST_ASSERT_TRUE(ucal_RdnToDateFC(&fd, &cal, ucal_DateToRdnGD(2024, 2, 3)));
+    TEST_ASSERT_EQUAL(2023, fd.dYear);
+    TEST_ASSERT_EQUAL(371, fd.dYDay);
+    TEST_ASSERT_EQUAL(53, fd.dWeek);
+    TEST_ASSERT_EQUAL(12, fd.dPeriod);
+    TEST_ASSERT_EQUAL(5, fd.dPWeek);
+    TEST_ASSERT_EQUAL(7, fd.dWDay);
+
+    // 2nd quarter begins with period 4 in week 14
+    TEST_ASSERT_TRUE(ucal_RdnToDateFC(&fd, &cal, ucal_DateToRdnGD(2024, 5, 5)));
+    TEST_ASSERT_EQUAL(2024, fd.dYear);
+    TEST_ASSERT_EQUAL(14, fd.dWeek);
+    TEST_ASSERT_EQUAL(4, fd.dPeriod);
+    TEST_ASSERT_EQUAL(1, fd.dPWeek);
+    TEST_ASSERT_EQUAL(1, fd.dWDay);
+
+    // periods wrap into the neighbour years
+    TEST_ASSERT_EQUAL(ucal_DateToRdnFC(&cal, 2024, 1, 1, 1),
+                      ucal_DateToRdnFC(&cal, 2023, 13, 1, 1));
+    TEST_ASSERT_EQUAL(ucal_DateToRdnFC(&cal, 2023, 12, 1, 1),
+                      ucal_DateToRdnFC(&cal, 2024, 0, 1, 1));
+
+    // "last Saturday of January" ends the year: starts on the Sunday on or before Feb,1
+    bad = cal;
+    bad.rule = ucal_FiscalLast;
+    TEST_ASSERT_TRUE(ucal_FiscalInit(&bad));
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2025, 1, 26), ucal_YearStartFC(&bad, 2025));
+
+    bad = cal; bad.pWeeks[0] = 5;
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_FiscalInit(&bad));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    bad = cal; bad.aMonth = 2; bad.aMDay = 29;
+    TEST_ASSERT_FALSE(ucal_FiscalInit(&bad));
+    bad = cal; bad.leapPeriod = 13;
+    TEST_ASSERT_FALSE(ucal_FiscalInit(&bad));
+    bad = cal; bad.aWDay = 0;
+    TEST_ASSERT_FALSE(ucal_FiscalInit(&bad));
+    bad = cal; bad.rule = 3;
+    TEST_ASSERT_FALSE(ucal_FiscalInit(&bad));
+}
+
+// -------------------------------------------------------------------------------------
+// the ISO configuration against the ISO week calendar, all other ones against a day walk
+static void
+test_Calendar(void)
+{
+    static const int8_t s_rule[3] = { ucal_FiscalNearest, ucal_FiscalLast, ucal_FiscalFirst };
+    static const int8_t s_anchor[][2] = { { 1, 1 }, { 2, 1 }, { 6, 30 }, { 9, 30 }, { 12, 31 } };
+
+    ucal_FiscalCalT  cal = make_ISO();
+    ucal_FiscalDateT fd;
+    ucal_WeekDateT   wd;
+    int32_t          rdn, rlo = ucal_DateToRdnGD(1582, 1, 1), rhi = ucal_DateToRdnGD(2420, 1, 1);
+    int16_t          y;
+    unsigned         ia, ir, wday;
+
+    for (y = 1582; y < 2420; ++y) {
+        TEST_ASSERT_EQUAL(ucal_YearStartWD(y), ucal_YearStartFC(&cal, y));
+    }
+    for (rdn = rlo; rdn < rhi; ++rdn) {
+        TEST_ASSERT_TRUE(ucal_RdnToDateWD(&wd, rdn));
+        TEST_ASSERT_TRUE(ucal_RdnToDateFC(&fd, &cal, rdn));
+        TEST_ASSERT_EQUAL(wd.dYear, fd.dYear);
+        TEST_ASSERT_EQUAL(wd.dWeek, fd.dWeek);
+        TEST_ASSERT_EQUAL(wd.dWDay, fd.dWDay);
+        TEST_ASSERT_EQUAL((wd.dWeek - 1) / 4 + 1 - (wd.dWeek == 53), fd.dPeriod);
+    }
+
+    // walk the days and count weeks and periods by hand
+    for (ia = 0; ia < sizeof(s_anchor) / sizeof(s_anchor[0]); ++ia) {
+        for (ir = 0; ir < 3; ++ir) {
+            for (wday = 1; wday <= 7; wday += 3) {
+                int32_t start, next;
+                cal = make_NRF();
+                cal.aMonth = s_anchor[ia][0];
+                cal.aMDay  = s_anchor[ia][1];
+                cal.aWDay  = wday;
+                cal.rule   = s_rule[ir];
+                cal.yearOffs   = (s_anchor[ia][0] > 6);
+                cal.leapPeriod = 4;
+                TEST_ASSERT_TRUE(ucal_FiscalInit(&cal));
+
+                for (y = 1890; y < 2110; ++y) {
+                    unsigned p = 0, pw = 0, w = 0, weeks;
+                    start = ucal_YearStartFC(&cal, y);
+                    next  = ucal_YearStartFC(&cal, y + 1);
+                    weeks = (unsigned)(next - start) / 7;
+                    TEST_ASSERT_EQUAL(0, (next - start) % 7);
+                    TEST_ASSERT_TRUE(weeks == 52 || weeks == 53);
+                    TEST_ASSERT_EQUAL(weeks, ucal_YearWeeksFC(&cal, y));
+                    TEST_ASSERT_EQUAL(wday % 7, ucal_i32SubMod7(start, 0));
+                    for (rdn = start; rdn < next; rdn += 7, ++w, ++pw) {
+                        unsigned plen = cal.pWeeks[p]
+                                      + (weeks == 53 && p + 1 == (unsigned)cal.leapPeriod);
+                        if (pw == plen) {
+                            ++p;
+                            pw = 0;
+                        }
+                        TEST_ASSERT_TRUE(ucal_RdnToDateFC(&fd, &cal, rdn + 6));
+                        TEST_ASSERT_EQUAL(y, fd.dYear);
+                        TEST_ASSERT_EQUAL(w + 1, fd.dWeek);
+                        TEST_ASSERT_EQUAL(p + 1, fd.dPeriod);
+                        TEST_ASSERT_EQUAL(pw + 1, fd.dPWeek);
+                        TEST_ASSERT_EQUAL(7, fd.dWDay);
+                        TEST_ASSERT_EQUAL(rdn - start + 7, fd.dYDay);
+                        TEST_ASSERT_EQUAL(rdn + 3, ucal_DateToRdnFC(&cal, y, p + 1, pw + 1, 4));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------
+// array conversions against the single ones
+
+#define NDAYS (1 << 20)
+
+static void
+test_Arrays(void)
+{
+    ucal_FiscalCalT   cal  = make_NRF();
+    int32_t          *rdn  = malloc(NDAYS * sizeof(int32_t));
+    int32_t          *back = malloc(NDAYS * sizeof(int32_t));
+    ucal_FiscalDateT *fd   = malloc(NDAYS * sizeof(ucal_FiscalDateT));
+    ucal_FiscalDateT  fx;
+    int32_t           rbase = ucal_DateToRdnGD(1900, 1, 1);
+    size_t            idx;
+
+    TEST_ASSERT_TRUE(rdn && back && fd);
+    for (idx = 0; idx < NDAYS; ++idx) {
+        rdn[idx] = rbase + (int32_t)(idx >> 5);     // time stamps binned by day
+    }
+    TEST_ASSERT_EQUAL(NDAYS, ucal_RdnToDateFCArray(fd, &cal, rdn, NDAYS));
+
+    for (idx = 0; idx < NDAYS; idx += 37) {
+        TEST_ASSERT_TRUE(ucal_RdnToDateFC(&fx, &cal, rdn[idx]));
+        TEST_ASSERT_EQUAL_MEMORY(&fx, &fd[idx], sizeof(fx));
+    }
+    ucal_DateToRdnFCArray(back, &cal, fd, NDAYS);
+    TEST_ASSERT_EQUAL_MEMORY(rdn, back, NDAYS * sizeof(int32_t));
+
+    free(rdn);
+    free(back);
+    free(fd);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_Config);
+    RUN_TEST(test_Calendar);
+    RUN_TEST(test_Arrays);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
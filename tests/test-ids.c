@@ -0,0 +1,235 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for time stamps of time-ordered identifiers
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/clockmap.h"
+#include "ucal/idstamp.h"
+
+#include <unity.h>
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+// the example of RFC 9562, appendix A: 2022-02-22T19:22:22Z
+#define RFC9562_NS INT64_C(1645557742000000000)
+
+static const ucal_IdFormatT s_uuid      = { ucal_IdUUID, 0, 0 };
+static const ucal_IdFormatT s_ulid      = { ucal_IdULID, 0, 0 };
+static const ucal_IdFormatT s_oid       = { ucal_IdObjectId, 0, 0 };
+static const ucal_IdFormatT s_discord   = { ucal_IdSnowflake, 22, UCAL_SNOWFLAKE_DISCORD };
+
+// parse hex digits to bytes, for the binary vectors
+static void
+hex_bytes(
+    uint8_t    *into,
+    const char *str )
+{
+    unsigned v;
+
+    while (*str) {
+        if ('-' == *str) {
+            ++str;
+            continue;
+        }
+        TEST_ASSERT_EQUAL(1, sscanf(str, "%2x", &v));
+        *into++ = (uint8_t)v;
+        str += 2;
+    }
+}
+
+static void
+test_Constants(void)
+{
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(1582, 10, 15), UCAL_rdnUUID);
+    TEST_ASSERT_EQUAL_INT64((int64_t)(UCAL_rdnUNIX - UCAL_rdnUUID) * 86400 * 10000000,
+                            (int64_t)UCAL_sysPhiUUID);
+}
+
+static void
+test_Uuid(void)
+{
+    static const char * const good[] = {
+        "C232AB00-9414-11EC-B3C8-9F6BDECED846",     // v1
+        "1EC9414C-232A-6B00-B3C8-9F6BDECED846",     // v6
+        "017F22E2-79B0-7CC3-98C4-DC0C0C07398F",     // v7
+        "017f22e279b07cc398c4dc0c0c07398f"          // v7, no hyphens, lower case
+    };
+    static const char * const bad[] = {
+        "919108F7-52D1-4320-9BAC-F847DB4148A8",     // v4
+        "017F22E2-79B0-7CC3-98C4-DC0C0C07398F",     // read with a stride of 32
+        "017F22E2_79B0-7CC3-98C4-DC0C0C07398F",
+        "017F22G2-79B0-7CC3-98C4-DC0C0C07398F",
+        "017F22E2-79B0-7CC3:98C4-DC0C0C07398F"
+    };
+    uint8_t  bin[16];
+    int64_t  ns;
+    size_t   idx;
+
+    for (idx = 0; idx < sizeof(good) / sizeof(good[0]); ++idx) {
+        ns = 0;
+        TEST_ASSERT_EQUAL_MESSAGE(1, ucal_decIdArray(&ns, &s_uuid, good[idx],
+                                                     strlen(good[idx]), 1), good[idx]);
+        TEST_ASSERT_EQUAL_INT64(RFC9562_NS, ns);
+        hex_bytes(bin, good[idx]);
+        ns = 0;
+        TEST_ASSERT_TRUE(ucal_IdToNs(&ns, &s_uuid, bin));
+        TEST_ASSERT_EQUAL_INT64(RFC9562_NS, ns);
+    }
+
+    // a version 4 UUID has no time; with a stride of 32, the hyphens are hex digits
+    errno = 0;
+    TEST_ASSERT_EQUAL(0, ucal_decIdArray(&ns, &s_uuid, bad[0], 36, 1));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_EQUAL(0, ucal_decIdArray(&ns, &s_uuid, bad[1], 32, 1));
+    for (idx = 2; idx < sizeof(bad) / sizeof(bad[0]); ++idx) {
+        errno = 0;
+        TEST_ASSERT_EQUAL_MESSAGE(0, ucal_decIdArray(&ns, &s_uuid, bad[idx], 36, 1), bad[idx]);
+        TEST_ASSERT_EQUAL(EINVAL, errno);
+    }
+    hex_bytes(bin, bad[0]);
+    TEST_ASSERT_FALSE(ucal_IdToNs(&ns, &s_uuid, bin));
+
+    // the end of the 60bit tick range is beyond 2262
+    memset(bin, 0xFF, sizeof(bin));
+    bin[6] = 0x1F;
+    errno  = 0;
+    TEST_ASSERT_FALSE(ucal_IdToNs(&ns, &s_uuid, bin));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+}
+
+static void
+test_Others(void)
+{
+    static const uint8_t oid[12] = { 0x50, 0x7f, 0x1f, 0x77, 0xbc, 0xf8,
+                                     0x6c, 0xd7, 0x99, 0x43, 0x90, 0x11 };
+    static const char    ulid[]  = "01ARZ3NDEKTSV4RRFFQ69G5FAV"
+                                   "01arz3ndektsv4rrffq69g5fav"
+                                   "OLARZ3NDEKTSV4RRFFQ69G5FAV"
+                                   "81ARZ3NDEKTSV4RRFFQ69G5FAV";
+    uint64_t sf = UINT64_C(175928847299117063);
+    uint8_t  bin[16];
+    int64_t  ns[4];
+
+    // ULID; the first digit must not exceed 7
+    errno = 0;
+    TEST_ASSERT_EQUAL(3, ucal_decIdArray(ns, &s_ulid, ulid, 26, 4));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_EQUAL_INT64(INT64_C(1469922850259000000), ns[0]);
+    TEST_ASSERT_EQUAL_INT64(ns[0], ns[1]);
+    TEST_ASSERT_EQUAL_INT64(ns[0], ns[2]);
+    memset(bin, 0, sizeof(bin));
+    bin[0] = 0x01;
+    bin[1] = 0x56;
+    TEST_ASSERT_TRUE(ucal_IdToNs(&ns[0], &s_ulid, bin));
+    TEST_ASSERT_EQUAL_INT64(INT64_C(0x015600000000) * 1000000, ns[0]);
+
+    // ObjectId
+    TEST_ASSERT_TRUE(ucal_IdToNs(&ns[0], &s_oid, oid));
+    TEST_ASSERT_EQUAL_INT64(INT64_C(1350508407000000000), ns[0]);
+    TEST_ASSERT_EQUAL(1, ucal_decIdArray(&ns[1], &s_oid, "507F1f77bcf86cd799439011", 24, 1));
+    TEST_ASSERT_EQUAL_INT64(ns[0], ns[1]);
+    TEST_ASSERT_EQUAL(0, ucal_decIdArray(&ns[1], &s_oid, "507f1f7 bcf86cd799439011", 24, 1));
+
+    // Snowflake, the example of the Discord documentation
+    TEST_ASSERT_TRUE(ucal_IdToNs(&ns[0], &s_discord, (const uint8_t*)&sf));
+    TEST_ASSERT_EQUAL_INT64(INT64_C(1462015105796000000), ns[0]);
+    TEST_ASSERT_EQUAL(2, ucal_decIdArray(ns, &s_discord, "175928847299117063\0\0"
+                                         "175928847299117063,x", 20, 2));
+    TEST_ASSERT_EQUAL_INT64(INT64_C(1462015105796000000), ns[0]);
+    TEST_ASSERT_EQUAL_INT64(ns[0], ns[1]);
+    TEST_ASSERT_EQUAL(0, ucal_decIdArray(ns, &s_discord, "99999999999999999999", 20, 1));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+    TEST_ASSERT_EQUAL(0, ucal_decIdArray(ns, &s_discord, "-1", 2, 1));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+
+    // bad formats
+    errno = 0;
+    TEST_ASSERT_EQUAL(0, ucal_decIdArray(ns, &s_ulid, ulid, 25, 1));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// the fused path gives the same as the two steps
+#define NIDS 4000
+
+static void
+test_Civil(void)
+{
+    static char            text[NIDS][37];
+    static uint8_t         bin[NIDS][16];
+    static int64_t         ns[NIDS];
+    static ucal_CivilDateT d1[NIDS], d2[NIDS];
+    static ucal_CivilTimeT t1[NIDS], t2[NIDS];
+    static uint32_t        n1[NIDS], n2[NIDS];
+    uint64_t               ms = UINT64_C(1645557742000);
+    size_t                 idx;
+
+    // UUIDv7 every 13 minutes and a bit
+    for (idx = 0; idx < NIDS; ++idx, ms += 789012) {
+        snprintf(text[idx], sizeof(text[idx]), "%08lX-%04lX-7%03X-8000-000000000000",
+                 (unsigned long)(ms >> 16), (unsigned long)(ms & 0xFFFF), (unsigned)idx & 0xFFF);
+        hex_bytes(bin[idx], text[idx]);
+    }
+    TEST_ASSERT_EQUAL(NIDS, ucal_decIdArray(ns, &s_uuid, text[0], 37, NIDS));
+    ucal_NsToCivilArrayGD(d1, t1, n1, ns, NIDS);
+    TEST_ASSERT_EQUAL(NIDS, ucal_decIdCivilArray(d2, t2, n2, &s_uuid, text[0], 37, NIDS));
+    TEST_ASSERT_EQUAL_MEMORY(d1, d2, sizeof(d1));
+    TEST_ASSERT_EQUAL_MEMORY(t1, t2, sizeof(t1));
+    TEST_ASSERT_EQUAL_MEMORY(n1, n2, sizeof(n1));
+    memset(d2, 0, sizeof(d2));
+    TEST_ASSERT_EQUAL(NIDS, ucal_IdToCivilArray(d2, t2, NULL, &s_uuid, bin[0], 16, NIDS));
+    TEST_ASSERT_EQUAL_MEMORY(d1, d2, sizeof(d1));
+    TEST_ASSERT_EQUAL_MEMORY(t1, t2, sizeof(t1));
+    TEST_ASSERT_EQUAL(2022, d1[0].dYear);
+    TEST_ASSERT_EQUAL(2, d1[0].dMonth);
+    TEST_ASSERT_EQUAL(22, d1[0].dMDay);
+    TEST_ASSERT_EQUAL(19, t1[0].tHour);
+
+    // an error stops in the middle of a block
+    text[300][14] = '4';
+    TEST_ASSERT_EQUAL(300, ucal_decIdCivilArray(d2, t2, n2, &s_uuid, text[0], 37, NIDS));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_Constants);
+    RUN_TEST(test_Uuid);
+    RUN_TEST(test_Others);
+    RUN_TEST(test_Civil);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,190 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for ordinal dates
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/ordinal.h"
+
+#include <unity.h>
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+// -------------------------------------------------------------------------------------
+// all days from 0000-001 to 9999-365 against the Gregorian conversions
+static void
+test_Calendar(void)
+{
+    int32_t           rdn, rlo = ucal_DateToRdnGD(0, 1, 1), rhi = ucal_DateToRdnGD(9999, 12, 31);
+    ucal_CivilDateT   cd, cx;
+    ucal_OrdinalDateT od, ox;
+
+    for (rdn = rlo; rdn <= rhi; ++rdn) {
+        TEST_ASSERT_TRUE(ucal_RdnToDateGD(&cd, rdn));
+        TEST_ASSERT_TRUE(ucal_RdnToDateOD(&od, rdn));
+        TEST_ASSERT_EQUAL(cd.dYear, od.dYear);
+        TEST_ASSERT_EQUAL(cd.dYDay, od.dYDay);
+        TEST_ASSERT_EQUAL(rdn, ucal_DateToRdnOD(od.dYear, od.dYDay));
+
+        TEST_ASSERT_TRUE(ucal_OrdinalToCivilGD(&cx, &od));
+        TEST_ASSERT_EQUAL(cd.dMonth, cx.dMonth);
+        TEST_ASSERT_EQUAL(cd.dMDay, cx.dMDay);
+        TEST_ASSERT_EQUAL(cd.dWDay, cx.dWDay);
+        TEST_ASSERT_EQUAL(cd.fLeap, cx.fLeap);
+
+        TEST_ASSERT_TRUE(ucal_CivilToOrdinalGD(&ox, cd.dYear, cd.dMonth, cd.dMDay));
+        TEST_ASSERT_EQUAL(od.dYDay, ox.dYDay);
+    }
+
+    od.dYear = 2025;
+    od.dYDay = 366;
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_OrdinalToCivilGD(&cd, &od));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_FALSE(ucal_CivilToOrdinalGD(&od, 2025, 2, 29));
+    TEST_ASSERT_TRUE(ucal_CivilToOrdinalGD(&od, 2024, 12, 31));
+    TEST_ASSERT_EQUAL(366, od.dYDay);
+    // off-range days roll over
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2026, 1, 1), ucal_DateToRdnOD(2025, 366));
+}
+
+// -------------------------------------------------------------------------------------
+static void
+test_Text(void)
+{
+    static const char * const bad[] = {
+        "2025000", "2025366", "2025-366", "202436", "2024-36", "2O25001", "2025/001", "2025-0a1",
+        "-025001", "2025 001", ""
+    };
+    ucal_OrdinalDateT od;
+    const char       *cp;
+    char              buf[16];
+    size_t            idx;
+
+    cp = "2024366T";
+    TEST_ASSERT_TRUE(ucal_decOrdinal(&od, &cp, NULL));
+    TEST_ASSERT_EQUAL(2024, od.dYear);
+    TEST_ASSERT_EQUAL(366, od.dYDay);
+    TEST_ASSERT_EQUAL('T', *cp);
+
+    cp = "1999-001";
+    TEST_ASSERT_TRUE(ucal_decOrdinal(&od, &cp, NULL));
+    TEST_ASSERT_EQUAL(1999, od.dYear);
+    TEST_ASSERT_EQUAL(1, od.dYDay);
+    TEST_ASSERT_EQUAL('\0', *cp);
+
+    for (idx = 0; idx < sizeof(bad) / sizeof(bad[0]); ++idx) {
+        cp = bad[idx];
+        errno = 0;
+        TEST_ASSERT_FALSE_MESSAGE(ucal_decOrdinal(&od, &cp, NULL), bad[idx]);
+        TEST_ASSERT_EQUAL(EINVAL, errno);
+        TEST_ASSERT_TRUE(cp == bad[idx]);
+    }
+    // the parse region is respected
+    cp = "2025-100";
+    TEST_ASSERT_FALSE(ucal_decOrdinal(&od, &cp, cp + 7));
+
+    od.dYear = 7;
+    od.dYDay = 42;
+    TEST_ASSERT_EQUAL(7, ucal_encOrdinal(buf, sizeof(buf), &od, false));
+    TEST_ASSERT_EQUAL_STRING("0007042", buf);
+    TEST_ASSERT_EQUAL(8, ucal_encOrdinal(buf, sizeof(buf), &od, true));
+    TEST_ASSERT_EQUAL_STRING("0007-042", buf);
+    TEST_ASSERT_EQUAL(0, ucal_encOrdinal(buf, 8, &od, true));
+    od.dYear = 10000;
+    errno = 0;
+    TEST_ASSERT_EQUAL(0, ucal_encOrdinal(buf, sizeof(buf), &od, false));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+}
+
+// -------------------------------------------------------------------------------------
+// arrays: every day of 0000..9999 through text and back
+
+#define NDAYS (3652425 + 366)
+
+static void
+test_Arrays(void)
+{
+    int32_t           *rdn  = malloc(NDAYS * sizeof(int32_t));
+    int32_t           *back = malloc(NDAYS * sizeof(int32_t));
+    ucal_OrdinalDateT *od   = malloc(NDAYS * sizeof(ucal_OrdinalDateT));
+    char              *text = malloc(NDAYS * 9);
+    int32_t            rlo  = ucal_DateToRdnGD(0, 1, 1);
+    char               ref[16];
+    size_t             idx, n;
+
+    TEST_ASSERT_TRUE(rdn && back && od && text);
+    n = (size_t)(ucal_DateToRdnGD(9999, 12, 31) - rlo + 1);
+    TEST_ASSERT_TRUE(n <= NDAYS);
+    for (idx = 0; idx < n; ++idx) {
+        rdn[idx] = rlo + (int32_t)idx;
+    }
+
+    TEST_ASSERT_EQUAL(n, ucal_RdnToDateODArray(od, rdn, n));
+    ucal_DateToRdnODArray(back, od, n);
+    TEST_ASSERT_EQUAL_MEMORY(rdn, back, n * sizeof(int32_t));
+
+    // 7-digit fields packed without gaps, 8-character fields with a blank between
+    TEST_ASSERT_EQUAL(n, ucal_encOrdinalArray(text, 7, rdn, n, false));
+    memset(back, 0, n * sizeof(int32_t));
+    TEST_ASSERT_EQUAL(n, ucal_decOrdinalArray(back, text, 7, n));
+    TEST_ASSERT_EQUAL_MEMORY(rdn, back, n * sizeof(int32_t));
+
+    memset(text, ' ', n * 9);
+    TEST_ASSERT_EQUAL(n, ucal_encOrdinalArray(text, 9, rdn, n, true));
+    for (idx = 0; idx < n; idx += 997) {
+        ucal_encOrdinal(ref, sizeof(ref), &od[idx], true);
+        TEST_ASSERT_EQUAL_MEMORY(ref, text + idx * 9, 8);
+        TEST_ASSERT_EQUAL(' ', text[idx * 9 + 8]);
+    }
+    memset(back, 0, n * sizeof(int32_t));
+    TEST_ASSERT_EQUAL(n, ucal_decOrdinalArray(back, text, 9, n));
+    TEST_ASSERT_EQUAL_MEMORY(rdn, back, n * sizeof(int32_t));
+
+    // stop at the first bad field
+    text[1000 * 9 + 6] = 'x';
+    TEST_ASSERT_EQUAL(1000, ucal_decOrdinalArray(back, text, 9, n));
+
+    free(rdn);
+    free(back);
+    free(od);
+    free(text);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_Calendar);
+    RUN_TEST(test_Text);
+    RUN_TEST(test_Arrays);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -18,16 +18,37 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/random.h>
 #include <time.h>
 #include <unity.h>
 
 #include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/clockmap.h"
+#include "ucal/daycount.h"
+#include "ucal/fiscal.h"
 #include "ucal/gpsdate.h"
 #include "ucal/gregorian.h"
+#include "ucal/idstamp.h"
 #include "ucal/julian.h"
 #include "ucal/ntpdate.h"
+#include "ucal/ordinal.h"
+#ifdef UCAL_WITH_PIPELINE
+# include "ucal/pipeline.h"
+#endif
+#include "ucal/rdnset.h"
+#include "ucal/rtcdecode.h"
+#ifdef UCAL_WITH_SYSZONE
+# include "ucal/syszone.h"
+#endif
+#include "ucal/tsdecode.h"
+#include "ucal/tzbatch.h"
+#include "ucal/tzperiod.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzrezone.h"
 
 #if defined(CLOCK_THREAD_CPUTIME_ID)
 # define MYCLCOCK CLOCK_THREAD_CPUTIME_ID
@@ -53,10 +74,26 @@ tearDown(void)
   // NOP
 }
 
+// seconds on clock 'clk' since 't0'
+static double
+perf_ElapsedOn(clockid_t clk, struct timespec const *t0)
+{
+    struct timespec t1;
+    clock_gettime(clk, &t1);
+    return (double)(t1.tv_sec - t0->tv_sec) + 1e-9 * (double)(t1.tv_nsec - t0->tv_nsec);
+}
+
+// seconds since 't0', on the benchmark clock
+static double
+perf_Elapsed(struct timespec const *t0)
+{
+    return perf_ElapsedOn(MYCLCOCK, t0);
+}
+
 static void test_ucalPerf(void) {
     ucal_CivilTimeT ct;
     ucal_CivilDateT cd;
-    struct timespec tbeg, tend;
+    struct timespec tbeg;
     clock_gettime(MYCLCOCK, &tbeg);
     for (int loops = 10; loops; --loops) {
         for (int32_t day = -24855; day <= 24855; ++day) {
@@ -73,21 +110,12 @@ static void test_ucalPerf(void) {
             TEST_ASSERT_EQUAL(tt, tx);
         }
     }
-    clock_gettime(MYCLCOCK, &tend);
-    tend.tv_sec  -= tbeg.tv_sec;
-    tend.tv_nsec -= tbeg.tv_nsec;
-    if (tend.tv_nsec < 0) {
-        tend.tv_nsec += 1000000000L;
-        tend.tv_sec  -= 1;
-    }
-    printf("execution time was %ld.%06ld\n",
-           (long)tend.tv_sec,
-           (long)(tend.tv_nsec / 1000));
+    printf("execution time was %.6f\n", perf_Elapsed(&tbeg));
 }
 
 static void test_libcPerf(void) {
     struct tm dtb;
-    struct timespec tbeg, tend;
+    struct timespec tbeg;
 
     clock_gettime(MYCLCOCK, &tbeg);
     for (int loops = 10; loops; --loops) {
@@ -100,18 +128,984 @@ static void test_libcPerf(void) {
             TEST_ASSERT_EQUAL(tt, tx);
         }
     }
-    clock_gettime(MYCLCOCK, &tend);
-    tend.tv_sec  -= tbeg.tv_sec;
-    tend.tv_nsec -= tbeg.tv_nsec;
-    if (tend.tv_nsec < 0) {
-        tend.tv_nsec += 1000000000L;
-        tend.tv_sec  -= 1;
+    printf("execution time was %.6f\n", perf_Elapsed(&tbeg));
+}
+
+// -------------------------------------------------------------------------------------
+// ordinal dates: SWAR array decoding against a plain digit loop
+
+#define NORD (1 << 22)
+
+static void test_ordPerf(void) {
+    char           *text = malloc(NORD * 8);
+    int32_t        *rdn  = malloc(NORD * sizeof(int32_t));
+    int32_t         rbase = ucal_DateToRdnGD(2000, 1, 1);
+    uint32_t        sum = 0;
+    struct timespec t0;
+    double          secs;
+    size_t          idx;
+
+    TEST_ASSERT_TRUE(text && rdn);
+    for (idx = 0; idx < NORD; ++idx) {
+        rdn[idx] = rbase + (int32_t)(idx >> 10);
+    }
+    TEST_ASSERT_EQUAL(NORD, ucal_encOrdinalArray(text, 8, rdn, NORD, true));
+
+    clock_gettime(MYCLCOCK, &t0);
+    TEST_ASSERT_EQUAL(NORD, ucal_decOrdinalArray(rdn, text, 8, NORD));
+    secs = perf_Elapsed(&t0);
+    printf("SWAR array decode    %8d fields in %.6fs, %.2f ns/field\n",
+           NORD, secs, 1e9 * secs / NORD);
+
+    clock_gettime(MYCLCOCK, &t0);
+    for (idx = 0; idx < NORD; ++idx) {
+        const char *cp = text + idx * 8;
+        int         y = 0, d = 0, k;
+        for (k = 0; k < 4; ++k) {
+            y = y * 10 + (cp[k] - '0');
+        }
+        for (k = 5; k < 8; ++k) {
+            d = d * 10 + (cp[k] - '0');
+        }
+        sum += (uint32_t)ucal_DateToRdnOD(y, d);
+    }
+    secs = perf_Elapsed(&t0);
+    printf("digit loop           %8d fields in %.6fs, %.2f ns/field (%u)\n",
+           NORD, secs, 1e9 * secs / NORD, (unsigned)(sum & 1));
+
+    free(text);
+    free(rdn);
+}
+
+// -------------------------------------------------------------------------------------
+// clock maps: mapped and split trace events against per-event double arithmetic and a full
+// split
+
+#define NCLK      (1 << 21)
+#define NCLK_ANCH 64
+
+static void test_clkPerf(void) {
+    static const int64_t nsec = INT64_C(1000000000);
+    static const int64_t base = INT64_C(1748736000) * INT64_C(1000000000);
+
+    int64_t         *mono = malloc(NCLK * sizeof(int64_t));
+    int64_t         *real = malloc(NCLK * sizeof(int64_t));
+    ucal_CivilDateT *date = malloc(NCLK * sizeof(ucal_CivilDateT));
+    ucal_CivilTimeT *tod  = malloc(NCLK * sizeof(ucal_CivilTimeT));
+    uint32_t        *nfrac = malloc(NCLK * sizeof(uint32_t));
+    ucal_ClkSegT     buf[NCLK_ANCH];
+    ucal_ClockMapT   map;
+    struct timespec  t0;
+    double           secs;
+    int64_t          step = INT64_C(600) * nsec, sum = 0;
+    size_t           idx;
+
+    TEST_ASSERT_TRUE(mono && real && date && tod && nfrac);
+    ucal_ClockMapInit(&map, buf, NCLK_ANCH);
+    for (idx = 0; idx < NCLK_ANCH; ++idx) {
+        int64_t m = (int64_t)idx * step;
+        ucal_ClockMapAddAnchor(&map, m, base + m + m / 20000);
+    }
+    for (idx = 0; idx < NCLK; ++idx) {
+        mono[idx] = (int64_t)idx * ((NCLK_ANCH - 1) * step / NCLK);
+    }
+
+    clock_gettime(MYCLCOCK, &t0);
+    ucal_ClockMapConvert(&map, real, mono, NCLK);
+    ucal_NsToCivilArrayGD(date, tod, nfrac, real, NCLK);
+    secs = perf_Elapsed(&t0);
+    printf("map + fused split    %8d events in %.6fs, %.2f ns/event\n",
+           NCLK, secs, 1e9 * secs / NCLK);
+
+    clock_gettime(MYCLCOCK, &t0);
+    for (idx = 0; idx < NCLK; ++idx) {
+        size_t          k = (size_t)(mono[idx] / step);
+        double          r = (double)(mono[idx] - buf[k].mono) * (1.0 + 1.0 / 20000.0);
+        int64_t         ns = buf[k].real + (int64_t)r;
+        ucal_TimeDivT   td = ucal_TimeToRdn((time_t)(ns / nsec));
+        ucal_CivilDateT cd;
+        ucal_CivilTimeT ct;
+        ucal_RdnToDateGD(&cd, (int32_t)td.q);
+        ucal_DayTimeSplit(&ct, (int32_t)td.r, 0);
+        sum += cd.dMDay + ct.tSec;
+    }
+    secs = perf_Elapsed(&t0);
+    printf("double + full split  %8d events in %.6fs, %.2f ns/event (%d)\n",
+           NCLK, secs, 1e9 * secs / NCLK, (int)(sum & 1));
+
+    free(mono);
+    free(real);
+    free(date);
+    free(tod);
+    free(nfrac);
+}
+
+// -------------------------------------------------------------------------------------
+// fiscal calendars: array split of days against the single split
+
+#define NFISC (1 << 20)
+
+static void test_fiscalPerf(void) {
+    ucal_FiscalCalT   cal = {   // NRF 4-5-4, ending near the end of January
+        .aMonth = 2, .aMDay = 1, .aWDay = 7, .rule = ucal_FiscalNearest, .yearOffs = 0,
+        .nPeriods = 12, .leapPeriod = 12,
+        .pWeeks = { 4, 5, 4, 4, 5, 4, 4, 5, 4, 4, 5, 4 }
+    };
+    int32_t          *rdn = malloc(NFISC * sizeof(int32_t));
+    ucal_FiscalDateT *fd  = malloc(NFISC * sizeof(ucal_FiscalDateT));
+    ucal_FiscalDateT  fx;
+    int32_t           rbase = ucal_DateToRdnGD(1900, 1, 1);
+    uint32_t          sum = 0;
+    struct timespec   t0;
+    double            secs;
+    size_t            idx;
+
+    TEST_ASSERT_TRUE(rdn && fd && ucal_FiscalInit(&cal));
+    for (idx = 0; idx < NFISC; ++idx) {
+        rdn[idx] = rbase + (int32_t)(idx >> 5);     // time stamps binned by day
+    }
+
+    clock_gettime(MYCLCOCK, &t0);
+    TEST_ASSERT_EQUAL(NFISC, ucal_RdnToDateFCArray(fd, &cal, rdn, NFISC));
+    secs = perf_Elapsed(&t0);
+    printf("array split          %8d days in %.6fs, %.2f ns/day\n",
+           NFISC, secs, 1e9 * secs / NFISC);
+
+    clock_gettime(MYCLCOCK, &t0);
+    for (idx = 0; idx < NFISC; ++idx) {
+        (void)ucal_RdnToDateFC(&fx, &cal, rdn[idx]);
+        sum += (uint32_t)fx.dWeek;
+    }
+    secs = perf_Elapsed(&t0);
+    printf("single split         %8d days in %.6fs, %.2f ns/day (%u)\n",
+           NFISC, secs, 1e9 * secs / NFISC, (unsigned)(sum & 1));
+
+    free(rdn);
+    free(fd);
+}
+
+// -------------------------------------------------------------------------------------
+// time-ordered IDs: SWAR hex against a character loop, on a column of UUIDv7 texts
+
+#define NIDS     (1 << 20)
+#define NIDS_SRC 1024
+
+static bool
+perf_Uuid7(
+    int64_t    *into,
+    const char *str )
+{
+    uint64_t w = 0;
+    unsigned idx, d;
+    int      ch;
+
+    for (idx = 0; idx < 12; ++idx) {
+        if (8 == idx) {
+            ++str;
+        }
+        ch = (unsigned char)*str++;
+        if ((ch >= '0') && (ch <= '9')) {
+            d = ch - '0';
+        } else if (((ch | 0x20) >= 'a') && ((ch | 0x20) <= 'f')) {
+            d = (ch | 0x20) - 'a' + 10;
+        } else {
+            return false;
+        }
+        w = (w << 4) | d;
+    }
+    *into = (int64_t)w * 1000000;
+    return true;
+}
+
+static void test_idsPerf(void) {
+    static const ucal_IdFormatT uuid = { ucal_IdUUID, 0, 0 };
+    static char                 text[NIDS_SRC][36];
+    static int64_t              ns[NIDS_SRC];
+    struct timespec             t0;
+    double                      secs[2];
+    uint64_t                    ms = UINT64_C(1645557742000), sum = 0;
+    size_t                      idx, run;
+
+    for (idx = 0; idx < NIDS_SRC; ++idx, ms += 12345) {
+        char buf[40];
+        snprintf(buf, sizeof(buf), "%08lX-%04lX-7%03X-8000-000000000000",
+                 (unsigned long)(ms >> 16), (unsigned long)(ms & 0xFFFF), (unsigned)idx & 0xFFF);
+        memcpy(text[idx], buf, 36);
+    }
+    clock_gettime(MYCLCOCK, &t0);
+    for (run = 0; run < NIDS; run += NIDS_SRC) {
+        TEST_ASSERT_EQUAL(NIDS_SRC, ucal_decIdArray(ns, &uuid, text[0], 36, NIDS_SRC));
+        sum += (uint64_t)ns[run % NIDS_SRC];
+    }
+    secs[0] = perf_Elapsed(&t0);
+
+    clock_gettime(MYCLCOCK, &t0);
+    for (run = 0; run < NIDS; run += NIDS_SRC) {
+        for (idx = 0; idx < NIDS_SRC; ++idx) {
+            TEST_ASSERT_TRUE(perf_Uuid7(&ns[idx], text[idx]));
+        }
+        sum -= (uint64_t)ns[run % NIDS_SRC];
+    }
+    secs[1] = perf_Elapsed(&t0);
+    TEST_ASSERT_EQUAL_UINT64(0, sum);
+
+    printf("UUIDv7 text %d IDs: SWAR %.2f ns/id, char loop %.2f ns/id\n",
+           NIDS, 1e9 * secs[0] / NIDS, 1e9 * secs[1] / NIDS);
+}
+
+
+// -------------------------------------------------------------------------------------
+// day count conventions: a cash flow schedule of monthly dates from a common start, batched
+// against one pair at a time
+
+#define NDCF (1 << 20)
+
+static void test_daycountPerf(void) {
+    static int32_t  d1[NDCF], d2[NDCF];
+    static int64_t  q32[NDCF];
+    ucal_YearFracT  yf;
+    struct timespec t0;
+    double          secs[2];
+    uint64_t        sum = 0;
+    size_t          idx;
+    int             dc;
+
+    for (idx = 0; idx < NDCF; ++idx) {
+        d1[idx] = ucal_DateToRdnGD(2020, 1, 15);
+        d2[idx] = ucal_DateToRdnGD((int16_t)(2020 + (idx % 360) / 12),
+                                   (int16_t)(1 + idx % 12), 15 + (idx & 16));
+    }
+    for (dc = ucal_DcActActISDA; dc <= ucal_Dc30E_360; ++dc) {
+        clock_gettime(MYCLCOCK, &t0);
+        TEST_ASSERT_EQUAL(NDCF, ucal_YearFracQ32Array(q32, dc, d1, d2, NDCF));
+        secs[0] = perf_Elapsed(&t0);
+        sum += (uint64_t)q32[NDCF / 3];
+
+        clock_gettime(MYCLCOCK, &t0);
+        for (idx = 0; idx < NDCF; ++idx) {
+            (void)ucal_YearFrac(&yf, dc, d1[idx], d2[idx]);
+            q32[idx] = ucal_YearFracQ32(&yf);
+        }
+        secs[1] = perf_Elapsed(&t0);
+        sum += (uint64_t)q32[NDCF / 3];
+
+        printf("day count %d, %d pairs: batch %.2f ns/pair, single %.2f ns/pair\n",
+               dc, NDCF, 1e9 * secs[0] / NDCF, 1e9 * secs[1] / NDCF);
+    }
+    TEST_ASSERT_TRUE(0 != sum);
+}
+
+// -------------------------------------------------------------------------------------
+// day sets: availability of many people, working days minus personal absences, intersected
+
+#define NPEOPLE   1000
+#define NSET_CONT 64
+
+static void test_rdnsetPerf(void) {
+    static ucal_RdnSetContT mp[NSET_CONT], mr[2][NSET_CONT];
+    ucal_RdnSetT            p, r[2];
+    struct timespec         t0;
+    double                  secs;
+    int32_t                 lo = ucal_YearStartGD(2025), hi = ucal_YearStartGD(2035), d;
+    int                     i, cur = 0;
+    size_t                  sum = 0;
+
+    srand(2025);
+    ucal_RdnSetInit(&r[0], mr[0], NSET_CONT);
+    ucal_RdnSetInit(&r[1], mr[1], NSET_CONT);
+    ucal_RdnSetInit(&p, mp, NSET_CONT);
+    TEST_ASSERT_TRUE(ucal_RdnSetAddWeekdays(&r[0], lo, hi, 0x3E));
+
+    clock_gettime(MYCLCOCK, &t0);
+    for (i = 0; i < NPEOPLE; ++i) {
+        ucal_RdnSetClear(&p);
+        TEST_ASSERT_TRUE(ucal_RdnSetAddRange(&p, lo + rand() % 60, hi));
+        d = lo + rand() % (hi - lo - 30);
+        TEST_ASSERT_TRUE(ucal_RdnSetRemoveRange(&p, d, d + 1 + rand() % 3));
+        TEST_ASSERT_TRUE(ucal_RdnSetIntersect(&r[cur ^ 1], &r[cur], &p));
+        cur ^= 1;
+        TEST_ASSERT_TRUE(ucal_RdnSetNext(&d, &r[cur], lo + i, 10));
+        sum += (size_t)d;
+    }
+    secs = perf_Elapsed(&t0);
+    TEST_ASSERT_TRUE(0 != sum);
+
+    printf("%d calendars of 10 years: build, intersect and query %.2f us/calendar, "
+           "%u days left\n", NPEOPLE, 1e6 * secs / NPEOPLE, (unsigned)ucal_RdnSetCount(&r[cur]));
+}
+
+// -------------------------------------------------------------------------------------
+// radio time codes: replay a stream of DCF77 and WWVB frames, one per minute over roughly
+// two years, with a persistent and with a fresh decoder per frame
+
+#define NFRAMES (2 * 366 * 1440)
+
+static uint64_t
+perf_PutBits(uint64_t f, unsigned pos, unsigned n, unsigned v, bool msbf)
+{
+    for (unsigned k = 0; k < n; ++k) {
+        f |= (uint64_t)((v >> (msbf ? n - 1 - k : k)) & 1u) << (pos + k);
+    }
+    return f;
+}
+
+static unsigned
+perf_Parity(uint64_t v)
+{
+    unsigned p = 0;
+    for ( ; v; v &= v - 1) {
+        p ^= 1;
+    }
+    return p;
+}
+
+static uint64_t
+perf_EncDCF77(const ucal_CivilDateT *cd, int hh, int mm)
+{
+    uint64_t f = 0;
+    f = perf_PutBits(f, 17, 2, 2, false);
+    f = perf_PutBits(f, 20, 1, 1, false);
+    f = perf_PutBits(f, 21, 4, mm % 10, false);
+    f = perf_PutBits(f, 25, 3, mm / 10, false);
+    f = perf_PutBits(f, 28, 1, perf_Parity(f & (UINT64_C(0x7F) << 21)), false);
+    f = perf_PutBits(f, 29, 4, hh % 10, false);
+    f = perf_PutBits(f, 33, 2, hh / 10, false);
+    f = perf_PutBits(f, 35, 1, perf_Parity(f & (UINT64_C(0x3F) << 29)), false);
+    f = perf_PutBits(f, 36, 4, cd->dMDay % 10, false);
+    f = perf_PutBits(f, 40, 2, cd->dMDay / 10, false);
+    f = perf_PutBits(f, 42, 3, cd->dWDay, false);
+    f = perf_PutBits(f, 45, 4, cd->dMonth % 10, false);
+    f = perf_PutBits(f, 49, 1, cd->dMonth / 10, false);
+    f = perf_PutBits(f, 50, 4, (cd->dYear % 100) % 10, false);
+    f = perf_PutBits(f, 54, 4, (cd->dYear % 100) / 10, false);
+    f = perf_PutBits(f, 58, 1, perf_Parity(f & (UINT64_C(0x3FFFFF) << 36)), false);
+    return f;
+}
+
+static uint64_t
+perf_EncWWVB(const ucal_CivilDateT *cd, int hh, int mm)
+{
+    uint64_t f = 0;
+    f = perf_PutBits(f,  1, 3, mm / 10, true);
+    f = perf_PutBits(f,  5, 4, mm % 10, true);
+    f = perf_PutBits(f, 12, 2, hh / 10, true);
+    f = perf_PutBits(f, 15, 4, hh % 10, true);
+    f = perf_PutBits(f, 22, 2, cd->dYDay / 100, true);
+    f = perf_PutBits(f, 25, 4, (cd->dYDay / 10) % 10, true);
+    f = perf_PutBits(f, 30, 4, cd->dYDay % 10, true);
+    f = perf_PutBits(f, 45, 4, (cd->dYear % 100) / 10, true);
+    f = perf_PutBits(f, 50, 4, (cd->dYear % 100) % 10, true);
+    f = perf_PutBits(f, 55, 1, cd->fLeap != 0, true);
+    return f;
+}
+
+static void
+perf_Replay(const char *name, uint64_t const *frames, bool isDCF, bool keepState)
+{
+    ucal_RtcDecoderT dec;
+    ucal_RtcTimeT    rt;
+    struct timespec  t0;
+    double           secs;
+    unsigned         nok = 0;
+
+    ucal_RtcDecoderInit(&dec, 2000);
+    clock_gettime(MYCLCOCK, &t0);
+    for (int32_t i = 0; i < NFRAMES; ++i) {
+        if (!keepState) {
+            ucal_RtcDecoderInit(&dec, 2000);
+        }
+        nok += isDCF ? ucal_RtcDecodeDCF77(&rt, &dec, frames[i])
+                     : ucal_RtcDecodeWWVB(&rt, &dec, frames[i]);
+    }
+    secs = perf_Elapsed(&t0);
+    TEST_ASSERT_EQUAL(NFRAMES, nok);
+    printf("%-24s %8d frames in %.6fs, %.1f ns/frame\n",
+           name, NFRAMES, secs, 1e9 * secs / NFRAMES);
+}
+
+static void test_rtcPerf(void) {
+    uint64_t       *dcf  = malloc(NFRAMES * sizeof(uint64_t));
+    uint64_t       *wwvb = malloc(NFRAMES * sizeof(uint64_t));
+    ucal_CivilDateT cd;
+
+    TEST_ASSERT_TRUE(dcf && wwvb);
+    for (int32_t i = 0; i < NFRAMES; ++i) {
+        ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2024, 1, 1) + i / 1440);
+        dcf[i]  = perf_EncDCF77(&cd, (i / 60) % 24, i % 60);
+        wwvb[i] = perf_EncWWVB(&cd, (i / 60) % 24, i % 60);
+    }
+    perf_Replay("DCF77, stateful",  dcf,  true,  true);
+    perf_Replay("DCF77, stateless", dcf,  true,  false);
+    perf_Replay("WWVB, stateful",   wwvb, false, true);
+    perf_Replay("WWVB, stateless",  wwvb, false, false);
+    free(dcf);
+    free(wwvb);
+}
+
+// -------------------------------------------------------------------------------------
+// time zone batches: a mix of northern, southern, negative-DST, odd-rule and fixed zones,
+// repeated to fill 'count' slots
+
+static const char * const perf_tzSpecs[] = {
+    "CET-1CEST,M3.5.0,M10.5.0/3", "EST5EDT,M3.2.0,M11.1.0", "AEST-10AEDT,M10.1.0,M4.1.0/3",
+    "NZST-12NZDT,M9.5.0,M4.1.0/3", "IST-1GMT0,M10.5.0,M3.5.0/1", "GMT0BST,M3.5.0/1,M10.5.0",
+    "EET-2EEST,M3.5.4/24,M10.5.5/1", "CST6CDT,M4.1.0,M10.5.0", "XST3XDT,J60/2,J300/2",
+    "<+0545>-5:45", "JST-9", "ACST-9:30ACDT,M10.1.0,M4.1.0/3"
+};
+
+#define NTZ_SPEC   (sizeof(perf_tzSpecs) / sizeof(perf_tzSpecs[0]))
+#define NTZ        4096
+#define NTZ_ROUNDS 256
+
+static void
+perf_TzZones(tziPosixZoneT *zones, size_t count)
+{
+    for (size_t idx = 0; idx < count; ++idx) {
+        const char *pret = tziFromPosixSpec(&zones[idx], perf_tzSpecs[idx % NTZ_SPEC], NULL);
+        TEST_ASSERT_TRUE(pret && !*pret);
+    }
+}
+
+static int64_t
+perf_TzStamp(int16_t y, int16_t m, int16_t d)
+{
+    return ((int64_t)ucal_DateToRdnGD(y, m, d) - UCAL_rdnUNIX) * 86400;
+}
+
+// one instant into many zones, fan-out vs. one call per zone
+static void test_tzFanOutPerf(void) {
+    tziPosixZoneT   *zones  = malloc(NTZ * sizeof(*zones));
+    tziZoneBlockT   *blocks = malloc(TZI_BLOCKS(NTZ) * sizeof(*blocks));
+    tziConvCtxT     *ctx    = malloc(NTZ * sizeof(*ctx));
+    int32_t         *offs   = malloc(NTZ * sizeof(*offs));
+    uint8_t         *flags  = malloc(NTZ * sizeof(*flags));
+    tziConvInfoT     info;
+    struct timespec  t0;
+    double           secs;
+    int64_t          ts, sum1 = 0, sum2 = 0;
+    int              round, idx;
+
+    TEST_ASSERT_TRUE(zones && blocks && ctx && offs && flags);
+    perf_TzZones(zones, NTZ);
+    tziPackZones(blocks, zones, NTZ);
+
+    // Every round is a new instant, a week apart, so the per-zone contexts have to be
+    // refreshed every now and then, too.
+    clock_gettime(MYCLCOCK, &t0);
+    for (round = 0, ts = perf_TzStamp(2025, 1, 1); round < NTZ_ROUNDS;
+         ++round, ts += 7 * 86400 + 1) {
+        tziFanOutUtc2Local(offs, flags, blocks, NTZ, ts);
+        for (idx = 0; idx < NTZ; ++idx) {
+            sum1 += offs[idx] + flags[idx];
+        }
+    }
+    secs = perf_Elapsed(&t0);
+    printf("%-24s %8d zones in %.6fs, %.1f ns/zone\n",
+           "fan-out", NTZ * NTZ_ROUNDS, secs, 1e9 * secs / (NTZ * NTZ_ROUNDS));
+
+    memset(ctx, 0, NTZ * sizeof(*ctx));
+    clock_gettime(MYCLCOCK, &t0);
+    for (round = 0, ts = perf_TzStamp(2025, 1, 1); round < NTZ_ROUNDS;
+         ++round, ts += 7 * 86400 + 1) {
+        for (idx = 0; idx < NTZ; ++idx) {
+            ctx[idx].pTZI = &zones[idx];
+            tziGetInfoUtc2Local(&info, &ctx[idx], ts);
+            sum2 += info.offs + info.isDst + (info.isHrA << 1) + (info.isHrB << 2);
+        }
+    }
+    secs = perf_Elapsed(&t0);
+    printf("%-24s %8d zones in %.6fs, %.1f ns/zone\n",
+           "single, cached context", NTZ * NTZ_ROUNDS, secs, 1e9 * secs / (NTZ * NTZ_ROUNDS));
+
+    TEST_ASSERT_EQUAL_INT64(sum2, sum1);
+    free(zones);
+    free(blocks);
+    free(ctx);
+    free(offs);
+    free(flags);
+}
+
+static uint32_t
+perf_TzRnd(uint32_t *state)
+{
+    *state = *state * UINT32_C(1664525) + UINT32_C(1013904223);
+    return *state >> 8;
+}
+
+// mixed-zone records, batch vs. one call per record with a context per zone
+#define NTZ_REC   400000
+#define NTZ_RZONE 400
+
+static void test_tzByZonePerf(void) {
+    int64_t         *ts      = malloc(NTZ_REC * sizeof(*ts));
+    uint16_t        *zid     = malloc(NTZ_REC * sizeof(*zid));
+    int32_t         *offs    = malloc(NTZ_REC * sizeof(*offs));
+    uint8_t         *flags   = malloc(NTZ_REC * sizeof(*flags));
+    tziPosixZoneT   *zones   = malloc(NTZ_RZONE * sizeof(*zones));
+    tziConvCtxT     *ctx     = malloc(NTZ_RZONE * sizeof(*ctx));
+    void            *scratch = malloc(tziBatchScratchSize(NTZ_REC, NTZ_RZONE));
+    tziConvInfoT     info;
+    struct timespec  t0;
+    double           secs;
+    int64_t          t, sum1 = 0, sum2 = 0;
+    uint32_t         rnd = 12345;
+    size_t           idx;
+
+    TEST_ASSERT_TRUE(ts && zid && offs && flags && zones && ctx && scratch);
+    perf_TzZones(zones, NTZ_RZONE);
+    // time ordered records with random zones, like an event log
+    for (idx = 0, t = perf_TzStamp(2025, 3, 1); idx < NTZ_REC; ++idx) {
+        t += perf_TzRnd(&rnd) % 120;
+        ts[idx]  = t;
+        zid[idx] = (uint16_t)(perf_TzRnd(&rnd) % NTZ_RZONE);
+    }
+
+    memset(ctx, 0, NTZ_RZONE * sizeof(*ctx));
+    for (idx = 0; idx < NTZ_RZONE; ++idx) {
+        ctx[idx].pTZI = &zones[idx];
+    }
+    clock_gettime(MYCLCOCK, &t0);
+    tziBatchUtc2LocalByZone(offs, flags, ts, zid, NTZ_REC, ctx, NTZ_RZONE, scratch);
+    secs = perf_Elapsed(&t0);
+    for (idx = 0; idx < NTZ_REC; ++idx) {
+        sum1 += offs[idx] + flags[idx];
+    }
+    printf("%-24s %8d records in %.6fs, %.1f ns/record\n",
+           "batch by zone", NTZ_REC, secs, 1e9 * secs / NTZ_REC);
+
+    memset(ctx, 0, NTZ_RZONE * sizeof(*ctx));
+    for (idx = 0; idx < NTZ_RZONE; ++idx) {
+        ctx[idx].pTZI = &zones[idx];
+    }
+    clock_gettime(MYCLCOCK, &t0);
+    for (idx = 0; idx < NTZ_REC; ++idx) {
+        tziGetInfoUtc2Local(&info, &ctx[zid[idx]], ts[idx]);
+        sum2 += info.offs + info.isDst + (info.isHrA << 1) + (info.isHrB << 2);
+    }
+    secs = perf_Elapsed(&t0);
+    printf("%-24s %8d records in %.6fs, %.1f ns/record\n",
+           "per record", NTZ_REC, secs, 1e9 * secs / NTZ_REC);
+
+    TEST_ASSERT_EQUAL_INT64(sum2, sum1);
+    free(ts);
+    free(zid);
+    free(offs);
+    free(flags);
+    free(zones);
+    free(ctx);
+    free(scratch);
+}
+
+// one-second samples into 10 minute, hourly and daily windows, batch vs. one
+// tziAlignedLocalRange() call per sample and resolution
+#define NTZ_SAMP (1 << 20)
+
+static void test_tzWindowsPerf(void) {
+    static const tziWindowT win[3] = { { 600, 0 }, { 3600, 0 }, { 86400, 0 } };
+
+    int64_t         *ts    = malloc(NTZ_SAMP * sizeof(*ts));
+    int64_t         *tlohi = malloc(NTZ_SAMP * 3 * 2 * sizeof(*tlohi));
+    tziPosixZoneT    zone;
+    tziConvCtxT      ctx;
+    tziConvInfoT     info;
+    struct timespec  t0;
+    double           secs;
+    int64_t          rng[2], sum1 = 0, sum2 = 0;
+    size_t           idx, k;
+
+    TEST_ASSERT_TRUE(ts && tlohi);
+    perf_TzZones(&zone, 1);
+    for (idx = 0; idx < NTZ_SAMP; ++idx) {
+        ts[idx] = perf_TzStamp(2025, 10, 20) + (int64_t)idx;
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &zone;
+    clock_gettime(MYCLCOCK, &t0);
+    TEST_ASSERT_TRUE(tziAlignedLocalRanges(tlohi, NULL, &ctx, win, 3, ts, NTZ_SAMP));
+    for (idx = 0; idx < NTZ_SAMP * 3 * 2; ++idx) {
+        sum1 += tlohi[idx];
+    }
+    secs = perf_Elapsed(&t0);
+    printf("%-24s %8d samples in %.6fs, %.1f ns/sample\n",
+           "windows, batch", NTZ_SAMP, secs, 1e9 * secs / NTZ_SAMP);
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &zone;
+    clock_gettime(MYCLCOCK, &t0);
+    for (idx = 0; idx < NTZ_SAMP; ++idx) {
+        for (k = 0; k < 3; ++k) {
+            tziAlignedLocalRange(rng, &info, &ctx, ts[idx], win[k].period, win[k].phi);
+            sum2 += rng[0] + rng[1];
+        }
+    }
+    secs = perf_Elapsed(&t0);
+    printf("%-24s %8d samples in %.6fs, %.1f ns/sample\n",
+           "windows, single calls", NTZ_SAMP, secs, 1e9 * secs / NTZ_SAMP);
+
+    TEST_ASSERT_EQUAL_INT64(sum2, sum1);
+    free(ts);
+    free(tlohi);
+}
+
+// -------------------------------------------------------------------------------------
+// re-zoning: ten years of minute values and the US rule change of 2007, rewriting only the
+// rows that change vs. converting every row
+
+#define NREZONE (3653 * 1440)
+
+// old local time to UTC (first occurrence in an overlap), then to the new local time; gap
+// times stay
+static int64_t
+perf_Rezone(tziConvCtxT *cold, tziConvCtxT *cnew, int64_t loc)
+{
+    tziConvInfoT info;
+    int64_t      u;
+
+    if (tziGetInfoLocal2Utc(&info, cold, loc, tziCvtHint_None)) {
+        u = loc + info.offs;
+    } else {
+        tziGetInfoLocal2Utc(&info, cold, loc, tziCvtHint_HrA);
+        u = loc + info.offs;
+        tziGetInfoLocal2Utc(&info, cold, loc, tziCvtHint_HrB);
+        if (u > loc + info.offs) {
+            return loc;
+        }
+    }
+    tziGetInfoUtc2Local(&info, cnew, u);
+    return u + info.offs;
+}
+
+static void test_rezonePerf(void) {
+    int64_t        *col = malloc(NREZONE * sizeof(*col));
+    int64_t        *ref = malloc(NREZONE * sizeof(*ref));
+    tziRezoneT      iv[64];
+    tziPosixZoneT   zold, znew;
+    tziConvCtxT     cold, cnew;
+    struct timespec t0;
+    double          secs;
+    const char     *pold, *pnew;
+    size_t          idx, niv, nchg;
+
+    TEST_ASSERT_TRUE(col && ref);
+    pold = tziFromPosixSpec(&zold, "EST5EDT,M4.1.0,M10.5.0", NULL);
+    pnew = tziFromPosixSpec(&znew, "EST5EDT,M3.2.0,M11.1.0", NULL);
+    TEST_ASSERT_TRUE(pold && !*pold && pnew && !*pnew);
+    for (idx = 0; idx < NREZONE; ++idx) {
+        col[idx] = perf_TzStamp(2007, 1, 1) + 60 * (int64_t)idx;
+    }
+    memcpy(ref, col, NREZONE * sizeof(*col));
+
+    clock_gettime(MYCLCOCK, &t0);
+    niv  = tziRezoneIntervals(iv, 64, &zold, &znew, 2006, 2017);
+    nchg = tziRezoneColumn(col, NREZONE, iv, niv);
+    secs = perf_Elapsed(&t0);
+    printf("%-16s %8d rows, %7zu changed in %.6fs\n", "re-zone", NREZONE, nchg, secs);
+
+    memset(&cold, 0, sizeof(cold));
+    memset(&cnew, 0, sizeof(cnew));
+    cold.pTZI = &zold;
+    cnew.pTZI = &znew;
+    clock_gettime(MYCLCOCK, &t0);
+    for (idx = 0; idx < NREZONE; ++idx) {
+        ref[idx] = perf_Rezone(&cold, &cnew, ref[idx]);
+    }
+    secs = perf_Elapsed(&t0);
+    printf("%-16s %8d rows in %.6fs\n", "reconvert all", NREZONE, secs);
+
+    TEST_ASSERT_EQUAL_MEMORY(ref, col, NREZONE * sizeof(*col));
+    free(col);
+    free(ref);
+}
+
+// -------------------------------------------------------------------------------------
+// local period numbers: the array call against the civil conversion per event
+
+#define NPERIOD (1 << 20)
+
+// local civil date, then the period
+static int32_t
+perf_PeriodCivil(tziConvCtxT *ctx, int64_t ts, tziPeriodT unit)
+{
+    tziConvInfoT    info;
+    ucal_CivilDateT cd;
+    ucal_TimeDivT   ds;
+
+    tziGetInfoUtc2Local(&info, ctx, ts);
+    ds = ucal_TimeToRdn((time_t)(ts + info.offs));
+    ucal_RdnToDateGD(&cd, (int32_t)ds.q);
+    switch (unit) {
+    case tziPeriod_Day:
+        return (int32_t)ds.q - UCAL_rdnUNIX;
+    case tziPeriod_Week:
+        return (ucal_WdLE((int32_t)ds.q, 1) - (UCAL_rdnUNIX - 3)) / 7;
+    case tziPeriod_Month:
+        return (cd.dYear - 1970) * 12 + cd.dMonth - 1;
+    case tziPeriod_Quarter:
+        return (cd.dYear - 1970) * 4 + (cd.dMonth - 1) / 3;
+    default:
+        return cd.dYear - 1970;
+    }
+}
+
+static void test_periodPerf(void) {
+    int64_t        *ts  = malloc(NPERIOD * sizeof(*ts));
+    int32_t        *out = malloc(NPERIOD * sizeof(*out));
+    int32_t        *ref = malloc(NPERIOD * sizeof(*ref));
+    tziPosixZoneT   zone;
+    tziConvCtxT     ctx;
+    tziPeriodT      unit;
+    struct timespec t0;
+    double          secs;
+    size_t          idx;
+
+    TEST_ASSERT_TRUE(ts && out && ref);
+    perf_TzZones(&zone, 1);
+    // events every 2 minutes or so, with some jitter back and forth
+    for (idx = 0; idx < NPERIOD; ++idx) {
+        ts[idx] = perf_TzStamp(2024, 1, 1) + 120 * (int64_t)idx
+                + (int64_t)((idx * 7919u) % 600u) - 300;
+    }
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &zone;
+
+    for (unit = tziPeriod_Day; unit <= tziPeriod_Quarter; ++unit) {
+        clock_gettime(MYCLCOCK, &t0);
+        TEST_ASSERT_EQUAL(NPERIOD, tziPeriodIndexArray(out, &ctx, ts, NPERIOD, unit));
+        secs = perf_Elapsed(&t0);
+        printf("period %d, array     %8d events in %.6fs, %.2f ns/event\n",
+               (int)unit, NPERIOD, secs, 1e9 * secs / NPERIOD);
+
+        clock_gettime(MYCLCOCK, &t0);
+        for (idx = 0; idx < NPERIOD; ++idx) {
+            ref[idx] = perf_PeriodCivil(&ctx, ts[idx], unit);
+        }
+        secs = perf_Elapsed(&t0);
+        printf("period %d, civil     %8d events in %.6fs, %.2f ns/event\n",
+               (int)unit, NPERIOD, secs, 1e9 * secs / NPERIOD);
+        TEST_ASSERT_EQUAL_MEMORY(ref, out, NPERIOD * sizeof(*out));
+    }
+    free(ts);
+    free(out);
+    free(ref);
+}
+
+// -------------------------------------------------------------------------------------
+// mail Date headers: throughput on a mix of header styles
+
+#define NMAIL (1 << 20)
+
+static void test_mailDatePerf(void) {
+    static const char * const hdr[4] = {
+        "Fri, 21 Nov 1997 09:55:06 -0600",
+        "Tue, 1 Jul 2003 10:52:37 +0200 (CEST)",
+        "21 Nov 97 09:55:06 GMT",
+        "Mon, 3 Mar 2025 17:04:11 PST"
+    };
+    struct timespec t0, ts;
+    const char     *str;
+    int64_t         sum = 0;
+    double          secs;
+    size_t          nok = 0, idx;
+
+    clock_gettime(MYCLCOCK, &t0);
+    for (idx = 0; idx < NMAIL; ++idx) {
+        str  = hdr[idx & 3];
+        nok += ucal_decRFC5322Date(&ts, &str, NULL, NULL);
+        sum += ts.tv_sec;
+    }
+    secs = perf_Elapsed(&t0);
+    TEST_ASSERT_EQUAL(NMAIL, nok);
+    printf("mail date decode %8d headers in %.6fs, %.2f ns/header (%d)\n",
+           NMAIL, secs, 1e9 * secs / NMAIL, (int)(sum & 1));
+}
+
+// -------------------------------------------------------------------------------------
+// time stamp columns: the bound decoder against classifying every value, in chunks
+
+#define NTS_COL (1 << 20)
+#define NTS_SRC 1024
+
+static void test_columnPerf(void) {
+    static char               buf[NTS_SRC][32];
+    static const char        *col[NTS_SRC];
+    static struct timespec    ts[NTS_SRC];
+    static const char * const fmt[2] = {
+        "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+        "%04d%02d%02d%02d%02d%02d.%03dZ"
+    };
+    ucal_DecDetectT det;
+    struct timespec t0;
+    double          secs[2];
+    size_t          nok, idx;
+    int             ifmt, pass;
+
+    for (ifmt = 0; ifmt < 2; ++ifmt) {
+        for (idx = 0; idx < NTS_SRC; ++idx) {
+            snprintf(buf[idx], sizeof(buf[idx]), fmt[ifmt], 1970 + (int)(idx % 100),
+                     1 + (int)(idx % 12), 1 + (int)(idx % 28), (int)(idx % 24),
+                     (int)(idx % 60), (int)(idx * 7 % 60), (int)(idx % 1000));
+            col[idx] = buf[idx];
+        }
+        for (pass = 0; pass < 2; ++pass) {
+            ucal_decDetectInit(&det, NULL, 1950);
+            TEST_ASSERT_TRUE(ucal_decDetect(&det, col, NULL, 16));
+            if (pass) {
+                det.layout.format = ucal_DecFmt_None;   // as if nothing was detected
+            }
+            nok = 0;
+            clock_gettime(MYCLCOCK, &t0);
+            for (idx = 0; idx < NTS_COL; idx += NTS_SRC) {
+                nok += ucal_decColumn(ts, &det, col, NULL, NTS_SRC);
+            }
+            secs[pass] = perf_Elapsed(&t0);
+            TEST_ASSERT_EQUAL(NTS_COL, nok);
+            TEST_ASSERT_EQUAL(pass ? NTS_COL : 0, det.nslow);
+        }
+        printf("%s column %d values: bound %.2f ns/value, classified %.2f ns/value\n",
+               ifmt ? "ASN.1" : "RFC 3339", NTS_COL, 1e9 * secs[0] / NTS_COL,
+               1e9 * secs[1] / NTS_COL);
+    }
+}
+
+#ifdef UCAL_WITH_PIPELINE
+// -------------------------------------------------------------------------------------
+// record pipeline: throughput at 0 (no threads), 1, 2 and 4 stage threads; this is wall
+// clock time, and scaling needs that many cores
+
+#define NPIPE_REC  (1 << 18)
+#define NPIPE_POOL 8
+
+static double
+perf_PipeRun(tziConvCtxT *ctx, char (*text)[32], uint16_t const *zid, unsigned nthreads,
+             size_t bsize)
+{
+    ucal_PipeCfgT    cfg = { nthreads ? nthreads : 1, 4, ctx, NTZ_SPEC };
+    ucal_PipeBatchT  batch[NPIPE_POOL];
+    ucal_PipeBatchT *pool[NPIPE_POOL];
+    ucal_PipeBatchT *b;
+    ucal_PipeT       pipe;
+    struct timespec  t0;
+    double           secs;
+    size_t           next = 0, nbad = 0, idx;
+    unsigned         nfree;
+
+    for (nfree = 0; nfree < NPIPE_POOL; ++nfree) {
+        void *mem = malloc(ucal_PipeBatchMemSize(bsize, NTZ_SPEC));
+        TEST_ASSERT_NOT_NULL(mem);
+        ucal_PipeBatchInit(&batch[nfree], mem, bsize, NTZ_SPEC);
+        batch[nfree].user = mem;
+        pool[nfree] = &batch[nfree];
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (nthreads) {
+        TEST_ASSERT_TRUE(ucal_PipeStart(&pipe, &cfg));
+    }
+    while (next < NPIPE_REC || nfree < NPIPE_POOL) {
+        if (next < NPIPE_REC && nfree) {
+            b = pool[--nfree];
+            b->count = (NPIPE_REC - next < bsize) ? (NPIPE_REC - next) : bsize;
+            for (idx = 0; idx < b->count; ++idx, ++next) {
+                b->text[idx]   = text[next];
+                b->zoneId[idx] = zid[next];
+            }
+            if (nthreads) {
+                ucal_PipeSubmit(&pipe, b);
+                continue;
+            }
+            ucal_PipeProcess(b, &cfg);
+        } else {
+            b = ucal_PipeReceive(&pipe);
+        }
+        for (idx = 0; idx < b->count; ++idx) {
+            nbad += (b->status[idx] != 0);
+        }
+        pool[nfree++] = b;
+    }
+    if (nthreads) {
+        ucal_PipeClose(&pipe);
+        ucal_PipeJoin(&pipe);
+    }
+    secs = perf_ElapsedOn(CLOCK_MONOTONIC, &t0);
+
+    TEST_ASSERT_EQUAL(0, nbad);
+    while (nfree) {
+        free(pool[--nfree]->user);
     }
-    printf("execution time was %ld.%06ld\n",
-           (long)tend.tv_sec,
-           (long)(tend.tv_nsec / 1000));
+    return secs;
 }
 
+static void test_pipePerf(void) {
+    static const unsigned nthr[]   = { 0, 1, 2, 4 };
+    static const size_t   bsizes[] = { 64, 512, 4096 };
+
+    char          (*text)[32] = malloc(NPIPE_REC * sizeof(*text));
+    uint16_t       *zid       = malloc(NPIPE_REC * sizeof(*zid));
+    tziPosixZoneT   zones[NTZ_SPEC];
+    tziConvCtxT     ctx[NTZ_SPEC];
+    ucal_CivilDateT cd;
+    uint32_t        rnd  = 1;
+    int32_t         rdn0 = ucal_DateToRdnGD(2024, 1, 1);
+    double          secs;
+    size_t          idx;
+    unsigned        nt, bi;
+
+    TEST_ASSERT_TRUE(text && zid);
+    perf_TzZones(zones, NTZ_SPEC);
+    for (idx = 0; idx < NPIPE_REC; ++idx) {
+        int32_t sec = (int32_t)(idx * 120u);
+        ucal_RdnToDateGD(&cd, rdn0 + sec / 86400);
+        sec %= 86400;
+        snprintf(text[idx], sizeof(text[idx]), "%04d%02d%02d%02d%02d%02d.%03uZ",
+                 cd.dYear, cd.dMonth, cd.dMDay, sec / 3600, sec / 60 % 60, sec % 60,
+                 (unsigned)perf_TzRnd(&rnd) % 1000u);
+        zid[idx] = (uint16_t)(perf_TzRnd(&rnd) % NTZ_SPEC);
+    }
+
+    for (bi = 0; bi < sizeof(bsizes) / sizeof(bsizes[0]); ++bi) {
+        for (nt = 0; nt < sizeof(nthr) / sizeof(nthr[0]); ++nt) {
+            memset(ctx, 0, sizeof(ctx));
+            for (idx = 0; idx < NTZ_SPEC; ++idx) {
+                ctx[idx].pTZI = &zones[idx];
+            }
+            secs = perf_PipeRun(ctx, text, zid, nthr[nt], bsizes[bi]);
+            printf("threads=%u batch=%-5u %8d records in %.6fs, %.2f Mrec/s\n",
+                   nthr[nt], (unsigned)bsizes[bi], NPIPE_REC, secs, 1e-6 * NPIPE_REC / secs);
+        }
+    }
+    free(text);
+    free(zid);
+}
+#endif
+
+#ifdef UCAL_WITH_SYSZONE
+// -------------------------------------------------------------------------------------
+// system zone tracker: the reader fast path, sync and UTC->local conversion
+
+#define NSYSZONE 10000000
+
+static void test_syszonePerf(void) {
+    ucal_SysZoneT    sz;
+    ucal_SysZoneCtxT lc;
+    tziConvInfoT     ci;
+    struct timespec  t0;
+    double           secs;
+    unsigned long    n;
+
+    TEST_ASSERT_TRUE(ucal_SysZoneOpen(&sz, NULL, NULL));
+    TEST_ASSERT_TRUE(ucal_SysZonePublish(&sz, "<B2>-2"));
+    memset(&lc, 0, sizeof(lc));
+    clock_gettime(MYCLCOCK, &t0);
+    for (n = 0; n < NSYSZONE; ++n) {
+        tziGetInfoUtc2Local(&ci, ucal_SysZoneSync(&lc, &sz), 1751371200 + (int64_t)(n & 1023));
+    }
+    secs = perf_Elapsed(&t0);
+    printf("sync + UTC->local: %.2f ns/call\n", 1e9 * secs / NSYSZONE);
+    TEST_ASSERT_EQUAL(2 * 3600, ci.offs);
+    ucal_SysZoneClose(&sz);
+}
+#endif
 
 int main(int argc, char **argv)
 {
@@ -119,6 +1113,26 @@ int main(int argc, char **argv)
     UNITY_BEGIN();
     RUN_TEST(test_ucalPerf);
     RUN_TEST(test_libcPerf);
+    RUN_TEST(test_ordPerf);
+    RUN_TEST(test_clkPerf);
+    RUN_TEST(test_fiscalPerf);
+    RUN_TEST(test_idsPerf);
+    RUN_TEST(test_daycountPerf);
+    RUN_TEST(test_rdnsetPerf);
+    RUN_TEST(test_rtcPerf);
+    RUN_TEST(test_tzFanOutPerf);
+    RUN_TEST(test_tzByZonePerf);
+    RUN_TEST(test_tzWindowsPerf);
+    RUN_TEST(test_rezonePerf);
+    RUN_TEST(test_periodPerf);
+    RUN_TEST(test_mailDatePerf);
+    RUN_TEST(test_columnPerf);
+#ifdef UCAL_WITH_PIPELINE
+    RUN_TEST(test_pipePerf);
+#endif
+#ifdef UCAL_WITH_SYSZONE
+    RUN_TEST(test_syszonePerf);
+#endif
     return UNITY_END();
 }
 // -*- that's allk folks -*-
@@ -0,0 +1,269 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests and benchmark for local period numbers
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzperiod.h"
+
+#include <unity.h>
+
+// northern, southern, midnight transitions, negative DST, fixed
+static const char * const zoneTab[] = {
+    "CET-1CEST,M3.5.0,M10.5.0/3", "NZST-12NZDT,M9.5.0,M4.1.0/3", "CST5CDT,M3.2.0/0,M11.1.0/1",
+    "EET-2EEST,M3.5.5/0,M10.5.6/1", "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",
+    "IST-1GMT0,M10.5.0,M3.5.0/1", "<+0545>-5:45", "<GMT+10>-10",
+    NULL
+};
+
+#define NZONES (sizeof(zoneTab) / sizeof(zoneTab[0]) - 1)
+
+static tziPosixZoneT s_zones[NZONES];
+
+void setUp(void)
+{
+    size_t idx;
+    for (idx = 0; idx < NZONES; ++idx) {
+        const char *pret = tziFromPosixSpec(&s_zones[idx], zoneTab[idx], NULL);
+        TEST_ASSERT_MESSAGE((pret && !*pret), zoneTab[idx]);
+    }
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+static int64_t
+mkts(int16_t y, int16_t m, int16_t d)
+{
+    return ((int64_t)ucal_DateToRdnGD(y, m, d) - UCAL_rdnUNIX) * 86400;
+}
+
+// the long way: local civil date, then the period
+static int32_t
+period_ref(tziConvCtxT *ctx, int64_t ts, tziPeriodT unit)
+{
+    tziConvInfoT    info;
+    ucal_CivilDateT cd;
+    ucal_TimeDivT   ds;
+
+    TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&info, ctx, ts));
+    ds = ucal_TimeToRdn((time_t)(ts + info.offs));
+    TEST_ASSERT_TRUE(ucal_RdnToDateGD(&cd, (int32_t)ds.q));
+    switch (unit) {
+    case tziPeriod_Day:
+        return (int32_t)ds.q - UCAL_rdnUNIX;
+    case tziPeriod_Week:
+        return (ucal_WdLE((int32_t)ds.q, 1) - (UCAL_rdnUNIX - 3)) / 7;
+    case tziPeriod_Month:
+        return (cd.dYear - 1970) * 12 + cd.dMonth - 1;
+    case tziPeriod_Quarter:
+        return (cd.dYear - 1970) * 4 + (cd.dMonth - 1) / 3;
+    default:
+        return cd.dYear - 1970;
+    }
+}
+
+// -------------------------------------------------------------------------------------
+// all zones and periods in 7 minute steps against the civil conversion; the start of
+// every period found must bracket the time stamps in it
+static void
+test_Index(void)
+{
+    tziConvCtxT ctx;
+    tziPeriodT  unit;
+    int32_t     pidx, plast;
+    int64_t     ts, tlo = 0, thi = 0;
+    size_t      zi;
+
+    for (zi = 0; zi < NZONES; ++zi) {
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.pTZI = &s_zones[zi];
+        for (unit = tziPeriod_Day; unit <= tziPeriod_Quarter; ++unit) {
+            plast = INT32_MIN;
+            for (ts = mkts(2023, 1, 1); ts < mkts(2027, 1, 1); ts += 420) {
+                TEST_ASSERT_TRUE(tziPeriodIndex(&pidx, &ctx, ts, unit));
+                TEST_ASSERT_EQUAL_MESSAGE(period_ref(&ctx, ts, unit), pidx, zoneTab[zi]);
+                if (pidx != plast) {
+                    TEST_ASSERT_TRUE(tziPeriodStart(&tlo, &ctx, pidx, unit));
+                    TEST_ASSERT_TRUE(tziPeriodStart(&thi, &ctx, pidx + 1, unit));
+                    plast = pidx;
+                }
+                TEST_ASSERT_TRUE_MESSAGE((tlo <= ts) && (ts < thi), zoneTab[zi]);
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------
+// starts of periods in special places
+static void
+test_Start(void)
+{
+    tziConvCtxT ctx;
+    int64_t     ts;
+    int32_t     pidx;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &s_zones[0];
+    TEST_ASSERT_TRUE(tziPeriodStart(&ts, &ctx, 0, tziPeriod_Day));
+    TEST_ASSERT_EQUAL(-3600, ts);
+    TEST_ASSERT_TRUE(tziPeriodStart(&ts, &ctx, 0, tziPeriod_Week));
+    TEST_ASSERT_EQUAL(mkts(1969, 12, 29) - 3600, ts);
+    TEST_ASSERT_TRUE(tziPeriodStart(&ts, &ctx, 55 * 12 + 6, tziPeriod_Month));
+    TEST_ASSERT_EQUAL(mkts(2025, 7, 1) - 7200, ts);
+    TEST_ASSERT_TRUE(tziPeriodStart(&ts, &ctx, -1, tziPeriod_Year));
+    TEST_ASSERT_EQUAL(mkts(1969, 1, 1) - 3600, ts);
+
+    // Cuba-like midnight gap: 2025-03-09 starts at 01:00 CDT, which is 05:00Z
+    ctx.pTZI = &s_zones[2];
+    TEST_ASSERT_TRUE(tziPeriodIndex(&pidx, &ctx, mkts(2025, 3, 9) + 5 * 3600, tziPeriod_Day));
+    TEST_ASSERT_EQUAL(mkts(2025, 3, 9) / 86400, pidx);
+    TEST_ASSERT_TRUE(tziPeriodStart(&ts, &ctx, pidx, tziPeriod_Day));
+    TEST_ASSERT_EQUAL(mkts(2025, 3, 9) + 5 * 3600, ts);
+
+    errno = 0;
+    TEST_ASSERT_FALSE(tziPeriodStart(&ts, &ctx, INT32_MAX, tziPeriod_Year));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+    errno = 0;
+    TEST_ASSERT_FALSE(tziPeriodIndex(&pidx, &ctx, 0, (tziPeriodT)42));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// -------------------------------------------------------------------------------------
+// ranges of calendar units, single and on sorted arrays
+static void
+test_Range(void)
+{
+    static int64_t  ts[20000];
+    static int64_t  tlohi[2 * 20000];
+    static int32_t  pidx[20000];
+    tziConvCtxT     ctx, ref;
+    tziPeriodCacheT pc;
+    tziPeriodT      unit;
+    int64_t         rng[2], tlo, thi, t;
+    int32_t         cur;
+    size_t          zi, idx;
+
+    // CET: March has 743 hours, the 4th quarter 2209
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &s_zones[0];
+    tziPeriodCacheInit(&pc, &ctx, tziPeriod_Month);
+    TEST_ASSERT_TRUE(tziPeriodRange(rng, &cur, &pc, mkts(2025, 3, 30) + 3600));
+    TEST_ASSERT_EQUAL_INT64(mkts(2025, 3, 1) - 3600, rng[0]);
+    TEST_ASSERT_EQUAL_INT64(mkts(2025, 4, 1) - 7200, rng[1]);
+    TEST_ASSERT_EQUAL(55 * 12 + 2, cur);
+    tziPeriodCacheInit(&pc, &ctx, tziPeriod_Quarter);
+    TEST_ASSERT_TRUE(tziPeriodRange(rng, &cur, &pc, mkts(2025, 12, 31) + 23 * 3600 - 1));
+    TEST_ASSERT_EQUAL_INT64(mkts(2025, 10, 1) - 7200, rng[0]);
+    TEST_ASSERT_EQUAL_INT64(mkts(2026, 1, 1) - 3600, rng[1]);
+    TEST_ASSERT_EQUAL(55 * 4 + 3, cur);
+    TEST_ASSERT_TRUE(tziPeriodRange(rng, &cur, &pc, mkts(2025, 12, 31) + 23 * 3600));
+    TEST_ASSERT_EQUAL_INT64(mkts(2026, 1, 1) - 3600, rng[0]);
+    TEST_ASSERT_EQUAL(56 * 4, cur);
+
+    for (zi = 0; zi < NZONES; ++zi) {
+        for (unit = tziPeriod_Day; unit <= tziPeriod_Quarter; ++unit) {
+            memset(&ctx, 0, sizeof(ctx));
+            ctx.pTZI = &s_zones[zi];
+            ref = ctx;
+            tziPeriodCacheInit(&pc, &ctx, unit);
+            for (t = mkts(2023, 12, 1), idx = 0; idx < 20000; ++idx) {
+                t += (int64_t)((idx * 7919u) % 9000u);
+                ts[idx] = t;
+            }
+            TEST_ASSERT_EQUAL(20000, tziPeriodRangeArray(tlohi, pidx, &pc, ts, 20000));
+            for (idx = 0; idx < 20000; ++idx) {
+                TEST_ASSERT_EQUAL_MESSAGE(period_ref(&ref, ts[idx], unit), pidx[idx],
+                                          zoneTab[zi]);
+                TEST_ASSERT_TRUE(tziPeriodStart(&tlo, &ref, pidx[idx], unit));
+                TEST_ASSERT_TRUE(tziPeriodStart(&thi, &ref, pidx[idx] + 1, unit));
+                TEST_ASSERT_EQUAL_INT64(tlo, tlohi[2 * idx + 0]);
+                TEST_ASSERT_EQUAL_INT64(thi, tlohi[2 * idx + 1]);
+                TEST_ASSERT_TRUE_MESSAGE((tlo <= ts[idx]) && (ts[idx] < thi), zoneTab[zi]);
+            }
+        }
+    }
+
+    errno = 0;
+    TEST_ASSERT_FALSE(tziPeriodRange(NULL, NULL, &pc, 0));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    tziPeriodCacheInit(&pc, &ctx, (tziPeriodT)42);
+    errno = 0;
+    TEST_ASSERT_EQUAL(0, tziPeriodRangeArray(tlohi, NULL, &pc, ts, 1));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// -------------------------------------------------------------------------------------
+// arrays against the civil conversion
+
+#define NARRAY (1 << 20)
+
+static void
+test_Array(void)
+{
+    int64_t    *ts  = malloc(NARRAY * sizeof(*ts));
+    int32_t    *out = malloc(NARRAY * sizeof(*out));
+    int32_t    *ref = malloc(NARRAY * sizeof(*ref));
+    tziConvCtxT ctx;
+    tziPeriodT  unit;
+    size_t      idx;
+
+    TEST_ASSERT_TRUE(ts && out && ref);
+    // events every 2 minutes or so, with some jitter back and forth
+    for (idx = 0; idx < NARRAY; ++idx) {
+        ts[idx] = mkts(2024, 1, 1) + 120 * (int64_t)idx + (int64_t)((idx * 7919u) % 600u) - 300;
+    }
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &s_zones[0];
+
+    for (unit = tziPeriod_Day; unit <= tziPeriod_Quarter; ++unit) {
+        TEST_ASSERT_EQUAL(NARRAY, tziPeriodIndexArray(out, &ctx, ts, NARRAY, unit));
+        for (idx = 0; idx < NARRAY; ++idx) {
+            ref[idx] = period_ref(&ctx, ts[idx], unit);
+        }
+        TEST_ASSERT_EQUAL_MEMORY(ref, out, NARRAY * sizeof(*out));
+    }
+
+    errno = 0;
+    TEST_ASSERT_EQUAL(0, tziPeriodIndexArray(NULL, &ctx, ts, 1, tziPeriod_Day));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    free(ts);
+    free(out);
+    free(ref);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_Index);
+    RUN_TEST(test_Start);
+    RUN_TEST(test_Range);
+    RUN_TEST(test_Array);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,263 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests and throughput benchmark for the threaded pipeline
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzbatch.h"
+#include "ucal/pipeline.h"
+
+#include <unity.h>
+
+static const char * const zoneTab[] = {
+    "CET-1CEST,M3.5.0,M10.5.0/3", "EST5EDT,M3.2.0,M11.1.0", "AEST-10AEDT,M10.1.0,M4.1.0/3",
+    "<+0545>-5:45", "NZST-12NZDT,M9.5.0,M4.1.0/3", "UTC0"
+};
+
+#define NZONES (sizeof(zoneTab) / sizeof(zoneTab[0]))
+
+static tziPosixZoneT s_zones[NZONES];
+static tziConvCtxT   s_ctx[NZONES];
+
+void setUp(void)
+{
+    size_t idx;
+    memset(s_ctx, 0, sizeof(s_ctx));
+    for (idx = 0; idx < NZONES; ++idx) {
+        const char *pret = tziFromPosixSpec(&s_zones[idx], zoneTab[idx], NULL);
+        TEST_ASSERT_MESSAGE((pret && !*pret), zoneTab[idx]);
+        s_ctx[idx].pTZI = &s_zones[idx];
+    }
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+static ucal_PipeBatchT*
+mk_batch(size_t capacity)
+{
+    ucal_PipeBatchT *b   = malloc(sizeof(*b));
+    void            *mem = malloc(ucal_PipeBatchMemSize(capacity, NZONES));
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_NOT_NULL(mem);
+    ucal_PipeBatchInit(b, mem, capacity, NZONES);
+    b->user = mem;
+    return b;
+}
+
+static void
+free_batch(ucal_PipeBatchT *b)
+{
+    free(b->user);
+    free(b);
+}
+
+// -------------------------------------------------------------------------------------
+// all stages, single threaded
+static void
+test_Process(void)
+{
+    static const struct {
+        const char *text;
+        uint16_t    zone;
+        const char *expect;
+    } tab[] = {
+        { "20250301123456Z",          0, "2025-03-01T13:34:56+01:00" },
+        { "20250701000000.5Z",        0, "2025-07-01T02:00:00.500000000+02:00" },
+        { "20250301123456+0100",      0, "2025-03-01T12:34:56+01:00" },
+        { "20250301123456Z",          1, "2025-03-01T07:34:56-05:00" },
+        { "20251231230000Z",          2, "2026-01-01T10:00:00+11:00" },
+        { "20250101000000Z",          3, "2025-01-01T05:45:00+05:45" },
+        { "garbage",                  0, "" },
+        { "20250301123456Z",          9, "" }
+    };
+    ucal_PipeCfgT    cfg = { 1, 1, s_ctx, NZONES };
+    ucal_PipeBatchT *b   = mk_batch(8);
+    size_t           idx;
+
+    for (idx = 0; idx < 8; ++idx) {
+        b->text[idx]   = tab[idx].text;
+        b->zoneId[idx] = tab[idx].zone;
+    }
+    b->count = 8;
+    ucal_PipeProcess(b, &cfg);
+    for (idx = 0; idx < 8; ++idx) {
+        TEST_ASSERT_EQUAL_STRING(tab[idx].expect, b->out + idx * UCAL_PIPE_TXTLEN);
+    }
+    TEST_ASSERT_EQUAL(0, b->status[0]);
+    TEST_ASSERT_EQUAL(tziFlag_DST, b->flags[1]);
+    TEST_ASSERT_EQUAL(EINVAL, b->status[6]);
+    TEST_ASSERT_EQUAL(EINVAL, b->status[7]);
+    free_batch(b);
+}
+
+// -------------------------------------------------------------------------------------
+// records and the driver loop for the threaded runs
+
+#define NREC    (1 << 18)
+#define NPOOL   8
+
+static char     (*s_text)[32];
+static uint16_t  *s_zid;
+
+static void
+mk_records(void)
+{
+    ucal_CivilDateT cd;
+    uint32_t        rnd = 1;
+    int32_t         rdn0 = ucal_DateToRdnGD(2024, 1, 1);
+    size_t          idx;
+
+    s_text = malloc(NREC * sizeof(*s_text));
+    s_zid  = malloc(NREC * sizeof(*s_zid));
+    TEST_ASSERT_TRUE(s_text && s_zid);
+    for (idx = 0; idx < NREC; ++idx) {
+        int32_t sec = (int32_t)(idx * 120u);
+        ucal_RdnToDateGD(&cd, rdn0 + sec / 86400);
+        sec %= 86400;
+        rnd = rnd * UINT32_C(1664525) + UINT32_C(1013904223);
+        snprintf(s_text[idx], sizeof(s_text[idx]), "%04d%02d%02d%02d%02d%02d.%03uZ",
+                 cd.dYear, cd.dMonth, cd.dMDay, sec / 3600, sec / 60 % 60, sec % 60,
+                 (unsigned)(rnd >> 8) % 1000u);
+        s_zid[idx] = (uint16_t)((rnd >> 20) % NZONES);
+    }
+}
+
+static uint64_t
+digest(uint64_t h, const char *cp)
+{
+    while (*cp) {
+        h = (h ^ (unsigned char)*cp++) * UINT64_C(0x100000001B3);
+    }
+    return h;
+}
+
+// Push all records through a pipe with 'nthreads' threads (zero: no threads at all) and
+// return a digest of the output.
+static uint64_t
+run(unsigned nthreads, size_t bsize)
+{
+    ucal_PipeCfgT    cfg  = { nthreads ? nthreads : 1, 4, s_ctx, NZONES };
+    ucal_PipeBatchT *pool[NPOOL];
+    ucal_PipeBatchT *b;
+    ucal_PipeT       pipe;
+    uint64_t         hash = UINT64_C(0xCBF29CE484222325);
+    size_t           next = 0, idx;
+    unsigned         nfree;
+
+    for (nfree = 0; nfree < NPOOL; ++nfree) {
+        pool[nfree] = mk_batch(bsize);
+    }
+    memset(s_ctx, 0, sizeof(s_ctx));
+    for (idx = 0; idx < NZONES; ++idx) {
+        s_ctx[idx].pTZI = &s_zones[idx];
+    }
+
+    if (nthreads) {
+        TEST_ASSERT_TRUE(ucal_PipeStart(&pipe, &cfg));
+    }
+    while (next < NREC || nfree < NPOOL) {
+        if (next < NREC && nfree) {
+            // fill and submit a batch
+            b = pool[--nfree];
+            b->count = (NREC - next < bsize) ? (NREC - next) : bsize;
+            for (idx = 0; idx < b->count; ++idx, ++next) {
+                b->text[idx]   = s_text[next];
+                b->zoneId[idx] = s_zid[next];
+            }
+            if (nthreads) {
+                ucal_PipeSubmit(&pipe, b);
+                continue;
+            }
+            ucal_PipeProcess(b, &cfg);
+        } else {
+            b = ucal_PipeReceive(&pipe);
+            TEST_ASSERT_NOT_NULL(b);
+        }
+        // consume a batch
+        for (idx = 0; idx < b->count; ++idx) {
+            TEST_ASSERT_EQUAL(0, b->status[idx]);
+            hash = digest(hash, b->out + idx * UCAL_PIPE_TXTLEN);
+        }
+        pool[nfree++] = b;
+    }
+    if (nthreads) {
+        ucal_PipeClose(&pipe);
+        TEST_ASSERT_NULL(ucal_PipeReceive(&pipe));
+        ucal_PipeJoin(&pipe);
+    }
+
+    while (nfree) {
+        free_batch(pool[--nfree]);
+    }
+    return hash;
+}
+
+// -------------------------------------------------------------------------------------
+// threaded runs must give the same output as the plain run, in the same order
+static void
+test_Threads(void)
+{
+    static const size_t bsizes[] = { 1, 100, 4096 };
+    uint64_t ref = run(0, 256);
+    unsigned nt, bi;
+
+    for (nt = 1; nt <= UCAL_PIPE_STAGES; ++nt) {
+        for (bi = 0; bi < sizeof(bsizes) / sizeof(bsizes[0]); ++bi) {
+            TEST_ASSERT_EQUAL_UINT64(ref, run(nt, bsizes[bi]));
+        }
+    }
+}
+
+static void
+test_BadConfig(void)
+{
+    ucal_PipeT    pipe;
+    ucal_PipeCfgT cfg = { 0, 4, s_ctx, NZONES };
+
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_PipeStart(&pipe, &cfg));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    cfg.nthreads = UCAL_PIPE_STAGES + 1;
+    TEST_ASSERT_FALSE(ucal_PipeStart(&pipe, &cfg));
+    cfg.nthreads = 1;
+    cfg.depth    = UCAL_PIPE_RING + 1;
+    TEST_ASSERT_FALSE(ucal_PipeStart(&pipe, &cfg));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    mk_records();
+    RUN_TEST(test_Process);
+    RUN_TEST(test_BadConfig);
+    RUN_TEST(test_Threads);
+    free(s_text);
+    free(s_zid);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,290 @@
+// -*- mode: C++; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for the C++20 range adaptors: the views against the C functions element by
+// element, and a pipeline against the hand-written loop
+// ----------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <ranges>
+#include <vector>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/clockmap.h"
+#include "ucal/gregorian.h"
+#include "ucal/isoweek.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzbatch.h"
+#include "ucal/tzposix.hpp"
+#include "ucal/ranges.hpp"
+
+#include <unity.h>
+
+static constexpr tziPosixZoneT Berlin   = ucal::posix_zone("CET-1CEST,M3.5.0,M10.5.0/3");
+static constexpr tziPosixZoneT Auckland = ucal::posix_zone("NZST-12NZDT,M9.5.0,M4.1.0/3");
+
+using V64 = std::ranges::ref_view<std::vector<int64_t>>;
+
+static_assert(std::ranges::input_range<ucal::to_local_view<V64>>);
+static_assert(std::ranges::view<ucal::to_local_view<V64>>);
+static_assert(std::ranges::sized_range<ucal::to_local_view<V64>>);
+static_assert(std::ranges::input_range<ucal::civil_view<ucal::to_local_view<V64>>>);
+static_assert(std::ranges::view<ucal::iso_week_view<ucal::civil_view<V64>>>);
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+// a cheap generator
+static uint32_t s_rng = 4711;
+
+static uint32_t
+rnd(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// time stamps from 2023 to 2027: mostly small steps forward, some jumps either way
+static std::vector<int64_t>
+stamps(size_t n)
+{
+    std::vector<int64_t> v(n);
+    int64_t              t = (int64_t)(ucal_DateToRdnGD(2023, 1, 1) - UCAL_rdnUNIX) * 86400;
+
+    for (auto &x : v) {
+        uint32_t const r = rnd() % 100;
+        if (r < 90) {
+            t += rnd() % 7200;
+        } else if (r < 98) {
+            t += rnd() % (3 * 86400);
+        } else {
+            t = (int64_t)(ucal_DateToRdnGD(2023, 1, 1) - UCAL_rdnUNIX) * 86400
+              + (int64_t)(rnd() % (4 * 365)) * 86400 + rnd() % 86400;
+        }
+        x = t;
+    }
+    return v;
+}
+
+static uint8_t
+flagsOf(tziConvInfoT const &ci)
+{
+    return (uint8_t)((ci.isDst ? tziFlag_DST : 0) | (ci.isHrA ? tziFlag_HrA : 0)
+                     | (ci.isHrB ? tziFlag_HrB : 0));
+}
+
+// -------------------------------------------------------------------------------------
+
+static void
+test_ToLocal(void)
+{
+    auto const  ts = stamps(10000);
+    tziConvCtxT ctx{};
+    size_t      idx;
+
+    ctx.pTZI = &Auckland;
+
+    // contiguous: the batch kernel
+    idx = 0;
+    for (ucal::local_time lt : ts | ucal::views::to_local(Auckland)) {
+        tziConvInfoT ci;
+        TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&ci, &ctx, ts[idx]));
+        TEST_ASSERT_EQUAL_INT64(ts[idx], lt.utc);
+        TEST_ASSERT_EQUAL(ci.offs, lt.offs);
+        TEST_ASSERT_EQUAL(flagsOf(ci), lt.flags);
+        ++idx;
+    }
+    TEST_ASSERT_EQUAL(ts.size(), idx);
+
+    // a list and a transform: one by one
+    std::list<int64_t> const lst(ts.begin(), ts.end());
+    auto                     v1 = ucal::views::to_local(lst, Auckland);
+    auto                     v2 = ts | std::views::transform([](int64_t t) { return t; })
+                                     | ucal::views::to_local(Auckland);
+    auto                     i2 = v2.begin();
+    idx = 0;
+    for (ucal::local_time lt : v1) {
+        ucal::local_time const lt2 = *i2;
+        TEST_ASSERT_FALSE(i2 == v2.end());
+        TEST_ASSERT_EQUAL_INT64(ts[idx], lt.utc);
+        TEST_ASSERT_EQUAL_INT64(ts[idx], lt2.utc);
+        TEST_ASSERT_EQUAL(lt.offs, lt2.offs);
+        TEST_ASSERT_EQUAL(lt.flags, lt2.flags);
+        ++i2;
+        ++idx;
+    }
+    TEST_ASSERT_TRUE(i2 == v2.end());
+    TEST_ASSERT_EQUAL(ts.size(), idx);
+    TEST_ASSERT_EQUAL(ts.size(), v1.size());
+
+    // a second pass starts afresh
+    auto   v3 = ts | ucal::views::to_local(Berlin);
+    size_t n  = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (ucal::local_time lt : v3 | std::views::take(100)) {
+            n += (lt.offs == 3600) || (lt.offs == 7200);
+        }
+    }
+    TEST_ASSERT_EQUAL(200, n);
+}
+
+static void
+test_Civil(void)
+{
+    auto const ts = stamps(20000);
+    size_t     idx;
+
+    // plain seconds; negative ones too
+    std::vector<int64_t> secs(ts);
+    for (idx = 0; idx < 1000; ++idx) {
+        secs[idx] = -(int64_t)(ts[idx] / 5);
+    }
+    idx = 0;
+    for (ucal::civil_time ct : secs | ucal::views::civil) {
+        ucal_CivilDateT d;
+        ucal_CivilTimeT t;
+        ucal_NsToCivilGD(&d, &t, nullptr, secs[idx] * 1000000000);
+        TEST_ASSERT_EQUAL(0, memcmp(&d, &ct.date, sizeof(d)));
+        TEST_ASSERT_EQUAL(0, memcmp(&t, &ct.time, sizeof(t)));
+        TEST_ASSERT_EQUAL(ucal::detail::date_to_rdn(d.dYear, d.dMonth, d.dMDay), ct.rdn);
+        ++idx;
+    }
+    TEST_ASSERT_EQUAL(secs.size(), idx);
+
+    // local time from the zone view
+    idx = 0;
+    for (ucal::civil_time ct : ucal::views::civil(ts | ucal::views::to_local(Berlin))) {
+        tziConvInfoT    ci;
+        tziConvCtxT     ctx{};
+        ucal_CivilDateT d;
+        ucal_CivilTimeT t;
+        ctx.pTZI = &Berlin;
+        TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&ci, &ctx, ts[idx]));
+        ucal_NsToCivilGD(&d, &t, nullptr, (ts[idx] + ci.offs) * 1000000000);
+        TEST_ASSERT_EQUAL(0, memcmp(&d, &ct.date, sizeof(d)));
+        TEST_ASSERT_EQUAL(0, memcmp(&t, &ct.time, sizeof(t)));
+        ++idx;
+    }
+    TEST_ASSERT_EQUAL(ts.size(), idx);
+}
+
+static void
+test_IsoWeek(void)
+{
+    std::vector<int64_t> days;
+    size_t               idx;
+
+    // every day of 12 years, some twice, some skipped
+    for (int32_t rdn = ucal_DateToRdnGD(2019, 12, 20); rdn < ucal_DateToRdnGD(2032, 1, 10);) {
+        days.push_back((int64_t)(rdn - UCAL_rdnUNIX) * 86400 + rnd() % 86400);
+        rdn += (int32_t)(rnd() % 5 == 0 ? 0 : rnd() % 7 == 0 ? 2 : 1);
+    }
+    idx = 0;
+    for (ucal_WeekDateT wd : days | ucal::views::civil | ucal::views::iso_week) {
+        ucal_WeekDateT ref;
+        TEST_ASSERT_TRUE(ucal_RdnToDateWD(&ref, (int32_t)(days[idx] / 86400) + UCAL_rdnUNIX));
+        TEST_ASSERT_EQUAL(ref.dYear, wd.dYear);
+        TEST_ASSERT_EQUAL(ref.dWeek, wd.dWeek);
+        TEST_ASSERT_EQUAL(ref.dWDay, wd.dWDay);
+        ++idx;
+    }
+    TEST_ASSERT_EQUAL(days.size(), idx);
+}
+
+// the pipeline against the loop one would write by hand
+static void
+test_Pipeline(void)
+{
+    size_t const         n  = 2000000;
+    std::vector<int64_t> ts(n);
+    int64_t              t  = (int64_t)(ucal_DateToRdnGD(2025, 1, 1) - UCAL_rdnUNIX) * 86400;
+    unsigned long        s1 = 0, s2 = 0;
+
+    for (auto &x : ts) {
+        x = (t += rnd() % 60);
+    }
+
+    // the hand-written loop does the same work
+    for (ucal_WeekDateT wd : ts | ucal::views::to_local(Berlin) | ucal::views::civil
+                                | ucal::views::iso_week) {
+        s1 += (unsigned)wd.dWeek * 8 + (unsigned)wd.dWDay;
+    }
+    {
+        tziConvCtxT     ctx{};
+        int32_t         offs[ucal::to_local_chunk];
+        uint8_t         flags[ucal::to_local_chunk];
+        ucal_CivilDateT d{};
+        ucal_WeekDateT  wd{};
+        int32_t         last = INT32_MIN, lastW = INT32_MIN;
+
+        ctx.pTZI = &Berlin;
+        for (size_t lo = 0; lo < n; lo += ucal::to_local_chunk) {
+            size_t const cnt = std::min(n - lo, ucal::to_local_chunk);
+            tziBatchUtc2Local(offs, flags, &ctx, ts.data() + lo, cnt);
+            for (size_t i = 0; i < cnt; ++i) {
+                int64_t const loc = ts[lo + i] + offs[i];
+                int32_t const rdn = (int32_t)(loc / 86400) + UCAL_rdnUNIX;
+                if (rdn != last) {
+                    if ((rdn == last + 1)
+                        && (d.dMDay < _ucal_mdtab[d.fLeap != 0][d.dMonth - 1])) {
+                        d.dMDay += 1;
+                        d.dYDay += 1;
+                        d.dWDay  = d.dWDay % 7 + 1;
+                    } else {
+                        ucal_RdnToDateGD(&d, rdn);
+                    }
+                    last = rdn;
+                }
+                if (rdn != lastW) {
+                    if ((rdn == lastW + 1) && (wd.dWDay < 7)) {
+                        wd.dWDay += 1;
+                    } else {
+                        ucal_RdnToDateWD(&wd, rdn);
+                    }
+                    lastW = rdn;
+                }
+                s2 += (unsigned)wd.dWeek * 8 + (unsigned)wd.dWDay;
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL(s2, s1);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_ToLocal);
+    RUN_TEST(test_Civil);
+    RUN_TEST(test_IsoWeek);
+    RUN_TEST(test_Pipeline);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,255 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for compressed sets of days
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/rdnset.h"
+
+#include <unity.h>
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+#define NCONT 64
+
+// reference: one flag per day from 1990 on
+#define REF_Y0   1990
+#define REF_DAYS (40 * 366)
+
+static int32_t s_base;
+
+static void
+ref_Add(
+    bool    *ref ,
+    int32_t  lo  ,
+    int32_t  hi  ,
+    unsigned mask,
+    bool     val )
+{
+    int32_t d;
+
+    for (d = lo; d < hi; ++d) {
+        if ((mask >> ucal_i32Mod7(d)) & 1u) {
+            ref[d - s_base] = val;
+        }
+    }
+}
+
+// compare a set against the reference in every respect
+static void
+ref_Check(
+    ucal_RdnSetT const *set,
+    bool const         *ref)
+{
+    size_t  rank = 0;
+    int32_t d, sel;
+
+    for (d = 0; d < REF_DAYS; ++d) {
+        TEST_ASSERT_EQUAL(rank, ucal_RdnSetRank(set, s_base + d));
+        TEST_ASSERT_EQUAL(ref[d], ucal_RdnSetContains(set, s_base + d));
+        if (ref[d]) {
+            TEST_ASSERT_TRUE(ucal_RdnSetSelect(&sel, set, rank));
+            TEST_ASSERT_EQUAL(s_base + d, sel);
+            ++rank;
+        }
+    }
+    TEST_ASSERT_EQUAL(rank, ucal_RdnSetCount(set));
+    TEST_ASSERT_FALSE(ucal_RdnSetSelect(&sel, set, rank));
+    for (d = 1; d < (int32_t)set->ncont; ++d) {
+        TEST_ASSERT_TRUE(set->cont[d - 1].year < set->cont[d].year);
+        TEST_ASSERT_TRUE(set->cont[d].card > 0);
+    }
+}
+
+static void
+test_Basic(void)
+{
+    static ucal_RdnSetContT mem[NCONT];
+    ucal_RdnSetT            set;
+    int32_t                 d, lo;
+
+    ucal_RdnSetInit(&set, mem, NCONT);
+    TEST_ASSERT_EQUAL(0, ucal_RdnSetCount(&set));
+    TEST_ASSERT_FALSE(ucal_RdnSetNext(&d, &set, 0, 1));
+
+    // a long range gets one run container per year
+    lo = ucal_DateToRdnGD(2023, 7, 1);
+    TEST_ASSERT_TRUE(ucal_RdnSetAddRange(&set, lo, ucal_DateToRdnGD(2026, 1, 1)));
+    TEST_ASSERT_EQUAL(3, set.ncont);
+    TEST_ASSERT_EQUAL(ucal_RdnSetRuns, set.cont[1].kind);
+    TEST_ASSERT_EQUAL(1, set.cont[1].nrun);
+    TEST_ASSERT_EQUAL(366, set.cont[1].card);
+    TEST_ASSERT_EQUAL(184 + 366 + 365, ucal_RdnSetCount(&set));
+
+    // weekdays make a bitmap
+    ucal_RdnSetClear(&set);
+    TEST_ASSERT_TRUE(ucal_RdnSetAddWeekdays(&set, ucal_DateToRdnGD(2025, 1, 1),
+                                            ucal_DateToRdnGD(2026, 1, 1), 0x3E));
+    TEST_ASSERT_EQUAL(1, set.ncont);
+    TEST_ASSERT_EQUAL(ucal_RdnSetBits, set.cont[0].kind);
+    TEST_ASSERT_EQUAL(261, ucal_RdnSetCount(&set));
+
+    // the 10th working day after Friday, 2025-07-04
+    TEST_ASSERT_TRUE(ucal_RdnSetNext(&d, &set, ucal_DateToRdnGD(2025, 7, 4), 10));
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2025, 7, 18), d);
+    TEST_ASSERT_FALSE(ucal_RdnSetNext(&d, &set, ucal_DateToRdnGD(2025, 12, 31), 1));
+
+    // Sundays only, as bit 7; then the range is cut again
+    ucal_RdnSetClear(&set);
+    TEST_ASSERT_TRUE(ucal_RdnSetAddWeekdays(&set, ucal_DateToRdnGD(2025, 1, 1),
+                                            ucal_DateToRdnGD(2025, 1, 8), 1u << ucal_wdSUN));
+    TEST_ASSERT_EQUAL(1, ucal_RdnSetCount(&set));
+    TEST_ASSERT_TRUE(ucal_RdnSetContains(&set, ucal_DateToRdnGD(2025, 1, 5)));
+    TEST_ASSERT_TRUE(ucal_RdnSetAddWeekdays(&set, ucal_DateToRdnGD(2027, 1, 4),
+                                            ucal_DateToRdnGD(2027, 1, 9), 1u << ucal_wdSUN));
+    TEST_ASSERT_EQUAL(1, set.ncont);
+    TEST_ASSERT_TRUE(ucal_RdnSetRemoveRange(&set, ucal_DateToRdnGD(2025, 1, 5),
+                                            ucal_DateToRdnGD(2025, 1, 6)));
+    TEST_ASSERT_EQUAL(0, set.ncont);
+
+    // errors leave the set alone
+    ucal_RdnSetInit(&set, mem, 2);
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_RdnSetAddRange(&set, lo, ucal_DateToRdnGD(2026, 1, 1)));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+    TEST_ASSERT_EQUAL(0, set.ncont);
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_RdnSetAddRange(&set, ucal_YearStartGD(INT16_MIN) - 1, lo));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+}
+
+static void
+test_Random(void)
+{
+    static ucal_RdnSetContT mem[NCONT];
+    static bool             ref[REF_DAYS];
+    ucal_RdnSetT            set;
+    int                     op;
+
+    s_base = ucal_YearStartGD(REF_Y0);
+    ucal_RdnSetInit(&set, mem, NCONT);
+    memset(ref, 0, sizeof(ref));
+    srand(121);
+    for (op = 0; op < 400; ++op) {
+        int32_t  lo   = s_base + rand() % REF_DAYS;
+        int32_t  hi   = lo + rand() % ((op & 1) ? 30 : 1500);
+        unsigned mask = (unsigned)rand() & 0xFF;
+
+        if (hi > s_base + REF_DAYS) {
+            hi = s_base + REF_DAYS;
+        }
+        switch (rand() % 3) {
+        case 0:
+            TEST_ASSERT_TRUE(ucal_RdnSetAddRange(&set, lo, hi));
+            ref_Add(ref, lo, hi, 0x7F, true);
+            break;
+        case 1:
+            TEST_ASSERT_TRUE(ucal_RdnSetAddWeekdays(&set, lo, hi, mask));
+            ref_Add(ref, lo, hi, (mask | (mask >> 7)), true);
+            break;
+        default:
+            TEST_ASSERT_TRUE(ucal_RdnSetRemoveRange(&set, lo, hi));
+            ref_Add(ref, lo, hi, 0x7F, false);
+            break;
+        }
+        if (0 == op % 50) {
+            ref_Check(&set, ref);
+        }
+    }
+    ref_Check(&set, ref);
+}
+
+static void
+test_SetOps(void)
+{
+    static ucal_RdnSetContT ma[NCONT], mb[NCONT], mr[NCONT];
+    static bool             ra[REF_DAYS], rb[REF_DAYS], rr[REF_DAYS];
+    ucal_RdnSetT            a, b, r;
+    int                     round, op, d;
+
+    s_base = ucal_YearStartGD(REF_Y0);
+    srand(4711);
+    for (round = 0; round < 4; ++round) {
+        ucal_RdnSetInit(&a, ma, NCONT);
+        ucal_RdnSetInit(&b, mb, NCONT);
+        memset(ra, 0, sizeof(ra));
+        memset(rb, 0, sizeof(rb));
+        for (op = 0; op < 60; ++op) {
+            int32_t  lo   = s_base + rand() % (REF_DAYS - 2000);
+            int32_t  hi   = lo + rand() % 2000;
+            unsigned mask = (unsigned)rand() & 0x7F;
+            if (op & 1) {
+                TEST_ASSERT_TRUE(ucal_RdnSetAddWeekdays(&a, lo, hi, mask));
+                ref_Add(ra, lo, hi, mask, true);
+            } else {
+                TEST_ASSERT_TRUE(ucal_RdnSetAddRange(&b, lo, hi - hi % 4));
+                ref_Add(rb, lo, hi - hi % 4, 0x7F, true);
+            }
+        }
+
+        ucal_RdnSetInit(&r, mr, NCONT);
+        TEST_ASSERT_TRUE(ucal_RdnSetUnion(&r, &a, &b));
+        for (d = 0; d < REF_DAYS; ++d) {
+            rr[d] = ra[d] || rb[d];
+        }
+        ref_Check(&r, rr);
+        TEST_ASSERT_TRUE(ucal_RdnSetIntersect(&r, &a, &b));
+        for (d = 0; d < REF_DAYS; ++d) {
+            rr[d] = ra[d] && rb[d];
+        }
+        ref_Check(&r, rr);
+        TEST_ASSERT_TRUE(ucal_RdnSetDifference(&r, &a, &b));
+        for (d = 0; d < REF_DAYS; ++d) {
+            rr[d] = ra[d] && !rb[d];
+        }
+        ref_Check(&r, rr);
+    }
+
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_RdnSetUnion(&a, &a, &b));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    ucal_RdnSetInit(&r, mr, 1);
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_RdnSetUnion(&r, &a, &b));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_Basic);
+    RUN_TEST(test_Random);
+    RUN_TEST(test_SetOps);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,180 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests and benchmark for re-zoning local time stamps
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzrezone.h"
+
+#include <unity.h>
+
+// pairs of old and new rules
+static const char * const ruleTab[][2] = {
+    { "CET-1CEST,M3.5.0,M10.5.0/3", "CET-1" },
+    { "CET-1", "CET-1CEST,M3.5.0,M10.5.0/3" },
+    { "EST5EDT,M4.1.0,M10.5.0", "EST5EDT,M3.2.0,M11.1.0" },
+    { "NZST-12NZDT,M9.5.0,M4.1.0/3", "NZST-12NZDT,M9.4.0,M4.2.0/3" },
+    { "IST-1GMT0,M10.5.0,M3.5.0/1", "GMT0BST,M3.5.0/1,M10.5.0" },
+    { "MSK-4", "MSK-3" },
+    { "CET-1CEST,M3.5.0,M10.5.0/3", "CET-1CEST,M3.5.0,M10.5.0/3" }
+};
+
+#define NPAIRS (sizeof(ruleTab) / sizeof(ruleTab[0]))
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+static int64_t
+mkts(int16_t y, int16_t m, int16_t d)
+{
+    return ((int64_t)ucal_DateToRdnGD(y, m, d) - UCAL_rdnUNIX) * 86400;
+}
+
+static void
+mkzone(tziPosixZoneT *zone, const char *spec)
+{
+    const char *pret = tziFromPosixSpec(zone, spec, NULL);
+    TEST_ASSERT_MESSAGE((pret && !*pret), spec);
+}
+
+// the straight way: old local time to UTC (first occurrence in an overlap), then to the new
+// local time; gap times stay
+static int64_t
+rezone_ref(tziConvCtxT *cold, tziConvCtxT *cnew, int64_t loc)
+{
+    tziConvInfoT info;
+    int64_t      u, uB;
+
+    if (tziGetInfoLocal2Utc(&info, cold, loc, tziCvtHint_None)) {
+        u = loc + info.offs;
+    } else {
+        TEST_ASSERT_TRUE(tziGetInfoLocal2Utc(&info, cold, loc, tziCvtHint_HrA));
+        u = loc + info.offs;
+        TEST_ASSERT_TRUE(tziGetInfoLocal2Utc(&info, cold, loc, tziCvtHint_HrB));
+        uB = loc + info.offs;
+        if (u > uB) {
+            return loc;
+        }
+    }
+    TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&info, cnew, u));
+    return u + info.offs;
+}
+
+// -------------------------------------------------------------------------------------
+// intervals of a simple case
+static void
+test_Intervals(void)
+{
+    tziPosixZoneT zold, znew;
+    tziRezoneT    iv[4];
+    int64_t       tt[2];
+
+    mkzone(&zold, ruleTab[0][0]);
+    mkzone(&znew, ruleTab[0][1]);
+    TEST_ASSERT_EQUAL(3, tziRezoneIntervals(iv, 4, &zold, &znew, 2025, 2027));
+    TEST_ASSERT_TRUE(tziGetTransitions(tt, &zold, 2026));
+    TEST_ASSERT_EQUAL(tt[0], iv[1].utcLo);
+    TEST_ASSERT_EQUAL(tt[1], iv[1].utcHi);
+    TEST_ASSERT_EQUAL(mkts(2026, 3, 29) + 3 * 3600, iv[1].locLo);
+    TEST_ASSERT_EQUAL(mkts(2026, 10, 25) + 3 * 3600, iv[1].locHi);
+    TEST_ASSERT_EQUAL(7200, iv[1].offsOld);
+    TEST_ASSERT_EQUAL(3600, iv[1].offsNew);
+    TEST_ASSERT_FALSE(tziGetTransitions(tt, &znew, 2026));
+
+    // fewer slots than intervals: the count is still right
+    TEST_ASSERT_EQUAL(3, tziRezoneIntervals(iv, 1, &zold, &znew, 2025, 2027));
+    TEST_ASSERT_EQUAL(mkts(2025, 3, 30) + 3600, iv[0].utcLo);
+    TEST_ASSERT_EQUAL(0, tziRezoneIntervals(NULL, 0, &zold, &zold, 2025, 2027));
+
+    // the fixed zones differ all the time
+    mkzone(&zold, ruleTab[5][0]);
+    mkzone(&znew, ruleTab[5][1]);
+    TEST_ASSERT_EQUAL(1, tziRezoneIntervals(iv, 4, &zold, &znew, 2025, 2027));
+    TEST_ASSERT_EQUAL(mkts(2025, 1, 1), iv[0].utcLo);
+    TEST_ASSERT_EQUAL(mkts(2028, 1, 1), iv[0].utcHi);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL(0, tziRezoneIntervals(iv, 4, &zold, &znew, 2027, 2025));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+}
+
+// -------------------------------------------------------------------------------------
+// columns in 10 minute steps against the straight conversion, for all pairs
+
+#define NCOL (4 * 366 * 144)
+
+static void
+test_Column(void)
+{
+    int64_t      *col = malloc(NCOL * sizeof(*col));
+    int64_t      *ref = malloc(NCOL * sizeof(*ref));
+    tziRezoneT    iv[64];
+    tziPosixZoneT zold, znew;
+    tziConvCtxT   cold, cnew;
+    size_t        pi, idx, n, niv, nchg;
+
+    TEST_ASSERT_TRUE(col && ref);
+    for (pi = 0; pi < NPAIRS; ++pi) {
+        mkzone(&zold, ruleTab[pi][0]);
+        mkzone(&znew, ruleTab[pi][1]);
+        memset(&cold, 0, sizeof(cold));
+        memset(&cnew, 0, sizeof(cnew));
+        cold.pTZI = &zold;
+        cnew.pTZI = &znew;
+
+        n    = 0;
+        nchg = 0;
+        for (int64_t loc = mkts(2024, 1, 1); loc < mkts(2028, 1, 1); loc += 600) {
+            col[n] = loc;
+            ref[n] = rezone_ref(&cold, &cnew, loc);
+            nchg  += (ref[n] != loc);
+            ++n;
+        }
+        niv = tziRezoneIntervals(iv, 64, &zold, &znew, 2023, 2028);
+        TEST_ASSERT_TRUE(niv <= 64);
+        TEST_ASSERT_EQUAL_MESSAGE(nchg, tziRezoneColumn(col, n, iv, niv), ruleTab[pi][0]);
+        for (idx = 0; idx < n; ++idx) {
+            TEST_ASSERT_EQUAL_MESSAGE(ref[idx], col[idx], ruleTab[pi][0]);
+        }
+    }
+    free(col);
+    free(ref);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_Intervals);
+    RUN_TEST(test_Column);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,403 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for radio / time code frame decoding
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/rtcdecode.h"
+
+#include <unity.h>
+
+void
+setUp(void)
+{
+    // NOP
+}
+
+void
+tearDown(void)
+{
+    // NOP
+}
+
+// -------------------------------------------------------------------------------------
+// frame encoders (the inverse of the decoders, written the naive way)
+
+static uint64_t
+put_lsbf(uint64_t f, unsigned pos, unsigned n, unsigned v)
+{
+    while (n--) {
+        f |= (uint64_t)(v & 1u) << pos++;
+        v >>= 1;
+    }
+    return f;
+}
+
+static uint64_t
+put_msbf(uint64_t f, unsigned pos, unsigned n, unsigned v)
+{
+    while (n--) {
+        f |= (uint64_t)((v >> n) & 1u) << pos++;
+    }
+    return f;
+}
+
+static unsigned
+popcnt(uint64_t v)
+{
+    unsigned n = 0;
+    for ( ; v; v &= v - 1) {
+        ++n;
+    }
+    return n;
+}
+
+static uint64_t
+enc_dcf77(const ucal_CivilDateT *cd, int hh, int mm, bool dst)
+{
+    uint64_t f = 0;
+    f = put_lsbf(f, 17, 2, dst ? 1 : 2);
+    f = put_lsbf(f, 20, 1, 1);
+    f = put_lsbf(f, 21, 4, mm % 10);
+    f = put_lsbf(f, 25, 3, mm / 10);
+    f = put_lsbf(f, 28, 1, popcnt(f & (UINT64_C(0x7F) << 21)) & 1);
+    f = put_lsbf(f, 29, 4, hh % 10);
+    f = put_lsbf(f, 33, 2, hh / 10);
+    f = put_lsbf(f, 35, 1, popcnt(f & (UINT64_C(0x3F) << 29)) & 1);
+    f = put_lsbf(f, 36, 4, cd->dMDay % 10);
+    f = put_lsbf(f, 40, 2, cd->dMDay / 10);
+    f = put_lsbf(f, 42, 3, cd->dWDay);
+    f = put_lsbf(f, 45, 4, cd->dMonth % 10);
+    f = put_lsbf(f, 49, 1, cd->dMonth / 10);
+    f = put_lsbf(f, 50, 4, (cd->dYear % 100) % 10);
+    f = put_lsbf(f, 54, 4, (cd->dYear % 100) / 10);
+    f = put_lsbf(f, 58, 1, popcnt(f & (UINT64_C(0x3FFFFF) << 36)) & 1);
+    return f;
+}
+
+static void
+enc_msf(uint64_t ab[2], const ucal_CivilDateT *cd, int hh, int mm, bool bst)
+{
+    uint64_t a = 0, b = 0;
+    a = put_msbf(a, 17, 4, (cd->dYear % 100) / 10);
+    a = put_msbf(a, 21, 4, (cd->dYear % 100) % 10);
+    a = put_msbf(a, 25, 1, cd->dMonth / 10);
+    a = put_msbf(a, 26, 4, cd->dMonth % 10);
+    a = put_msbf(a, 30, 2, cd->dMDay / 10);
+    a = put_msbf(a, 32, 4, cd->dMDay % 10);
+    a = put_msbf(a, 36, 3, cd->dWDay % 7);
+    a = put_msbf(a, 39, 2, hh / 10);
+    a = put_msbf(a, 41, 4, hh % 10);
+    a = put_msbf(a, 45, 3, mm / 10);
+    a = put_msbf(a, 48, 4, mm % 10);
+    a = put_msbf(a, 52, 8, 0x7E);
+    b = put_lsbf(b, 54, 1, !(popcnt(a & (UINT64_C(0xFF)   << 17)) & 1));
+    b = put_lsbf(b, 55, 1, !(popcnt(a & (UINT64_C(0x7FF)  << 25)) & 1));
+    b = put_lsbf(b, 56, 1, !(popcnt(a & (UINT64_C(0x7)    << 36)) & 1));
+    b = put_lsbf(b, 57, 1, !(popcnt(a & (UINT64_C(0x1FFF) << 39)) & 1));
+    b = put_lsbf(b, 58, 1, bst);
+    ab[0] = a;
+    ab[1] = b;
+}
+
+static uint64_t
+enc_wwvb(const ucal_CivilDateT *cd, int hh, int mm)
+{
+    uint64_t f = 0;
+    f = put_msbf(f,  1, 3, mm / 10);
+    f = put_msbf(f,  5, 4, mm % 10);
+    f = put_msbf(f, 12, 2, hh / 10);
+    f = put_msbf(f, 15, 4, hh % 10);
+    f = put_msbf(f, 22, 2, cd->dYDay / 100);
+    f = put_msbf(f, 25, 4, (cd->dYDay / 10) % 10);
+    f = put_msbf(f, 30, 4, cd->dYDay % 10);
+    f = put_msbf(f, 45, 4, (cd->dYear % 100) / 10);
+    f = put_msbf(f, 50, 4, (cd->dYear % 100) % 10);
+    f = put_msbf(f, 55, 1, cd->fLeap != 0);
+    return f;
+}
+
+static void
+enc_irig(uint64_t f[2], const ucal_CivilDateT *cd, int hh, int mm, int ss, int offsh)
+{
+    f[0] = f[1] = 0;
+    f[0] = put_lsbf(f[0],  1, 4, ss % 10);
+    f[0] = put_lsbf(f[0],  6, 3, ss / 10);
+    f[0] = put_lsbf(f[0], 10, 4, mm % 10);
+    f[0] = put_lsbf(f[0], 15, 3, mm / 10);
+    f[0] = put_lsbf(f[0], 20, 4, hh % 10);
+    f[0] = put_lsbf(f[0], 25, 2, hh / 10);
+    f[0] = put_lsbf(f[0], 30, 4, cd->dYDay % 10);
+    f[0] = put_lsbf(f[0], 35, 4, (cd->dYDay / 10) % 10);
+    f[0] = put_lsbf(f[0], 40, 2, cd->dYDay / 100);
+    f[0] = put_lsbf(f[0], 50, 4, (cd->dYear % 100) % 10);
+    f[0] = put_lsbf(f[0], 55, 4, (cd->dYear % 100) / 10);
+    f[1] = put_lsbf(f[1], 0, 1, offsh < 0);
+    f[1] = put_lsbf(f[1], 1, 4, (unsigned)abs(offsh));
+}
+
+// -------------------------------------------------------------------------------------
+
+static void
+test_DCF77(void)
+{
+    ucal_RtcDecoderT dec;
+    ucal_RtcTimeT    rt;
+    ucal_CivilDateT  cd;
+
+    ucal_RtcDecoderInit(&dec, 2000);
+
+    // 2025-03-30T03:00 CEST, first minute of summer time
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2025, 3, 30));
+    uint64_t f = enc_dcf77(&cd, 3, 0, true);
+    TEST_ASSERT_TRUE(ucal_RtcDecodeDCF77(&rt, &dec, f));
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2025, 3, 30), rt.rdn);
+    TEST_ASSERT_EQUAL(3 * 3600, rt.tod);
+    TEST_ASSERT_EQUAL(120, rt.offs);
+    TEST_ASSERT_EQUAL(ucal_RtcFlag_DST, rt.flags);
+    TEST_ASSERT_EQUAL(1743296400, (long long)rt.tsUtc);
+
+    // any single bit error in the parity-protected region must be detected
+    for (unsigned bit = 21; bit < 59; ++bit) {
+        TEST_ASSERT_FALSE(ucal_RtcDecodeDCF77(&rt, &dec, f ^ (UINT64_C(1) << bit)));
+    }
+    // as must a broken start-of-time bit or both zone bits
+    TEST_ASSERT_FALSE(ucal_RtcDecodeDCF77(&rt, &dec, f ^ (UINT64_C(1) << 20)));
+    TEST_ASSERT_FALSE(ucal_RtcDecodeDCF77(&rt, &dec, f | (UINT64_C(3) << 17)));
+}
+
+static void
+test_Century(void)
+{
+    ucal_RtcDecoderT dec;
+    ucal_RtcTimeT    rt;
+    ucal_CivilDateT  cd;
+
+    // The weekday pins the century in a 400 year window...
+    for (int y = 1900; y < 2300; y += 37) {
+        ucal_RtcDecoderInit(&dec, 1900);
+        ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(y, 7, 14));
+        TEST_ASSERT_TRUE(ucal_RtcDecodeDCF77(&rt, &dec, enc_dcf77(&cd, 12, 0, true)));
+        TEST_ASSERT_EQUAL(ucal_DateToRdnGD(y, 7, 14), rt.rdn);
+    }
+
+    // ...but a cached year follows the stream across a century boundary.
+    ucal_RtcDecoderInit(&dec, 2000);
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2099, 12, 31));
+    TEST_ASSERT_TRUE(ucal_RtcDecodeWWVB(&rt, &dec, enc_wwvb(&cd, 23, 59)));
+    TEST_ASSERT_EQUAL(2099, dec.yFull);
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2100, 1, 1));
+    TEST_ASSERT_TRUE(ucal_RtcDecodeWWVB(&rt, &dec, enc_wwvb(&cd, 0, 0)));
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2100, 1, 1), rt.rdn);
+
+    // A date in a century has only four possible weekdays; the other three are rejected.
+    int nOk = 0, nErr = 0;
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2024, 2, 29));
+    for (int wd = 1; wd <= 7; ++wd) {
+        ucal_RtcDecoderInit(&dec, 2000);
+        cd.dWDay = wd;
+        errno = 0;
+        if (ucal_RtcDecodeDCF77(&rt, &dec, enc_dcf77(&cd, 0, 0, false))) {
+            ++nOk;
+        } else {
+            TEST_ASSERT_EQUAL(EINVAL, errno);
+            ++nErr;
+        }
+    }
+    TEST_ASSERT_EQUAL(4, nOk);
+    TEST_ASSERT_EQUAL(3, nErr);
+}
+
+// A rejected frame must leave the year cache alone.
+static void
+test_Rejected(void)
+{
+    ucal_RtcDecoderT dec, keep;
+    ucal_RtcTimeT    rt;
+    ucal_CivilDateT  cd;
+    int              nErr = 0;
+
+    ucal_RtcDecoderInit(&dec, 2000);
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2099, 12, 31));
+    TEST_ASSERT_TRUE(ucal_RtcDecodeWWVB(&rt, &dec, enc_wwvb(&cd, 23, 59)));
+    keep = dec;
+
+    // WWVB: day 366 of 2100, which is no leap year, and a wrong leap year indicator
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2100, 12, 31));
+    cd.dYDay = 366;
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_RtcDecodeWWVB(&rt, &dec, enc_wwvb(&cd, 0, 0)));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_EQUAL_MEMORY(&keep, &dec, sizeof(dec));
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2100, 1, 1));
+    cd.fLeap = !cd.fLeap;
+    TEST_ASSERT_FALSE(ucal_RtcDecodeWWVB(&rt, &dec, enc_wwvb(&cd, 0, 0)));
+    TEST_ASSERT_EQUAL_MEMORY(&keep, &dec, sizeof(dec));
+
+    // DCF77: the year after the cached one, with the weekdays no year of the window has
+    for (int wd = 1; wd <= 7; ++wd) {
+        dec = keep;
+        ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2100, 1, 1));
+        cd.dWDay = wd;
+        if (!ucal_RtcDecodeDCF77(&rt, &dec, enc_dcf77(&cd, 1, 0, false))) {
+            TEST_ASSERT_EQUAL_MEMORY(&keep, &dec, sizeof(dec));
+            ++nErr;
+        }
+    }
+    TEST_ASSERT_EQUAL(3, nErr);
+
+    // and the stream goes on
+    dec = keep;
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2100, 1, 1));
+    TEST_ASSERT_TRUE(ucal_RtcDecodeWWVB(&rt, &dec, enc_wwvb(&cd, 0, 0)));
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2100, 1, 1), rt.rdn);
+    TEST_ASSERT_EQUAL(2100, dec.yFull);
+}
+
+static void
+test_MSF(void)
+{
+    ucal_RtcDecoderT dec;
+    ucal_RtcTimeT    rt;
+    ucal_CivilDateT  cd;
+    uint64_t         ab[2];
+
+    ucal_RtcDecoderInit(&dec, 2000);
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2025, 6, 1));   // a Sunday
+    enc_msf(ab, &cd, 14, 30, true);
+    TEST_ASSERT_TRUE(ucal_RtcDecodeMSF(&rt, &dec, ab[0], ab[1]));
+    TEST_ASSERT_EQUAL(ucal_DateToRdnGD(2025, 6, 1), rt.rdn);
+    TEST_ASSERT_EQUAL(60, rt.offs);
+    TEST_ASSERT_EQUAL(((time_t)ucal_DateToRdnGD(2025, 6, 1) - UCAL_rdnUNIX) * 86400 + 13 * 3600
+                      + 1800, rt.tsUtc);
+    for (unsigned bit = 17; bit < 52; ++bit) {
+        TEST_ASSERT_FALSE(ucal_RtcDecodeMSF(&rt, &dec, ab[0] ^ (UINT64_C(1) << bit), ab[1]));
+    }
+}
+
+static void
+test_IRIGB(void)
+{
+    ucal_RtcDecoderT dec;
+    ucal_RtcTimeT    rt;
+    ucal_CivilDateT  cd;
+    uint64_t         f[2];
+
+    ucal_RtcDecoderInit(&dec, 2000);
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2024, 12, 31));
+    enc_irig(f, &cd, 23, 59, 60, -5);
+    TEST_ASSERT_TRUE(ucal_RtcDecodeIRIGB(&rt, &dec, f, false));
+    TEST_ASSERT_EQUAL(366, rt.rdn - ucal_YearStartGD(2024) + 1);
+    TEST_ASSERT_EQUAL(86400, rt.tod);
+    TEST_ASSERT_EQUAL(0, rt.offs);
+
+    // IEEE 1344: IRIG time plus offset is UTC
+    TEST_ASSERT_TRUE(ucal_RtcDecodeIRIGB(&rt, &dec, f, true));
+    TEST_ASSERT_EQUAL(300, rt.offs);
+
+    // day 366 in a regular year is invalid
+    ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2025, 12, 31));
+    cd.dYDay = 366;
+    enc_irig(f, &cd, 0, 0, 0, 0);
+    TEST_ASSERT_FALSE(ucal_RtcDecodeIRIGB(&rt, &dec, f, false));
+
+    // valid BCD digits, but no day of any year
+    cd.dYDay = 370;
+    enc_irig(f, &cd, 0, 0, 0, 0);
+    TEST_ASSERT_FALSE(ucal_RtcDecodeIRIGB(&rt, &dec, f, false));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    cd.dYDay = 0;
+    enc_irig(f, &cd, 0, 0, 0, 0);
+    TEST_ASSERT_FALSE(ucal_RtcDecodeIRIGB(&rt, &dec, f, false));
+}
+
+// -------------------------------------------------------------------------------------
+// Replay: a stream of DCF77 and WWVB frames (one per minute over roughly two years),
+// decoded with a persistent and with a fresh decoder per frame.
+
+#define NFRAMES (2 * 366 * 1440)
+
+static uint64_t *s_dcf;
+static uint64_t *s_wwvb;
+static time_t    s_tbase;
+
+static void
+mk_streams(void)
+{
+    ucal_CivilDateT cd;
+    s_dcf  = malloc(NFRAMES * sizeof(uint64_t));
+    s_wwvb = malloc(NFRAMES * sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(s_dcf);
+    TEST_ASSERT_NOT_NULL(s_wwvb);
+    s_tbase = ((time_t)ucal_DateToRdnGD(2024, 1, 1) - UCAL_rdnUNIX) * 86400;
+    for (int32_t i = 0; i < NFRAMES; ++i) {
+        ucal_RdnToDateGD(&cd, ucal_DateToRdnGD(2024, 1, 1) + i / 1440);
+        s_dcf[i]  = enc_dcf77(&cd, (i / 60) % 24, i % 60, false);
+        s_wwvb[i] = enc_wwvb(&cd, (i / 60) % 24, i % 60);
+    }
+}
+
+static void
+replay(bool isDCF, bool keepState)
+{
+    ucal_RtcDecoderT dec;
+    ucal_RtcTimeT    rt;
+
+    ucal_RtcDecoderInit(&dec, 2000);
+    for (int32_t i = 0; i < NFRAMES; ++i) {
+        if (!keepState) {
+            ucal_RtcDecoderInit(&dec, 2000);
+        }
+        bool ok = isDCF ? ucal_RtcDecodeDCF77(&rt, &dec, s_dcf[i])
+                        : ucal_RtcDecodeWWVB(&rt, &dec, s_wwvb[i]);
+        TEST_ASSERT_TRUE(ok);
+        TEST_ASSERT_EQUAL(s_tbase + (time_t)i * 60 - (isDCF ? 3600 : 0), rt.tsUtc);
+    }
+}
+
+static void
+test_Replay(void)
+{
+    mk_streams();
+    replay(true,  true);
+    replay(true,  false);
+    replay(false, true);
+    replay(false, false);
+    free(s_dcf);
+    free(s_wwvb);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_DCF77);
+    RUN_TEST(test_Century);
+    RUN_TEST(test_Rejected);
+    RUN_TEST(test_MSF);
+    RUN_TEST(test_IRIGB);
+    RUN_TEST(test_Replay);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
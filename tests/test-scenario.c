@@ -0,0 +1,507 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// scenario benchmarks: whole request paths on synthetic but realistic input
+// ----------------------------------------------------------------------------------------------
+
+// Each scenario processes units of work the way a service would: an NTP packet, a
+// certificate chain, a log line, a second of power quality samples.  The units run twice:
+// once in a tight loop for the throughput, once with a clock read around each unit for the
+// latency distribution.  The clock overhead is measured and taken off the latencies.
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/clockmap.h"
+#include "ucal/ntpdate.h"
+#include "ucal/tzposix.h"
+#include "ucal/tsdecode.h"
+
+#include <unity.h>
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+#define NSEC 1000000000
+
+// ----------------------------------------------------------------------------------------------
+// driver
+
+#define NUNIT_MAX 262144
+
+static uint32_t s_lat[NUNIT_MAX];
+
+typedef unsigned (*scn_UnitFn)(size_t idx);
+
+static inline int64_t
+scn_Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ucal_TimespecToNs(&ts);
+}
+
+static int
+scn_Cmp(
+    const void *a,
+    const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+// median cost of reading the clock twice
+static int64_t
+scn_ClockCost(void)
+{
+    size_t idx;
+
+    for (idx = 0; idx < 4096; ++idx) {
+        int64_t t0 = scn_Now();
+        s_lat[idx] = (uint32_t)(scn_Now() - t0);
+    }
+    qsort(s_lat, 4096, sizeof(s_lat[0]), scn_Cmp);
+    return s_lat[2048];
+}
+
+// run the units, report, and return the sum of the unit results of the first pass
+static unsigned long
+scn_Run(
+    const char *name,
+    const char *unit,
+    scn_UnitFn  fn  ,
+    size_t      n   )
+{
+    int64_t       cost = scn_ClockCost();
+    int64_t       t0, t1;
+    unsigned long sum = 0;
+    size_t        idx;
+
+    TEST_ASSERT_TRUE(n <= NUNIT_MAX);
+    t0 = scn_Now();
+    for (idx = 0; idx < n; ++idx) {
+        sum += fn(idx);
+    }
+    t1 = scn_Now();
+
+    for (idx = 0; idx < n; ++idx) {
+        int64_t u0 = scn_Now();
+        (void)fn(idx);
+        u0 = scn_Now() - u0 - cost;
+        s_lat[idx] = (uint32_t)((u0 > 0) ? u0 : 0);
+    }
+    qsort(s_lat, n, sizeof(s_lat[0]), scn_Cmp);
+
+    printf("%-18s %7u %-7s %10.0f %s/s  p50 %6u ns  p99 %6u ns  max %7u ns\n",
+           name, (unsigned)n, unit, (double)n * NSEC / (double)(t1 - t0), unit,
+           (unsigned)s_lat[n / 2], (unsigned)s_lat[n - n / 100 - 1], (unsigned)s_lat[n - 1]);
+    return sum;
+}
+
+// two digits, the way a formatter does it
+static inline char *
+scn_Put2(
+    char    *p,
+    unsigned v)
+{
+    p[0] = (char)('0' + v / 10);
+    p[1] = (char)('0' + v % 10);
+    return p + 2;
+}
+
+// a cheap generator, so the inputs do not depend on the C library
+static uint32_t s_rng;
+
+static uint32_t
+scn_Rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// ----------------------------------------------------------------------------------------------
+// NTP server: per request packet, expand the client's transmit time stamp for the rate and
+// sanity checks, and stamp receive and transmit time of the reply
+
+#define NPKT 200000
+
+typedef struct {
+    uint32_t xmtSec, xmtFrac;   // client transmit time, NTP format
+    int64_t  rxNs;              // server clock at arrival
+} scn_PktT;
+
+static scn_PktT s_pkt[NPKT];
+static uint32_t s_reply[4];     // receive and transmit time stamps of the reply
+
+static void
+scn_PktInit(void)
+{
+    int64_t base = ((int64_t)ucal_DateToRdnGD(2025, 6, 1) - UCAL_rdnUNIX) * 86400 * NSEC;
+    size_t  idx;
+
+    s_rng = 123;
+    for (idx = 0; idx < NPKT; ++idx) {
+        int64_t rx  = base + (int64_t)idx * 50000 + scn_Rand() % 20000;
+        int64_t clk = rx - 2000000;                         // 2ms on the way
+        uint32_t r  = scn_Rand() % 1000;
+        if (r < 900) {
+            clk += (int64_t)(scn_Rand() % 100000000) - 50000000;     // +/-50ms off
+        } else if (r < 990) {
+            clk += ((int64_t)(scn_Rand() % 20000) - 10000) * NSEC;   // hours off
+        } else if (r < 999) {
+            clk -= (int64_t)(scn_Rand() % 9000) * 86400 * NSEC;      // days back, bad battery
+        } else {
+            clk = 0;                                                 // 1900 (unset)
+        }
+        s_pkt[idx].rxNs = rx;
+        if (clk) {
+            s_pkt[idx].xmtSec = ucal_NsToNtp(&s_pkt[idx].xmtFrac, clk);
+        } else {
+            s_pkt[idx].xmtSec  = 0;
+            s_pkt[idx].xmtFrac = 0;
+        }
+    }
+}
+
+static unsigned
+scn_Ntp(
+    size_t idx)
+{
+    scn_PktT const *p = &s_pkt[idx];
+    int64_t         offs;
+
+    offs = p->rxNs - ucal_NtpToNs(p->xmtSec, p->xmtFrac, &p->rxNs);
+    s_reply[0] = ucal_NsToNtp(&s_reply[1], p->rxNs);
+    s_reply[2] = ucal_NsToNtp(&s_reply[3], p->rxNs + 15000);
+    // clients more than 1000s off get a kiss-o'-death instead of the time
+    return (offs > -1000 * (int64_t)NSEC) && (offs < 1000 * (int64_t)NSEC);
+}
+
+static void
+test_Ntp(void)
+{
+    unsigned long good;
+
+    scn_PktInit();
+    good = scn_Run("NTP server", "packets", scn_Ntp, NPKT);
+    // 90% within 50ms, and some of the hours-off clocks
+    TEST_ASSERT_TRUE(good > NPKT * 90ul / 100);
+    TEST_ASSERT_TRUE(good < NPKT * 99ul / 100);
+}
+
+// ----------------------------------------------------------------------------------------------
+// X.509 chain validation: decode notBefore/notAfter of every certificate in a chain of 2 to 4
+// and check the validation time against them.  UTCTime up to 2049, GeneralizedTime after,
+// as RFC 5280 has it; so only long-lived roots have GeneralizedTime.
+
+#define NCHAIN 50000
+
+typedef struct {
+    uint8_t ncert;
+    bool    valid;
+    char    tv[4][2][16];   // not before / not after
+} scn_ChainT;
+
+static scn_ChainT s_chain[NCHAIN];
+static int64_t    s_vtime;
+
+static void
+scn_FmtAsn1(
+    char   *buf,
+    int64_t t  )
+{
+    ucal_CivilDateT cd;
+    ucal_CivilTimeT ct;
+
+    ucal_NsToCivilGD(&cd, &ct, NULL, t * NSEC);
+    if (cd.dYear >= 2050) {
+        buf = scn_Put2(buf, (unsigned)cd.dYear / 100);
+    }
+    buf = scn_Put2(buf, (unsigned)cd.dYear % 100);
+    buf = scn_Put2(buf, (unsigned)cd.dMonth);
+    buf = scn_Put2(buf, (unsigned)cd.dMDay);
+    buf = scn_Put2(buf, (unsigned)ct.tHour);
+    buf = scn_Put2(buf, (unsigned)ct.tMin);
+    buf = scn_Put2(buf, (unsigned)ct.tSec);
+    memcpy(buf, "Z", 2);
+}
+
+static void
+scn_ChainInit(void)
+{
+    // lifetime of leaf, intermediates and root
+    static const int32_t life[4] = { 90, 3 * 365, 5 * 365, 25 * 365 };
+    size_t idx;
+    int    c;
+
+    s_vtime = ((int64_t)ucal_DateToRdnGD(2025, 6, 1) - UCAL_rdnUNIX) * 86400;
+    s_rng   = 509;
+    for (idx = 0; idx < NCHAIN; ++idx) {
+        scn_ChainT *ch = &s_chain[idx];
+        uint32_t    r  = scn_Rand() % 10;
+        ch->ncert = (r < 1) ? 2 : (r < 8) ? 3 : 4;
+        ch->valid = true;
+        for (c = 0; c < ch->ncert; ++c) {
+            // the root is the last one, with the longest life
+            int32_t l   = life[(c == ch->ncert - 1) ? 3 : (c ? c : 0)];
+            int64_t nb  = s_vtime - (int64_t)(scn_Rand() % (uint32_t)(l * 86400 / 10 * 11));
+            int64_t na  = nb + (int64_t)l * 86400;
+            ch->valid = ch->valid && (nb <= s_vtime) && (s_vtime <= na);
+            scn_FmtAsn1(ch->tv[c][0], nb);
+            scn_FmtAsn1(ch->tv[c][1], na);
+        }
+    }
+}
+
+static bool
+scn_DecAsn1(
+    int64_t    *into,
+    const char *str )
+{
+    struct timespec ts;
+    const char     *p = str;
+    bool            ok;
+
+    if (13 == strlen(str)) {
+        ok = ucal_decASN1UtcTime23(&ts, &p, NULL, 1950);
+    } else {
+        ok = ucal_decASN1GenTime24(&ts, &p, NULL);
+    }
+    *into = ts.tv_sec;
+    return ok;
+}
+
+static unsigned
+scn_Chain(
+    size_t idx)
+{
+    scn_ChainT const *ch = &s_chain[idx];
+    int64_t           nb, na;
+    int               c;
+
+    for (c = 0; c < ch->ncert; ++c) {
+        if (!scn_DecAsn1(&nb, ch->tv[c][0]) || !scn_DecAsn1(&na, ch->tv[c][1])
+            || (s_vtime < nb) || (s_vtime > na)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void
+test_Chain(void)
+{
+    unsigned long valid, exp = 0;
+    size_t        idx;
+
+    scn_ChainInit();
+    for (idx = 0; idx < NCHAIN; ++idx) {
+        exp += s_chain[idx].valid;
+    }
+    valid = scn_Run("X.509 chains", "chains", scn_Chain, NCHAIN);
+    TEST_ASSERT_EQUAL(exp, valid);
+}
+
+// ----------------------------------------------------------------------------------------------
+// log ingestion: RFC 3339 stamps in UTC with milliseconds, a few events per millisecond at
+// busy times, over the end of DST in Berlin; decode, convert to local time and format as the
+// log viewer shows it
+
+#define NLINE 200000
+
+static char            s_line[NLINE][64];
+static char            s_out[80];
+static tziPosixZoneT   s_zone;
+static tziConvCtxT     s_ctx;
+static ucal_DecDetectT s_det;
+
+static void
+scn_LogInit(void)
+{
+    static const char *const path[4] = {
+        "GET /api/v1/items", "POST /api/v1/orders", "GET /health", "GET /static/app.js"
+    };
+    // ms, 02:00 local, an hour before the end of DST
+    int64_t t = ((int64_t)ucal_DateToRdnGD(2025, 10, 26) - UCAL_rdnUNIX) * 86400 * 1000;
+    size_t  idx;
+
+    s_rng = 77;
+    for (idx = 0; idx < NLINE; ++idx) {
+        ucal_CivilDateT cd;
+        ucal_CivilTimeT ct;
+        uint32_t        ns;
+
+        t += ((scn_Rand() & 7) ? scn_Rand() % 5 : scn_Rand() % 400);
+        ucal_NsToCivilGD(&cd, &ct, &ns, t * 1000000);
+        snprintf(s_line[idx], sizeof(s_line[idx]),
+                 "%04d-%02d-%02dT%02d:%02d:%02d.%03uZ %s %u", cd.dYear, cd.dMonth, cd.dMDay,
+                 ct.tHour, ct.tMin, ct.tSec, ns / 1000000, path[scn_Rand() & 3],
+                 200 + (scn_Rand() % 50 ? 0 : 300));
+    }
+
+    TEST_ASSERT_NOT_NULL(tziFromPosixSpec(&s_zone, "CET-1CEST,M3.5.0,M10.5.0/3", NULL));
+    memset(&s_ctx, 0, sizeof(s_ctx));
+    s_ctx.pTZI = &s_zone;
+    ucal_decDetectInit(&s_det, NULL, 1950);
+}
+
+static unsigned
+scn_Log(
+    size_t idx)
+{
+    const char     *line[1] = { s_line[idx] };
+    size_t          len = (size_t)((const char *)memchr(line[0], ' ', 64) - line[0]);
+    ucal_ns_t       ns;
+    tziConvInfoT    ci;
+    ucal_CivilDateT cd;
+    ucal_CivilTimeT ct;
+    uint32_t        nsec;
+    char           *p = s_out;
+
+    if ((1 != ucal_decColumnNs(&ns, &s_det, line, &len, 1))
+        || !tziGetInfoUtc2Local(&ci, &s_ctx, ucal_NsToSecs(ns).q)) {
+        return 0;
+    }
+    ucal_NsToCivilGD(&cd, &ct, &nsec, ns + (int64_t)ci.offs * NSEC);
+    p = scn_Put2(p, (unsigned)cd.dYear / 100);
+    p = scn_Put2(p, (unsigned)cd.dYear % 100);
+    *p++ = '-';
+    p = scn_Put2(p, cd.dMonth);
+    *p++ = '-';
+    p = scn_Put2(p, cd.dMDay);
+    *p++ = ' ';
+    p = scn_Put2(p, (unsigned)ct.tHour);
+    *p++ = ':';
+    p = scn_Put2(p, (unsigned)ct.tMin);
+    *p++ = ':';
+    p = scn_Put2(p, (unsigned)ct.tSec);
+    *p++ = '.';
+    p = scn_Put2(p, nsec / 10000000);
+    *p++ = (char)('0' + nsec / 1000000 % 10);
+    *p++ = ' ';
+    memcpy(p, ci.isDst ? "CEST" : "CET\0", 5);
+    return 1 + ci.isDst;
+}
+
+static void
+test_Log(void)
+{
+    unsigned long sum;
+    const char   *line[1];
+    size_t        len = 24;
+
+    scn_LogInit();
+    line[0] = s_line[0];
+    TEST_ASSERT_TRUE(ucal_decDetect(&s_det, line, &len, 1));
+    sum = scn_Run("log ingestion", "lines", scn_Log, NLINE);
+    // every line decoded; some of them before the end of DST, most after it
+    TEST_ASSERT_TRUE(sum > NLINE);
+    TEST_ASSERT_TRUE(sum < NLINE * 2);
+    TEST_ASSERT_EQUAL(0, s_det.nslow);
+    TEST_ASSERT_EQUAL(0, memcmp(s_out, "2025-10-26 ", 11));
+}
+
+// ----------------------------------------------------------------------------------------------
+// power quality aggregation: 10-cycle values of a 50Hz grid, five per second, over three days
+// around the start of DST; aggregated into 10 minute, 2 hour and daily intervals of local
+// time.  A unit is one second with its five values, stamped in milliseconds; the interval
+// bounds are only looked up when a value leaves the current interval, as an aggregator does.
+
+#define NSECS (3 * 86400)
+
+static const int32_t s_period[3] = { 600, 7200, 86400 };
+
+static int64_t  s_pqT0;
+static int64_t  s_pqLoHi[3][2];     // interval bounds in milliseconds
+static unsigned s_pqClosed[3];
+
+static unsigned
+scn_Pq(
+    size_t idx)
+{
+    unsigned n = 0;
+    int      s, p;
+
+    for (s = 0; s < 5; ++s) {
+        int64_t const ms = (s_pqT0 + (int64_t)idx) * 1000 + s * 200;
+        for (p = 0; p < 3; ++p) {
+            if ((ms < s_pqLoHi[p][0]) || (ms >= s_pqLoHi[p][1])) {
+                tziConvInfoT ci;
+                int64_t      lohi[2];
+                if (!tziAlignedLocalRange(lohi, &ci, &s_ctx, ms / 1000, s_period[p], 0)) {
+                    return 0;
+                }
+                s_pqLoHi[p][0] = lohi[0] * 1000;
+                s_pqLoHi[p][1] = lohi[1] * 1000;
+                ++s_pqClosed[p];
+                ++n;
+            }
+        }
+    }
+    return n;
+}
+
+static void
+test_Pq(void)
+{
+    TEST_ASSERT_NOT_NULL(tziFromPosixSpec(&s_zone, "CET-1CEST,M3.5.0,M10.5.0/3", NULL));
+    memset(&s_ctx, 0, sizeof(s_ctx));
+    s_ctx.pTZI = &s_zone;
+
+    // 2025-03-29T00:00 local
+    s_pqT0 = ((int64_t)ucal_DateToRdnGD(2025, 3, 29) - UCAL_rdnUNIX) * 86400 - 3600;
+    memset(s_pqLoHi, 0, sizeof(s_pqLoHi));
+    memset(s_pqClosed, 0, sizeof(s_pqClosed));
+    (void)scn_Run("PQ aggregation", "seconds", scn_Pq, NSECS);
+
+    // 72 hours from midnight, in both runs; ranges longer than an hour are cut at the switch,
+    // so the day and the 2 hour interval there come in two parts
+    TEST_ASSERT_EQUAL(2 * 432, s_pqClosed[0]);
+    TEST_ASSERT_EQUAL(2 * 37, s_pqClosed[1]);
+    TEST_ASSERT_EQUAL(2 * 5, s_pqClosed[2]);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_Ntp);
+    RUN_TEST(test_Chain);
+    RUN_TEST(test_Log);
+    RUN_TEST(test_Pq);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,354 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// test the system time zone tracker
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ucal/common.h"
+#include "ucal/tzposix.h"
+#include "ucal/syszone.h"
+
+#include <unity.h>
+
+static char s_dir[64];
+static char s_file[96];
+
+void setUp(void)
+{
+    strcpy(s_dir, "/tmp/ucal-syszone-XXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(s_dir));
+    snprintf(s_file, sizeof(s_file), "%s/localtime", s_dir);
+}
+
+void tearDown(void)
+{
+    char cmd[96];
+
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", s_dir);
+    TEST_ASSERT_EQUAL(0, system(cmd));
+}
+
+// write a TZif file with empty data blocks and a footer
+static void
+writeTZif(
+    const char *path,
+    const char *spec)
+{
+    char hdr[44];
+    int  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, "TZif2", 5);
+    TEST_ASSERT_EQUAL(44, write(fd, hdr, 44));
+    TEST_ASSERT_EQUAL(44, write(fd, hdr, 44));
+    TEST_ASSERT_EQUAL(1, write(fd, "\n", 1));
+    TEST_ASSERT_EQUAL(strlen(spec), write(fd, spec, strlen(spec)));
+    TEST_ASSERT_EQUAL(1, write(fd, "\n", 1));
+    TEST_ASSERT_EQUAL(0, close(fd));
+}
+
+// replace a file the way zone tools do: write a new one, rename it over the old one
+static void
+replaceTZif(
+    const char *path,
+    const char *spec)
+{
+    char tmp[128];
+
+    snprintf(tmp, sizeof(tmp), "%s.new", path);
+    writeTZif(tmp, spec);
+    TEST_ASSERT_EQUAL(0, rename(tmp, path));
+}
+
+static void
+assertSpec(
+    const char          *spec,
+    ucal_SysZoneT const *sz  )
+{
+    ucal_SysZoneSnapT snap;
+
+    ucal_SysZoneSnapshot(&snap, sz);
+    TEST_ASSERT_EQUAL_STRING(spec, snap.spec);
+}
+
+// offset of the zone seen by a reader, at 2025-07-01
+static int32_t
+readerOffs(
+    ucal_SysZoneCtxT *lc,
+    ucal_SysZoneT    *sz)
+{
+    tziConvInfoT ci;
+
+    TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&ci, ucal_SysZoneSync(lc, sz), 1751371200));
+    return ci.offs;
+}
+
+// ----------------------------------------------------------------------------------------------
+
+static void
+test_file(void)
+{
+    ucal_SysZoneT    sz;
+    ucal_SysZoneCtxT lc;
+
+    writeTZif(s_file, "CET-1CEST,M3.5.0,M10.5.0/3");
+    TEST_ASSERT_TRUE(ucal_SysZoneOpen(&sz, s_file, NULL));
+    TEST_ASSERT_EQUAL(1, ucal_SysZoneGeneration(&sz));
+    assertSpec("CET-1CEST,M3.5.0,M10.5.0/3", &sz);
+    memset(&lc, 0, sizeof(lc));
+    TEST_ASSERT_EQUAL(7200, readerOffs(&lc, &sz));
+    TEST_ASSERT_EQUAL(1, lc.gen);
+
+    // in place
+    writeTZif(s_file, "EST5EDT,M3.2.0,M11.1.0");
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(2, ucal_SysZoneGeneration(&sz));
+    TEST_ASSERT_EQUAL(-4 * 3600, readerOffs(&lc, &sz));
+
+    // renamed over, twice, to see the file watch follows
+    replaceTZif(s_file, "JST-9");
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(3, ucal_SysZoneGeneration(&sz));
+    TEST_ASSERT_EQUAL(9 * 3600, readerOffs(&lc, &sz));
+    replaceTZif(s_file, "<+0530>-5:30");
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(4, ucal_SysZoneGeneration(&sz));
+    writeTZif(s_file, "UTC0");
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(5, ucal_SysZoneGeneration(&sz));
+    TEST_ASSERT_EQUAL(0, readerOffs(&lc, &sz));
+
+    // same zone again, nothing to do
+    writeTZif(s_file, "UTC0");
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(5, ucal_SysZoneGeneration(&sz));
+
+    // gone: keep the zone until a new file shows up
+    TEST_ASSERT_EQUAL(0, unlink(s_file));
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(ENOENT, errno);
+    TEST_ASSERT_EQUAL(5, ucal_SysZoneGeneration(&sz));
+    writeTZif(s_file, "CET-1CEST,M3.5.0,M10.5.0/3");
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(6, ucal_SysZoneGeneration(&sz));
+    TEST_ASSERT_EQUAL(7200, readerOffs(&lc, &sz));
+
+    // no footer
+    replaceTZif(s_file, "");
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    assertSpec("CET-1CEST,M3.5.0,M10.5.0/3", &sz);
+
+    // nothing pending
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    TEST_ASSERT_EQUAL(6, ucal_SysZoneGeneration(&sz));
+    ucal_SysZoneClose(&sz);
+
+    // no file at all: UTC, and the file is picked up when it appears
+    TEST_ASSERT_EQUAL(0, unlink(s_file));
+    TEST_ASSERT_TRUE(ucal_SysZoneOpen(&sz, s_file, NULL));
+    assertSpec("UTC0", &sz);
+    replaceTZif(s_file, "JST-9");
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    assertSpec("JST-9", &sz);
+    ucal_SysZoneClose(&sz);
+}
+
+static void
+test_env(void)
+{
+    ucal_SysZoneT sz;
+    char          path[128];
+    char          *old = getenv("TZ");
+
+    old = old ? strdup(old) : NULL;
+    snprintf(path, sizeof(path), "%s/Zone", s_dir);
+    writeTZif(path, "EST5EDT,M3.2.0,M11.1.0");
+
+    TEST_ASSERT_EQUAL(0, setenv("TZ", "JST-9", 1));
+    TEST_ASSERT_TRUE(ucal_SysZoneOpen(&sz, NULL, s_dir));
+    assertSpec("JST-9", &sz);
+    TEST_ASSERT_EQUAL(-1, sz.wdFile);
+
+    // a zone name, relative to the zone directory
+    TEST_ASSERT_EQUAL(0, setenv("TZ", "Zone", 1));
+    TEST_ASSERT_TRUE(ucal_SysZoneReload(&sz));
+    assertSpec("EST5EDT,M3.2.0,M11.1.0", &sz);
+    TEST_ASSERT_EQUAL(2, ucal_SysZoneGeneration(&sz));
+
+    // ... which is watched now
+    writeTZif(path, "CET-1CEST,M3.5.0,M10.5.0/3");
+    TEST_ASSERT_TRUE(ucal_SysZoneUpdate(&sz));
+    assertSpec("CET-1CEST,M3.5.0,M10.5.0/3", &sz);
+
+    // empty is UTC; a colon makes it a file even if it would parse
+    TEST_ASSERT_EQUAL(0, setenv("TZ", "", 1));
+    TEST_ASSERT_TRUE(ucal_SysZoneReload(&sz));
+    assertSpec("UTC0", &sz);
+    TEST_ASSERT_EQUAL(0, setenv("TZ", ":UTC0", 1));
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_SysZoneReload(&sz));
+    TEST_ASSERT_EQUAL(ENOENT, errno);
+    assertSpec("UTC0", &sz);
+    TEST_ASSERT_EQUAL(0, setenv("TZ", path, 1));
+    TEST_ASSERT_TRUE(ucal_SysZoneReload(&sz));
+    assertSpec("CET-1CEST,M3.5.0,M10.5.0/3", &sz);
+
+    // a given zone stays until the next change
+    TEST_ASSERT_TRUE(ucal_SysZonePublish(&sz, "AAA-1BBB"));
+    assertSpec("AAA-1BBB", &sz);
+    errno = 0;
+    TEST_ASSERT_FALSE(ucal_SysZonePublish(&sz, "AAA-1BBB,"));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_TRUE(ucal_SysZoneReload(&sz));
+    assertSpec("CET-1CEST,M3.5.0,M10.5.0/3", &sz);
+    ucal_SysZoneClose(&sz);
+
+    if (old) {
+        setenv("TZ", old, 1);
+        free(old);
+    } else {
+        unsetenv("TZ");
+    }
+}
+
+static void
+test_thread(void)
+{
+    ucal_SysZoneT    sz;
+    ucal_SysZoneCtxT lc;
+    struct timespec  ts = { 0, 1000000 };
+    int              idx;
+
+    writeTZif(s_file, "UTC0");
+    TEST_ASSERT_TRUE(ucal_SysZoneOpen(&sz, s_file, NULL));
+    TEST_ASSERT_TRUE(ucal_SysZoneStart(&sz));
+    TEST_ASSERT_FALSE(ucal_SysZoneStart(&sz));
+    memset(&lc, 0, sizeof(lc));
+    TEST_ASSERT_EQUAL(0, readerOffs(&lc, &sz));
+
+    replaceTZif(s_file, "JST-9");
+    for (idx = 0; (idx < 5000) && (1 == ucal_SysZoneGeneration(&sz)); ++idx) {
+        nanosleep(&ts, NULL);
+    }
+    TEST_ASSERT_EQUAL(2, ucal_SysZoneGeneration(&sz));
+    TEST_ASSERT_EQUAL(9 * 3600, readerOffs(&lc, &sz));
+
+    ucal_SysZoneStop(&sz);
+    ucal_SysZoneClose(&sz);
+}
+
+// ----------------------------------------------------------------------------------------------
+// readers against a busy writer: every copy must be one of the published zones
+
+#define NREADER 3
+#define NPUBLISH 200000
+
+typedef struct {
+    ucal_SysZoneT *sz;
+    unsigned long  calls;
+    unsigned       seen;
+    bool           torn;
+} rdArgT;
+
+static bool s_done;
+
+static void*
+reader(void *arg)
+{
+    rdArgT * const   a = (rdArgT*)arg;
+    ucal_SysZoneCtxT lc;
+    uint32_t         gen = 0;
+
+    memset(&lc, 0, sizeof(lc));
+    while (!__atomic_load_n(&s_done, __ATOMIC_ACQUIRE)) {
+        tziConvCtxT *ctx = ucal_SysZoneSync(&lc, a->sz);
+        if (lc.gen != gen) {
+            gen = lc.gen;
+            ++a->seen;
+            // the zone names carry the offset
+            a->torn = a->torn || (ctx->pTZI != &lc.zone)
+                || (lc.zone.stdOffs != -60 * (lc.zone.stdName[1] - '0'))
+                || (lc.zone.dstOffs != -60 * (lc.zone.dstName[1] - '0'));
+        }
+        ++a->calls;
+    }
+    return NULL;
+}
+
+static void
+test_readers(void)
+{
+    static const char *const spec[2] = { "<A1>-1<B2>-2", "<A3>-3<B4>-4" };
+
+    ucal_SysZoneT    sz;
+    ucal_SysZoneCtxT lc;
+    pthread_t        thr[NREADER];
+    rdArgT           args[NREADER];
+    tziConvInfoT     ci;
+    int              idx;
+
+    TEST_ASSERT_TRUE(ucal_SysZoneOpen(&sz, s_file, NULL));
+    TEST_ASSERT_TRUE(ucal_SysZonePublish(&sz, spec[0]));
+
+    __atomic_store_n(&s_done, false, __ATOMIC_RELEASE);
+    for (idx = 0; idx < NREADER; ++idx) {
+        memset(&args[idx], 0, sizeof(args[idx]));
+        args[idx].sz = &sz;
+        TEST_ASSERT_EQUAL(0, pthread_create(&thr[idx], NULL, reader, &args[idx]));
+    }
+    for (idx = 1; idx <= NPUBLISH; ++idx) {
+        TEST_ASSERT_TRUE(ucal_SysZonePublish(&sz, spec[idx & 1]));
+    }
+    __atomic_store_n(&s_done, true, __ATOMIC_RELEASE);
+    for (idx = 0; idx < NREADER; ++idx) {
+        pthread_join(thr[idx], NULL);
+        TEST_ASSERT_FALSE(args[idx].torn);
+    }
+    TEST_ASSERT_EQUAL(NPUBLISH + 2, ucal_SysZoneGeneration(&sz));
+
+    // a fresh reader sees the last zone
+    memset(&lc, 0, sizeof(lc));
+    TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&ci, ucal_SysZoneSync(&lc, &sz), 1751371200));
+    TEST_ASSERT_EQUAL(2 * 3600, ci.offs);
+
+    ucal_SysZoneClose(&sz);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_file);
+    RUN_TEST(test_env);
+    RUN_TEST(test_thread);
+    RUN_TEST(test_readers);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
@@ -0,0 +1,450 @@
+// -*- mode: C; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for bulk time zone conversions
+// ----------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucal/common.h"
+#include "ucal/calconst.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzbatch.h"
+
+#include <unity.h>
+
+// a mix of northern, southern, negative-DST, odd-rule and fixed zones
+static const char * const zoneTab[] = {
+    "CET-1CEST,M3.5.0,M10.5.0/3", "EST5EDT,M3.2.0,M11.1.0", "AEST-10AEDT,M10.1.0,M4.1.0/3",
+    "NZST-12NZDT,M9.5.0,M4.1.0/3", "IST-1GMT0,M10.5.0,M3.5.0/1", "GMT0BST,M3.5.0/1,M10.5.0",
+    "EET-2EEST,M3.5.4/24,M10.5.5/1", "EET-2EEST,M3.5.5/0,M10.5.6/1", "CST6CDT,M4.1.0,M10.5.0",
+    "CST5CDT,M3.2.0/0,M11.1.0/1", "WET0WEST,M3.5.0/1,M10.5.0", "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",
+    "XST3XDT,J60/2,J300/2", "XST3XDT,59/2,299/2", "EST5EDT,0/0,J365/25", "<+0545>-5:45",
+    "JST-9", "<GMT+10>-10", "HST10", "ACST-9:30ACDT,M10.1.0,M4.1.0/3",
+    NULL
+};
+
+#define NZONES (sizeof(zoneTab) / sizeof(zoneTab[0]) - 1)
+
+static tziPosixZoneT s_zones[NZONES];
+
+void setUp(void)
+{
+    size_t idx;
+    for (idx = 0; idx < NZONES; ++idx) {
+        const char *pret = tziFromPosixSpec(&s_zones[idx], zoneTab[idx], NULL);
+        TEST_ASSERT_MESSAGE((pret && !*pret), zoneTab[idx]);
+    }
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+static int64_t
+mkts(int16_t y, int16_t m, int16_t d)
+{
+    return ((int64_t)ucal_DateToRdnGD(y, m, d) - UCAL_rdnUNIX) * 86400;
+}
+
+// -------------------------------------------------------------------------------------
+// compare against the single-zone conversion, in 15 minute steps over a few years
+static void
+test_FanOutVsSingle(void)
+{
+    tziZoneBlockT blocks[TZI_BLOCKS(NZONES)];
+    int32_t       offs[NZONES];
+    uint8_t       flags[NZONES];
+    tziConvCtxT   ctx[NZONES];
+    tziConvInfoT  info;
+    int64_t       ts;
+    size_t        idx;
+
+    memset(ctx, 0, sizeof(ctx));
+    for (idx = 0; idx < NZONES; ++idx) {
+        ctx[idx].pTZI = &s_zones[idx];
+    }
+    tziPackZones(blocks, s_zones, NZONES);
+
+    for (ts = mkts(2023, 1, 1); ts < mkts(2027, 1, 1); ts += 900) {
+        TEST_ASSERT_TRUE(tziFanOutUtc2Local(offs, flags, blocks, NZONES, ts));
+        for (idx = 0; idx < NZONES; ++idx) {
+            TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&info, &ctx[idx], ts));
+            TEST_ASSERT_EQUAL_MESSAGE(info.offs, offs[idx], zoneTab[idx]);
+            TEST_ASSERT_EQUAL_MESSAGE(info.isDst, !!(flags[idx] & tziFlag_DST), zoneTab[idx]);
+            TEST_ASSERT_EQUAL_MESSAGE(info.isHrA, !!(flags[idx] & tziFlag_HrA), zoneTab[idx]);
+            TEST_ASSERT_EQUAL_MESSAGE(info.isHrB, !!(flags[idx] & tziFlag_HrB), zoneTab[idx]);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------
+// partial blocks, no flags, errors
+static void
+test_FanOutEdges(void)
+{
+    tziZoneBlockT blocks[TZI_BLOCKS(NZONES)];
+    int32_t       offs[NZONES + 1];
+    int32_t       offsRef[NZONES];
+    uint8_t       flags[NZONES + 1];
+    int64_t       ts = mkts(2025, 7, 1);
+    size_t        cnt;
+
+    tziPackZones(blocks, s_zones, NZONES);
+    TEST_ASSERT_TRUE(tziFanOutUtc2Local(offsRef, NULL, blocks, NZONES, ts));
+    for (cnt = 0; cnt <= NZONES; ++cnt) {
+        offs[cnt]  = INT32_MIN;
+        flags[cnt] = 0xFF;
+        TEST_ASSERT_TRUE(tziFanOutUtc2Local(offs, flags, blocks, cnt, ts));
+        TEST_ASSERT_EQUAL(0, memcmp(offs, offsRef, cnt * sizeof(*offs)));
+        TEST_ASSERT_EQUAL(INT32_MIN, offs[cnt]);
+        TEST_ASSERT_EQUAL(0xFF, flags[cnt]);
+    }
+    // Berlin in summer, Sydney in winter:
+    TEST_ASSERT_EQUAL(7200, offsRef[0]);
+    TEST_ASSERT_EQUAL(36000, offsRef[2]);
+
+    errno = 0;
+    TEST_ASSERT_FALSE(tziFanOutUtc2Local(NULL, flags, blocks, NZONES, ts));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_FALSE(tziFanOutUtc2Local(offs, flags, blocks, NZONES, INT64_MAX));
+    TEST_ASSERT_EQUAL(ERANGE, errno);
+}
+
+// -------------------------------------------------------------------------------------
+// runs and mixed-zone records
+
+static uint32_t s_rnd = 12345;
+
+static uint32_t
+rnd(void)
+{
+    s_rnd = s_rnd * UINT32_C(1664525) + UINT32_C(1013904223);
+    return s_rnd >> 8;
+}
+
+static void
+check_one(tziPosixZoneT const *zone, int64_t ts, int32_t offs, uint8_t flags)
+{
+    tziConvCtxT  ctx;
+    tziConvInfoT info;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = zone;
+    TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&info, &ctx, ts));
+    TEST_ASSERT_EQUAL(info.offs, offs);
+    TEST_ASSERT_EQUAL(info.isDst, !!(flags & tziFlag_DST));
+    TEST_ASSERT_EQUAL(info.isHrA, !!(flags & tziFlag_HrA));
+    TEST_ASSERT_EQUAL(info.isHrB, !!(flags & tziFlag_HrB));
+}
+
+#define NRUN 20000
+
+static void
+test_BatchRun(void)
+{
+    static int64_t ts[NRUN];
+    static int32_t offs[NRUN];
+    static uint8_t flags[NRUN];
+    tziConvCtxT    ctx;
+    size_t         zi, idx;
+    int            mode;
+
+    for (zi = 0; zi < NZONES; ++zi) {
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.pTZI = &s_zones[zi];
+        for (mode = 0; mode < 3; ++mode) {
+            // ascending in 10 minute steps, descending, random
+            for (idx = 0; idx < NRUN; ++idx) {
+                switch (mode) {
+                case 0: ts[idx] = mkts(2024, 1, 1) + (int64_t)idx * 600; break;
+                case 1: ts[idx] = mkts(2025, 1, 1) - (int64_t)idx * 600; break;
+                default: ts[idx] = mkts(2020, 1, 1) + (int64_t)rnd() * 37; break;
+                }
+            }
+            TEST_ASSERT_TRUE(tziBatchUtc2Local(offs, flags, &ctx, ts, NRUN));
+            for (idx = 0; idx < NRUN; ++idx) {
+                check_one(&s_zones[zi], ts[idx], offs[idx], flags[idx]);
+            }
+        }
+    }
+}
+
+// time ordered records with random zones, like an event log
+static void
+mk_records(int64_t *ts, uint16_t *zid, size_t count, size_t nzones)
+{
+    size_t  idx;
+    int64_t t = mkts(2025, 3, 1);
+    for (idx = 0; idx < count; ++idx) {
+        t += rnd() % 120;
+        ts[idx]  = t;
+        zid[idx] = (uint16_t)(rnd() % nzones);
+    }
+}
+
+static void
+test_BatchByZone(void)
+{
+    static int64_t  ts[NRUN];
+    static uint16_t zid[NRUN];
+    static int32_t  offs[NRUN];
+    static uint8_t  flags[NRUN];
+    tziConvCtxT     ctx[NZONES];
+    void           *scratch;
+    size_t          idx;
+
+    memset(ctx, 0, sizeof(ctx));
+    for (idx = 0; idx < NZONES; ++idx) {
+        ctx[idx].pTZI = &s_zones[idx];
+    }
+    scratch = malloc(tziBatchScratchSize(NRUN, NZONES));
+    TEST_ASSERT_NOT_NULL(scratch);
+
+    mk_records(ts, zid, NRUN, NZONES);
+    TEST_ASSERT_TRUE(tziBatchUtc2LocalByZone(offs, flags, ts, zid, NRUN, ctx, NZONES, scratch));
+    for (idx = 0; idx < NRUN; ++idx) {
+        check_one(&s_zones[zid[idx]], ts[idx], offs[idx], flags[idx]);
+    }
+
+    // empty input is fine, bad zone ids are not
+    TEST_ASSERT_TRUE(tziBatchUtc2LocalByZone(offs, flags, ts, zid, 0, ctx, NZONES, scratch));
+    errno = 0;
+    TEST_ASSERT_FALSE(tziBatchUtc2LocalByZone(offs, flags, ts, zid, NRUN, ctx, 3, scratch));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    free(scratch);
+}
+
+// -------------------------------------------------------------------------------------
+// local time streams: an ascending UTC stream, shown in local time, must come back
+// unchanged; the overlap is resolved by monotonicity alone
+
+#define NSTREAM (4 * 366 * 288)
+
+static void
+test_StreamRun(void)
+{
+    int64_t     *utc   = malloc(NSTREAM * sizeof(*utc));
+    int64_t     *loc   = malloc(NSTREAM * sizeof(*loc));
+    int64_t     *back  = malloc(NSTREAM * sizeof(*back));
+    uint8_t     *fref  = malloc(NSTREAM * sizeof(*fref));
+    uint8_t     *flags = malloc(NSTREAM * sizeof(*flags));
+    tziConvCtxT  ctx;
+    tziConvInfoT info;
+    tziStreamT   strm;
+    size_t       idx, zi, n = 0;
+
+    TEST_ASSERT_TRUE(utc && loc && back && fref && flags);
+    for (zi = 0; zi < NZONES; ++zi) {
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.pTZI = &s_zones[zi];
+        n = 0;
+        for (int64_t ts = mkts(2023, 1, 1); ts < mkts(2027, 1, 1); ts += 300) {
+            TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&info, &ctx, ts));
+            utc[n]  = ts;
+            loc[n]  = ts + info.offs;
+            fref[n] = (uint8_t)((info.isDst ? tziFlag_DST : 0)
+                              | (info.isHrA ? tziFlag_HrA : 0)
+                              | (info.isHrB ? tziFlag_HrB : 0));
+            ++n;
+        }
+
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.pTZI = &s_zones[zi];
+        tziStreamInit(&strm, &ctx, INT64_MIN);
+        // in two parts, to see the state carried over
+        TEST_ASSERT_EQUAL(n / 3, tziStreamLocal2Utc(back, flags, &strm, loc, n / 3));
+        TEST_ASSERT_EQUAL(n - n / 3, tziStreamLocal2Utc(back + n / 3, flags + n / 3, &strm,
+                                                        loc + n / 3, n - n / 3));
+        for (idx = 0; idx < n; ++idx) {
+            TEST_ASSERT_EQUAL_MESSAGE(utc[idx], back[idx], zoneTab[zi]);
+            TEST_ASSERT_EQUAL_MESSAGE(fref[idx], flags[idx], zoneTab[zi]);
+        }
+    }
+
+    // in place, without flags
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &s_zones[NZONES - 1];
+    tziStreamInit(&strm, &ctx, INT64_MIN);
+    TEST_ASSERT_EQUAL(n, tziStreamLocal2Utc(loc, NULL, &strm, loc, n));
+    TEST_ASSERT_EQUAL_MEMORY(utc, loc, n * sizeof(*utc));
+
+    free(utc);
+    free(loc);
+    free(back);
+    free(fref);
+    free(flags);
+}
+
+// gaps, steps back and errors, in Berlin
+static void
+test_StreamEdges(void)
+{
+    int64_t     loc[4], utc[4];
+    uint8_t     flags[4];
+    tziConvCtxT ctx;
+    tziStreamT  strm;
+    int64_t     spring = mkts(2025, 3, 30), autumn = mkts(2025, 10, 26);
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &s_zones[0];
+    tziStreamInit(&strm, &ctx, INT64_MIN);
+
+    // 01:59 CET, 02:30 (does not exist), 03:00 CEST
+    loc[0] = spring + 7140;
+    loc[1] = spring + 9000;
+    loc[2] = spring + 10800;
+    TEST_ASSERT_EQUAL(3, tziStreamLocal2Utc(utc, flags, &strm, loc, 3));
+    TEST_ASSERT_EQUAL(spring + 3540, utc[0]);
+    TEST_ASSERT_EQUAL(0, flags[0]);
+    TEST_ASSERT_EQUAL(spring + 5400, utc[1]);
+    TEST_ASSERT_EQUAL(tziFlag_DST | tziFlag_Gap, flags[1]);
+    TEST_ASSERT_EQUAL(spring + 3600, utc[2]);
+    TEST_ASSERT_EQUAL(tziFlag_DST | tziFlag_Bck, flags[2]);
+
+    // 02:30 CEST, 02:30 again is CET, 02:15 after that is a step back
+    loc[0] = autumn + 9000;
+    loc[1] = autumn + 9000;
+    loc[2] = autumn + 8100;
+    loc[3] = autumn + 10800;
+    tziStreamInit(&strm, &ctx, INT64_MIN);
+    TEST_ASSERT_EQUAL(4, tziStreamLocal2Utc(utc, flags, &strm, loc, 4));
+    TEST_ASSERT_EQUAL(autumn + 1800, utc[0]);
+    TEST_ASSERT_EQUAL(tziFlag_DST | tziFlag_HrA, flags[0]);
+    TEST_ASSERT_EQUAL(autumn + 5400, utc[1]);
+    TEST_ASSERT_EQUAL(tziFlag_HrB, flags[1]);
+    TEST_ASSERT_EQUAL(autumn + 4500, utc[2]);
+    TEST_ASSERT_EQUAL(tziFlag_HrB | tziFlag_Bck, flags[2]);
+    TEST_ASSERT_EQUAL(autumn + 7200, utc[3]);
+    TEST_ASSERT_EQUAL(0, flags[3]);
+
+    // a known pivot decides the first overlap time, too
+    tziStreamInit(&strm, &ctx, autumn + 3600);
+    TEST_ASSERT_EQUAL(1, tziStreamLocal2Utc(utc, flags, &strm, loc, 1));
+    TEST_ASSERT_EQUAL(autumn + 5400, utc[0]);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL(0, tziStreamLocal2Utc(NULL, flags, &strm, loc, 1));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_EQUAL(0, tziStreamLocal2Utc(utc, flags, &strm, loc, 0));
+}
+
+// -------------------------------------------------------------------------------------
+// aligned windows in several resolutions against one tziAlignedLocalRange() call each
+
+static const tziWindowT s_win[] = {
+    { 600, 0 }, { 3600, 0 }, { 86400, 0 }, { 7200, 1800 }, { 7 * 86400, 3 * 86400 }, { 1, 0 }
+};
+
+static const tziWindowT s_bad[] = {
+    { 600, 0 }, { 8 * 86400, 0 }
+};
+
+#define NWIN  (sizeof(s_win) / sizeof(s_win[0]))
+#define NWRUN 6000
+
+static int64_t
+floordiv(int64_t a, int32_t b)
+{
+    return a / b - ((a % b) < 0);
+}
+
+static void
+test_Windows(void)
+{
+    static int64_t ts[NWRUN];
+    static int64_t tlohi[NWRUN * NWIN * 2];
+    static int64_t widx[NWRUN * NWIN];
+    tziConvCtxT    ctx, ref;
+    tziConvInfoT   info;
+    int64_t        rng[2], t0;
+    size_t         zi, idx, k;
+    int            mode;
+
+    for (zi = 0; zi < NZONES; ++zi) {
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.pTZI = &s_zones[zi];
+        ref = ctx;
+        for (mode = 0; mode < 4; ++mode) {
+            // ascending over both transitions of a year, around each transition, random
+            t0 = mkts(2025, (mode == 1) ? 3 : 9, 20);
+            for (idx = 0; idx < NWRUN; ++idx) {
+                switch (mode) {
+                case 0: ts[idx] = mkts(2025, 1, 1) + (int64_t)idx * 5293; break;
+                case 1:
+                case 2: ts[idx] = t0 + (int64_t)idx * 293; break;
+                default: ts[idx] = mkts(2020, 1, 1) + (int64_t)rnd() * 37; break;
+                }
+            }
+            TEST_ASSERT_TRUE(tziAlignedLocalRanges(tlohi, widx, &ctx, s_win, NWIN, ts, NWRUN));
+            for (idx = 0; idx < NWRUN; ++idx) {
+                for (k = 0; k < NWIN; ++k) {
+                    TEST_ASSERT_TRUE(tziAlignedLocalRange(rng, &info, &ref, ts[idx],
+                                                          s_win[k].period, s_win[k].phi));
+                    TEST_ASSERT_EQUAL_INT64(rng[0], tlohi[(idx * NWIN + k) * 2 + 0]);
+                    TEST_ASSERT_EQUAL_INT64(rng[1], tlohi[(idx * NWIN + k) * 2 + 1]);
+                    TEST_ASSERT_EQUAL_INT64(
+                        floordiv(ts[idx] + info.offs + s_win[k].phi, s_win[k].period),
+                        widx[idx * NWIN + k]);
+                }
+            }
+        }
+    }
+
+    // transition time stamps exactly, in CET
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &s_zones[0];
+    ref = ctx;
+    for (idx = 0; idx < 8; ++idx) {
+        ts[idx] = mkts(2025, 3, 30) + 3600 + (int64_t)idx - 4;
+    }
+    TEST_ASSERT_TRUE(tziAlignedLocalRanges(tlohi, NULL, &ctx, s_win, NWIN, ts, 8));
+    for (idx = 0; idx < 8; ++idx) {
+        for (k = 0; k < NWIN; ++k) {
+            TEST_ASSERT_TRUE(tziAlignedLocalRange(rng, &info, &ref, ts[idx],
+                                                  s_win[k].period, s_win[k].phi));
+            TEST_ASSERT_EQUAL_INT64(rng[0], tlohi[(idx * NWIN + k) * 2 + 0]);
+            TEST_ASSERT_EQUAL_INT64(rng[1], tlohi[(idx * NWIN + k) * 2 + 1]);
+        }
+    }
+
+    // bad resolutions
+    errno = 0;
+    TEST_ASSERT_FALSE(tziAlignedLocalRanges(tlohi, NULL, &ctx, s_bad, 2, ts, 1));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_FALSE(tziAlignedLocalRanges(tlohi, NULL, &ctx, s_win, TZI_MAX_WINDOWS + 1,
+                                            ts, 1));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_FanOutVsSingle);
+    RUN_TEST(test_FanOutEdges);
+    RUN_TEST(test_BatchRun);
+    RUN_TEST(test_BatchByZone);
+    RUN_TEST(test_StreamRun);
+    RUN_TEST(test_StreamEdges);
+    RUN_TEST(test_Windows);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
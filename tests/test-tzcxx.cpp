@@ -0,0 +1,187 @@
+// -*- mode: C++; c-file-style: "bsd"; c-basic-offset: 4; fill-column: 98; coding: utf-8-unix; -*-
+// ----------------------------------------------------------------------------------------------
+// µCal by J.Perlinger (perlinger@nwtime.org)
+//
+// To the extent possible under law, the person who associated CC0 with
+// µCal has waived all copyright and related or neighboring rights
+// to µCal.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+// ----------------------------------------------------------------------------------------------
+// µCal -- a small calendar component in C99
+// Written anno 2025 by J.Perlinger (perlinger@nwtime.org)
+//
+// unit tests for the compile-time POSIX time zone strings: the vectors of test-tzposix.c as
+// static assertions, and the C++ parser against the C one at run time
+// ----------------------------------------------------------------------------------------------
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "ucal/common.h"
+#include "ucal/gregorian.h"
+#include "ucal/tzposix.h"
+#include "ucal/tzposix.hpp"
+
+#include <unity.h>
+
+using namespace std::literals;
+
+// the zone descriptions of test_ParseZones() in test-tzposix.c
+static constexpr std::array zoneTab = {
+    "ACST-9"sv, "AEST-10"sv, "AEST-10AEDT,M10.1.0,M4.1.0/3"sv, "AKST9AKDT,M3.2.0,M11.1.0"sv,
+    "AST4"sv, "AST4ADT,M3.2.0,M11.1.0"sv, "AWST-8"sv, "CAT-2"sv, "CET-1"sv,
+    "CET-1CEST,M3.5.0,M10.5.0/3"sv, "CST5CDT,M3.2.0/0,M11.1.0/1"sv, "CST6"sv,
+    "CST6CDT,M3.2.0,M11.1.0"sv, "CST6CDT,M4.1.0,M10.5.0"sv, "CST-8"sv, "EAT-3"sv, "EET-2"sv,
+    "EET-2EEST,M3.5.0/0,M10.5.0/0"sv, "EET-2EEST,M3.5.0/3,M10.5.0/4"sv,
+    "EET-2EEST,M3.5.0,M10.5.0/3"sv, "EET-2EEST,M3.5.4/24,M10.5.5/1"sv,
+    "EET-2EEST,M3.5.5/0,M10.5.5/0"sv, "EET-2EEST,M3.5.5/0,M10.5.6/1"sv, "EST5"sv,
+    "EST5EDT,M3.2.0,M11.1.0"sv, "GMT0"sv, "GMT0BST,M3.5.0/1,M10.5.0"sv, "<GMT+10>-10"sv,
+    "<GMT-10>+10"sv, "<GMT+1>-1"sv, "<GMT-1>+1"sv, "<GMT+11>-11"sv, "<GMT-11>+11"sv,
+    "<GMT+12>-12"sv, "<GMT+13>-13"sv, "<GMT+14>-14"sv, "<GMT-2>+2"sv, "<GMT+3>-3"sv,
+    "<GMT-3>+3"sv, "<GMT+4>-4"sv, "<GMT-4>+4"sv, "<GMT+5>-5"sv, "<GMT-5>+5"sv, "<GMT+6>-6"sv,
+    "<GMT-6>+6"sv, "<GMT+7>-7"sv, "<GMT+8>-8"sv, "<GMT-8>+8"sv, "<GMT+9>-9"sv, "<GMT-9>+9"sv,
+    "HKT-8"sv, "HST10"sv, "HST10HDT,M3.2.0,M11.1.0"sv, "IST-1GMT0,M10.5.0,M3.5.0/1"sv,
+    "IST-5"sv, "JST-9"sv, "KST-9"sv, "MSK-3"sv, "MST7"sv, "MST7MDT,M3.2.0,M11.1.0"sv,
+    "MST7MDT,M4.1.0,M10.5.0"sv, "NST3"sv, "NZST-12NZDT,M9.5.0,M4.1.0/3"sv, "PKT-5"sv,
+    "PST-8"sv, "PST8PDT,M3.2.0,M11.1.0"sv, "SAST-2"sv, "SST11"sv, "WAT-1"sv,
+    "WET0WEST,M3.5.0/1,M10.5.0"sv, "WIB-7"sv, "WIT-9"sv, "WITA-8"sv,
+    // odd rules of test-tzbatch.c
+    "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1"sv, "XST3XDT,J60/2,J300/2"sv, "XST3XDT,59/2,299/2"sv,
+    "EST5EDT,0/0,J365/25"sv, "<+0545>-5:45"sv, "ACST-9:30ACDT,M10.1.0,M4.1.0/3"sv
+};
+
+// -------------------------------------------------------------------------------------
+// compile time
+
+// all zones parse completely
+static_assert([] {
+    for (auto spec : zoneTab) {
+        tziPosixZoneT zone{};
+        if (ucal::from_posix_spec(zone, spec) != spec.size()) {
+            return false;
+        }
+    }
+    return true;
+}());
+
+// Berlin2 of test-tzposix.c
+static constexpr tziPosixZoneT Berlin2 = {
+    "CET", "CEST", -60, -120,
+    { 10, 5, 7, 180 },
+    {  3, 5, 7, 120 }
+};
+static_assert(ucal::same_zone(Berlin2, ucal::posix_zone("CET-1<CEST>-2,M3.5.0/2,M10.5.0/3")));
+static_assert(ucal::same_zone(Berlin2, ucal::posix_zone("CET-1CEST-2,M3.5.0/2,M10.5.0/3")));
+static_assert(ucal::same_zone(Berlin2, ucal::posix_zone("CET-1CEST,M3.5.0,M10.5.0/3")));
+
+// seconds of a UTC date and time
+static constexpr int64_t
+utc(int16_t y, int16_t m, int16_t d, int h)
+{
+    return (int64_t)(ucal::detail::date_to_rdn(y, m, d) - UCAL_rdnUNIX) * 86400 + h * 3600;
+}
+
+static_assert(ucal::detail::date_to_rdn(1970, 1, 1) == UCAL_rdnUNIX);
+static_assert(ucal::detail::date_to_rdn(1, 1, 1) == 1);
+static_assert(ucal::detail::date_to_rdn(2024, 14, 0) == ucal::detail::date_to_rdn(2025, 1, 31));
+
+// the transitions the conversion tests of test-tzposix.c are built around
+static constexpr tziPosixZoneT Berlin   = ucal::posix_zone("CET-1CEST,M3.5.0,M10.5.0/3");
+static constexpr tziPosixZoneT Auckland = ucal::posix_zone("NZST-12NZDT,M9.5.0,M4.1.0/3");
+static constexpr tziPosixZoneT Dublin   = ucal::posix_zone("IST-1GMT0,M10.5.0,M3.5.0/1");
+
+static_assert((*ucal::transitions(Berlin, 2025))[0] == utc(2025, 3, 30, 1));
+static_assert((*ucal::transitions(Berlin, 2025))[1] == utc(2025, 10, 26, 1));
+static_assert((*ucal::transitions(Auckland, 2025))[0] == utc(2025, 9, 27, 14));
+static_assert((*ucal::transitions(Auckland, 2025))[1] == utc(2025, 4, 5, 14));
+static_assert((*ucal::transitions(Dublin, 2025))[0] == utc(2025, 10, 26, 1));
+static_assert((*ucal::transitions(Dublin, 2025))[1] == utc(2025, 3, 30, 1));
+static_assert(Dublin.stdOffs == -60 && Dublin.dstOffs == 0);
+static_assert(!ucal::transitions(ucal::posix_zone("JST-9"), 2025));
+
+// a compile-time table
+static constexpr auto BerlinTab = ucal::transition_table<2020, 16>(Berlin);
+static_assert(BerlinTab[5].year == 2025);
+static_assert(BerlinTab[5].ttDST == utc(2025, 3, 30, 1));
+static_assert(BerlinTab[15].ttSTD == utc(2035, 10, 28, 1));
+
+// bad specs
+static_assert([] {
+    tziPosixZoneT zone{};
+    return (ucal::from_posix_spec(zone, "cet-1") == std::string_view::npos)
+        && (ucal::from_posix_spec(zone, "CET-1CEST,M3.5.0") == std::string_view::npos)
+        && (ucal::from_posix_spec(zone, "CET-1CEST,M13.5.0,M10.5.0") == std::string_view::npos)
+        && (ucal::from_posix_spec(zone, "CET-1 trailing") == 5);
+}());
+
+// -------------------------------------------------------------------------------------
+// run time
+
+void setUp(void)
+{
+    // NOP
+}
+
+void tearDown(void)
+{
+    // NOP
+}
+
+// the C++ parser gives the same bytes as the C one
+static void
+test_ParseSame(void)
+{
+    for (auto spec : zoneTab) {
+        tziPosixZoneT zc, zx;
+        std::string   text(spec);
+        const char   *pret;
+
+        std::memset(&zc, 0, sizeof(zc));
+        std::memset(&zx, 0, sizeof(zx));
+        pret = tziFromPosixSpec(&zc, text.c_str(), NULL);
+        TEST_ASSERT_MESSAGE((pret && !*pret), text.c_str());
+        TEST_ASSERT_EQUAL(spec.size(), ucal::from_posix_spec(zx, spec));
+        TEST_ASSERT_MESSAGE(ucal::same_zone(zc, zx), text.c_str());
+    }
+}
+
+// rule evaluation against the C library, for many years
+static void
+test_Transitions(void)
+{
+    for (auto spec : zoneTab) {
+        tziPosixZoneT const zone = ucal::posix_zone(spec);
+        int64_t             tt[2];
+
+        for (int16_t y = 1800; y <= 2400; ++y) {
+            auto const tx = ucal::transitions(zone, y);
+            TEST_ASSERT_EQUAL(tziGetTransitions(tt, &zone, y), tx.has_value());
+            if (tx) {
+                TEST_ASSERT_EQUAL_INT64(tt[0], (*tx)[0]);
+                TEST_ASSERT_EQUAL_INT64(tt[1], (*tx)[1]);
+            }
+        }
+    }
+
+    // a compile-time zone works with the C conversions
+    tziConvCtxT  ctx;
+    tziConvInfoT info;
+    std::memset(&ctx, 0, sizeof(ctx));
+    ctx.pTZI = &Berlin;
+    TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&info, &ctx, utc(2025, 7, 1, 0)));
+    TEST_ASSERT_EQUAL(7200, info.offs);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc, (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_ParseSame);
+    RUN_TEST(test_Transitions);
+    return UNITY_END();
+}
+// -*- that's all folks -*-
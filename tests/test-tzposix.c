@@ -417,6 +417,46 @@ test_DublinAutumn2025(void) {
     TEST_ASSERT(0 == info.isHrA && 0 == info.isHrB);
 }
 
+// -------------------------------------------------------------------------------------
+// A zeroed context has the empty frame [0,0]; time stamps within a day of the epoch
+// must not take its null transitions for cached ones.
+static void
+test_ZeroedCtxNearEpoch(void) {
+    static const char * const zoneTab[] = {
+        "CET-1CEST,M3.5.0,M10.5.0/3", "NZST-12NZDT,M9.5.0,M4.1.0/3",
+        "IST-1GMT0,M10.5.0,M3.5.0/1", "EST5EDT,M3.2.0,M11.1.0",
+        NULL
+    };
+
+    tziPosixZoneT zone;
+    tziConvCtxT   ctx, ref;
+    tziConvInfoT  info, rinfo;
+    const char   *pret, *const *tptr;
+
+    for (tptr = zoneTab; NULL != *tptr; ++tptr) {
+        pret = tziFromPosixSpec(&zone, *tptr, NULL);
+        TEST_ASSERT_TRUE(pret && !*pret);
+        memset(&ref, 0, sizeof(ref));
+        ref.pTZI = &zone;
+        TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&rinfo, &ref, INT64_C(180) * 86400));
+        for (int64_t ts = -86400; ts <= 86400; ts += 1800) {
+            memset(&ctx, 0, sizeof(ctx));
+            ctx.pTZI = &zone;
+            TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&info, &ctx, ts));
+            TEST_ASSERT_TRUE(tziGetInfoUtc2Local(&rinfo, &ref, ts));
+            TEST_ASSERT_MESSAGE(info.offs == rinfo.offs, *tptr);
+            TEST_ASSERT_MESSAGE(info.isDst == rinfo.isDst, *tptr);
+
+            memset(&ctx, 0, sizeof(ctx));
+            ctx.pTZI = &zone;
+            TEST_ASSERT_TRUE(tziGetInfoLocal2Utc(&info, &ctx, ts, tziCvtHint_STD));
+            TEST_ASSERT_TRUE(tziGetInfoLocal2Utc(&rinfo, &ref, ts, tziCvtHint_STD));
+            TEST_ASSERT_MESSAGE(info.offs == rinfo.offs, *tptr);
+            TEST_ASSERT_MESSAGE(info.isDst == rinfo.isDst, *tptr);
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
     (void)argc;
@@ -438,5 +478,6 @@ int main(int argc, char **argv)
     RUN_TEST(test_AucklandAutumn2025);
     RUN_TEST(test_DublinSpring2025);
     RUN_TEST(test_DublinAutumn2025);
+    RUN_TEST(test_ZeroedCtxNearEpoch);
     return UNITY_END();
 }